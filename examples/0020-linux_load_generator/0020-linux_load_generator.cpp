@@ -0,0 +1,480 @@
+#include "Posix_MQTT_Client.h"
+#include <Attribute_Request.h>
+#include <Client_Side_RPC.h>
+#include <File_Firmware_Cache.h>
+#include <OTA_Firmware_Update.h>
+#include <ThingsBoard.h>
+
+#include <getopt.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+
+// Keys of the shared attributes requested by every device, a response is received even if the attributes do not exist on the device
+constexpr std::array<char const *, 2U> SHARED_ATTRIBUTES = { "targetTemperature", "reportInterval" };
+// Method of the client-side RPC requested by every device, has to be answered by the rule chain, for example with the "RPC Call Reply" node
+constexpr char RPC_METHOD[] = "getCurrentTime";
+// Keys of the sent telemetry, interned so the records are written directly into the send buffer
+constexpr Telemetry_Key TELEMETRY_KEYS[] = { TELEMETRY_KEY("temperature"), TELEMETRY_KEY("humidity"), TELEMETRY_KEY("rssi") };
+// Firmware the simulated devices report as installed, any firmware assigned on the server is downloaded and discarded
+constexpr char CURRENT_FIRMWARE_TITLE[] = "load_generator";
+constexpr char CURRENT_FIRMWARE_VERSION[] = "0.0.0";
+
+constexpr uint16_t MAX_MESSAGE_SEND_SIZE = 256U;
+constexpr uint16_t MAX_MESSAGE_RECEIVE_SIZE = 256U;
+constexpr uint32_t RECONNECT_DELAY_MILLISECONDS = 1000U;
+constexpr size_t MAX_EPOLL_EVENTS = 1024U;
+
+
+/// @brief Command line configuration of the load generator
+struct Configuration {
+    char const *host = "localhost";         // Broker or ThingsBoard instance the devices connect to
+    uint16_t   port = 1883U;                // MQTT port of the broker
+    size_t     clients = 100U;              // Amount of simulated devices
+    char const *token_prefix = "device";    // Access tokens are created by appending the index of the device, starting at 0
+    uint32_t   duration = 60U;              // Duration of the measurement in seconds, starting once the first device is connected
+    uint32_t   connect_rate = 100U;         // Maximum amount of connections established per second
+    uint32_t   telemetry_interval = 1000U;  // Interval telemetry is sent with in milliseconds, 0 disables the workload
+    uint32_t   attribute_interval = 0U;     // Interval shared attributes are requested with in milliseconds, 0 disables the workload
+    uint32_t   rpc_interval = 0U;           // Interval client-side RPC is requested with in milliseconds, 0 disables the workload
+    uint32_t   request_timeout = 5000U;     // Timeout of attribute and RPC requests in milliseconds
+    bool       ota = false;                 // Whether assigned firmware is downloaded
+    char const *ota_cache = nullptr;        // Directory downloaded firmware is shared between the devices in, nullptr if every device downloads it from the server
+    bool       short_topics = false;        // Whether the short topics of the device API are used instead of the full length topics
+    uint16_t   keep_alive = 60U;            // Keep alive interval of the connections in seconds
+    uint32_t   report_interval = 10U;       // Interval intermediate results are printed with in seconds
+    bool       verbose = false;             // Whether log messages of the ThingsBoard client are printed
+};
+
+
+/// @brief Counters and latency samples collected from all simulated devices
+struct Statistics {
+    uint64_t              connects = {};
+    uint64_t              connect_failures = {};
+    uint64_t              disconnects = {};
+    uint64_t              telemetry_sent = {};
+    uint64_t              telemetry_failed = {};
+    uint64_t              attribute_requests = {};
+    uint64_t              attribute_timeouts = {};
+    uint64_t              rpc_requests = {};
+    uint64_t              rpc_timeouts = {};
+    uint64_t              firmware_bytes = {};
+    uint64_t              firmware_updates = {};
+    uint64_t              firmware_failures = {};
+    uint64_t              log_messages = {};
+    std::vector<uint32_t> attribute_latencies = {}; // Round trip time of answered attribute requests in microseconds
+    std::vector<uint32_t> rpc_latencies = {};       // Round trip time of answered RPC requests in microseconds
+};
+
+Configuration configuration;
+Statistics statistics;
+
+
+/// @brief Logger that only counts the messages of the thousands of ThingsBoard clients, because printing all of them would distort the measurement
+class Counting_Logger {
+  public:
+    template<typename ...Args>
+    static int printfln(char const * format, Args const &... args) {
+        statistics.log_messages++;
+        if (!configuration.verbose) {
+            return 0;
+        }
+        return DefaultLogger::printfln(format, args...);
+    }
+};
+
+
+/// @brief Updater that discards the downloaded firmware, only the download itself and the verification of its checksum are measured
+class Discarding_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        statistics.firmware_bytes += total_bytes;
+        return total_bytes;
+    }
+
+    void reset() override {
+        // Nothing to do
+    }
+
+    bool end() override {
+        return true;
+    }
+};
+
+Discarding_Updater updater;
+
+
+/// @brief Single simulated device, consisting of its own MQTT connection, ThingsBoard client and API implementations,
+/// can not be copied or moved, because the ThingsBoard client binds callbacks to the addresses of its members
+struct Simulated_Device {
+    explicit Simulated_Device(size_t const & index)
+      : client()
+      , attribute_request()
+      , rpc_request()
+      , ota()
+      , firmware_cache(configuration.ota_cache)
+      , apis{ &attribute_request, &rpc_request, &ota }
+      , tb(client, MAX_MESSAGE_RECEIVE_SIZE, MAX_MESSAGE_SEND_SIZE, Default_Max_Stack_Size, apis)
+      , token()
+      , socket(-1)
+      , next_connect(0U)
+      , next_telemetry(0U)
+      , next_attribute(0U)
+      , next_rpc(0U)
+      , attribute_pending(false)
+      , rpc_pending(false)
+      , ota_subscribed(false)
+      , temperature(20.0F + static_cast<float>(index % 10U))
+    {
+        (void)snprintf(token, sizeof(token), "%s%zu", configuration.token_prefix, index);
+        client.set_keep_alive(configuration.keep_alive);
+        if (configuration.short_topics) {
+            tb.setTopicProfile(SHORT_TOPIC_PROFILE);
+        }
+    }
+
+    Simulated_Device(Simulated_Device const &) = delete;
+    Simulated_Device & operator=(Simulated_Device const &) = delete;
+
+    Posix_MQTT_Client                              client;
+    Attribute_Request<1U, 2U, Counting_Logger>     attribute_request;
+    Client_Side_RPC<1U, 1U, Counting_Logger>       rpc_request;
+    OTA_Firmware_Update<Counting_Logger>           ota;
+    File_Firmware_Cache<Counting_Logger>           firmware_cache;
+    std::array<IAPI_Implementation *, 3U>          apis;
+    ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, Counting_Logger> tb;
+    char                                           token[32U];
+    int                                            socket;
+    uint32_t                                       next_connect;
+    uint32_t                                       next_telemetry;
+    uint32_t                                       next_attribute;
+    uint32_t                                       next_rpc;
+    bool                                           attribute_pending;
+    bool                                           rpc_pending;
+    bool                                           ota_subscribed;
+    float                                          temperature;
+};
+
+
+/// @brief Whether the given time has been reached, handles the overflow of the millisecond counter
+/// @param now Current time in milliseconds
+/// @param time Time that should be checked
+/// @return Whether the given time is now or in the past
+bool Reached(uint32_t const & now, uint32_t const & time) {
+    return static_cast<int32_t>(now - time) >= 0;
+}
+
+/// @brief Remaining time until the given time, 0 if it has already been reached
+/// @param now Current time in milliseconds
+/// @param time Time the remaining time should be calculated for
+/// @return Remaining time in milliseconds
+uint32_t Remaining(uint32_t const & now, uint32_t const & time) {
+    return Reached(now, time) ? 0U : time - now;
+}
+
+/// @brief Gets the currently used heap memory, used to calculate the memory required per simulated device
+/// @return Allocated heap memory in bytes
+size_t Heap_Usage() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0U;
+#endif
+}
+
+/// @brief Gets the given percentile of the given latency samples
+/// @param samples Sorted latency samples in microseconds
+/// @param percentile Percentile between 0 and 100
+/// @return Latency in milliseconds
+double Percentile(std::vector<uint32_t> const & samples, double const & percentile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t const index = static_cast<size_t>((percentile / 100.0) * static_cast<double>(samples.size() - 1U));
+    return static_cast<double>(samples[index]) / 1000.0;
+}
+
+/// @brief Prints the latency percentiles of the given request type
+/// @param name Name of the request type
+/// @param samples Latency samples in microseconds, are sorted by this method
+/// @param requests Amount of sent requests
+/// @param timeouts Amount of requests that timed out
+void Print_Latencies(char const * name, std::vector<uint32_t> & samples, uint64_t const & requests, uint64_t const & timeouts) {
+    std::sort(samples.begin(), samples.end());
+    printf("  %-10s requests %-9llu answered %-9zu timeouts %-9llu p50 %8.2f ms  p90 %8.2f ms  p99 %8.2f ms  max %8.2f ms\n", name, static_cast<unsigned long long>(requests), samples.size(), static_cast<unsigned long long>(timeouts),
+      Percentile(samples, 50.0), Percentile(samples, 90.0), Percentile(samples, 99.0), Percentile(samples, 100.0));
+}
+
+/// @brief Prints the statistics collected since the measurement started
+/// @param devices Simulated devices, used to sum up their traffic and connection state
+/// @param elapsed Time since the measurement started in milliseconds
+/// @param memory_per_device Heap memory required per device in bytes
+void Print_Report(std::vector<std::unique_ptr<Simulated_Device>> & devices, uint32_t const & elapsed, size_t const & memory_per_device) {
+    uint64_t bytes_sent = 0U;
+    uint64_t bytes_received = 0U;
+    size_t connected = 0U;
+    for (auto const & device : devices) {
+        uint64_t sent = 0U;
+        uint64_t received = 0U;
+        device->client.get_traffic(sent, received);
+        bytes_sent += sent;
+        bytes_received += received;
+        connected += device->client.connected() ? 1U : 0U;
+    }
+    double const seconds = elapsed > 0U ? static_cast<double>(elapsed) / 1000.0 : 1.0;
+
+    printf("[%7.1f s] connected %zu/%zu, connects %llu, connect failures %llu, disconnects %llu, logged messages %llu\n", seconds, connected, devices.size(),
+      static_cast<unsigned long long>(statistics.connects), static_cast<unsigned long long>(statistics.connect_failures), static_cast<unsigned long long>(statistics.disconnects), static_cast<unsigned long long>(statistics.log_messages));
+    printf("  telemetry  sent %llu (%.1f msg/s), failed %llu\n", static_cast<unsigned long long>(statistics.telemetry_sent), static_cast<double>(statistics.telemetry_sent) / seconds, static_cast<unsigned long long>(statistics.telemetry_failed));
+    Print_Latencies("attributes", statistics.attribute_latencies, statistics.attribute_requests, statistics.attribute_timeouts);
+    Print_Latencies("rpc", statistics.rpc_latencies, statistics.rpc_requests, statistics.rpc_timeouts);
+    printf("  firmware   downloaded %llu bytes, updates %llu, failures %llu\n", static_cast<unsigned long long>(statistics.firmware_bytes), static_cast<unsigned long long>(statistics.firmware_updates), static_cast<unsigned long long>(statistics.firmware_failures));
+    printf("  traffic    sent %.1f KiB/s, received %.1f KiB/s\n", static_cast<double>(bytes_sent) / 1024.0 / seconds, static_cast<double>(bytes_received) / 1024.0 / seconds);
+    printf("  memory     %zu bytes per device (%zu bytes instance, remaining heap allocated by buffers)\n", memory_per_device, sizeof(Simulated_Device));
+}
+
+/// @brief Connects the given device if it is not connected and the reconnect delay passed, registers its socket to be waited for and subscribes to firmware updates
+/// @param device Device that should be connected
+/// @param epoll Epoll instance the socket of the device is registered to
+/// @param now Current time in milliseconds
+void Connect(Simulated_Device & device, int const & epoll, uint32_t const & now) {
+    if (device.socket >= 0) {
+        // Closed sockets are removed from the epoll instance automatically
+        statistics.disconnects++;
+        device.socket = -1;
+    }
+    if (!device.tb.connect(configuration.host, device.token, configuration.port)) {
+        statistics.connect_failures++;
+        device.next_connect = now + RECONNECT_DELAY_MILLISECONDS;
+        return;
+    }
+    statistics.connects++;
+    device.socket = device.tb.getReadinessHandle();
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = &device;
+    (void)epoll_ctl(epoll, EPOLL_CTL_ADD, device.socket, &event);
+
+    // Only subscribed once, because the ThingsBoard client resubscribes all topics after reconnecting itself. Start_Firmware_Update() is not used,
+    // because it keeps its request callback in a function-local static, which would always answer to the first instance of all devices
+    if (configuration.ota && !device.ota_subscribed) {
+        OTA_Update_Callback callback(CURRENT_FIRMWARE_TITLE, CURRENT_FIRMWARE_VERSION, &updater, [](bool const & success) {
+            success ? statistics.firmware_updates++ : statistics.firmware_failures++;
+        });
+        // Every device requires its own instance, because each instance only reads or stores one binary at once, but all of them share the same directory
+        if (configuration.ota_cache != nullptr) {
+            callback.Set_Firmware_Cache(&device.firmware_cache);
+        }
+        device.ota_subscribed = device.ota.Subscribe_Firmware_Update(callback);
+    }
+    // Spreads the workloads of the devices over their intervals, to not send all messages at the same time
+    device.next_telemetry = now + (configuration.telemetry_interval > 0U ? static_cast<uint32_t>(rand()) % configuration.telemetry_interval : 0U);
+    device.next_attribute = now + (configuration.attribute_interval > 0U ? static_cast<uint32_t>(rand()) % configuration.attribute_interval : 0U);
+    device.next_rpc = now + (configuration.rpc_interval > 0U ? static_cast<uint32_t>(rand()) % configuration.rpc_interval : 0U);
+}
+
+/// @brief Runs every workload of the given device that is due
+/// @param device Device the workloads should be run for
+/// @param now Current time in milliseconds
+void Run_Workloads(Simulated_Device & device, uint32_t const & now) {
+    if (configuration.telemetry_interval > 0U && Reached(now, device.next_telemetry)) {
+        device.next_telemetry += configuration.telemetry_interval;
+        device.temperature += static_cast<float>(rand() % 11 - 5) / 10.0F;
+        const Telemetry data[] = { Telemetry(TELEMETRY_KEYS[0U], device.temperature), Telemetry(TELEMETRY_KEYS[1U], 40 + rand() % 20), Telemetry(TELEMETRY_KEYS[2U], -60 - rand() % 30) };
+        device.tb.sendTelemetry<3U>(data, data + 3U) ? statistics.telemetry_sent++ : statistics.telemetry_failed++;
+    }
+
+    uint64_t const timeout = static_cast<uint64_t>(configuration.request_timeout) * 1000U;
+    if (configuration.attribute_interval > 0U && !device.attribute_pending && Reached(now, device.next_attribute)) {
+        device.next_attribute += configuration.attribute_interval;
+        Simulated_Device * instance = &device;
+        unsigned long const start = micros();
+        const Attribute_Request_Callback<2U> callback([instance, start](JsonObjectConst const & data) {
+            statistics.attribute_latencies.push_back(static_cast<uint32_t>(micros() - start));
+            instance->attribute_pending = false;
+        }, timeout, [instance]() {
+            statistics.attribute_timeouts++;
+            instance->attribute_pending = false;
+        }, SHARED_ATTRIBUTES.cbegin(), SHARED_ATTRIBUTES.cend());
+        device.attribute_pending = device.attribute_request.Shared_Attributes_Request(callback);
+        statistics.attribute_requests += device.attribute_pending ? 1U : 0U;
+    }
+
+    if (configuration.rpc_interval > 0U && !device.rpc_pending && Reached(now, device.next_rpc)) {
+        device.next_rpc += configuration.rpc_interval;
+        Simulated_Device * instance = &device;
+        unsigned long const start = micros();
+        const RPC_Request_Callback callback(RPC_METHOD, [instance, start](JsonDocument const & data) {
+            statistics.rpc_latencies.push_back(static_cast<uint32_t>(micros() - start));
+            instance->rpc_pending = false;
+        }, nullptr, timeout, [instance]() {
+            statistics.rpc_timeouts++;
+            instance->rpc_pending = false;
+        });
+        device.rpc_pending = device.rpc_request.RPC_Request(callback);
+        statistics.rpc_requests += device.rpc_pending ? 1U : 0U;
+    }
+}
+
+/// @brief Gets the time until the next workload of the given device is due
+/// @param device Device the next workload should be calculated for
+/// @param now Current time in milliseconds
+/// @return Remaining time in milliseconds, UINT32_MAX if no workload is enabled
+uint32_t Next_Workload(Simulated_Device const & device, uint32_t const & now) {
+    uint32_t deadline = UINT32_MAX;
+    if (configuration.telemetry_interval > 0U) {
+        deadline = std::min(deadline, Remaining(now, device.next_telemetry));
+    }
+    if (configuration.attribute_interval > 0U && !device.attribute_pending) {
+        deadline = std::min(deadline, Remaining(now, device.next_attribute));
+    }
+    if (configuration.rpc_interval > 0U && !device.rpc_pending) {
+        deadline = std::min(deadline, Remaining(now, device.next_rpc));
+    }
+    return deadline;
+}
+
+/// @brief Parses the command line arguments into the global configuration
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @return Whether the arguments were valid or not
+bool Parse_Arguments(int argc, char ** argv) {
+    static option const options[] = {
+        { "host", required_argument, nullptr, 'H' },
+        { "port", required_argument, nullptr, 'p' },
+        { "clients", required_argument, nullptr, 'c' },
+        { "token-prefix", required_argument, nullptr, 't' },
+        { "duration", required_argument, nullptr, 'd' },
+        { "connect-rate", required_argument, nullptr, 'r' },
+        { "telemetry-interval", required_argument, nullptr, 'T' },
+        { "attribute-interval", required_argument, nullptr, 'A' },
+        { "rpc-interval", required_argument, nullptr, 'R' },
+        { "request-timeout", required_argument, nullptr, 'o' },
+        { "ota", no_argument, nullptr, 'O' },
+        { "ota-cache", required_argument, nullptr, 'C' },
+        { "short-topics", no_argument, nullptr, 'S' },
+        { "keep-alive", required_argument, nullptr, 'k' },
+        { "report-interval", required_argument, nullptr, 'i' },
+        { "verbose", no_argument, nullptr, 'v' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    int option = 0;
+    while ((option = getopt_long(argc, argv, "H:p:c:t:d:r:T:A:R:o:OC:Sk:i:v", options, nullptr)) != -1) {
+        switch (option) {
+            case 'H': configuration.host = optarg; break;
+            case 'p': configuration.port = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 'c': configuration.clients = strtoul(optarg, nullptr, 10); break;
+            case 't': configuration.token_prefix = optarg; break;
+            case 'd': configuration.duration = strtoul(optarg, nullptr, 10); break;
+            case 'r': configuration.connect_rate = strtoul(optarg, nullptr, 10); break;
+            case 'T': configuration.telemetry_interval = strtoul(optarg, nullptr, 10); break;
+            case 'A': configuration.attribute_interval = strtoul(optarg, nullptr, 10); break;
+            case 'R': configuration.rpc_interval = strtoul(optarg, nullptr, 10); break;
+            case 'o': configuration.request_timeout = strtoul(optarg, nullptr, 10); break;
+            case 'O': configuration.ota = true; break;
+            case 'C': configuration.ota = true; configuration.ota_cache = optarg; break;
+            case 'S': configuration.short_topics = true; break;
+            case 'k': configuration.keep_alive = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 'i': configuration.report_interval = strtoul(optarg, nullptr, 10); break;
+            case 'v': configuration.verbose = true; break;
+            default: return false;
+        }
+    }
+    return configuration.clients > 0U && configuration.connect_rate > 0U;
+}
+
+int main(int argc, char ** argv) {
+    if (!Parse_Arguments(argc, argv)) {
+        printf("Usage: %s [--host localhost] [--port 1883] [--clients 100] [--token-prefix device] [--duration 60] [--connect-rate 100]\n"
+               "          [--telemetry-interval 1000] [--attribute-interval 0] [--rpc-interval 0] [--request-timeout 5000] [--ota]\n"
+               "          [--ota-cache directory] [--short-topics] [--keep-alive 60] [--report-interval 10] [--verbose]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int const epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        perror("epoll_create1");
+        return EXIT_FAILURE;
+    }
+
+    size_t const heap_before = Heap_Usage();
+    std::vector<std::unique_ptr<Simulated_Device>> devices;
+    devices.reserve(configuration.clients);
+    for (size_t i = 0U; i < configuration.clients; ++i) {
+        devices.emplace_back(new Simulated_Device(i));
+    }
+    size_t memory_per_device = (Heap_Usage() - heap_before) / configuration.clients;
+
+    uint32_t const connect_spacing = std::max<uint32_t>(1000U / configuration.connect_rate, 1U);
+    uint32_t next_connect_slot = millis();
+    uint32_t start = 0U;
+    uint32_t next_report = 0U;
+    bool measuring = false;
+    epoll_event events[MAX_EPOLL_EVENTS] = {};
+
+    while (!measuring || !Reached(millis(), start + configuration.duration * 1000U)) {
+        uint32_t now = millis();
+        uint32_t timeout = measuring ? Remaining(now, start + configuration.duration * 1000U) : UINT32_MAX;
+
+        for (auto const & pointer : devices) {
+            Simulated_Device & device = *pointer;
+            if (!device.tb.connected()) {
+                if (!Reached(now, device.next_connect)) {
+                    timeout = std::min(timeout, Remaining(now, device.next_connect));
+                    continue;
+                }
+                else if (!Reached(now, next_connect_slot)) {
+                    timeout = std::min(timeout, Remaining(now, next_connect_slot));
+                    continue;
+                }
+                next_connect_slot = now + connect_spacing;
+                Connect(device, epoll, now);
+                now = millis();
+                if (!device.tb.connected()) {
+                    continue;
+                }
+                else if (!measuring) {
+                    measuring = true;
+                    start = now;
+                    next_report = start + configuration.report_interval * 1000U;
+                }
+            }
+            Run_Workloads(device, now);
+            if (device.tb.getNextDeadline() == 0U) {
+                device.tb.loop();
+            }
+            timeout = std::min(timeout, std::min(device.tb.getNextDeadline(), Next_Workload(device, now)));
+        }
+
+        if (measuring && configuration.report_interval > 0U && Reached(now, next_report)) {
+            next_report += configuration.report_interval * 1000U;
+            Print_Report(devices, now - start, memory_per_device);
+            timeout = 0U;
+        }
+
+        // Sleeps until any socket received a packet or the earliest deadline of all devices passed, instead of looping all devices continously
+        int const ready = epoll_wait(epoll, events, MAX_EPOLL_EVENTS, timeout == UINT32_MAX ? -1 : static_cast<int>(std::min<uint32_t>(timeout, INT32_MAX)));
+        for (int i = 0; i < ready; ++i) {
+            static_cast<Simulated_Device *>(events[i].data.ptr)->tb.loop();
+        }
+    }
+
+    // Receive buffers might have been increased while downloading firmware, therefore the memory per device is measured again
+    memory_per_device = (Heap_Usage() - heap_before) / configuration.clients;
+    Print_Report(devices, millis() - start, memory_per_device);
+    for (auto const & device : devices) {
+        device->tb.disconnect();
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,523 @@
+// Header include.
+#include "Posix_MQTT_Client.h"
+
+// Library includes.
+#include <Arduino.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+// Fixed header bytes of the MQTT control packets, the lower half byte contains the flags required by the specification for the given packet type
+uint8_t constexpr MQTT_CONNECT_HEADER = 0x10U;
+uint8_t constexpr MQTT_CONNACK_HEADER = 0x20U;
+uint8_t constexpr MQTT_PUBLISH_HEADER = 0x30U;
+uint8_t constexpr MQTT_PUBACK_HEADER = 0x40U;
+uint8_t constexpr MQTT_SUBSCRIBE_HEADER = 0x82U;
+uint8_t constexpr MQTT_UNSUBSCRIBE_HEADER = 0xA2U;
+uint8_t constexpr MQTT_PINGREQ_HEADER = 0xC0U;
+uint8_t constexpr MQTT_DISCONNECT_HEADER = 0xE0U;
+uint8_t constexpr MQTT_PACKET_TYPE_MASK = 0xF0U;
+// Protocol name and level of MQTT 3.1.1, followed by the connect flags
+uint8_t constexpr MQTT_PROTOCOL_NAME[] = { 0x00U, 0x04U, 'M', 'Q', 'T', 'T', 0x04U };
+uint8_t constexpr MQTT_CLEAN_SESSION_FLAG = 0x02U;
+uint8_t constexpr MQTT_PASSWORD_FLAG = 0x40U;
+uint8_t constexpr MQTT_USER_NAME_FLAG = 0x80U;
+// Maximum size of the fixed header, consisting of the packet type and at most four bytes of the variable length encoded remaining length
+size_t constexpr MQTT_MAX_HEADER_SIZE = 5U;
+// Maximum value the multiplier of the variable length encoding reaches after the fourth byte
+size_t constexpr MQTT_MAX_LENGTH_MULTIPLIER = 128U * 128U * 128U * 128U;
+// Default keep alive interval in seconds, connect timeout in milliseconds and size of the staging buffer received bytes are read into
+uint16_t constexpr DEFAULT_KEEP_ALIVE = 15U;
+uint32_t constexpr DEFAULT_CONNECT_TIMEOUT = 5000U;
+size_t constexpr READ_CHUNK_SIZE = 512U;
+
+Posix_MQTT_Client::Posix_MQTT_Client() :
+    m_connected_callback(),
+    m_data_callback(),
+    m_host(nullptr),
+    m_port(0U),
+    m_keep_alive(DEFAULT_KEEP_ALIVE),
+    m_connect_timeout(DEFAULT_CONNECT_TIMEOUT),
+    m_socket(-1),
+    m_connected(false),
+    m_session_present(false),
+    m_ping_outstanding(false),
+    m_packet_identifier(0U),
+    m_last_outbound(0U),
+    m_last_inbound(0U),
+    m_receive_buffer(nullptr),
+    m_receive_buffer_size(0U),
+    m_send_buffer_size(0U),
+    m_read_state(Read_State::HEADER),
+    m_header(0U),
+    m_remaining_length(0U),
+    m_length_multiplier(1U),
+    m_body_offset(0U),
+    m_discard_packet(false),
+    m_bytes_sent(0U),
+    m_bytes_received(0U)
+{
+    // Nothing to do
+}
+
+Posix_MQTT_Client::~Posix_MQTT_Client() {
+    Close_Socket();
+    delete[] m_receive_buffer;
+    m_receive_buffer = nullptr;
+}
+
+void Posix_MQTT_Client::set_keep_alive(uint16_t keep_alive) {
+    m_keep_alive = keep_alive;
+}
+
+void Posix_MQTT_Client::set_connect_timeout(uint32_t timeout_milliseconds) {
+    m_connect_timeout = timeout_milliseconds;
+}
+
+void Posix_MQTT_Client::set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) {
+    m_data_callback.Set_Callback(callback);
+}
+
+void Posix_MQTT_Client::set_connect_callback(Callback<void>::function callback) {
+    m_connected_callback.Set_Callback(callback);
+}
+
+bool Posix_MQTT_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    if (receive_buffer_size != m_receive_buffer_size) {
+        uint8_t * receive_buffer = new uint8_t[receive_buffer_size]();
+        if (receive_buffer == nullptr) {
+            return false;
+        }
+        delete[] m_receive_buffer;
+        m_receive_buffer = receive_buffer;
+        m_receive_buffer_size = receive_buffer_size;
+        // A partially received packet would have been collected into the previous buffer, therefore it can not be completed anymore
+        m_discard_packet = m_discard_packet || m_read_state == Read_State::BODY;
+    }
+    m_send_buffer_size = send_buffer_size;
+    return true;
+}
+
+uint16_t Posix_MQTT_Client::get_receive_buffer_size() {
+    return m_receive_buffer_size;
+}
+
+uint16_t Posix_MQTT_Client::get_send_buffer_size() {
+    return m_send_buffer_size;
+}
+
+void Posix_MQTT_Client::set_server(char const * domain, uint16_t port) {
+    m_host = domain;
+    m_port = port;
+}
+
+bool Posix_MQTT_Client::connect(char const * client_id, char const * user_name, char const * password) {
+    Close_Socket();
+    if (client_id == nullptr || !Open_Socket()) {
+        return false;
+    }
+
+    uint8_t flags = MQTT_CLEAN_SESSION_FLAG;
+    std::vector<uint8_t> body(MQTT_PROTOCOL_NAME, MQTT_PROTOCOL_NAME + sizeof(MQTT_PROTOCOL_NAME));
+    body.push_back(0U);
+    body.push_back(static_cast<uint8_t>(m_keep_alive >> 8U));
+    body.push_back(static_cast<uint8_t>(m_keep_alive & 0xFFU));
+    auto const append_string = [&body](char const * value) {
+        size_t const length = strlen(value);
+        body.push_back(static_cast<uint8_t>(length >> 8U));
+        body.push_back(static_cast<uint8_t>(length & 0xFFU));
+        body.insert(body.end(), value, value + length);
+    };
+    append_string(client_id);
+    if (user_name != nullptr) {
+        flags |= MQTT_USER_NAME_FLAG;
+        append_string(user_name);
+    }
+    if (password != nullptr) {
+        flags |= MQTT_PASSWORD_FLAG;
+        append_string(password);
+    }
+    body[sizeof(MQTT_PROTOCOL_NAME)] = flags;
+
+    uint8_t header[MQTT_MAX_HEADER_SIZE] = { MQTT_CONNECT_HEADER };
+    iovec buffers[2U] = { { header, 1U + Encode_Length(header + 1U, body.size()) }, { body.data(), body.size() } };
+    if (!Write_Packet(buffers, 2U)) {
+        return false;
+    }
+
+    // Waits for the CONNACK packet, which is the only packet the broker is allowed to send before it accepted the connection
+    uint32_t const start = millis();
+    while (!m_connected) {
+        uint32_t const elapsed = millis() - start;
+        if (elapsed >= m_connect_timeout) {
+            Close_Socket();
+            return false;
+        }
+        pollfd descriptor = { m_socket, POLLIN, 0 };
+        int const result = poll(&descriptor, 1U, static_cast<int>(m_connect_timeout - elapsed));
+        if (result < 0 && errno != EINTR) {
+            Close_Socket();
+            return false;
+        }
+        else if (result > 0 && !Read_Available()) {
+            Close_Socket();
+            return false;
+        }
+    }
+    m_connected_callback.Call_Callback();
+    return true;
+}
+
+void Posix_MQTT_Client::disconnect() {
+    if (m_connected) {
+        uint8_t header[2U] = { MQTT_DISCONNECT_HEADER, 0U };
+        iovec buffer = { header, sizeof(header) };
+        (void)Write_Packet(&buffer, 1U);
+    }
+    Close_Socket();
+}
+
+bool Posix_MQTT_Client::loop() {
+    if (!m_connected) {
+        return false;
+    }
+    else if (!Read_Available()) {
+        Close_Socket();
+        return false;
+    }
+
+    uint32_t const now = millis();
+    uint32_t const keep_alive = static_cast<uint32_t>(m_keep_alive) * 1000U;
+    if (keep_alive != 0U && (now - m_last_outbound >= keep_alive || now - m_last_inbound >= keep_alive)) {
+        // Same behaviour as the PubSubClient, the connection is considered lost if the previous keep alive message was not answered within one interval
+        if (m_ping_outstanding) {
+            Close_Socket();
+            return false;
+        }
+        uint8_t header[2U] = { MQTT_PINGREQ_HEADER, 0U };
+        iovec buffer = { header, sizeof(header) };
+        if (!Write_Packet(&buffer, 1U)) {
+            return false;
+        }
+        m_last_inbound = now;
+        m_ping_outstanding = true;
+    }
+    return m_connected;
+}
+
+bool Posix_MQTT_Client::publish(char const * topic, uint8_t const * payload, size_t const & length) {
+    if (!m_connected) {
+        return false;
+    }
+    size_t const topic_length = strlen(topic);
+    // Same limit as the PubSubClient, which has to fit the complete packet into its send buffer
+    if (MQTT_MAX_HEADER_SIZE + 2U + topic_length + length > m_send_buffer_size) {
+        return false;
+    }
+
+    uint8_t header[MQTT_MAX_HEADER_SIZE + 2U] = { MQTT_PUBLISH_HEADER };
+    size_t header_length = 1U + Encode_Length(header + 1U, 2U + topic_length + length);
+    header[header_length++] = static_cast<uint8_t>(topic_length >> 8U);
+    header[header_length++] = static_cast<uint8_t>(topic_length & 0xFFU);
+    iovec buffers[3U] = { { header, header_length }, { const_cast<char *>(topic), topic_length }, { const_cast<uint8_t *>(payload), length } };
+    return Write_Packet(buffers, 3U);
+}
+
+bool Posix_MQTT_Client::subscribe(char const * topic) {
+    return Write_Topic_Packet(MQTT_SUBSCRIBE_HEADER, topic, 0);
+}
+
+bool Posix_MQTT_Client::subscribe(char const * const * topics, size_t const & topic_amount) {
+    for (size_t i = 0U; i < topic_amount; ++i) {
+        if (!subscribe(topics[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Posix_MQTT_Client::unsubscribe(char const * topic) {
+    return Write_Topic_Packet(MQTT_UNSUBSCRIBE_HEADER, topic, -1);
+}
+
+bool Posix_MQTT_Client::connected() {
+    return m_connected;
+}
+
+bool Posix_MQTT_Client::get_session_present() {
+    return m_session_present;
+}
+
+uint32_t Posix_MQTT_Client::get_next_deadline() {
+    // Looping a disconnected client does nothing, the load generator reconnects every device itself once its backoff delay passed
+    if (!m_connected) {
+        return UINT32_MAX;
+    }
+    uint32_t const keep_alive = static_cast<uint32_t>(m_keep_alive) * 1000U;
+    if (keep_alive == 0U) {
+        return UINT32_MAX;
+    }
+    uint32_t const now = millis();
+    uint32_t const outbound_elapsed = now - m_last_outbound;
+    uint32_t const inbound_elapsed = now - m_last_inbound;
+    uint32_t const elapsed = outbound_elapsed > inbound_elapsed ? outbound_elapsed : inbound_elapsed;
+    return elapsed >= keep_alive ? 0U : keep_alive - elapsed;
+}
+
+int Posix_MQTT_Client::get_readiness_handle() {
+    return m_socket;
+}
+
+void Posix_MQTT_Client::get_traffic(uint64_t & sent, uint64_t & received) const {
+    sent = m_bytes_sent;
+    received = m_bytes_received;
+}
+
+bool Posix_MQTT_Client::Open_Socket() {
+    if (m_host == nullptr) {
+        return false;
+    }
+    char port[6U] = {};
+    (void)snprintf(port, sizeof(port), "%u", m_port);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo * addresses = nullptr;
+    if (getaddrinfo(m_host, port, &hints, &addresses) != 0) {
+        return false;
+    }
+
+    for (addrinfo * address = addresses; address != nullptr && m_socket < 0; address = address->ai_next) {
+        m_socket = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address->ai_protocol);
+        if (m_socket < 0) {
+            continue;
+        }
+        // Connecting without blocking allows to limit the time waited for an unreachable server to the connect timeout
+        int result = ::connect(m_socket, address->ai_addr, address->ai_addrlen);
+        if (result < 0 && errno == EINPROGRESS) {
+            pollfd descriptor = { m_socket, POLLOUT, 0 };
+            int error = 0;
+            socklen_t error_length = sizeof(error);
+            result = (poll(&descriptor, 1U, static_cast<int>(m_connect_timeout)) == 1 && getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &error, &error_length) == 0 && error == 0) ? 0 : -1;
+        }
+        if (result < 0) {
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (m_socket < 0) {
+        return false;
+    }
+
+    // Writes block until the packet has been handed to the kernel, while reads always use MSG_DONTWAIT, because only received bytes should be waited for with epoll
+    int const flags = fcntl(m_socket, F_GETFL, 0);
+    (void)fcntl(m_socket, F_SETFL, flags & ~O_NONBLOCK);
+    int const no_delay = 1;
+    (void)setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    m_last_inbound = millis();
+    return true;
+}
+
+bool Posix_MQTT_Client::Write_Packet(iovec * buffers, size_t const & buffer_amount) {
+    if (m_socket < 0) {
+        return false;
+    }
+    msghdr message = {};
+    message.msg_iov = buffers;
+    message.msg_iovlen = buffer_amount;
+    while (message.msg_iovlen > 0U) {
+        ssize_t const written = sendmsg(m_socket, &message, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Close_Socket();
+            return false;
+        }
+        m_bytes_sent += static_cast<uint64_t>(written);
+        // Skips the completely written buffers and advances into the partially written one
+        size_t remaining = static_cast<size_t>(written);
+        while (message.msg_iovlen > 0U && remaining >= message.msg_iov->iov_len) {
+            remaining -= message.msg_iov->iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        if (message.msg_iovlen > 0U) {
+            message.msg_iov->iov_base = static_cast<uint8_t *>(message.msg_iov->iov_base) + remaining;
+            message.msg_iov->iov_len -= remaining;
+        }
+    }
+    m_last_outbound = millis();
+    return true;
+}
+
+bool Posix_MQTT_Client::Write_Topic_Packet(uint8_t const & header, char const * topic, int const & quality_of_service) {
+    if (!m_connected) {
+        return false;
+    }
+    size_t const topic_length = strlen(topic);
+    m_packet_identifier = (m_packet_identifier == UINT16_MAX) ? 1U : m_packet_identifier + 1U;
+
+    uint8_t fixed_header[MQTT_MAX_HEADER_SIZE + 4U] = { header };
+    size_t header_length = 1U + Encode_Length(fixed_header + 1U, 4U + topic_length + (quality_of_service >= 0 ? 1U : 0U));
+    fixed_header[header_length++] = static_cast<uint8_t>(m_packet_identifier >> 8U);
+    fixed_header[header_length++] = static_cast<uint8_t>(m_packet_identifier & 0xFFU);
+    fixed_header[header_length++] = static_cast<uint8_t>(topic_length >> 8U);
+    fixed_header[header_length++] = static_cast<uint8_t>(topic_length & 0xFFU);
+    uint8_t requested_quality_of_service = static_cast<uint8_t>(quality_of_service);
+    iovec buffers[3U] = { { fixed_header, header_length }, { const_cast<char *>(topic), topic_length }, { &requested_quality_of_service, 1U } };
+    return Write_Packet(buffers, quality_of_service >= 0 ? 3U : 2U);
+}
+
+bool Posix_MQTT_Client::Read_Available() {
+    uint8_t chunk[READ_CHUNK_SIZE] = {};
+    while (m_socket >= 0) {
+        ssize_t const received = recv(m_socket, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received > 0) {
+            m_bytes_received += static_cast<uint64_t>(received);
+            if (!Handle_Bytes(chunk, static_cast<size_t>(received))) {
+                return false;
+            }
+            continue;
+        }
+        else if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        // Either every available byte has been read or the connection has been closed by the broker
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    return false;
+}
+
+bool Posix_MQTT_Client::Handle_Bytes(uint8_t const * data, size_t const & length) {
+    size_t index = 0U;
+    while (index < length) {
+        switch (m_read_state) {
+            case Read_State::HEADER:
+                m_header = data[index++];
+                m_remaining_length = 0U;
+                m_length_multiplier = 1U;
+                m_read_state = Read_State::LENGTH;
+                break;
+            case Read_State::LENGTH: {
+                uint8_t const current = data[index++];
+                m_remaining_length += (current & 0x7FU) * m_length_multiplier;
+                m_length_multiplier *= 128U;
+                if ((current & 0x80U) != 0U) {
+                    if (m_length_multiplier >= MQTT_MAX_LENGTH_MULTIPLIER) {
+                        return false;
+                    }
+                    break;
+                }
+                m_body_offset = 0U;
+                m_discard_packet = m_remaining_length > m_receive_buffer_size;
+                m_read_state = Read_State::BODY;
+                if (m_remaining_length == 0U) {
+                    m_read_state = Read_State::HEADER;
+                    if (!Handle_Packet()) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            case Read_State::BODY: {
+                size_t const available = length - index;
+                size_t const missing = m_remaining_length - m_body_offset;
+                size_t const amount = available < missing ? available : missing;
+                // Packets that do not fit into the receive buffer are discarded, just like the PubSubClient does
+                if (!m_discard_packet) {
+                    memcpy(m_receive_buffer + m_body_offset, data + index, amount);
+                }
+                m_body_offset += amount;
+                index += amount;
+                if (m_body_offset == m_remaining_length) {
+                    m_read_state = Read_State::HEADER;
+                    if (!m_discard_packet && !Handle_Packet()) {
+                        return false;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool Posix_MQTT_Client::Handle_Packet() {
+    m_last_inbound = millis();
+    m_ping_outstanding = false;
+
+    switch (m_header & MQTT_PACKET_TYPE_MASK) {
+        case MQTT_CONNACK_HEADER:
+            // Return code 0 is the only code that accepts the connection, every other code is followed by the broker closing the connection
+            if (m_remaining_length != 2U || m_receive_buffer[1U] != 0U) {
+                return false;
+            }
+            m_session_present = (m_receive_buffer[0U] & 0x01U) != 0U;
+            m_connected = true;
+            break;
+        case MQTT_PUBLISH_HEADER: {
+            uint8_t const quality_of_service = (m_header >> 1U) & 0x03U;
+            if (m_remaining_length < 2U) {
+                return false;
+            }
+            size_t const topic_length = (static_cast<size_t>(m_receive_buffer[0U]) << 8U) | m_receive_buffer[1U];
+            size_t const payload_offset = 2U + topic_length + (quality_of_service > 0U ? 2U : 0U);
+            if (payload_offset > m_remaining_length) {
+                return false;
+            }
+            uint8_t identifier[2U] = {};
+            if (quality_of_service > 0U) {
+                memcpy(identifier, m_receive_buffer + 2U + topic_length, sizeof(identifier));
+            }
+            // Moves the topic one byte to the front over the length, to null-terminate it without overwriting the packet identifier or the payload, same as the PubSubClient
+            memmove(m_receive_buffer + 1U, m_receive_buffer + 2U, topic_length);
+            m_receive_buffer[1U + topic_length] = '\0';
+            m_data_callback.Call_Callback(reinterpret_cast<char *>(m_receive_buffer + 1U), m_receive_buffer + payload_offset, static_cast<unsigned int>(m_remaining_length - payload_offset));
+            // Quality of service 2 is not supported just like by the PubSubClient, the ThingsBoard client only ever subscribes with quality of service 0 anyway
+            if (quality_of_service == 1U) {
+                uint8_t acknowledgement[4U] = { MQTT_PUBACK_HEADER, 2U, identifier[0U], identifier[1U] };
+                iovec buffer = { acknowledgement, sizeof(acknowledgement) };
+                return Write_Packet(&buffer, 1U);
+            }
+            break;
+        }
+        default:
+            // SUBACK, UNSUBACK and PINGRESP do not have to be handled, because subscriptions are not awaited and any received packet resets the keep alive
+            break;
+    }
+    return true;
+}
+
+void Posix_MQTT_Client::Close_Socket() {
+    if (m_socket >= 0) {
+        (void)close(m_socket);
+    }
+    m_socket = -1;
+    m_connected = false;
+    m_ping_outstanding = false;
+    m_read_state = Read_State::HEADER;
+    m_discard_packet = false;
+}
+
+size_t Posix_MQTT_Client::Encode_Length(uint8_t * buffer, size_t length) {
+    size_t index = 0U;
+    do {
+        uint8_t current = static_cast<uint8_t>(length % 128U);
+        length /= 128U;
+        if (length > 0U) {
+            current |= 0x80U;
+        }
+        buffer[index++] = current;
+    } while (length > 0U && index < 4U);
+    return index;
+}
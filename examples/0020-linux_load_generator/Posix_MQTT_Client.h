@@ -0,0 +1,145 @@
+#ifndef Posix_MQTT_Client_h
+#define Posix_MQTT_Client_h
+
+// Local includes.
+#include <IMQTT_Client.h>
+
+// Library includes.
+#include <sys/uio.h>
+
+
+/// @brief MQTT 3.1.1 client interface implementation for Linux, that communicates directly over a POSIX socket instead of relying on the Arduino networking stack.
+/// Received bytes are only ever read without blocking, in the amount that is currently available, and collected into the receive buffer until a packet is complete,
+/// which allows to wait for thousands of instances at once with epoll on the handle returned by get_readiness_handle(), until either any of them is readable or the earliest deadline passed.
+/// Only supports publishing with quality of service 0 and subscribing with quality of service 0, which is the same subset the ThingsBoard client uses with the PubSubClient on Arduino.
+/// Packets are written with sendmsg() directly from the topic and payload, meaning the topic and payload do not have to be copied into a send buffer first
+class Posix_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructor
+    Posix_MQTT_Client();
+
+    /// @brief Destructor
+    ~Posix_MQTT_Client();
+
+    /// @brief Sets the keep alive interval the connection is established with, has to be called before connecting to take effect, default = 15 seconds
+    /// @param keep_alive Keep alive interval in seconds
+    void set_keep_alive(uint16_t keep_alive);
+
+    /// @brief Sets the maximum time connect() waits for the connection to be established and for the CONNACK packet to be received, default = 5 seconds
+    /// @param timeout_milliseconds Maximum time in milliseconds
+    void set_connect_timeout(uint32_t timeout_milliseconds);
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override;
+
+    void set_connect_callback(Callback<void>::function callback) override;
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override;
+
+    uint16_t get_receive_buffer_size() override;
+
+    uint16_t get_send_buffer_size() override;
+
+    void set_server(char const * domain, uint16_t port) override;
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override;
+
+    void disconnect() override;
+
+    bool loop() override;
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
+
+    bool subscribe(char const * topic) override;
+
+    bool subscribe(char const * const * topics, size_t const & topic_amount) override;
+
+    bool unsubscribe(char const * topic) override;
+
+    bool connected() override;
+
+    bool get_session_present() override;
+
+    uint32_t get_next_deadline() override;
+
+    int get_readiness_handle() override;
+
+    /// @brief Gets the amount of bytes written to and read from the socket since the instance was created, including the MQTT packet overhead
+    /// @param sent Amount of written bytes
+    /// @param received Amount of read bytes
+    void get_traffic(uint64_t & sent, uint64_t & received) const;
+
+  private:
+    /// @brief State of reading the packet that is currently being received
+    enum class Read_State : uint8_t {
+        HEADER, ///< Waiting for the first byte of the fixed header
+        LENGTH, ///< Reading the variable length encoded remaining length
+        BODY ///< Reading the variable header and payload into the receive buffer or discarding them
+    };
+
+    /// @brief Opens the socket and establishes the TCP connection with the configured server, waits at most for the connect timeout
+    /// @return Whether the connection could be established or not
+    bool Open_Socket();
+
+    /// @brief Sends the given buffers as one packet, waits until every byte has been written and closes the connection if writing fails
+    /// @param buffers Buffers that should be written after each other
+    /// @param buffer_amount Amount of given buffers
+    /// @return Whether every byte could be written or not
+    bool Write_Packet(iovec * buffers, size_t const & buffer_amount);
+
+    /// @brief Sends a packet with the given fixed header byte and a topic filter, used for SUBSCRIBE and UNSUBSCRIBE packets
+    /// @param header First byte of the fixed header
+    /// @param topic Topic filter that should be sent
+    /// @param quality_of_service Requested quality of service byte appended after the topic filter, negative if none should be appended
+    /// @return Whether the packet could be sent or not
+    bool Write_Topic_Packet(uint8_t const & header, char const * topic, int const & quality_of_service);
+
+    /// @brief Reads all currently available bytes without blocking and handles every completely received packet
+    /// @return Whether reading was successful or not, fails if the connection has been closed or an invalid packet was received
+    bool Read_Available();
+
+    /// @brief Handles the given received bytes, depending on the state of the packet that is currently being received
+    /// @param data Received bytes
+    /// @param length Amount of received bytes
+    /// @return Whether the bytes could be handled or not, fails if an invalid packet was received
+    bool Handle_Bytes(uint8_t const * data, size_t const & length);
+
+    /// @brief Handles the completely received packet, contained in the receive buffer
+    /// @return Whether the packet could be handled or not
+    bool Handle_Packet();
+
+    /// @brief Closes the socket and resets the state of the packet that is currently being received
+    void Close_Socket();
+
+    /// @brief Encodes the given remaining length with the variable length encoding of MQTT into the given buffer
+    /// @param buffer Buffer the length should be written into, needs to be at least 4 bytes big
+    /// @param length Remaining length that should be encoded
+    /// @return Amount of bytes the encoded length requires
+    static size_t Encode_Length(uint8_t * buffer, size_t length);
+
+    Callback<void>                                  m_connected_callback = {};   // Callback that will be called as soon as the mqtt client has connected
+    Callback<void, char *, uint8_t *, unsigned int> m_data_callback = {};        // Callback that will be called with received messages that fit into the receive buffer
+    char const                                      *m_host = {};                // Server instance the connection is established with
+    uint16_t                                        m_port = {};                 // Port the connection is established with
+    uint16_t                                        m_keep_alive = {};           // Keep alive interval in seconds
+    uint32_t                                        m_connect_timeout = {};      // Maximum time connect() waits for the connection in milliseconds
+    int                                             m_socket = {};               // File descriptor of the socket, -1 if not connected
+    bool                                            m_connected = {};            // Whether the CONNACK packet accepted the connection and the socket was not closed since
+    bool                                            m_session_present = {};      // Session present flag of the last received CONNACK packet
+    bool                                            m_ping_outstanding = {};     // Whether a PINGREQ packet has been sent without receiving a response yet
+    uint16_t                                        m_packet_identifier = {};    // Identifier of the last sent SUBSCRIBE or UNSUBSCRIBE packet
+    uint32_t                                        m_last_outbound = {};        // Time the last packet was sent at in milliseconds
+    uint32_t                                        m_last_inbound = {};         // Time the last packet was received at in milliseconds
+    uint8_t                                         *m_receive_buffer = {};      // Buffer the variable header and payload of received packets are collected in
+    uint16_t                                        m_receive_buffer_size = {};  // Size of the receive buffer
+    uint16_t                                        m_send_buffer_size = {};     // Maximum size of sent packets, packets are never copied into a buffer
+    Read_State                                      m_read_state = {};           // State of reading the packet that is currently being received
+    uint8_t                                         m_header = {};               // First byte of the fixed header of the packet that is currently being received
+    size_t                                          m_remaining_length = {};     // Remaining length of the packet that is currently being received
+    size_t                                          m_length_multiplier = {};    // Multiplier of the next byte of the variable length encoded remaining length
+    size_t                                          m_body_offset = {};          // Amount of bytes of the variable header and payload that have already been received
+    bool                                            m_discard_packet = {};       // Whether the packet that is currently being received does not fit into the receive buffer and is discarded
+    uint64_t                                        m_bytes_sent = {};           // Amount of bytes written to the socket
+    uint64_t                                        m_bytes_received = {};       // Amount of bytes read from the socket
+};
+
+#endif // Posix_MQTT_Client_h
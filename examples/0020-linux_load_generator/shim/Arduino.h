@@ -0,0 +1,28 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// Minimal replacement of the Arduino core for Linux, provides only the time functions used by the ThingsBoard client and the arduino-timer library,
+// based on the monotonic clock, which ensures the time never jumps when the system time is adjusted while the load generator is running.
+
+// Library includes.
+#include <stdint.h>
+#include <time.h>
+
+
+/// @brief Gets the time since the monotonic clock started in microseconds, overflows just like on Arduino, which is handled by the ThingsBoard client
+/// @return Current time in microseconds
+inline unsigned long micros() {
+    timespec now = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(static_cast<uint64_t>(now.tv_sec) * 1000000U + static_cast<uint64_t>(now.tv_nsec) / 1000U);
+}
+
+/// @brief Gets the time since the monotonic clock started in milliseconds, the ThingsBoard client only ever compares the difference between two timestamps
+/// @return Current time in milliseconds
+inline unsigned long millis() {
+    timespec now = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(static_cast<uint64_t>(now.tv_sec) * 1000U + static_cast<uint64_t>(now.tv_nsec) / 1000000U);
+}
+
+#endif // Arduino_h
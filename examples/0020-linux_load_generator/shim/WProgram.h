@@ -0,0 +1,8 @@
+#ifndef WProgram_h
+#define WProgram_h
+
+// The arduino-timer library includes the header of the pre 1.0 Arduino cores, if ARDUINO is not defined, which is not the case on Linux.
+// Defining ARDUINO instead is not possible, because it enables the Arduino specific implementations of the ThingsBoard client.
+#include "Arduino.h"
+
+#endif // WProgram_h
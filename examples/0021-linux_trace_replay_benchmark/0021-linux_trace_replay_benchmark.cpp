@@ -0,0 +1,436 @@
+#include <OTA_Firmware_Update.h>
+#include <Replay_MQTT_Client.h>
+#include <Server_Side_RPC.h>
+#include <Shared_Attribute_Update.h>
+#include <ThingsBoard.h>
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+
+
+// Maximum amount of different server-side RPC methods found in the trace that are subscribed, every further method is answered with an unknown method error like on a device
+constexpr size_t MAX_RPC_METHODS = 16U;
+// Firmware the replayed device reports as installed, any firmware update contained in the trace is downloaded and discarded
+constexpr char CURRENT_FIRMWARE_TITLE[] = "trace_replay";
+constexpr char CURRENT_FIRMWARE_VERSION[] = "0.0.0";
+// Token the replayed device connects with, is not checked because no connection is established
+constexpr char TOKEN[] = "replay";
+// Generated firmware update replayed with --fragmented-ota, the size is not a multiple of the chunk size, so that the last chunk is shorter than the others
+constexpr char GENERATED_FIRMWARE_VERSION[] = "1.0.0";
+constexpr size_t GENERATED_FIRMWARE_SIZE = 3U * CHUNK_SIZE + 1000U;
+// Request id the firmware chunks of the generated firmware update are responded with, the OTA update is the only API of a newly created client that uses a request id
+constexpr size_t GENERATED_FIRMWARE_REQUEST_ID = 1U;
+constexpr char GENERATED_TRACE_NAME[] = "fragmented-ota";
+
+
+/// @brief Command line configuration of the benchmark
+struct Configuration {
+    char const *trace = nullptr;             // Path of the trace recorded with the Recording_MQTT_Client
+    uint32_t   iterations = 10U;             // Amount of times the complete trace is replayed
+    bool       real_time = false;            // Whether messages are delivered at the time they were recorded at instead of as fast as possible
+    uint16_t   receive_size = 1024U;         // Receive buffer size of the replayed client, bigger messages are streamed or discarded
+    uint16_t   send_size = 1024U;            // Send buffer size of the replayed client, bigger responses are not sent
+    char const *csv = nullptr;               // Path of the CSV file the results of every iteration are appended to
+    char const *label = "current";           // Label written into every CSV row, to differentiate the results of different versions
+    bool       verbose = false;              // Whether log messages of the ThingsBoard client are printed
+    bool       fragmented_ota = false;       // Whether a generated firmware update, with chunks that arrive in fragments smaller than the receive buffer, is replayed instead of a recorded trace
+};
+
+
+/// @brief Measurements of replaying the trace once
+struct Iteration_Result {
+    uint64_t               cpu_ns = {};         // Process CPU time required to replay the trace in nanoseconds
+    uint64_t               wall_ns = {};        // Wall clock time required to replay the trace in nanoseconds
+    uint64_t               allocations = {};    // Amount of heap allocations while replaying the trace
+    uint64_t               allocated_bytes = {}; // Summed up size of all heap allocations while replaying the trace
+    MQTT_Replay_Statistics statistics = {};     // Messages handled by the replay client
+};
+
+Configuration configuration;
+uint64_t allocations = 0U;
+uint64_t allocated_bytes = 0U;
+uint64_t log_messages = 0U;
+uint64_t rpc_calls = 0U;
+uint64_t attribute_updates = 0U;
+uint64_t firmware_bytes = 0U;
+uint64_t firmware_updates = 0U;
+std::vector<uint8_t> expected_firmware;
+
+
+// Replaces the global allocation functions, to count every allocation of the ThingsBoard client, ArduinoJson and the standard library
+void * operator new(size_t size) {
+    allocations++;
+    allocated_bytes += size;
+    void * pointer = malloc(size > 0U ? size : 1U);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void * operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void * pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void * pointer, size_t size) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void * pointer, size_t size) noexcept {
+    free(pointer);
+}
+
+
+/// @brief Logger that only counts the messages of the ThingsBoard client, because printing them would distort the measurement
+class Counting_Logger {
+  public:
+    template<typename ...Args>
+    static int printfln(char const * format, Args const &... args) {
+        log_messages++;
+        if (!configuration.verbose) {
+            return 0;
+        }
+        return DefaultLogger::printfln(format, args...);
+    }
+};
+
+
+/// @brief Updater that discards the downloaded firmware, only the download itself and the verification of its checksum are measured.
+/// If the expected firmware is known, because it was generated, every written byte is additionally compared with it
+class Discarding_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_written = 0U;
+        m_mismatch = false;
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        firmware_bytes += total_bytes;
+        if (!expected_firmware.empty() && (m_written + total_bytes > expected_firmware.size() || memcmp(expected_firmware.data() + m_written, payload, total_bytes) != 0)) {
+            m_mismatch = true;
+        }
+        m_written += total_bytes;
+        return total_bytes;
+    }
+
+    /// @brief Whether exactly the expected firmware has been written since the update began
+    /// @return Whether every written byte matched the expected firmware and no byte is missing
+    bool Wrote_Expected_Firmware() const {
+        return !m_mismatch && m_written == expected_firmware.size();
+    }
+
+    void reset() override {
+        // Nothing to do
+    }
+
+    bool end() override {
+        return true;
+    }
+
+  private:
+    size_t m_written = {};  // Amount of bytes written since the update began
+    bool   m_mismatch = {}; // Whether any written byte did not match the expected firmware
+};
+
+Discarding_Updater updater;
+
+
+/// @brief Gets the current time of the given clock
+/// @param clock Clock that should be read
+/// @return Current time in nanoseconds
+uint64_t Now(clockid_t const & clock) {
+    timespec time = {};
+    (void)clock_gettime(clock, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000U + static_cast<uint64_t>(time.tv_nsec);
+}
+
+/// @brief Reads the complete trace file into memory
+/// @param path Path of the trace file
+/// @param trace Buffer the trace is read into
+/// @return Whether the file could be read or not
+bool Load_Trace(char const * path, std::vector<uint8_t> & trace) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    trace.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/// @brief Appends a single received message or slice to the given trace, with the same encoding the Recording_MQTT_Client uses, every record is stamped as received directly after the previous one
+/// @param trace Trace the record is appended to, the header is written first if the trace is still empty
+/// @param type Either MQTT_Trace_Record_Type::RECEIVE or MQTT_Trace_Record_Type::RECEIVE_SLICE
+/// @param topic Topic the message was received over
+/// @param payload Payload of the message or slice
+/// @param length Length of the payload
+/// @param offset Offset of the slice from the start of the complete payload, only written for slices
+/// @param total_length Total length of the complete payload, only written for slices
+void Append_Record(std::vector<uint8_t> & trace, MQTT_Trace_Record_Type const & type, std::string const & topic, uint8_t const * payload, size_t const & length, size_t const & offset = 0U, size_t const & total_length = 0U) {
+    if (trace.empty()) {
+        trace.insert(trace.end(), std::begin(MQTT_TRACE_MAGIC), std::end(MQTT_TRACE_MAGIC));
+        trace.push_back(MQTT_TRACE_VERSION);
+    }
+    uint8_t varint[MQTT_TRACE_MAX_VARINT_SIZE] = {};
+    trace.push_back(static_cast<uint8_t>(type));
+    trace.insert(trace.end(), varint, varint + MQTT_Trace::Encode_Varint(varint, 1U));
+    trace.insert(trace.end(), varint, varint + MQTT_Trace::Encode_Varint(varint, topic.size()));
+    trace.insert(trace.end(), topic.cbegin(), topic.cend());
+    trace.insert(trace.end(), varint, varint + MQTT_Trace::Encode_Varint(varint, length));
+    trace.insert(trace.end(), payload, payload + length);
+    if (type == MQTT_Trace_Record_Type::RECEIVE_SLICE) {
+        trace.insert(trace.end(), varint, varint + MQTT_Trace::Encode_Varint(varint, offset));
+        trace.insert(trace.end(), varint, varint + MQTT_Trace::Encode_Varint(varint, total_length));
+    }
+}
+
+/// @brief Generates a trace of a complete firmware update, where every chunk is received in fragments of half the receive buffer, like the Espressif_MQTT_Client passes on messages
+/// that esp-mqtt delivers in multiple MQTT_EVENT_DATA events, because they do not fit into its receive buffer. The firmware information contains the SHA256 checksum and the CRC-32 checksum of every chunk,
+/// which ensures the replayed update only succeeds if every fragment was written in the correct order
+/// @param trace Generated trace
+void Generate_Fragmented_OTA_Trace(std::vector<uint8_t> & trace) {
+    expected_firmware.resize(GENERATED_FIRMWARE_SIZE);
+    for (size_t i = 0U; i < expected_firmware.size(); ++i) {
+        expected_firmware[i] = static_cast<uint8_t>(rand());
+    }
+
+    HashGenerator hash;
+    char checksum[(MBEDTLS_MD_MAX_SIZE * 2U) + 1U] = {};
+    (void)hash.start(MBEDTLS_MD_SHA256);
+    (void)hash.update(expected_firmware.data(), expected_firmware.size());
+    (void)hash.finish(checksum);
+    std::string chunk_checksums;
+    for (size_t offset = 0U; offset < expected_firmware.size(); offset += CHUNK_SIZE) {
+        uint32_t const crc = Helper::calculateCrc32(expected_firmware.data() + offset, std::min<size_t>(CHUNK_SIZE, expected_firmware.size() - offset));
+        uint8_t const bytes[] = { static_cast<uint8_t>(crc >> 24U), static_cast<uint8_t>(crc >> 16U), static_cast<uint8_t>(crc >> 8U), static_cast<uint8_t>(crc) };
+        char hex[(sizeof(bytes) * 2U) + 1U] = {};
+        HashGenerator::encode_hex(bytes, sizeof(bytes), hex);
+        chunk_checksums += hex;
+    }
+
+    char information[512U] = {};
+    int const information_length = snprintf(information, sizeof(information), "{\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":%zu,\"%s\":\"%s\",\"%s\":\"SHA256\",\"%s\":\"%s\",\"%s\":%u}",
+      FW_TITLE_KEY, CURRENT_FIRMWARE_TITLE, FW_VER_KEY, GENERATED_FIRMWARE_VERSION, FW_SIZE_KEY, expected_firmware.size(), FW_CHKS_KEY, checksum, FW_CHKS_ALGO_KEY,
+      FW_CHUNK_CHKS_KEY, chunk_checksums.c_str(), FW_CHUNK_CHKS_SIZE_KEY, CHUNK_SIZE);
+    Append_Record(trace, MQTT_Trace_Record_Type::RECEIVE, ATTRIBUTE_TOPIC, reinterpret_cast<uint8_t const *>(information), static_cast<size_t>(information_length));
+
+    size_t const fragment_size = std::max<size_t>(configuration.receive_size / 2U, 1U);
+    for (size_t chunk = 0U; chunk * CHUNK_SIZE < expected_firmware.size(); ++chunk) {
+        char topic[Helper::detectSize(FIRMWARE_RESPONSE_TOPIC, GENERATED_FIRMWARE_REQUEST_ID) + Helper::detectSize(NUMBER_PRINTF, chunk)] = {};
+        int const topic_length = snprintf(topic, sizeof(topic), FIRMWARE_RESPONSE_TOPIC, GENERATED_FIRMWARE_REQUEST_ID);
+        (void)snprintf(topic + topic_length, sizeof(topic) - topic_length, NUMBER_PRINTF, chunk);
+        uint8_t const * data = expected_firmware.data() + chunk * CHUNK_SIZE;
+        size_t const chunk_length = std::min<size_t>(CHUNK_SIZE, expected_firmware.size() - chunk * CHUNK_SIZE);
+        for (size_t offset = 0U; offset < chunk_length; offset += fragment_size) {
+            Append_Record(trace, MQTT_Trace_Record_Type::RECEIVE_SLICE, topic, data + offset, std::min(fragment_size, chunk_length - offset), offset, chunk_length);
+        }
+    }
+}
+
+/// @brief Collects the methods of all server-side RPC requests contained in the trace, so each of them can be subscribed with a callback that answers it
+/// @param trace Recorded trace
+/// @param methods Found methods, without duplicates and at most MAX_RPC_METHODS
+void Find_RPC_Methods(std::vector<uint8_t> const & trace, std::vector<std::string> & methods) {
+    size_t const prefix_length = strlen(RPC_REQUEST_TOPIC);
+    MQTT_Trace_Reader reader(trace.data(), trace.size());
+    MQTT_Trace_Record record = {};
+    while (reader.Next(record)) {
+        if (record.type != MQTT_Trace_Record_Type::RECEIVE || record.topic_length <= prefix_length || strncmp(record.topic, RPC_REQUEST_TOPIC, prefix_length) != 0) {
+            continue;
+        }
+        StaticJsonDocument<64U> filter;
+        filter[RPC_METHOD_KEY] = true;
+        DynamicJsonDocument document(JSON_OBJECT_SIZE(1U) + 64U);
+        if (deserializeJson(document, record.payload, record.payload_length, DeserializationOption::Filter(filter)) != DeserializationError::Ok) {
+            continue;
+        }
+        char const * method = document[RPC_METHOD_KEY];
+        if (method != nullptr && methods.size() < MAX_RPC_METHODS && std::find(methods.cbegin(), methods.cend(), method) == methods.cend()) {
+            methods.emplace_back(method);
+        }
+    }
+}
+
+/// @brief Replays the complete trace once with a newly created ThingsBoard client, only the replay itself is measured, not the creation of the client and its subscriptions
+/// @param trace Recorded trace
+/// @param methods Server-side RPC methods that are subscribed
+/// @return Measurements of the replay
+Iteration_Result Run_Iteration(std::vector<uint8_t> const & trace, std::vector<std::string> const & methods) {
+    Replay_MQTT_Client client(trace.data(), trace.size(), configuration.real_time);
+    Server_Side_RPC<1U, MAX_RPC_METHODS, Counting_Logger> rpc;
+    Shared_Attribute_Update<1U, 1U, Counting_Logger> shared_update;
+    OTA_Firmware_Update<Counting_Logger> ota;
+    std::array<IAPI_Implementation *, 3U> apis = { &rpc, &shared_update, &ota };
+    ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, Counting_Logger> tb(client, configuration.receive_size, configuration.send_size, Default_Max_Stack_Size, apis);
+    (void)tb.connect("replay", TOKEN);
+
+    // Answers every request like a device would, with a small response written directly into the send buffer
+    std::vector<RPC_Callback> callbacks;
+    for (auto const & method : methods) {
+        callbacks.emplace_back(method.c_str(), RPC_Callback::writer_function([](JsonVariantConst const & params, RPC_Response_Writer & writer) {
+            rpc_calls++;
+            (void)writer.Add("success", true);
+        }));
+    }
+    (void)rpc.RPC_Subscribe(callbacks.cbegin(), callbacks.cend());
+    const Shared_Attribute_Callback<1U> attribute_callback([](JsonObjectConst const & data) {
+        attribute_updates++;
+    });
+    (void)shared_update.Shared_Attributes_Subscribe(attribute_callback);
+    const OTA_Update_Callback ota_callback(CURRENT_FIRMWARE_TITLE, CURRENT_FIRMWARE_VERSION, &updater, [](bool const & success) {
+        // The downloaded firmware is discarded, only whether the update succeeded, meaning the checksum matched, is counted
+        if (success) {
+            firmware_updates++;
+        }
+    });
+    (void)ota.Subscribe_Firmware_Update(ota_callback);
+
+    Iteration_Result result = {};
+    uint64_t const allocations_before = allocations;
+    uint64_t const allocated_bytes_before = allocated_bytes;
+    uint64_t const cpu_start = Now(CLOCK_PROCESS_CPUTIME_ID);
+    uint64_t const wall_start = Now(CLOCK_MONOTONIC);
+    while (!client.is_finished()) {
+        uint32_t const deadline = tb.getNextDeadline();
+        if (configuration.real_time && deadline > 0U && deadline != UINT32_MAX) {
+            (void)usleep(deadline * 1000U);
+        }
+        (void)tb.loop();
+    }
+    result.cpu_ns = Now(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+    result.wall_ns = Now(CLOCK_MONOTONIC) - wall_start;
+    result.allocations = allocations - allocations_before;
+    result.allocated_bytes = allocated_bytes - allocated_bytes_before;
+    result.statistics = client.get_statistics();
+    tb.disconnect();
+    return result;
+}
+
+/// @brief Parses the command line arguments into the global configuration
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @return Whether the arguments were valid or not
+bool Parse_Arguments(int argc, char ** argv) {
+    static option const options[] = {
+        { "iterations", required_argument, nullptr, 'n' },
+        { "real-time", no_argument, nullptr, 'r' },
+        { "receive-size", required_argument, nullptr, 'R' },
+        { "send-size", required_argument, nullptr, 'S' },
+        { "csv", required_argument, nullptr, 'c' },
+        { "label", required_argument, nullptr, 'l' },
+        { "verbose", no_argument, nullptr, 'v' },
+        { "fragmented-ota", no_argument, nullptr, 'f' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    int option = 0;
+    while ((option = getopt_long(argc, argv, "n:rR:S:c:l:vf", options, nullptr)) != -1) {
+        switch (option) {
+            case 'n': configuration.iterations = strtoul(optarg, nullptr, 10); break;
+            case 'r': configuration.real_time = true; break;
+            case 'R': configuration.receive_size = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 'S': configuration.send_size = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 'c': configuration.csv = optarg; break;
+            case 'l': configuration.label = optarg; break;
+            case 'v': configuration.verbose = true; break;
+            case 'f': configuration.fragmented_ota = true; break;
+            default: return false;
+        }
+    }
+    if (configuration.fragmented_ota) {
+        // The generated firmware update only tests fragmented chunks if a single chunk does not fit into the receive buffer
+        configuration.trace = GENERATED_TRACE_NAME;
+        return optind == argc && configuration.iterations > 0U && configuration.receive_size > 0U && configuration.receive_size < CHUNK_SIZE;
+    }
+    else if (optind + 1 != argc) {
+        return false;
+    }
+    configuration.trace = argv[optind];
+    return configuration.iterations > 0U && configuration.receive_size > 0U;
+}
+
+int main(int argc, char ** argv) {
+    if (!Parse_Arguments(argc, argv)) {
+        printf("Usage: %s [--iterations 10] [--real-time] [--receive-size 1024] [--send-size 1024] [--csv results.csv] [--label current] [--verbose] <trace>\n", argv[0]);
+        printf("       %s [--iterations 10] [--receive-size 1024] [--verbose] --fragmented-ota\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> trace;
+    if (configuration.fragmented_ota) {
+        Generate_Fragmented_OTA_Trace(trace);
+    }
+    else if (!Load_Trace(configuration.trace, trace) || !MQTT_Trace_Reader(trace.data(), trace.size()).Is_Valid()) {
+        printf("Could not read a valid trace from (%s)\n", configuration.trace);
+        return EXIT_FAILURE;
+    }
+    std::vector<std::string> methods;
+    Find_RPC_Methods(trace, methods);
+    printf("Replaying (%s) with %zu bytes and %zu subscribed RPC methods, %u iterations%s\n", configuration.trace, trace.size(), methods.size(), configuration.iterations, configuration.real_time ? " in real time" : "");
+
+    FILE * csv = nullptr;
+    if (configuration.csv != nullptr) {
+        bool const exists = access(configuration.csv, F_OK) == 0;
+        csv = fopen(configuration.csv, "a");
+        if (csv == nullptr) {
+            perror("fopen");
+            return EXIT_FAILURE;
+        }
+        else if (!exists) {
+            fprintf(csv, "label,trace,iteration,messages,cpu_ns,wall_ns,allocations,allocated_bytes,published,published_bytes\n");
+        }
+    }
+
+    std::vector<uint64_t> cpu_times;
+    Iteration_Result result = {};
+    for (uint32_t i = 0U; i < configuration.iterations; ++i) {
+        uint64_t const firmware_updates_before = firmware_updates;
+        result = Run_Iteration(trace, methods);
+        if (configuration.fragmented_ota && (firmware_updates != firmware_updates_before + 1U || !updater.Wrote_Expected_Firmware())) {
+            printf("Iteration %u did not write the generated firmware of %zu bytes, the fragmented firmware update failed\n", i, expected_firmware.size());
+            return EXIT_FAILURE;
+        }
+        uint64_t const messages = result.statistics.delivered + result.statistics.streamed;
+        cpu_times.push_back(result.cpu_ns);
+        printf("  iteration %-4u messages %-8llu cpu %10.3f ms  wall %10.3f ms  allocations %-8llu (%llu bytes)  published %-8u discarded %u\n", i, static_cast<unsigned long long>(messages),
+          static_cast<double>(result.cpu_ns) / 1e6, static_cast<double>(result.wall_ns) / 1e6, static_cast<unsigned long long>(result.allocations), static_cast<unsigned long long>(result.allocated_bytes),
+          result.statistics.published, result.statistics.discarded);
+        if (csv != nullptr) {
+            fprintf(csv, "%s,%s,%u,%llu,%llu,%llu,%llu,%llu,%u,%llu\n", configuration.label, configuration.trace, i, static_cast<unsigned long long>(messages), static_cast<unsigned long long>(result.cpu_ns),
+              static_cast<unsigned long long>(result.wall_ns), static_cast<unsigned long long>(result.allocations), static_cast<unsigned long long>(result.allocated_bytes), result.statistics.published,
+              static_cast<unsigned long long>(result.statistics.published_bytes));
+        }
+    }
+    if (csv != nullptr) {
+        (void)fclose(csv);
+    }
+
+    // The median is reported, because single iterations might be slowed down by the scheduler of the host
+    std::sort(cpu_times.begin(), cpu_times.end());
+    uint64_t const median = cpu_times[cpu_times.size() / 2U];
+    uint64_t const messages = std::max<uint64_t>(result.statistics.delivered + result.statistics.streamed, 1U);
+    printf("Median cpu %.3f ms (min %.3f ms), %.0f ns and %.2f allocations per message, %llu rpc calls, %llu attribute updates, %llu firmware bytes, %llu logged messages\n",
+      static_cast<double>(median) / 1e6, static_cast<double>(cpu_times.front()) / 1e6, static_cast<double>(median) / static_cast<double>(messages),
+      static_cast<double>(result.allocations) / static_cast<double>(messages), static_cast<unsigned long long>(rpc_calls), static_cast<unsigned long long>(attribute_updates),
+      static_cast<unsigned long long>(firmware_bytes), static_cast<unsigned long long>(log_messages));
+    return EXIT_SUCCESS;
+}
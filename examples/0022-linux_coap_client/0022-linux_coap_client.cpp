@@ -0,0 +1,229 @@
+#include <Attribute_Request.h>
+#include <CoAP_OTA_Firmware_Update.h>
+#include <Server_Side_RPC.h>
+#include <Shared_Attribute_Update.h>
+#include <Socket_CoAP_Client.h>
+#include <ThingsBoardCoap.h>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include <array>
+
+
+// Keys of the shared attributes requested after every wake up and observed while the device is awake
+constexpr std::array<char const *, 2U> SHARED_ATTRIBUTES = { "targetTemperature", "reportInterval" };
+// Method of the server-side RPC the device answers, sent periodically by the CoAP_Stand_In
+constexpr char RPC_METHOD[] = "setValue";
+constexpr char RPC_VALUE_KEY[] = "value";
+// Firmware the device reports as installed, any other firmware assigned on the server is downloaded into the firmware file
+constexpr char CURRENT_FIRMWARE_TITLE[] = "coap_client";
+constexpr char CURRENT_FIRMWARE_VERSION[] = "0.0.0";
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 512U;
+constexpr uint64_t REQUEST_TIMEOUT_MICROSECONDS = 5000U * 1000U;
+
+constexpr uint16_t MAX_MESSAGE_SEND_SIZE = 256U;
+constexpr uint16_t MAX_MESSAGE_RECEIVE_SIZE = 256U;
+
+
+/// @brief Command line configuration of the CoAP client
+struct Configuration {
+    char const *host = "localhost";                    // ThingsBoard instance or CoAP_Stand_In the device connects to
+    uint16_t   port = DEFAULT_COAP_PORT;               // CoAP port of the server
+    char const *token = "device0";                     // Access token of the device
+    uint32_t   wake_interval = 5000U;                  // Interval the device wakes up with to send telemetry and request the shared attributes in milliseconds
+    uint32_t   awake_time = 1000U;                     // Time the device stays awake after sending to receive notifications of the observed resources in milliseconds
+    uint32_t   cycles = 10U;                           // Amount of wake ups before the client exits, 0 runs forever
+    uint32_t   ack_timeout = COAP_DEFAULT_ACK_TIMEOUT; // Initial retransmission timeout of confirmable requests in milliseconds
+    bool       ota = false;                            // Whether assigned firmware is downloaded before the first wake up
+    char const *firmware_file = "firmware.bin";        // File downloaded firmware is written into
+};
+
+Configuration configuration;
+
+
+/// @brief Updater that writes the downloaded firmware into a file, which allows to compare it to the binary assigned on the server
+class File_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_file = fopen(configuration.firmware_file, "wb");
+        return m_file != nullptr;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        return (m_file == nullptr) ? 0U : fwrite(payload, 1U, total_bytes, m_file);
+    }
+
+    void reset() override {
+        if (m_file != nullptr) {
+            (void)fclose(m_file);
+            m_file = nullptr;
+        }
+        (void)remove(configuration.firmware_file);
+    }
+
+    bool end() override {
+        bool const result = m_file != nullptr && fclose(m_file) == 0;
+        m_file = nullptr;
+        return result;
+    }
+
+  private:
+    FILE *m_file = nullptr; // File the firmware is currently written into, nullptr if no update is running
+};
+
+
+Socket_CoAP_Client coap_client;
+Attribute_Request<1U, SHARED_ATTRIBUTES.size()> attribute_request;
+Shared_Attribute_Update<1U, SHARED_ATTRIBUTES.size()> shared_update;
+Server_Side_RPC<1U, 1U> rpc;
+const std::array<IAPI_Implementation *, 3U> apis = { &attribute_request, &shared_update, &rpc };
+ThingsBoardCoap tb(coap_client, MAX_MESSAGE_RECEIVE_SIZE, MAX_MESSAGE_SEND_SIZE, Default_Max_Stack_Size, apis);
+File_Updater updater;
+float temperature = 20.0F;
+
+
+/// @brief Prints the received shared attributes, called for both the requested and the observed attributes
+/// @param data Received shared attributes
+void processSharedAttributes(JsonObjectConst const & data) {
+    for (auto const it : data) {
+        char value[32U] = {};
+        (void)serializeJson(it.value(), value, sizeof(value));
+        printf("Shared attribute (%s) is (%s)\n", it.key().c_str(), value);
+    }
+}
+
+/// @brief Prints that the requested shared attributes were not received in time
+void requestTimedOut() {
+    printf("Shared attribute request timed out\n");
+}
+
+/// @brief Answers the server-side RPC, the response is sent to the rpc resource with the id of the request
+/// @param data Parameters of the RPC
+/// @param response Document the response is written into
+void processSetValue(JsonVariantConst const & data, JsonDocument & response) {
+    int const value = data.as<int>();
+    printf("Received RPC (%s) with value (%d)\n", RPC_METHOD, value);
+    response[RPC_VALUE_KEY] = value;
+}
+
+/// @brief Prints the result of the firmware update
+/// @param success Whether the firmware was downloaded and verified successfully
+void finishedCallback(bool const & success) {
+    printf(success ? "Firmware written into (%s)\n" : "Downloading firmware into (%s) failed\n", configuration.firmware_file);
+}
+
+/// @brief Prints the progress of the firmware update
+/// @param current Amount of already downloaded chunks
+/// @param total Total amount of chunks
+void progressCallback(size_t const & current, size_t const & total) {
+    printf("Downloading firmware progress %.2f%%\n", static_cast<float>(current * 100U) / total);
+}
+
+/// @brief Waits until a notification has been received or the given time has passed, without calling loop() continously,
+/// like a sleepy device that only wakes up its CPU once the radio received something
+/// @param timeout Maximum time that should be waited for in milliseconds
+void Wait_For_Notification(uint32_t const & timeout) {
+    int const handle = tb.getReadinessHandle();
+    if (handle < 0) {
+        return;
+    }
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(handle, &readable);
+    timeval wait = { static_cast<time_t>(timeout / 1000U), static_cast<suseconds_t>((timeout % 1000U) * 1000U) };
+    (void)select(handle + 1, &readable, nullptr, nullptr, &wait);
+}
+
+/// @brief Parses the command line arguments into the global configuration
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @return Whether the arguments were valid or not
+bool Parse_Arguments(int argc, char ** argv) {
+    static option const options[] = {
+        { "host", required_argument, nullptr, 'H' },
+        { "port", required_argument, nullptr, 'p' },
+        { "token", required_argument, nullptr, 't' },
+        { "wake-interval", required_argument, nullptr, 'w' },
+        { "awake-time", required_argument, nullptr, 'a' },
+        { "cycles", required_argument, nullptr, 'c' },
+        { "ack-timeout", required_argument, nullptr, 'k' },
+        { "ota", no_argument, nullptr, 'O' },
+        { "firmware-file", required_argument, nullptr, 'f' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    int option = 0;
+    while ((option = getopt_long(argc, argv, "H:p:t:w:a:c:k:Of:", options, nullptr)) != -1) {
+        switch (option) {
+            case 'H': configuration.host = optarg; break;
+            case 'p': configuration.port = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 't': configuration.token = optarg; break;
+            case 'w': configuration.wake_interval = strtoul(optarg, nullptr, 10); break;
+            case 'a': configuration.awake_time = strtoul(optarg, nullptr, 10); break;
+            case 'c': configuration.cycles = strtoul(optarg, nullptr, 10); break;
+            case 'k': configuration.ack_timeout = strtoul(optarg, nullptr, 10); break;
+            case 'O': configuration.ota = true; break;
+            case 'f': configuration.ota = true; configuration.firmware_file = optarg; break;
+            default: return false;
+        }
+    }
+    return configuration.awake_time <= configuration.wake_interval && configuration.ack_timeout > 0U;
+}
+
+int main(int argc, char ** argv) {
+    if (!Parse_Arguments(argc, argv)) {
+        printf("Usage: %s [--host localhost] [--port 5683] [--token device0] [--wake-interval 5000] [--awake-time 1000]\n"
+               "          [--cycles 10] [--ack-timeout 2000] [--ota] [--firmware-file firmware.bin]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    coap_client.set_transmission_parameters(configuration.ack_timeout, COAP_DEFAULT_MAX_RETRANSMIT);
+    if (!tb.connect(configuration.host, configuration.token, configuration.port)) {
+        printf("Failed to open the socket to (%s:%u)\n", configuration.host, configuration.port);
+        return EXIT_FAILURE;
+    }
+
+    if (configuration.ota) {
+        CoAP_OTA_Firmware_Update<> ota(coap_client, configuration.token);
+        const OTA_Update_Callback callback(CURRENT_FIRMWARE_TITLE, CURRENT_FIRMWARE_VERSION, &updater, &finishedCallback, &progressCallback, nullptr, CHUNK_RETRIES, FIRMWARE_CHUNK_SIZE, REQUEST_TIMEOUT_MICROSECONDS);
+        if (!ota.Start_Firmware_Update(callback)) {
+            printf("No new firmware assigned to the device\n");
+        }
+    }
+
+    // The observations are registered once, the server keeps them alive for as long as the notifications are acknowledged
+    const RPC_Callback rpc_callback(RPC_METHOD, &processSetValue);
+    const Shared_Attribute_Callback<SHARED_ATTRIBUTES.size()> update_callback(&processSharedAttributes, SHARED_ATTRIBUTES.cbegin(), SHARED_ATTRIBUTES.cend());
+    if (!rpc.RPC_Subscribe(rpc_callback) || !shared_update.Shared_Attributes_Subscribe(update_callback)) {
+        printf("Failed to observe the rpc and attributes resources\n");
+    }
+
+    for (uint32_t cycle = 0U; configuration.cycles == 0U || cycle < configuration.cycles; ++cycle) {
+        uint32_t const wake_up = millis();
+        temperature += 0.5F;
+        if (!tb.sendTelemetryData("temperature", temperature)) {
+            printf("Failed to send telemetry\n");
+        }
+        const Attribute_Request_Callback<SHARED_ATTRIBUTES.size()> request_callback(&processSharedAttributes, REQUEST_TIMEOUT_MICROSECONDS, &requestTimedOut, SHARED_ATTRIBUTES.cbegin(), SHARED_ATTRIBUTES.cend());
+        if (!attribute_request.Shared_Attributes_Request(request_callback)) {
+            printf("Failed to request shared attributes\n");
+        }
+
+        // Stays awake for a short time to receive the pushed notifications, afterwards the device would power down its radio until the next wake up
+        while (millis() - wake_up < configuration.awake_time) {
+            Wait_For_Notification(configuration.awake_time - (millis() - wake_up));
+            (void)tb.loop();
+        }
+        uint32_t const awake = millis() - wake_up;
+        if (awake < configuration.wake_interval) {
+            (void)usleep((configuration.wake_interval - awake) * 1000U);
+        }
+    }
+
+    tb.disconnect();
+    return EXIT_SUCCESS;
+}
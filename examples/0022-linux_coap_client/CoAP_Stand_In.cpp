@@ -0,0 +1,406 @@
+#include <CoAP_Codec.h>
+#include <HashGenerator.h>
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+
+// Method and key of the server-side RPC that is pushed to the observing client
+constexpr char RPC_METHOD[] = "setValue";
+constexpr char RPC_NOTIFICATION[] = "{\"id\":%u,\"method\":\"%s\",\"params\":%u}";
+constexpr char ATTRIBUTE_NOTIFICATION[] = "{\"targetTemperature\":%u}";
+constexpr char ATTRIBUTE_RESPONSE[] = "{\"client\":{},\"shared\":{\"targetTemperature\":%u,\"reportInterval\":5000%s}}";
+constexpr char FIRMWARE_ATTRIBUTES[] = ",\"fw_title\":\"%s\",\"fw_version\":\"%s\",\"fw_size\":%zu,\"fw_checksum_algorithm\":\"SHA256\",\"fw_checksum\":\"%s\"";
+constexpr char CLIENT_RPC_RESPONSE[] = "{\"time\":%ld}";
+constexpr char API_PREFIX[] = "/api/v1/";
+constexpr char FIRMWARE_PREFIX[] = "/fw/";
+
+constexpr size_t MAX_DATAGRAM_SIZE = 1500U;
+constexpr size_t MAX_URI_SIZE = 256U;
+constexpr size_t MAX_PAYLOAD_SIZE = 512U;
+constexpr size_t SHA256_HEX_SIZE = 65U;
+constexpr uint32_t ACK_TIMEOUT_MILLISECONDS = 2000U;
+constexpr uint8_t MAX_RETRANSMIT = 4U;
+
+
+/// @brief Command line configuration of the stand-in server
+struct Configuration {
+    uint16_t   port = DEFAULT_COAP_PORT;            // Port the stand-in listens on
+    uint32_t   notify_interval = 3000U;             // Interval RPC and shared attribute notifications are pushed to the observing client with in milliseconds, 0 disables them
+    uint32_t   loss = 0U;                           // Percentage of received and sent datagrams that are dropped, to simulate a lossy radio link
+    size_t     firmware_size = 0U;                  // Size of the firmware binary assigned to every device, 0 if no firmware is assigned
+    char const *firmware_title = "coap_client";     // Title of the assigned firmware
+    char const *firmware_version = "1.0.0";         // Version of the assigned firmware
+};
+
+
+/// @brief Single observation registered by the client, the stand-in only serves one client at a time and therefore keeps its address per observation
+struct Observation {
+    bool                 active = {};                       // Whether the observation is currently registered
+    sockaddr_storage     address = {};                      // Address of the client that registered the observation
+    socklen_t            address_length = {};               // Length of the address
+    uint8_t              token[COAP_MAX_TOKEN_LENGTH] = {}; // Token the notifications are sent with
+    uint8_t              token_length = {};                 // Amount of used bytes of the token
+    uint32_t             sequence = {};                     // Observe sequence number of the last notification
+    uint16_t             message_id = {};                   // Message id of the last notification, used to match acknowledgements and resets to the observation
+    std::vector<uint8_t> pending = {};                      // Last notification while it has not been acknowledged yet, empty once it has been acknowledged
+    uint32_t             retransmit_at = {};                // Time the pending notification is retransmitted at in milliseconds
+    uint32_t             timeout = {};                      // Current retransmission timeout, doubled with every retransmission
+    uint8_t              retransmissions = {};              // Amount of times the pending notification has already been retransmitted
+};
+
+
+Configuration configuration;
+Observation rpc_observation;
+Observation attribute_observation;
+std::vector<uint8_t> firmware;
+char firmware_checksum[SHA256_HEX_SIZE] = {};
+int server = -1;
+uint16_t next_message_id = 1U;
+uint32_t rpc_id = 0U;
+// Last response is cached and resent if the client retransmits its request, because the response might have been lost
+uint16_t last_message_id = 0U;
+std::vector<uint8_t> last_response;
+
+
+/// @brief Gets the time since the monotonic clock started
+/// @return Current time in milliseconds
+uint32_t Now() {
+    timespec time = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint32_t>(time.tv_sec * 1000U + time.tv_nsec / 1000000U);
+}
+
+/// @brief Whether the next datagram should be dropped, to simulate a lossy radio link
+/// @return Whether the datagram is dropped
+bool Lost() {
+    return configuration.loss > 0U && static_cast<uint32_t>(rand() % 100) < configuration.loss;
+}
+
+/// @brief Encodes the given message and sends it to the given address, unless it is dropped
+/// @param message Message that should be sent
+/// @param address Address of the receiving client
+/// @param address_length Length of the address
+/// @return Encoded message, allows to cache responses
+std::vector<uint8_t> Send(CoAP_Message const & message, sockaddr_storage const & address, socklen_t const & address_length) {
+    std::vector<uint8_t> datagram(MAX_DATAGRAM_SIZE);
+    datagram.resize(CoAP_Codec::Encode(message, datagram.data(), datagram.size()));
+    if (datagram.empty()) {
+        printf("Failed to encode message (%u)\n", message.message_id);
+    }
+    else if (Lost()) {
+        printf("Dropped sent message (%u)\n", message.message_id);
+    }
+    else {
+        (void)sendto(server, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr const *>(&address), address_length);
+    }
+    return datagram;
+}
+
+/// @brief Registers or deregisters the observation of the given resource
+/// @param observation Observation of the resource
+/// @param request Received GET request with the Observe option
+/// @param address Address of the client
+/// @param address_length Length of the address
+/// @param response Response the Observe option is added to, if the observation was registered
+void Observe(Observation & observation, CoAP_Message const & request, sockaddr_storage const & address, socklen_t const & address_length, CoAP_Message & response) {
+    if (request.observe != COAP_OBSERVE_REGISTER) {
+        printf("Deregistered observation of (%s)\n", request.uri);
+        observation.active = false;
+        return;
+    }
+    printf("Registered observation of (%s)\n", request.uri);
+    observation.active = true;
+    observation.address = address;
+    observation.address_length = address_length;
+    memcpy(observation.token, request.token, request.token_length);
+    observation.token_length = request.token_length;
+    response.has_observe = true;
+    response.observe = ++observation.sequence;
+}
+
+/// @brief Sends a confirmable notification with the given payload, which is retransmitted with an exponential back-off until it is acknowledged.
+/// A newer notification replaces the pending one, because the client is only interested in the current state of the resource
+/// @param observation Observation the notification is sent for
+/// @param payload Payload of the notification
+void Notify(Observation & observation, char const * payload) {
+    CoAP_Message notification;
+    notification.type = CoAP_Type::CONFIRMABLE;
+    notification.code = COAP_CODE_CONTENT;
+    notification.message_id = next_message_id++;
+    memcpy(notification.token, observation.token, observation.token_length);
+    notification.token_length = observation.token_length;
+    notification.has_observe = true;
+    notification.observe = ++observation.sequence;
+    notification.has_content_format = true;
+    notification.content_format = COAP_CONTENT_FORMAT_JSON;
+    notification.payload = reinterpret_cast<uint8_t *>(const_cast<char *>(payload));
+    notification.payload_length = strlen(payload);
+    observation.message_id = notification.message_id;
+    printf("Notified (%s)\n", payload);
+    observation.pending = Send(notification, observation.address, observation.address_length);
+    observation.timeout = ACK_TIMEOUT_MILLISECONDS;
+    observation.retransmit_at = Now() + observation.timeout;
+    observation.retransmissions = 0U;
+}
+
+/// @brief Retransmits the pending notification of the given observation if it has not been acknowledged in time,
+/// removes the observation once the client did not acknowledge any of the retransmissions, see https://datatracker.ietf.org/doc/html/rfc7641#section-4.5
+/// @param observation Observation whose pending notification should be retransmitted
+void Retransmit(Observation & observation) {
+    if (!observation.active || observation.pending.empty() || static_cast<int32_t>(Now() - observation.retransmit_at) < 0) {
+        return;
+    }
+    if (observation.retransmissions >= MAX_RETRANSMIT) {
+        printf("Removed observation, because notification (%u) was never acknowledged\n", observation.message_id);
+        observation.active = false;
+        observation.pending.clear();
+        return;
+    }
+    ++observation.retransmissions;
+    observation.timeout *= 2U;
+    observation.retransmit_at = Now() + observation.timeout;
+    printf("Retransmitted notification (%u)\n", observation.message_id);
+    if (!Lost()) {
+        (void)sendto(server, observation.pending.data(), observation.pending.size(), 0, reinterpret_cast<sockaddr const *>(&observation.address), observation.address_length);
+    }
+}
+
+/// @brief Whether the requested resource of the device API is the given resource
+/// @param resource Requested resource following the access token, may be followed by the query
+/// @param length Length of the requested resource without the query
+/// @param name Name of the resource it is compared to
+/// @return Whether the resource matches
+bool Is_Resource(char const * resource, size_t const & length, char const * name) {
+    return length == strlen(name) && strncmp(resource, name, length) == 0;
+}
+
+/// @brief Handles a received request of the device API and fills in the response
+/// @param request Received request
+/// @param address Address of the client
+/// @param address_length Length of the address
+/// @param response Response that should be sent, the code is COAP_CODE_NOT_FOUND if the resource does not exist
+/// @param payload Buffer the payload of the response is written into
+void Handle_Request(CoAP_Message const & request, sockaddr_storage const & address, socklen_t const & address_length, CoAP_Message & response, char * payload) {
+    response.code = COAP_CODE_NOT_FOUND;
+    if (request.uri == nullptr) {
+        return;
+    }
+    printf("Received %s (%s) with payload (%.*s)\n", request.code == static_cast<uint8_t>(CoAP_Method::GET) ? "GET" : "POST", request.uri, static_cast<int>(request.payload_length), request.payload != nullptr ? reinterpret_cast<char const *>(request.payload) : "");
+
+    if (strncmp(request.uri, FIRMWARE_PREFIX, strlen(FIRMWARE_PREFIX)) == 0) {
+        size_t const block_size = request.has_block2 ? request.block_size : COAP_MAX_BLOCK_SIZE;
+        size_t const offset = request.block_number * block_size;
+        if (firmware.empty() || offset > firmware.size()) {
+            return;
+        }
+        size_t const length = std::min(block_size, firmware.size() - offset);
+        response.code = COAP_CODE_CONTENT;
+        response.has_block2 = true;
+        response.block_number = request.block_number;
+        response.block_size = static_cast<uint16_t>(block_size);
+        response.more_blocks = offset + length < firmware.size();
+        response.payload = firmware.data() + offset;
+        response.payload_length = length;
+        return;
+    }
+
+    if (strncmp(request.uri, API_PREFIX, strlen(API_PREFIX)) != 0) {
+        return;
+    }
+    // Skips the access token, any token is accepted
+    char const * resource = strchr(request.uri + strlen(API_PREFIX), '/');
+    if (resource == nullptr) {
+        return;
+    }
+    ++resource;
+    size_t const resource_length = strcspn(resource, "?");
+
+    if (request.code == static_cast<uint8_t>(CoAP_Method::GET) && Is_Resource(resource, resource_length, "rpc") && request.has_observe) {
+        response.code = COAP_CODE_CONTENT;
+        Observe(rpc_observation, request, address, address_length, response);
+    }
+    else if (request.code == static_cast<uint8_t>(CoAP_Method::GET) && Is_Resource(resource, resource_length, "attributes")) {
+        response.code = COAP_CODE_CONTENT;
+        if (request.has_observe) {
+            Observe(attribute_observation, request, address, address_length, response);
+            return;
+        }
+        char firmware_attributes[MAX_PAYLOAD_SIZE / 2U] = {};
+        if (!firmware.empty()) {
+            (void)snprintf(firmware_attributes, sizeof(firmware_attributes), FIRMWARE_ATTRIBUTES, configuration.firmware_title, configuration.firmware_version, firmware.size(), firmware_checksum);
+        }
+        (void)snprintf(payload, MAX_PAYLOAD_SIZE, ATTRIBUTE_RESPONSE, attribute_observation.sequence + 20U, firmware_attributes);
+    }
+    else if (request.code == static_cast<uint8_t>(CoAP_Method::POST) && Is_Resource(resource, resource_length, "rpc")) {
+        // Client-side RPC, answered with the current time
+        response.code = COAP_CODE_CONTENT;
+        (void)snprintf(payload, MAX_PAYLOAD_SIZE, CLIENT_RPC_RESPONSE, static_cast<long>(time(nullptr)));
+    }
+    else if (request.code == static_cast<uint8_t>(CoAP_Method::POST)) {
+        // Telemetry, attributes, claiming and the responses to server-side RPC (rpc/$ID)
+        response.code = COAP_CODE_CHANGED;
+    }
+    if (payload[0U] != '\0') {
+        response.has_content_format = true;
+        response.content_format = COAP_CONTENT_FORMAT_JSON;
+        response.payload = reinterpret_cast<uint8_t *>(payload);
+        response.payload_length = strlen(payload);
+    }
+}
+
+/// @brief Receives a single datagram and answers it
+void Receive() {
+    uint8_t datagram[MAX_DATAGRAM_SIZE] = {};
+    sockaddr_storage address = {};
+    socklen_t address_length = sizeof(address);
+    ssize_t const length = recvfrom(server, datagram, sizeof(datagram), 0, reinterpret_cast<sockaddr *>(&address), &address_length);
+    if (length <= 0) {
+        return;
+    }
+    if (Lost()) {
+        printf("Dropped received datagram\n");
+        return;
+    }
+
+    CoAP_Message request;
+    char uri[MAX_URI_SIZE] = {};
+    if (!CoAP_Codec::Decode(datagram, static_cast<size_t>(length), request, uri, sizeof(uri))) {
+        return;
+    }
+    if (request.type == CoAP_Type::ACKNOWLEDGEMENT || request.type == CoAP_Type::RESET) {
+        for (Observation * observation : { &rpc_observation, &attribute_observation }) {
+            if (observation->message_id != request.message_id) {
+                continue;
+            }
+            observation->pending.clear();
+            // The client does not know the observation anymore, stop sending notifications for it
+            observation->active = observation->active && request.type == CoAP_Type::ACKNOWLEDGEMENT;
+        }
+        return;
+    }
+    if (request.type == CoAP_Type::CONFIRMABLE && request.message_id == last_message_id && !last_response.empty()) {
+        printf("Resent response to retransmitted message (%u)\n", request.message_id);
+        if (!Lost()) {
+            (void)sendto(server, last_response.data(), last_response.size(), 0, reinterpret_cast<sockaddr const *>(&address), address_length);
+        }
+        return;
+    }
+
+    CoAP_Message response;
+    response.type = (request.type == CoAP_Type::CONFIRMABLE) ? CoAP_Type::ACKNOWLEDGEMENT : CoAP_Type::NON_CONFIRMABLE;
+    response.message_id = (request.type == CoAP_Type::CONFIRMABLE) ? request.message_id : next_message_id++;
+    memcpy(response.token, request.token, request.token_length);
+    response.token_length = request.token_length;
+    char payload[MAX_PAYLOAD_SIZE] = {};
+    Handle_Request(request, address, address_length, response, payload);
+    last_message_id = request.message_id;
+    last_response = Send(response, address, address_length);
+}
+
+/// @brief Generates the firmware binary and calculates its checksum
+/// @return Whether the checksum could be calculated or not
+bool Generate_Firmware() {
+    firmware.resize(configuration.firmware_size);
+    for (size_t i = 0U; i < firmware.size(); ++i) {
+        firmware[i] = static_cast<uint8_t>(i * 31U + 7U);
+    }
+    HashGenerator hash;
+    return hash.start(MBEDTLS_MD_SHA256) && hash.update(firmware.data(), firmware.size()) && hash.finish(firmware_checksum);
+}
+
+/// @brief Parses the command line arguments into the global configuration
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @return Whether the arguments were valid or not
+bool Parse_Arguments(int argc, char ** argv) {
+    static option const options[] = {
+        { "port", required_argument, nullptr, 'p' },
+        { "notify-interval", required_argument, nullptr, 'n' },
+        { "loss", required_argument, nullptr, 'l' },
+        { "firmware-size", required_argument, nullptr, 's' },
+        { "firmware-title", required_argument, nullptr, 't' },
+        { "firmware-version", required_argument, nullptr, 'v' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    int option = 0;
+    while ((option = getopt_long(argc, argv, "p:n:l:s:t:v:", options, nullptr)) != -1) {
+        switch (option) {
+            case 'p': configuration.port = static_cast<uint16_t>(strtoul(optarg, nullptr, 10)); break;
+            case 'n': configuration.notify_interval = strtoul(optarg, nullptr, 10); break;
+            case 'l': configuration.loss = strtoul(optarg, nullptr, 10); break;
+            case 's': configuration.firmware_size = strtoul(optarg, nullptr, 10); break;
+            case 't': configuration.firmware_title = optarg; break;
+            case 'v': configuration.firmware_version = optarg; break;
+            default: return false;
+        }
+    }
+    return configuration.loss < 100U;
+}
+
+int main(int argc, char ** argv) {
+    if (!Parse_Arguments(argc, argv)) {
+        printf("Usage: %s [--port 5683] [--notify-interval 3000] [--loss 0] [--firmware-size 0] [--firmware-title coap_client] [--firmware-version 1.0.0]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Prints every handled message immediately, even if the output is redirected into a file
+    (void)setvbuf(stdout, nullptr, _IOLBF, 0U);
+    if (!Generate_Firmware()) {
+        printf("Failed to calculate the firmware checksum\n");
+        return EXIT_FAILURE;
+    }
+
+    server = socket(AF_INET6, SOCK_DGRAM, 0);
+    int const dual_stack = 0;
+    (void)setsockopt(server, IPPROTO_IPV6, IPV6_V6ONLY, &dual_stack, sizeof(dual_stack));
+    sockaddr_in6 address = {};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(configuration.port);
+    if (server < 0 || bind(server, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0) {
+        perror("bind");
+        return EXIT_FAILURE;
+    }
+    printf("Listening on port (%u)\n", configuration.port);
+
+    uint32_t next_notification = Now() + configuration.notify_interval;
+    char payload[MAX_PAYLOAD_SIZE] = {};
+    while (true) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(server, &readable);
+        timeval wait = { 0, 100000 };
+        if (select(server + 1, &readable, nullptr, nullptr, &wait) > 0) {
+            Receive();
+        }
+        Retransmit(rpc_observation);
+        Retransmit(attribute_observation);
+        if (configuration.notify_interval == 0U || static_cast<int32_t>(Now() - next_notification) < 0) {
+            continue;
+        }
+        next_notification += configuration.notify_interval;
+        // Alternates between pushing a server-side RPC and a shared attribute update
+        if (rpc_id % 2U == 0U && rpc_observation.active) {
+            (void)snprintf(payload, sizeof(payload), RPC_NOTIFICATION, rpc_id, RPC_METHOD, rpc_id);
+            Notify(rpc_observation, payload);
+        }
+        else if (attribute_observation.active) {
+            (void)snprintf(payload, sizeof(payload), ATTRIBUTE_NOTIFICATION, attribute_observation.sequence + 20U);
+            Notify(attribute_observation, payload);
+        }
+        ++rpc_id;
+    }
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,10 @@
 
 #ifdef ARDUINO
 
+// HTTP range header.
+char constexpr HTTP_RANGE_HEADER[] = "Range";
+char constexpr HTTP_RANGE_FORMAT[] = "bytes=%u-";
+
 Arduino_HTTP_Client::Arduino_HTTP_Client(Client& transport_client, char const * host, uint16_t port) :
     m_http_client(transport_client, host, port)
 {
@@ -35,6 +39,31 @@ int Arduino_HTTP_Client::get(char const * url_path) {
     return m_http_client.get(url_path);
 }
 
+int Arduino_HTTP_Client::get_range(char const * url_path, size_t const & range_start) {
+    if (range_start == 0U) {
+        return get(url_path);
+    }
+    // Starting the request manually allows to send additional headers, before the request is finished with endRequest()
+    m_http_client.beginRequest();
+    int const result = m_http_client.get(url_path);
+    if (result == 0) {
+        // Big enough for the format string with the biggest possible 32-bit offset inserted
+        char range[sizeof(HTTP_RANGE_FORMAT) + 10U] = {};
+        (void)snprintf(range, sizeof(range), HTTP_RANGE_FORMAT, range_start);
+        m_http_client.sendHeader(HTTP_RANGE_HEADER, range);
+    }
+    m_http_client.endRequest();
+    return result;
+}
+
+size_t Arduino_HTTP_Client::read_response_body(uint8_t * buffer, size_t const & size) {
+    if (!m_http_client.endOfHeadersReached()) {
+        (void)m_http_client.skipResponseHeaders();
+    }
+    // Uses the timeout of the underlying stream, which reads with the internal read method of the HttpClient and therefore handles chunked responses correctly
+    return m_http_client.readBytes(buffer, size);
+}
+
 #if THINGSBOARD_ENABLE_STL
 std::string Arduino_HTTP_Client::get_response_body() {
     return m_http_client.responseBody().c_str();
@@ -36,6 +36,10 @@ class Arduino_HTTP_Client : public IHTTP_Client {
 
     int get(char const * url_path) override;
 
+    int get_range(char const * url_path, size_t const & range_start) override;
+
+    size_t read_response_body(uint8_t * buffer, size_t const & size) override;
+
 #if THINGSBOARD_ENABLE_STL
     std::string get_response_body() override;
 #else
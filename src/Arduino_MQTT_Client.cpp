@@ -3,18 +3,57 @@
 
 #ifdef ARDUINO
 
+// Type of PUBLISH packets, contained in the upper half byte of the first byte of the fixed header
+uint8_t constexpr MQTT_PACKET_TYPE_MASK = 0xF0U;
+uint8_t constexpr MQTT_PUBLISH_PACKET = 0x30U;
+// Fixed header of PUBACK packets, followed by the remaining length and the packet identifier of the acknowledged PUBLISH packet
+uint8_t constexpr MQTT_PUBACK_HEADER = 0x40U;
+uint8_t constexpr MQTT_PUBACK_REMAINING_LENGTH = 2U;
+// Size of the receive buffer the PubSubClient keeps once streaming has been enabled, is big enough to hold the CONNACK, SUBACK, UNSUBACK and PINGRESP packets
+uint16_t constexpr CONTROL_PACKET_BUFFER_SIZE = 16U;
+// Fraction of the keep alive interval loop() has to be called in at least, the PubSubClient only sends a keep alive message once a complete interval passed without any activity,
+// but only while loop() is called, and the broker considers the connection lost after one and a half intervals
+uint8_t constexpr KEEP_ALIVE_LOOP_DIVIDER = 4U;
+
 Arduino_MQTT_Client::Arduino_MQTT_Client(Client & transport_client) :
     m_connected_callback(),
-    m_mqtt_client(transport_client)
+    m_data_callback(),
+    m_stream_filter_callback(),
+    m_stream_callback(),
+    m_clean_session(true),
+    m_keep_alive(MQTT_KEEPALIVE),
+    m_last_loop(0U),
+    m_transport_client(&transport_client),
+    m_receive_buffer(nullptr),
+    m_receive_buffer_size(0U),
+    m_guarded_client(),
+    m_mqtt_client()
 {
-    // Nothing to do
+    m_guarded_client.set_client(transport_client);
+    m_mqtt_client.setClient(m_guarded_client);
+}
+
+Arduino_MQTT_Client::~Arduino_MQTT_Client() {
+    Free_Receive_Buffer();
 }
 
 void Arduino_MQTT_Client::set_client(Client & transport_client) {
-    m_mqtt_client.setClient(transport_client);
+    m_transport_client = &transport_client;
+    m_guarded_client.set_client(transport_client);
+    m_mqtt_client.setClient(m_guarded_client);
+}
+
+void Arduino_MQTT_Client::set_clean_session(bool clean_session) {
+    m_clean_session = clean_session;
+}
+
+void Arduino_MQTT_Client::set_keep_alive(uint16_t keep_alive) {
+    m_keep_alive = keep_alive;
+    m_mqtt_client.setKeepAlive(keep_alive);
 }
 
 void Arduino_MQTT_Client::set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) {
+    m_data_callback.Set_Callback(callback);
     m_mqtt_client.setCallback(callback);
 }
 
@@ -23,10 +62,30 @@ void Arduino_MQTT_Client::set_connect_callback(Callback<void>::function callback
 }
 
 bool Arduino_MQTT_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
-    return m_mqtt_client.setBufferSize(receive_buffer_size, send_buffer_size);
+    if (m_receive_buffer == nullptr) {
+        return m_mqtt_client.setBufferSize(receive_buffer_size, send_buffer_size);
+    }
+    else if (!m_mqtt_client.setBufferSize(CONTROL_PACKET_BUFFER_SIZE, send_buffer_size)) {
+        return false;
+    }
+    else if (receive_buffer_size == m_receive_buffer_size) {
+        return true;
+    }
+
+    uint8_t * receive_buffer = new uint8_t[receive_buffer_size]();
+    if (receive_buffer == nullptr) {
+        return false;
+    }
+    Free_Receive_Buffer();
+    m_receive_buffer = receive_buffer;
+    m_receive_buffer_size = receive_buffer_size;
+    return true;
 }
 
 uint16_t Arduino_MQTT_Client::get_receive_buffer_size() {
+    if (m_receive_buffer != nullptr) {
+        return m_receive_buffer_size;
+    }
     return m_mqtt_client.getReceiveBufferSize();
 }
 
@@ -39,7 +98,10 @@ void Arduino_MQTT_Client::set_server(char const * domain, uint16_t port) {
 }
 
 bool Arduino_MQTT_Client::connect(char const * client_id, char const * user_name, char const * password) {
-    bool const result = m_mqtt_client.connect(client_id, user_name, password);
+    // The PubSubClient has to read the CONNACK packet itself, the broker does not send any PUBLISH packet before it
+    m_guarded_client.set_read_allowed(true);
+    bool const result = m_mqtt_client.connect(client_id, user_name, password, nullptr, 0U, false, nullptr, m_clean_session);
+    m_guarded_client.set_read_allowed(m_receive_buffer == nullptr);
     m_connected_callback.Call_Callback();
     return result;
 }
@@ -49,7 +111,21 @@ void Arduino_MQTT_Client::disconnect() {
 }
 
 bool Arduino_MQTT_Client::loop() {
-    return m_mqtt_client.loop();
+    m_last_loop = millis();
+    if (m_receive_buffer == nullptr) {
+        return m_mqtt_client.loop();
+    }
+    // PUBLISH packets have to be read before the PubSubClient attempts to read them into its minimal receive buffer, where they would be discarded
+    else if (!Receive_Publish_Packets()) {
+        m_mqtt_client.disconnect();
+        return false;
+    }
+    // The PubSubClient is still called if no control packet has been received, because it sends the keep alive messages, but it does not see any received bytes then,
+    // which ensures a PUBLISH packet that is received while it is called is left for the next loop, instead of being read and discarded by the PubSubClient
+    m_guarded_client.set_read_allowed(Control_Packet_Available());
+    bool const result = m_mqtt_client.loop();
+    m_guarded_client.set_read_allowed(false);
+    return result;
 }
 
 bool Arduino_MQTT_Client::publish(char const * topic, uint8_t const * payload, size_t const & length) {
@@ -60,6 +136,16 @@ bool Arduino_MQTT_Client::subscribe(char const * topic) {
     return m_mqtt_client.subscribe(topic);
 }
 
+bool Arduino_MQTT_Client::subscribe(char const * const * topics, size_t const & topic_amount) {
+    // PubSubClient only supports sending one topic filter per SUBSCRIBE packet, therefore we have to subscribe the topics one after another
+    for (size_t i = 0U; i < topic_amount; ++i) {
+        if (!m_mqtt_client.subscribe(topics[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Arduino_MQTT_Client::unsubscribe(char const * topic) {
     return m_mqtt_client.unsubscribe(topic);
 }
@@ -68,6 +154,184 @@ bool Arduino_MQTT_Client::connected() {
     return m_mqtt_client.connected();
 }
 
+bool Arduino_MQTT_Client::get_session_present() {
+    // PubSubClient does not expose the session present flag of the received CONNACK packet
+    return false;
+}
+
+bool Arduino_MQTT_Client::set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) {
+    m_stream_filter_callback.Set_Callback(filter_callback);
+    m_stream_callback.Set_Callback(stream_callback);
+    if (m_receive_buffer != nullptr) {
+        return true;
+    }
+
+    // Take over the previously configured receive buffer size, the PubSubClient only has to receive control packets from now on
+    uint16_t const receive_buffer_size = m_mqtt_client.getReceiveBufferSize();
+    m_receive_buffer = new uint8_t[receive_buffer_size]();
+    if (m_receive_buffer == nullptr) {
+        return false;
+    }
+    m_receive_buffer_size = receive_buffer_size;
+    m_guarded_client.set_read_allowed(false);
+    (void)m_mqtt_client.setBufferSize(CONTROL_PACKET_BUFFER_SIZE, m_mqtt_client.getSendBufferSize());
+    return true;
+}
+
+uint32_t Arduino_MQTT_Client::get_next_deadline() {
+    // Looping a disconnected client does nothing, reconnecting is instead driven by the deadline of the Reconnect_Manager or the application itself
+    if (!m_mqtt_client.connected()) {
+        return UINT32_MAX;
+    }
+    else if (m_transport_client != nullptr && m_transport_client->available() > 0) {
+        return 0U;
+    }
+    uint32_t const interval = (static_cast<uint32_t>(m_keep_alive) * 1000U) / KEEP_ALIVE_LOOP_DIVIDER;
+    // Unsigned subtraction ensures the elapsed time is still calculated correctly once the current time overflows
+    uint32_t const elapsed = millis() - m_last_loop;
+    return elapsed >= interval ? 0U : interval - elapsed;
+}
+
+bool Arduino_MQTT_Client::Receive_Publish_Packets() {
+    if (m_transport_client == nullptr || !m_mqtt_client.connected()) {
+        return true;
+    }
+
+    while (m_transport_client->available() > 0) {
+        int const header = m_transport_client->peek();
+        // Any other packet is left to be read by the PubSubClient, which only reads one packet per loop, meaning it will never read a following PUBLISH packet
+        if (header < 0 || (static_cast<uint8_t>(header) & MQTT_PACKET_TYPE_MASK) != MQTT_PUBLISH_PACKET) {
+            break;
+        }
+        (void)m_transport_client->read();
+        if (!Receive_Publish_Packet(static_cast<uint8_t>(header))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Arduino_MQTT_Client::Control_Packet_Available() {
+    if (m_transport_client == nullptr || m_transport_client->available() <= 0) {
+        return false;
+    }
+    int const header = m_transport_client->peek();
+    return header >= 0 && (static_cast<uint8_t>(header) & MQTT_PACKET_TYPE_MASK) != MQTT_PUBLISH_PACKET;
+}
+
+bool Arduino_MQTT_Client::Receive_Publish_Packet(uint8_t const & header) {
+    // Remaining length is encoded as a variable length integer, with 7 bits per byte and at most 4 bytes
+    size_t remaining_length = 0U;
+    for (uint8_t shift = 0U; ; shift += 7U) {
+        uint8_t encoded = 0U;
+        if (shift > 21U || !Read_Bytes(&encoded, 1U)) {
+            return false;
+        }
+        remaining_length |= static_cast<size_t>(encoded & 0x7FU) << shift;
+        if ((encoded & 0x80U) == 0U) {
+            break;
+        }
+    }
+
+    uint8_t topic_length_bytes[2U] = {};
+    if (remaining_length < sizeof(topic_length_bytes) || !Read_Bytes(topic_length_bytes, sizeof(topic_length_bytes))) {
+        return false;
+    }
+    size_t const topic_length = (static_cast<size_t>(topic_length_bytes[0U]) << 8U) | topic_length_bytes[1U];
+    uint8_t const quality_of_service = (header >> 1U) & 0x03U;
+    uint8_t identifier[2U] = {};
+    size_t const identifier_length = (quality_of_service > 0U) ? sizeof(identifier) : 0U;
+    if (remaining_length < sizeof(topic_length_bytes) + topic_length + identifier_length) {
+        return false;
+    }
+    size_t const payload_length = remaining_length - sizeof(topic_length_bytes) - topic_length - identifier_length;
+
+    // Topic and its null terminator have to fit into the receive buffer, otherwise the complete packet is discarded, the payload is read directly after the null terminator
+    bool const topic_fits = topic_length < m_receive_buffer_size;
+    if (!Read_Bytes(topic_fits ? m_receive_buffer : nullptr, topic_length) || !Read_Bytes(identifier, identifier_length)) {
+        return false;
+    }
+    char * topic = reinterpret_cast<char *>(m_receive_buffer);
+    uint8_t * payload = m_receive_buffer + topic_length + 1U;
+    size_t const capacity = topic_fits ? m_receive_buffer_size - topic_length - 1U : 0U;
+    if (topic_fits) {
+        m_receive_buffer[topic_length] = '\0';
+    }
+
+    if (topic_fits && payload_length <= capacity) {
+        if (!Read_Bytes(payload, payload_length) || !Acknowledge_Publish_Packet(quality_of_service, identifier)) {
+            return false;
+        }
+        m_data_callback.Call_Callback(topic, payload, payload_length);
+        return true;
+    }
+    else if (capacity == 0U || !m_stream_filter_callback.Call_Callback(topic)) {
+        // Discard the payload, the same as the PubSubClient does with packets that do not fit into its receive buffer
+        return Read_Bytes(nullptr, payload_length) && Acknowledge_Publish_Packet(quality_of_service, identifier);
+    }
+
+    for (size_t offset = 0U; offset < payload_length;) {
+        size_t const slice_length = (payload_length - offset < capacity) ? payload_length - offset : capacity;
+        if (!Read_Bytes(payload, slice_length)) {
+            return false;
+        }
+        // Acknowledge before passing the last slice, because the stream callback might already publish further messages once it received the complete payload
+        if (offset + slice_length == payload_length && !Acknowledge_Publish_Packet(quality_of_service, identifier)) {
+            return false;
+        }
+        m_stream_callback.Call_Callback(topic, payload, slice_length, offset, payload_length);
+        offset += slice_length;
+    }
+    return true;
+}
+
+bool Arduino_MQTT_Client::Acknowledge_Publish_Packet(uint8_t const & quality_of_service, uint8_t const * identifier) {
+    if (quality_of_service != 1U) {
+        return true;
+    }
+    uint8_t const acknowledgement[4U] = { MQTT_PUBACK_HEADER, MQTT_PUBACK_REMAINING_LENGTH, identifier[0U], identifier[1U] };
+    return m_transport_client->write(acknowledgement, sizeof(acknowledgement)) == sizeof(acknowledgement);
+}
+
+bool Arduino_MQTT_Client::Read_Bytes(uint8_t * buffer, size_t const & length) {
+    // Bytes that should be discarded are read into a small temporary buffer in multiple steps instead
+    uint8_t discarded[16U] = {};
+    unsigned long last_received = millis();
+    size_t read_bytes = 0U;
+    while (read_bytes < length) {
+        int const available = m_transport_client->available();
+        if (available <= 0) {
+            if (!m_transport_client->connected() || millis() - last_received >= MQTT_SOCKET_TIMEOUT * 1000UL) {
+                return false;
+            }
+            yield();
+            continue;
+        }
+
+        size_t requested = length - read_bytes;
+        if (requested > static_cast<size_t>(available)) {
+            requested = available;
+        }
+        if (buffer == nullptr && requested > sizeof(discarded)) {
+            requested = sizeof(discarded);
+        }
+        int const received = m_transport_client->read(buffer != nullptr ? buffer + read_bytes : discarded, requested);
+        if (received > 0) {
+            read_bytes += received;
+            last_received = millis();
+        }
+    }
+    return true;
+}
+
+void Arduino_MQTT_Client::Free_Receive_Buffer() {
+    // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+    // and set the pointer to null so we do not have a dangling reference.
+    delete[] m_receive_buffer;
+    m_receive_buffer = nullptr;
+    m_receive_buffer_size = 0U;
+}
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
 bool Arduino_MQTT_Client::begin_publish(char const * topic, size_t const & length) {
@@ -5,13 +5,19 @@
 
 // Local includes.
 #include "IMQTT_Client.h"
+#include "Read_Guarded_Client.h"
 
 // Library include
 #include <PubSubClient.h>
 
 
 /// @brief MQTT Client interface implementation that uses the PubSubClient forked from ThingsBoard (https://github.com/thingsboard/pubsubclient),
-/// under the hood to establish and communicate over a MQTT connection. The fork includes fixes to solve issues with using std::function callbacks for non ESP boards
+/// under the hood to establish and communicate over a MQTT connection. The fork includes fixes to solve issues with using std::function callbacks for non ESP boards.
+/// Once set_stream_callback() has been called, received PUBLISH packets are read directly from the transport client instead of by the PubSubClient, into a receive buffer owned by this class,
+/// because the PubSubClient always reads the complete packet into its buffer and discards packets that do not fit. This allows to stream payloads bigger than the receive buffer in slices,
+/// while the PubSubClient only keeps a minimal receive buffer for the remaining control packets (CONNACK, SUBACK, PINGRESP, ...).
+/// The PubSubClient accesses the transport client through a Read_Guarded_Client, which only reports received bytes while connecting or once a control packet has been peeked,
+/// therefore it can never read a PUBLISH packet into its minimal receive buffer, not even one that was received after the last PUBLISH packet was read by this class
 class Arduino_MQTT_Client : public IMQTT_Client {
   public:
     /// @brief Constructs a IMQTT_Client implementation without a network client, meaning it has to be added later with the set_client() method
@@ -22,11 +28,25 @@ class Arduino_MQTT_Client : public IMQTT_Client {
     /// but the actual type of connection does not matter (Ethernet or WiFi)
     Arduino_MQTT_Client(Client & transport_client);
 
+    /// @brief Destructor
+    ~Arduino_MQTT_Client();
+
     /// @brief Sets the client has to be used if the empty constructor was used initally
     /// @param transport_client Client that is used to send the actual payload via. MQTT, needs to implement the client interface,
     /// but the actual type of connection does not matter (Ethernet or WiFi)
     void set_client(Client & transport_client);
 
+    /// @brief Sets whether to connect with the clean session flag set or not. The default is true, meaning the broker discards the session state and all subscriptions once we disconnect.
+    /// Setting it to false allows the broker to keep the subscriptions over reconnects, but because the PubSubClient does not expose the session present flag of the connection response,
+    /// all topics are still resubscribed after every successful connection
+    /// @param clean_session Whether to connect with the clean session flag set or not
+    void set_clean_session(bool clean_session);
+
+    /// @brief Sets the keep alive interval the connection is established with, which decides how often get_next_deadline() requires loop() to be called to send keep alive messages.
+    /// Has to be called before connecting to take effect, the default is MQTT_KEEPALIVE (15 seconds) of the PubSubClient
+    /// @param keep_alive Keep alive interval in seconds
+    void set_keep_alive(uint16_t keep_alive);
+
     void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override;
 
     void set_connect_callback(Callback<void>::function callback) override;
@@ -49,10 +69,21 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 
     bool subscribe(char const * topic) override;
 
+    bool subscribe(char const * const * topics, size_t const & topic_amount) override;
+
     bool unsubscribe(char const * topic) override;
 
     bool connected() override;
 
+    bool get_session_present() override;
+
+    bool set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) override;
+
+    /// @brief The PubSubClient does not expose the time of the last sent or received packet, therefore the deadline is calculated from the last call to loop() instead,
+    /// which is required at least every quarter of the keep alive interval, to ensure the keep alive message is sent before the broker considers the connection lost.
+    /// Additionally returns 0 if the transport client already contains received bytes and UINT32_MAX if the client is disconnected, because reconnecting is not handled by loop()
+    uint32_t get_next_deadline() override;
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
     bool begin_publish(char const * topic, size_t const & length) override;
@@ -70,8 +101,46 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 
   private:
-    Callback<void> m_connected_callback = {}; // Callback that will be called as soon as the mqtt client has connected
-    PubSubClient   m_mqtt_client = {};        // Underlying MQTT client instance used to send data
+    /// @brief Reads all received PUBLISH packets directly from the transport client, until any other packet has been received, which is then left to be read by the PubSubClient
+    /// @return Whether reading the packets was successful or not, fails if the connection has been lost or a packet was not received completely in time
+    bool Receive_Publish_Packets();
+
+    /// @brief Checks whether the next received packet is a control packet, which is the only case the PubSubClient is allowed to read from the transport client, once streaming has been enabled
+    /// @return Whether any bytes have been received and the first one is the fixed header of a packet other than PUBLISH
+    bool Control_Packet_Available();
+
+    /// @brief Reads a single received PUBLISH packet directly from the transport client and either passes its payload to the data callback, streams it to the stream callback in slices or discards it
+    /// @param header First byte of the fixed header of the packet, which contains the packet type and the quality of service
+    /// @return Whether reading the packet was successful or not
+    bool Receive_Publish_Packet(uint8_t const & header);
+
+    /// @brief Reads the given amount of bytes from the transport client, waits for the bytes to arrive until the socket timeout of the PubSubClient has passed
+    /// @param buffer Buffer the read bytes are copied into, nullptr if the bytes should be discarded
+    /// @param length Amount of bytes that should be read
+    /// @return Whether the given amount of bytes could be read or not
+    bool Read_Bytes(uint8_t * buffer, size_t const & length);
+
+    /// @brief Acknowledges a received PUBLISH packet if it was sent with quality of service 1, quality of service 2 is not supported just like by the PubSubClient itself
+    /// @param quality_of_service Quality of service the packet was sent with
+    /// @param identifier Packet identifier of the received packet, only contained in packets with a quality of service bigger than 0
+    /// @return Whether acknowledging the packet was successful or not, always succeeds if no acknowledgement was required
+    bool Acknowledge_Publish_Packet(uint8_t const & quality_of_service, uint8_t const * identifier);
+
+    /// @brief Releases the receive buffer owned by this class
+    void Free_Receive_Buffer();
+
+    Callback<void>                                                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
+    Callback<void, char *, uint8_t *, unsigned int>                                 m_data_callback = {};          // Callback that will be called with received messages that fit into the receive buffer, once the packets are read by this class
+    Callback<bool, char const *>                                                    m_stream_filter_callback = {}; // Callback that decides whether the payload of messages that do not fit into the receive buffer is streamed or discarded
+    Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &> m_stream_callback = {};        // Callback that will be called with every slice of streamed payloads
+    bool                                                                            m_clean_session = true;        // Whether we connect with the clean session flag set, meaning the broker discards all subscriptions once we disconnect
+    uint16_t                                                                        m_keep_alive = MQTT_KEEPALIVE; // Keep alive interval the connection is established with in seconds
+    uint32_t                                                                        m_last_loop = {};              // Time loop() was last called at in milliseconds
+    Client                                                                          *m_transport_client = {};      // Transport client the PUBLISH packets are read from directly, once streaming has been enabled
+    uint8_t                                                                         *m_receive_buffer = {};        // Receive buffer PUBLISH packets are read into once streaming has been enabled, nullptr if the PubSubClient reads all packets
+    uint16_t                                                                        m_receive_buffer_size = {};    // Size of the receive buffer owned by this class
+    Read_Guarded_Client                                                             m_guarded_client = {};         // Forwards to the transport client, but only lets the PubSubClient read control packets, once streaming has been enabled
+    PubSubClient                                                                    m_mqtt_client = {};            // Underlying MQTT client instance used to send data
 };
 
 #endif // ARDUINO
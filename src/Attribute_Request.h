@@ -6,10 +6,6 @@
 #include "IAPI_Implementation.h"
 
 
-// Attribute request API topics.
-char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/%u";
-char constexpr ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/attributes/response/+";
-char constexpr ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
 // Client side attribute request keys.
 char constexpr CLIENT_REQUEST_KEYS[] = "clientKeys";
 char constexpr CLIENT_RESPONSE_KEY[] = "client";
@@ -82,7 +78,7 @@ class Attribute_Request : public IAPI_Implementation {
     }
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        size_t const request_id = Helper::parseRequestId(ATTRIBUTE_RESPONSE_TOPIC, topic);
+        size_t const request_id = Helper::parseRequestId(m_topic_profile->attribute_response, topic);
         JsonObjectConst object = data.template as<JsonObjectConst>();
 
 #if THINGSBOARD_ENABLE_STL
@@ -135,7 +131,7 @@ class Attribute_Request : public IAPI_Implementation {
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(ATTRIBUTE_RESPONSE_TOPIC, topic, strlen(ATTRIBUTE_RESPONSE_TOPIC)) == 0;
+        return strncmp(m_topic_profile->attribute_response, topic, strlen(m_topic_profile->attribute_response)) == 0;
     }
 
     bool Unsubscribe() override {
@@ -146,11 +142,24 @@ class Attribute_Request : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
+#if !THINGSBOARD_USE_ESP_TIMER
         for (auto & attribute_request : m_attribute_request_callbacks) {
             attribute_request.Update_Timeout_Timer();
         }
+#endif // !THINGSBOARD_USE_ESP_TIMER
+    }
+
+#if !THINGSBOARD_USE_ESP_TIMER
+    uint32_t Get_Next_Deadline() const override {
+        uint32_t deadline = UINT32_MAX;
+        for (auto const & attribute_request : m_attribute_request_callbacks) {
+            uint32_t const remaining = attribute_request.Get_Remaining_Timeout();
+            if (remaining < deadline) {
+                deadline = remaining;
+            }
+        }
+        return deadline;
     }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
@@ -158,6 +167,10 @@ class Attribute_Request : public IAPI_Implementation {
         // Nothing to do
     }
 
+    void Set_Topic_Profile(Topic_Profile const & profile) override {
+        m_topic_profile = &profile;
+    }
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_send_json_callback.Set_Callback(send_json_callback);
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
@@ -263,9 +276,9 @@ class Attribute_Request : public IAPI_Implementation {
         registered_callback->Set_Attribute_Key(attribute_response_key);
         registered_callback->Start_Timeout_Timer();
 
-        char topic[Helper::detectSize(ATTRIBUTE_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), ATTRIBUTE_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        char topic[Helper::detectSize(m_topic_profile->attribute_request, request_id)] = {};
+        (void)snprintf(topic, sizeof(topic), m_topic_profile->attribute_request, request_id);
+        return m_send_json_callback.Call_Callback(topic, request_buffer, 0U);
     }
 
     /// @brief Subscribes to attribute response topic
@@ -283,8 +296,8 @@ class Attribute_Request : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC)) {
-            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
+        if (!m_subscribe_topic_callback.Call_Callback(m_topic_profile->attribute_response_subscribe)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, m_topic_profile->attribute_response_subscribe);
           return false;
         }
         m_attribute_request_callbacks.push_back(callback);
@@ -297,13 +310,14 @@ class Attribute_Request : public IAPI_Implementation {
     /// and from the  attribute response topic, was successful or not
     bool Attributes_Request_Unsubscribe() {
         m_attribute_request_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
+        return m_unsubscribe_topic_callback.Call_Callback(m_topic_profile->attribute_response_subscribe);
     }
 
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    Topic_Profile const                                                      *m_topic_profile = &DEFAULT_TOPIC_PROFILE; // Topics the attribute requests are sent and received over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
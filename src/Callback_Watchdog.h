@@ -42,8 +42,10 @@ class Callback_Watchdog : public Callback<void> {
 #else
       , m_oneshot_timer()
 #endif // THINGSBOARD_USE_ESP_TIMER
-    {        
+    {
+#if THINGSBOARD_USE_ESP_TIMER
         create_timer();
+#endif // THINGSBOARD_USE_ESP_TIMER
     }
 
 #if THINGSBOARD_USE_ESP_TIMER
@@ -83,6 +85,16 @@ class Callback_Watchdog : public Callback<void> {
     void update() {
         m_oneshot_timer.tick<void>();
     }
+
+    /// @brief Gets the time until the currently ongoing watchdog timer expires, which is the latest time update() has to be called again at
+    /// @return Amount of milliseconds until the timer expires, 0 if it already expired and UINT32_MAX if the timer is not started
+    uint32_t Get_Remaining_Time() const {
+        // The timer reports 0 remaining ticks both if a task is due and if no task has been started, therefore the latter has to be checked seperately
+        if (m_oneshot_timer.size() == 0U) {
+            return UINT32_MAX;
+        }
+        return static_cast<uint32_t>(m_oneshot_timer.ticks() / 1000U);
+    }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
   private:
@@ -6,10 +6,6 @@
 #include "IAPI_Implementation.h"
 
 
-// Client side RPC topics.
-char constexpr RPC_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/response/+";
-char constexpr RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
-char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/%u";
 // Log messages.
 char constexpr CLIENT_RPC_METHOD_NULL[] = "Client-side RPC method name is NULL";
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -98,9 +94,9 @@ class Client_Side_RPC : public IAPI_Implementation {
         registered_callback->Set_Request_ID(++request_id);
         registered_callback->Start_Timeout_Timer();
 
-        char topic[Helper::detectSize(RPC_SEND_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), RPC_SEND_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        char topic[Helper::detectSize(m_topic_profile->rpc_send_request, request_id)] = {};
+        (void)snprintf(topic, sizeof(topic), m_topic_profile->rpc_send_request, request_id);
+        return m_send_json_callback.Call_Callback(topic, request_buffer, 0U);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -112,7 +108,7 @@ class Client_Side_RPC : public IAPI_Implementation {
     }
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        size_t const request_id = Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic);
+        size_t const request_id = Helper::parseRequestId(m_topic_profile->rpc_response, topic);
 
 #if THINGSBOARD_ENABLE_STL
         auto it = std::find_if(m_rpc_request_callbacks.begin(), m_rpc_request_callbacks.end(), [&request_id](RPC_Request_Callback & rpc_request) {
@@ -147,7 +143,7 @@ class Client_Side_RPC : public IAPI_Implementation {
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(RPC_RESPONSE_TOPIC, topic, strlen(RPC_RESPONSE_TOPIC)) == 0;
+        return strncmp(m_topic_profile->rpc_response, topic, strlen(m_topic_profile->rpc_response)) == 0;
     }
 
     bool Unsubscribe() override {
@@ -158,11 +154,24 @@ class Client_Side_RPC : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
+#if !THINGSBOARD_USE_ESP_TIMER
         for (auto & rpc_request : m_rpc_request_callbacks) {
             rpc_request.Update_Timeout_Timer();
         }
+#endif // !THINGSBOARD_USE_ESP_TIMER
+    }
+
+#if !THINGSBOARD_USE_ESP_TIMER
+    uint32_t Get_Next_Deadline() const override {
+        uint32_t deadline = UINT32_MAX;
+        for (auto const & rpc_request : m_rpc_request_callbacks) {
+            uint32_t const remaining = rpc_request.Get_Remaining_Timeout();
+            if (remaining < deadline) {
+                deadline = remaining;
+            }
+        }
+        return deadline;
     }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
@@ -170,6 +179,10 @@ class Client_Side_RPC : public IAPI_Implementation {
         // Nothing to do
     }
 
+    void Set_Topic_Profile(Topic_Profile const & profile) override {
+        m_topic_profile = &profile;
+    }
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_send_json_callback.Set_Callback(send_json_callback);
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
@@ -191,8 +204,8 @@ class Client_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
-            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_RESPONSE_SUBSCRIBE_TOPIC);
+        if (!m_subscribe_topic_callback.Call_Callback(m_topic_profile->rpc_response_subscribe)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, m_topic_profile->rpc_response_subscribe);
             return false;
         }
         m_rpc_request_callbacks.push_back(callback);
@@ -205,13 +218,14 @@ class Client_Side_RPC : public IAPI_Implementation {
     /// and from the client-side RPC response topic, was successful or not
     bool RPC_Request_Unsubscribe() {
         m_rpc_request_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC);
+        return m_unsubscribe_topic_callback.Call_Callback(m_topic_profile->rpc_response_subscribe);
     }
 
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    Topic_Profile const                                                      *m_topic_profile = &DEFAULT_TOPIC_PROFILE; // Topics the client-side RPC requests are sent and received over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
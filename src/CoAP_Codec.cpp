@@ -0,0 +1,289 @@
+// Header include.
+#include "CoAP_Codec.h"
+
+// Library includes.
+#include <string.h>
+
+// Version contained in the first two bits of every message.
+uint8_t constexpr COAP_VERSION = 1U;
+// Size of the fixed header, followed by the token.
+size_t constexpr COAP_HEADER_SIZE = 4U;
+// Byte seperating the options from the payload.
+uint8_t constexpr COAP_PAYLOAD_MARKER = 0xFF;
+// Option delta and length values that are encoded with one or two additional bytes, see https://datatracker.ietf.org/doc/html/rfc7252#section-3.1 for more information.
+uint32_t constexpr COAP_OPTION_ONE_BYTE_EXTENSION = 13U;
+uint32_t constexpr COAP_OPTION_TWO_BYTE_EXTENSION = 269U;
+uint32_t constexpr COAP_OPTION_MAX_FIELD_VALUE = 65535U + COAP_OPTION_TWO_BYTE_EXTENSION;
+// Half of the range of the 24-bit notification sequence number, see https://datatracker.ietf.org/doc/html/rfc7641#section-3.4 for more information.
+uint32_t constexpr COAP_OBSERVE_HALF_RANGE = 1UL << 23U;
+// Reserved block size exponent, see https://datatracker.ietf.org/doc/html/rfc7959#section-2.2 for more information.
+uint8_t constexpr COAP_RESERVED_BLOCK_EXPONENT = 7U;
+
+size_t CoAP_Codec::Encode(CoAP_Message const & message, uint8_t * buffer, size_t const & size) {
+    size_t const header_length = COAP_HEADER_SIZE + message.token_length;
+    if (buffer == nullptr || message.token_length > COAP_MAX_TOKEN_LENGTH || size < header_length) {
+        return 0U;
+    }
+    buffer[0U] = (COAP_VERSION << 6U) | (static_cast<uint8_t>(message.type) << 4U) | message.token_length;
+    buffer[1U] = message.code;
+    buffer[2U] = static_cast<uint8_t>(message.message_id >> 8U);
+    buffer[3U] = static_cast<uint8_t>(message.message_id);
+    memcpy(buffer + COAP_HEADER_SIZE, message.token, message.token_length);
+
+    // Options have to be encoded in ascending order of their number, because only the delta to the previous option number is encoded
+    size_t index = header_length;
+    uint16_t previous_number = 0U;
+    if (message.has_observe) {
+        index = Encode_Uint_Option(buffer, size, index, previous_number, COAP_OPTION_OBSERVE, message.observe);
+        previous_number = COAP_OPTION_OBSERVE;
+    }
+
+    char const * query = nullptr;
+    if (index != 0U && message.uri != nullptr) {
+        query = strchr(message.uri, '?');
+        size_t const path_length = (query == nullptr) ? strlen(message.uri) : static_cast<size_t>(query - message.uri);
+        index = Encode_Uri_Options(buffer, size, index, previous_number, COAP_OPTION_URI_PATH, message.uri, path_length, '/');
+    }
+    if (index != 0U && message.has_content_format) {
+        index = Encode_Uint_Option(buffer, size, index, previous_number, COAP_OPTION_CONTENT_FORMAT, message.content_format);
+        previous_number = COAP_OPTION_CONTENT_FORMAT;
+    }
+    if (index != 0U && query != nullptr) {
+        index = Encode_Uri_Options(buffer, size, index, previous_number, COAP_OPTION_URI_QUERY, query + 1U, strlen(query + 1U), '&');
+    }
+    if (index != 0U && message.has_block2) {
+        uint8_t exponent = 0U;
+        while ((COAP_MIN_BLOCK_SIZE << exponent) < message.block_size && exponent < COAP_RESERVED_BLOCK_EXPONENT - 1U) {
+            ++exponent;
+        }
+        uint32_t const block = (message.block_number << 4U) | (message.more_blocks ? 0x08U : 0x00U) | exponent;
+        index = Encode_Uint_Option(buffer, size, index, previous_number, COAP_OPTION_BLOCK2, block);
+        previous_number = COAP_OPTION_BLOCK2;
+    }
+    if (index == 0U) {
+        return 0U;
+    }
+
+    // The payload marker is only permitted if it is followed by a payload
+    if (message.payload != nullptr && message.payload_length > 0U) {
+        if (index + 1U + message.payload_length > size) {
+            return 0U;
+        }
+        buffer[index++] = COAP_PAYLOAD_MARKER;
+        memcpy(buffer + index, message.payload, message.payload_length);
+        index += message.payload_length;
+    }
+    return index;
+}
+
+bool CoAP_Codec::Decode(uint8_t * buffer, size_t const & length, CoAP_Message & message, char * uri, size_t const & uri_size) {
+    message = CoAP_Message();
+    if (buffer == nullptr || length < COAP_HEADER_SIZE || (buffer[0U] >> 6U) != COAP_VERSION) {
+        return false;
+    }
+    message.type = static_cast<CoAP_Type>((buffer[0U] >> 4U) & 0x03U);
+    message.token_length = buffer[0U] & 0x0FU;
+    if (message.token_length > COAP_MAX_TOKEN_LENGTH || COAP_HEADER_SIZE + message.token_length > length) {
+        return false;
+    }
+    message.code = buffer[1U];
+    message.message_id = static_cast<uint16_t>((buffer[2U] << 8U) | buffer[3U]);
+    memcpy(message.token, buffer + COAP_HEADER_SIZE, message.token_length);
+
+    if (uri != nullptr && uri_size > 0U) {
+        uri[0U] = '\0';
+    }
+    size_t uri_length = 0U;
+    bool has_query = false;
+    uint32_t number = 0U;
+    size_t index = COAP_HEADER_SIZE + message.token_length;
+    while (index < length) {
+        uint8_t const option_byte = buffer[index++];
+        if (option_byte == COAP_PAYLOAD_MARKER) {
+            // A payload marker followed by an empty payload is a message format error
+            if (index >= length) {
+                return false;
+            }
+            message.payload = buffer + index;
+            message.payload_length = length - index;
+            break;
+        }
+
+        uint32_t delta = 0U;
+        uint32_t option_length = 0U;
+        if (!Decode_Option_Field(buffer, length, index, option_byte >> 4U, delta) || !Decode_Option_Field(buffer, length, index, option_byte & 0x0FU, option_length) || index + option_length > length) {
+            return false;
+        }
+        number += delta;
+        uint8_t const * value = buffer + index;
+        index += option_length;
+
+        switch (number) {
+            case COAP_OPTION_OBSERVE:
+                message.has_observe = true;
+                message.observe = Decode_Uint(value, option_length);
+                break;
+            case COAP_OPTION_URI_PATH:
+            case COAP_OPTION_URI_QUERY: {
+                if (uri == nullptr) {
+                    break;
+                }
+                // Uri-Path options always preceed the Uri-Query options, because the options are sorted by their number
+                char const seperator = (number == COAP_OPTION_URI_PATH) ? '/' : (has_query ? '&' : '?');
+                has_query = has_query || number == COAP_OPTION_URI_QUERY;
+                if (uri_length + option_length + 2U > uri_size) {
+                    return false;
+                }
+                uri[uri_length++] = seperator;
+                memcpy(uri + uri_length, value, option_length);
+                uri_length += option_length;
+                uri[uri_length] = '\0';
+                message.uri = uri;
+                break;
+            }
+            case COAP_OPTION_CONTENT_FORMAT:
+                message.has_content_format = true;
+                message.content_format = static_cast<uint16_t>(Decode_Uint(value, option_length));
+                break;
+            case COAP_OPTION_BLOCK2: {
+                uint32_t const block = Decode_Uint(value, option_length);
+                uint8_t const exponent = block & 0x07U;
+                if (exponent == COAP_RESERVED_BLOCK_EXPONENT) {
+                    return false;
+                }
+                message.has_block2 = true;
+                message.block_number = block >> 4U;
+                message.more_blocks = (block & 0x08U) != 0U;
+                message.block_size = COAP_MIN_BLOCK_SIZE << exponent;
+                break;
+            }
+            default:
+                // Options that are not used by the ThingsBoard device API are skipped
+                break;
+        }
+    }
+    return true;
+}
+
+uint16_t CoAP_Codec::Get_Block_Size(size_t const & size) {
+    if (size < COAP_MIN_BLOCK_SIZE) {
+        return 0U;
+    }
+    uint16_t block_size = COAP_MAX_BLOCK_SIZE;
+    while (block_size > size) {
+        block_size >>= 1U;
+    }
+    return block_size;
+}
+
+int CoAP_Codec::Get_Response_Code(uint8_t const & code) {
+    return (code >> 5U) * 100 + (code & 0x1FU);
+}
+
+bool CoAP_Codec::Is_Newer_Notification(uint32_t const & previous, uint32_t const & received) {
+    return (previous < received && received - previous < COAP_OBSERVE_HALF_RANGE) || (previous > received && previous - received > COAP_OBSERVE_HALF_RANGE);
+}
+
+size_t CoAP_Codec::Encode_Option(uint8_t * buffer, size_t const & size, size_t index, uint16_t const & previous_number, uint16_t const & number, uint8_t const * value, size_t const & length) {
+    uint32_t const delta = number - previous_number;
+    if (index == 0U || length > COAP_OPTION_MAX_FIELD_VALUE || index + 1U + Get_Option_Extension_Size(delta) + Get_Option_Extension_Size(length) + length > size) {
+        return 0U;
+    }
+    buffer[index++] = (Get_Option_Nibble(delta) << 4U) | Get_Option_Nibble(length);
+    index = Encode_Option_Extension(buffer, index, delta);
+    index = Encode_Option_Extension(buffer, index, length);
+    if (length > 0U) {
+        memcpy(buffer + index, value, length);
+    }
+    return index + length;
+}
+
+size_t CoAP_Codec::Encode_Uint_Option(uint8_t * buffer, size_t const & size, size_t index, uint16_t const & previous_number, uint16_t const & number, uint32_t const & value) {
+    // Leading zero bytes are omitted, meaning the value 0 is encoded as an empty option
+    uint8_t bytes[sizeof(uint32_t)] = {};
+    size_t length = 0U;
+    for (size_t shift = sizeof(uint32_t); shift > 0U; --shift) {
+        uint8_t const byte = static_cast<uint8_t>(value >> ((shift - 1U) * 8U));
+        if (length == 0U && byte == 0U) {
+            continue;
+        }
+        bytes[length++] = byte;
+    }
+    return Encode_Option(buffer, size, index, previous_number, number, bytes, length);
+}
+
+size_t CoAP_Codec::Encode_Uri_Options(uint8_t * buffer, size_t const & size, size_t index, uint16_t & previous_number, uint16_t const & number, char const * part, size_t const & length, char const & seperator) {
+    size_t start = 0U;
+    while (index != 0U && start <= length) {
+        size_t end = start;
+        while (end < length && part[end] != seperator) {
+            ++end;
+        }
+        // Empty segments are skipped, which removes the leading slash of the path
+        if (end > start) {
+            index = Encode_Option(buffer, size, index, previous_number, number, reinterpret_cast<uint8_t const *>(part + start), end - start);
+            previous_number = number;
+        }
+        start = end + 1U;
+    }
+    return index;
+}
+
+uint8_t CoAP_Codec::Get_Option_Nibble(uint32_t const & value) {
+    if (value >= COAP_OPTION_TWO_BYTE_EXTENSION) {
+        return 14U;
+    }
+    else if (value >= COAP_OPTION_ONE_BYTE_EXTENSION) {
+        return 13U;
+    }
+    return static_cast<uint8_t>(value);
+}
+
+size_t CoAP_Codec::Get_Option_Extension_Size(uint32_t const & value) {
+    if (value >= COAP_OPTION_TWO_BYTE_EXTENSION) {
+        return 2U;
+    }
+    else if (value >= COAP_OPTION_ONE_BYTE_EXTENSION) {
+        return 1U;
+    }
+    return 0U;
+}
+
+size_t CoAP_Codec::Encode_Option_Extension(uint8_t * buffer, size_t index, uint32_t const & value) {
+    if (value >= COAP_OPTION_TWO_BYTE_EXTENSION) {
+        uint32_t const extension = value - COAP_OPTION_TWO_BYTE_EXTENSION;
+        buffer[index++] = static_cast<uint8_t>(extension >> 8U);
+        buffer[index++] = static_cast<uint8_t>(extension);
+    }
+    else if (value >= COAP_OPTION_ONE_BYTE_EXTENSION) {
+        buffer[index++] = static_cast<uint8_t>(value - COAP_OPTION_ONE_BYTE_EXTENSION);
+    }
+    return index;
+}
+
+bool CoAP_Codec::Decode_Option_Field(uint8_t const * buffer, size_t const & length, size_t & index, uint8_t const & nibble, uint32_t & value) {
+    if (nibble < COAP_OPTION_ONE_BYTE_EXTENSION) {
+        value = nibble;
+        return true;
+    }
+    else if (nibble == 13U && index + 1U <= length) {
+        value = buffer[index] + COAP_OPTION_ONE_BYTE_EXTENSION;
+        index += 1U;
+        return true;
+    }
+    else if (nibble == 14U && index + 2U <= length) {
+        value = ((static_cast<uint32_t>(buffer[index]) << 8U) | buffer[index + 1U]) + COAP_OPTION_TWO_BYTE_EXTENSION;
+        index += 2U;
+        return true;
+    }
+    // Nibble 15 is reserved for the payload marker and never a valid option delta or length
+    return false;
+}
+
+uint32_t CoAP_Codec::Decode_Uint(uint8_t const * value, size_t const & length) {
+    uint32_t result = 0U;
+    for (size_t i = 0U; i < length && i < sizeof(uint32_t); ++i) {
+        result = (result << 8U) | value[i];
+    }
+    return result;
+}
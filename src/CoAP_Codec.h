@@ -0,0 +1,187 @@
+#ifndef CoAP_Codec_h
+#define CoAP_Codec_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Default CoAP port without DTLS.
+uint16_t constexpr DEFAULT_COAP_PORT = 5683U;
+// Option numbers used by the ThingsBoard device API, see https://datatracker.ietf.org/doc/html/rfc7252#section-12.2 for more information.
+uint16_t constexpr COAP_OPTION_OBSERVE = 6U;
+uint16_t constexpr COAP_OPTION_URI_PATH = 11U;
+uint16_t constexpr COAP_OPTION_CONTENT_FORMAT = 12U;
+uint16_t constexpr COAP_OPTION_URI_QUERY = 15U;
+uint16_t constexpr COAP_OPTION_BLOCK2 = 23U;
+// Content format of json payloads.
+uint16_t constexpr COAP_CONTENT_FORMAT_JSON = 50U;
+// Observe option values to register and deregister an observation, see https://datatracker.ietf.org/doc/html/rfc7641#section-2 for more information.
+uint32_t constexpr COAP_OBSERVE_REGISTER = 0U;
+uint32_t constexpr COAP_OBSERVE_DEREGISTER = 1U;
+// Maximum length of a token, see https://datatracker.ietf.org/doc/html/rfc7252#section-3 for more information.
+size_t constexpr COAP_MAX_TOKEN_LENGTH = 8U;
+// Smallest and biggest block size of block-wise transfers, see https://datatracker.ietf.org/doc/html/rfc7959#section-2.2 for more information.
+uint16_t constexpr COAP_MIN_BLOCK_SIZE = 16U;
+uint16_t constexpr COAP_MAX_BLOCK_SIZE = 1024U;
+// Message codes, the upper 3 bits are the class and the lower 5 bits are the detail.
+uint8_t constexpr COAP_CODE_EMPTY = 0x00;
+uint8_t constexpr COAP_CODE_CREATED = 0x41;
+uint8_t constexpr COAP_CODE_CHANGED = 0x44;
+uint8_t constexpr COAP_CODE_CONTENT = 0x45;
+uint8_t constexpr COAP_CODE_BAD_REQUEST = 0x80;
+uint8_t constexpr COAP_CODE_UNAUTHORIZED = 0x81;
+uint8_t constexpr COAP_CODE_NOT_FOUND = 0x84;
+uint8_t constexpr COAP_CODE_METHOD_NOT_ALLOWED = 0x85;
+uint8_t constexpr COAP_CODE_INTERNAL_SERVER_ERROR = 0xA0;
+
+
+/// @brief Type of a CoAP message, see https://datatracker.ietf.org/doc/html/rfc7252#section-4 for more information
+enum class CoAP_Type : uint8_t {
+    CONFIRMABLE, ///< Requires an acknowledgement and is retransmitted until it is received
+    NON_CONFIRMABLE, ///< Does not require an acknowledgement and is never retransmitted
+    ACKNOWLEDGEMENT, ///< Acknowledges a confirmable message, may contain the response piggybacked
+    RESET ///< Rejects a message that could not be processed, for example a notification of an unknown observation
+};
+
+
+/// @brief Request method of a CoAP request, the value is the code of the request message
+enum class CoAP_Method : uint8_t {
+    GET = 1U, ///< Retrieves the resource, additionally used to register and deregister observations
+    POST = 2U, ///< Sends data to the resource
+    PUT = 3U, ///< Replaces the resource
+    DELETE = 4U ///< Deletes the resource
+};
+
+
+/// @brief Decoded CoAP message, only contains the options used by the ThingsBoard device API, every other option is ignored when decoding.
+/// The uri is kept as a single string instead of the seperate Uri-Path and Uri-Query options, with the same syntax as the path of a HTTP request (example: /api/v1/$TOKEN/attributes?sharedKeys=a,b)
+struct CoAP_Message {
+    CoAP_Type  type = {};                           // Type of the message
+    uint8_t    code = {};                           // Method of a request or response code, COAP_CODE_EMPTY for empty acknowledgements and resets
+    uint16_t   message_id = {};                     // Id used to detect duplicates and match acknowledgements and resets to confirmable messages
+    uint8_t    token[COAP_MAX_TOKEN_LENGTH] = {};   // Token used to match responses and notifications to requests
+    uint8_t    token_length = {};                   // Amount of used bytes of the token
+    char const *uri = {};                           // Path and query of the requested resource, nullptr if the message does not contain any Uri-Path or Uri-Query option
+    bool       has_observe = {};                    // Whether the message contains the Observe option
+    uint32_t   observe = {};                        // Value of the Observe option, register or deregister for requests and the sequence number for notifications
+    bool       has_block2 = {};                     // Whether the message contains the Block2 option
+    uint32_t   block_number = {};                   // Index of the requested or contained block
+    bool       more_blocks = {};                    // Whether more blocks follow the contained block
+    uint16_t   block_size = {};                     // Size of every block except the last one, power of two between COAP_MIN_BLOCK_SIZE and COAP_MAX_BLOCK_SIZE
+    bool       has_content_format = {};             // Whether the message contains the Content-Format option
+    uint16_t   content_format = {};                 // Format of the payload, COAP_CONTENT_FORMAT_JSON for json
+    uint8_t    *payload = {};                       // Payload of the message, points into the buffer the message was decoded from, is only read when encoding
+    size_t     payload_length = {};                 // Length of the payload
+};
+
+
+/// @brief Static helper class that encodes and decodes the binary format of CoAP messages, see https://datatracker.ietf.org/doc/html/rfc7252#section-3 for more information.
+/// Seperated from the UDP transport, so that the same code can be used by any ICoAP_Client implementation and by a local stand-in server that is used to test them
+class CoAP_Codec {
+  public:
+    /// @brief Encodes the given message into the given buffer. The uri is split into one Uri-Path option per path segment and one Uri-Query option per query argument,
+    /// which are not percent-decoded, because CoAP transmits the options as they are
+    /// @param message Message that should be encoded
+    /// @param buffer Buffer the encoded message is written into
+    /// @param size Size of the given buffer
+    /// @return Length of the encoded message or 0 if the buffer was too small
+    static size_t Encode(CoAP_Message const & message, uint8_t * buffer, size_t const & size);
+
+    /// @brief Decodes the message contained in the given buffer, the payload of the decoded message points into the given buffer
+    /// @param buffer Buffer containing a single received datagram
+    /// @param length Length of the received datagram
+    /// @param message Message the decoded values are written into
+    /// @param uri Buffer the Uri-Path and Uri-Query options are combined into, nullptr if they are not required, which is the case for responses
+    /// @param uri_size Size of the given uri buffer
+    /// @return Whether the datagram contained a valid message, fails as well if the given uri buffer is too small
+    static bool Decode(uint8_t * buffer, size_t const & length, CoAP_Message & message, char * uri = nullptr, size_t const & uri_size = 0U);
+
+    /// @brief Gets the biggest block size that is not bigger than the given size, because block sizes have to be a power of two between COAP_MIN_BLOCK_SIZE and COAP_MAX_BLOCK_SIZE
+    /// @param size Maximum size of a single block
+    /// @return Biggest valid block size not bigger than the given size or 0 if the given size is smaller than the smallest block size
+    static uint16_t Get_Block_Size(size_t const & size);
+
+    /// @brief Converts the given message code into the same decimal representation that is used for HTTP status codes, meaning 2.05 Content becomes 205 and 4.04 Not Found becomes 404
+    /// @param code Code of a received response
+    /// @return Response code as a decimal number
+    static int Get_Response_Code(uint8_t const & code);
+
+    /// @brief Checks whether the given received sequence number of a notification is newer than the previous one, while respecting that the 24-bit sequence number wraps around.
+    /// Notifications that are reordered by the network, are otherwise passed on after the newer notification and would overwrite it
+    /// @param previous Sequence number of the last notification that has been passed on
+    /// @param received Sequence number of the received notification
+    /// @return Whether the received notification is newer than the previous one
+    static bool Is_Newer_Notification(uint32_t const & previous, uint32_t const & received);
+
+  private:
+    /// @brief Encodes a single option with the given value after the option with the given previous number
+    /// @param buffer Buffer the option is written into
+    /// @param size Size of the given buffer
+    /// @param index Index the option should be written at
+    /// @param previous_number Number of the previously encoded option or 0 if it is the first one, options have to be encoded in ascending order
+    /// @param number Number of the option
+    /// @param value Value of the option
+    /// @param length Length of the value
+    /// @return Index after the encoded option or 0 if the buffer was too small
+    static size_t Encode_Option(uint8_t * buffer, size_t const & size, size_t index, uint16_t const & previous_number, uint16_t const & number, uint8_t const * value, size_t const & length);
+
+    /// @brief Encodes a single option with the given unsigned integer value, with as few bytes as possible
+    /// @param buffer Buffer the option is written into
+    /// @param size Size of the given buffer
+    /// @param index Index the option should be written at
+    /// @param previous_number Number of the previously encoded option or 0 if it is the first one
+    /// @param number Number of the option
+    /// @param value Value of the option
+    /// @return Index after the encoded option or 0 if the buffer was too small
+    static size_t Encode_Uint_Option(uint8_t * buffer, size_t const & size, size_t index, uint16_t const & previous_number, uint16_t const & number, uint32_t const & value);
+
+    /// @brief Encodes the path segments or query arguments contained in the given part of the uri as seperate options with the given number
+    /// @param buffer Buffer the options are written into
+    /// @param size Size of the given buffer
+    /// @param index Index the first option should be written at
+    /// @param previous_number Number of the previously encoded option, is updated to the given number if any option was encoded
+    /// @param number Number of the options, either COAP_OPTION_URI_PATH or COAP_OPTION_URI_QUERY
+    /// @param part Part of the uri that should be encoded
+    /// @param length Length of the given part
+    /// @param seperator Character seperating the single options, '/' for path segments and '&' for query arguments
+    /// @return Index after the encoded options or 0 if the buffer was too small
+    static size_t Encode_Uri_Options(uint8_t * buffer, size_t const & size, size_t index, uint16_t & previous_number, uint16_t const & number, char const * part, size_t const & length, char const & seperator);
+
+    /// @brief Gets the 4-bit value the given option delta or option length is encoded with in the byte preceeding the option
+    /// @param value Option delta or option length
+    /// @return The value itself if it is smaller than 13, otherwise 13 or 14 to denote an extension of one or two additional bytes
+    static uint8_t Get_Option_Nibble(uint32_t const & value);
+
+    /// @brief Gets the amount of additional bytes the given option delta or option length requires
+    /// @param value Option delta or option length
+    /// @return Amount of additional bytes, between 0 and 2
+    static size_t Get_Option_Extension_Size(uint32_t const & value);
+
+    /// @brief Encodes the additional bytes of the given option delta or option length, if it requires any
+    /// @param buffer Buffer the additional bytes are written into, has to be big enough
+    /// @param index Index the additional bytes should be written at
+    /// @param value Option delta or option length
+    /// @return Index after the additional bytes
+    static size_t Encode_Option_Extension(uint8_t * buffer, size_t index, uint32_t const & value);
+
+    /// @brief Decodes the extended option delta or option length, following the byte containing both of them
+    /// @param buffer Buffer containing the received message
+    /// @param length Length of the received message
+    /// @param index Index of the extended value, is moved after it
+    /// @param nibble Value contained in the option byte, 13 and 14 denote an extended value of one or two additional bytes
+    /// @param value Decoded value
+    /// @return Whether the value could be decoded, fails if the message ends prematurely or the nibble has the reserved value 15
+    static bool Decode_Option_Field(uint8_t const * buffer, size_t const & length, size_t & index, uint8_t const & nibble, uint32_t & value);
+
+    /// @brief Decodes the unsigned integer value of an option, that was encoded with as few bytes as possible
+    /// @param value Value of the option
+    /// @param length Length of the value
+    /// @return Decoded unsigned integer
+    static uint32_t Decode_Uint(uint8_t const * value, size_t const & length);
+};
+
+#endif // CoAP_Codec_h
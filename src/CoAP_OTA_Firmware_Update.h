@@ -0,0 +1,369 @@
+#ifndef CoAP_OTA_Firmware_Update_h
+#define CoAP_OTA_Firmware_Update_h
+
+// Local includes.
+#include "OTA_Handler.h"
+#include "ICoAP_Client.h"
+#include "DefaultLogger.h"
+
+
+// CoAP firmware paths.
+char constexpr COAP_FW_ATTRIBUTES_PATH[] = "/api/v1/%s/attributes?sharedKeys=fw_checksum,fw_checksum_algorithm,fw_size,fw_title,fw_version,fw_chunk_checksums,fw_chunk_checksums_size";
+char constexpr COAP_FW_DOWNLOAD_PATH[] = "/fw/%s?title=%s&version=%s";
+char constexpr COAP_FW_TELEMETRY_PATH[] = "/api/v1/%s/telemetry";
+char constexpr COAP_FW_SHARED_KEY[] = "shared";
+int constexpr COAP_RESPONSE_CONTENT = 205;
+int constexpr COAP_RESPONSE_CREATED = 201;
+int constexpr COAP_RESPONSE_CHANGED = 204;
+// Bytes required in the receive buffer besides the block itself, CoAP header, the longest token, the Block2 and Content-Format option and the payload marker.
+uint16_t constexpr COAP_FW_BLOCK_OVERHEAD = 32U;
+// Log messages.
+char constexpr FW_COAP_REQUEST_FAILED[] = "Requesting firmware block (%u) failed with CoAP response (%d)";
+char constexpr FW_COAP_ATTRIBUTES_FAILED[] = "Requesting shared attribute firmware keys failed with CoAP response (%d)";
+char constexpr FW_COAP_POST_FAILED[] = "Sending firmware information failed with CoAP response (%d)";
+char constexpr FW_COAP_BUFFER_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the firmware download buffer";
+char constexpr FW_COAP_INVALID_CHUNK_SIZE[] = "Chunk size (%u) is smaller than the smallest CoAP block size";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr DOWNLOADING_FW_COAP[] = "Attempting to download over CoAP with block size (%u)...";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Handles the ThingsBoard over the air firmware update over CoAP instead of MQTT, by downloading the firmware binary block-wise from the firmware resource of the CoAP API.
+/// Every chunk is requested as a single block with the Block2 option (https://datatracker.ietf.org/doc/html/rfc7959), which the server slices out of the firmware binary itself,
+/// meaning the chunk size configured in the OTA_Update_Callback is rounded down to the biggest valid block size, which is a power of two between 16 and 1024 bytes.
+/// The receive buffer of the client is temporarily increased to hold a complete block for the duration of the download and restored to its previous size afterwards.
+/// The received firmware binary is processed by the same OTA_Handler as the MQTT update, meaning the firmware checksum, the optional chunk checksums, the IUpdater and the fw_state reporting work exactly the same,
+/// lost blocks are simply retransmitted by the client and blocks that still fail are requested again until the configured amount of retries has been exceeded.
+/// Be aware that the update is blocking, meaning Start_Firmware_Update() only returns once the update has been completed or failed.
+/// See https://thingsboard.io/docs/reference/coap-api/#firmware-api for more information
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class CoAP_OTA_Firmware_Update {
+  public:
+    /// @brief Constructor
+    /// @param client CoAP client that is already connected to the ThingsBoard server and should be used to download the firmware, has to be kept alive for as long as the instance of this class
+    /// @param access_token Token used to verify the devices identity with the ThingsBoard server, the string is not copied and has to be kept alive for as long as the instance of this class
+    CoAP_OTA_Firmware_Update(ICoAP_Client & client, char const * access_token)
+      : m_client(client)
+      , m_token(access_token)
+      , m_fw_callback()
+#if THINGSBOARD_ENABLE_STL
+      , m_ota(std::bind(&CoAP_OTA_Firmware_Update::Request_Chunk, this, std::placeholders::_1, std::placeholders::_2), std::bind(&CoAP_OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&CoAP_OTA_Firmware_Update::Finish_Firmware_Update, this), false)
+#else
+      , m_ota(CoAP_OTA_Firmware_Update::staticRequestChunk, CoAP_OTA_Firmware_Update::staticFirmwareSend, CoAP_OTA_Firmware_Update::staticFinish, false)
+#endif // THINGSBOARD_ENABLE_STL
+      , m_requested_chunk(0U)
+      , m_finished(false)
+    {
+#if !THINGSBOARD_ENABLE_STL
+        m_subscribedInstance = this;
+#endif // !THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Requests the firmware information assigned to this device and if a firmware that is not already installed is assigned, downloads and flashes it.
+    /// Blocks until the update has been completed or failed, the result is passed to the finished callback of the given OTA_Update_Callback
+    /// @param callback Callback method that contains the configuration information and will be called once the update has finished
+    /// @return Whether an update was started or not, false if no new firmware is assigned or the firmware information could not be requested
+    bool Start_Firmware_Update(OTA_Update_Callback const & callback) {
+        char const * current_fw_title = callback.Get_Firmware_Title();
+        char const * current_fw_version = callback.Get_Firmware_Version();
+        if (Helper::stringIsNullorEmpty(current_fw_title) || Helper::stringIsNullorEmpty(current_fw_version) || m_token == nullptr) {
+            return false;
+        }
+        uint16_t const block_size = CoAP_Codec::Get_Block_Size(callback.Get_Chunk_Size());
+        if (block_size == 0U) {
+            Logger::printfln(FW_COAP_INVALID_CHUNK_SIZE, callback.Get_Chunk_Size());
+            return false;
+        }
+        (void)Firmware_Send_Info(current_fw_title, current_fw_version);
+        m_fw_callback = callback;
+        // Every chunk is requested as a single block, therefore the chunk size has to be a valid block size
+        m_fw_callback.Set_Chunk_Size(block_size);
+
+        char attributes_path[Helper::detectSize(COAP_FW_ATTRIBUTES_PATH, m_token)] = {};
+        (void)snprintf(attributes_path, sizeof(attributes_path), COAP_FW_ATTRIBUTES_PATH, m_token);
+        int code = 0;
+        bool const success = m_client.request(CoAP_Method::GET, attributes_path, nullptr, 0U) == 0;
+        if (success) {
+            code = m_client.get_response_code();
+        }
+        size_t const length = m_client.get_response_length();
+        if (!success || code != COAP_RESPONSE_CONTENT || length == 0U) {
+            Logger::printfln(FW_COAP_ATTRIBUTES_FAILED, code);
+            return false;
+        }
+
+        // Response points into the receive buffer of the client, which is overwritten by the next request, therefore it is copied
+        // and kept alive until the update is finished, because the deserialized strings point into the mutable copy instead of being copied into the document
+        char * response = new char[length + 1U]();
+        if (response == nullptr) {
+            Logger::printfln(FW_COAP_BUFFER_ALLOCATION_FAILED, length);
+            return false;
+        }
+        memcpy(response, m_client.get_response_payload(), length);
+        bool result = false;
+        StaticJsonDocument<JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(OTA_ATTRIBUTE_KEYS_AMOUNT)> document;
+        if (deserializeJson(document, response, length) != DeserializationError::Ok) {
+            Logger::printfln(NO_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, NO_FW);
+        }
+        else {
+            JsonObjectConst const data = document[COAP_FW_SHARED_KEY].as<JsonObjectConst>();
+            result = Firmware_Shared_Attribute_Received(data);
+        }
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] response;
+        response = nullptr;
+        return result;
+    }
+
+    /// @brief Sends the given firmware title and firmware version to the cloud.
+    /// See https://thingsboard.io/docs/user-guide/ota-updates/ for more information
+    /// @param current_fw_title Current device firmware title
+    /// @param current_fw_version Current device firmware version
+    /// @return Whether sending the current device firmware information was successful or not
+    bool Firmware_Send_Info(char const * current_fw_title, char const * current_fw_version) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_info;
+        current_firmware_info[CURR_FW_TITLE_KEY] = current_fw_title;
+        current_firmware_info[CURR_FW_VER_KEY] = current_fw_version;
+        return Send_Telemetry(current_firmware_info);
+    }
+
+    /// @brief Sends the given firmware state to the cloud.
+    /// See https://thingsboard.io/docs/user-guide/ota-updates/ for more information
+    /// @param current_fw_state Current firmware download state
+    /// @param fw_error Firmware error message that describes the current firmware state,
+    /// simply do not enter a value and the default value will be used which overwrites the firmware error messages, default = ""
+    /// @return Whether sending the current firmware download state was successful or not
+    bool Firmware_Send_State(char const * current_fw_state, char const * fw_error = "") {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_state;
+        current_firmware_state[FW_ERROR_KEY] = fw_error;
+        current_firmware_state[FW_STATE_KEY] = current_fw_state;
+        return Send_Telemetry(current_firmware_state);
+    }
+
+  private:
+    /// @brief Checks the received firmware information and downloads the firmware if it is meant for this device and not already installed
+    /// @param data Json data containing key-value pairs for the needed firmware information
+    /// @return Whether an update was started or not
+    bool Firmware_Shared_Attribute_Received(JsonObjectConst const & data) {
+        if (!data.containsKey(FW_VER_KEY) || !data.containsKey(FW_TITLE_KEY) || !data.containsKey(FW_CHKS_KEY) || !data.containsKey(FW_CHKS_ALGO_KEY) || !data.containsKey(FW_SIZE_KEY)) {
+            Logger::printfln(NO_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, NO_FW);
+            return false;
+        }
+
+        char const * fw_title = data[FW_TITLE_KEY];
+        char const * fw_version = data[FW_VER_KEY];
+        char const * fw_checksum = data[FW_CHKS_KEY];
+        char const * fw_algorithm = data[FW_CHKS_ALGO_KEY];
+        size_t const fw_size = data[FW_SIZE_KEY];
+        char const * fw_chunk_checksums = data[FW_CHUNK_CHKS_KEY];
+        uint16_t const fw_chunk_checksums_size = data[FW_CHUNK_CHKS_SIZE_KEY];
+
+        char const * curr_fw_title = m_fw_callback.Get_Firmware_Title();
+        char const * curr_fw_version = m_fw_callback.Get_Firmware_Version();
+
+        if (fw_title == nullptr || fw_version == nullptr || fw_algorithm == nullptr || fw_checksum == nullptr) {
+            Logger::printfln(EMPTY_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, EMPTY_FW);
+            return false;
+        }
+        // If firmware version and title is the same, we do not initiate an update, because we expect the type of binary to be the same one we are currently using
+        // and therefore updating would be useless as we have already updated previously
+        else if (strncmp(curr_fw_title, fw_title, strlen(curr_fw_title)) == 0 && strncmp(curr_fw_version, fw_version, strlen(curr_fw_version)) == 0) {
+            (void)Firmware_Send_State(FW_STATE_UPDATED);
+            return false;
+        }
+        // If firmware title is not the same, we do not initiate an update, because we expect the binary to be for another type of device
+        // and downloading it on this device could possibly cause hardware issues or even destroy the device
+        else if (strncmp(curr_fw_title, fw_title, strlen(curr_fw_title)) != 0) {
+            char message[strlen(FW_NOT_FOR_US) + strlen(fw_title) + strlen(curr_fw_title) + 3] = {};
+            (void)snprintf(message, sizeof(message), FW_NOT_FOR_US, fw_title, curr_fw_title);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            return false;
+        }
+
+        mbedtls_md_type_t const fw_checksum_algorithm = HashGenerator::string_to_type(fw_algorithm);
+        if (fw_checksum_algorithm == mbedtls_md_type_t::MBEDTLS_MD_NONE) {
+            char message[strlen(FW_CHKS_ALGO_NOT_SUPPORTED) + strlen(fw_algorithm) + 2] = {};
+            (void)snprintf(message, sizeof(message), FW_CHKS_ALGO_NOT_SUPPORTED, fw_algorithm);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            return false;
+        }
+
+        uint16_t const block_size = m_fw_callback.Get_Chunk_Size();
+        if (fw_chunk_checksums != nullptr && fw_chunk_checksums_size != block_size) {
+            Logger::printfln(FW_CHUNK_CHKS_SIZE_MISMATCH, fw_chunk_checksums_size, block_size);
+            fw_chunk_checksums = nullptr;
+        }
+
+        // Received blocks are copied out of the receive buffer of the client, because sending the firmware state while processing the block would otherwise overwrite it
+        uint8_t * buffer = new uint8_t[block_size]();
+        if (buffer == nullptr) {
+            char message[Helper::detectSize(FW_COAP_BUFFER_ALLOCATION_FAILED, block_size)] = {};
+            (void)snprintf(message, sizeof(message), FW_COAP_BUFFER_ALLOCATION_FAILED, block_size);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            m_fw_callback.Call_Callback(false);
+            return false;
+        }
+        uint16_t const previous_receive_size = m_client.get_receive_buffer_size();
+        uint16_t const previous_send_size = m_client.get_send_buffer_size();
+        uint16_t const required_receive_size = block_size + COAP_FW_BLOCK_OVERHEAD;
+        if (previous_receive_size < required_receive_size && !m_client.set_buffer_size(required_receive_size, previous_send_size)) {
+            char message[Helper::detectSize(FW_COAP_BUFFER_ALLOCATION_FAILED, required_receive_size)] = {};
+            (void)snprintf(message, sizeof(message), FW_COAP_BUFFER_ALLOCATION_FAILED, required_receive_size);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            m_fw_callback.Call_Callback(false);
+            delete[] buffer;
+            buffer = nullptr;
+            return false;
+        }
+
+        char download_path[Helper::detectSize(COAP_FW_DOWNLOAD_PATH, m_token, fw_title, fw_version)] = {};
+        (void)snprintf(download_path, sizeof(download_path), COAP_FW_DOWNLOAD_PATH, m_token, fw_title, fw_version);
+
+        m_fw_callback.Call_Update_Starting_Callback();
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(PAGE_BREAK);
+        Logger::printfln(NEW_FW);
+        char firmware[strlen(FROM_TOO) + strlen(curr_fw_version) + strlen(fw_version) + 3] = {};
+        (void)snprintf(firmware, sizeof(firmware), FROM_TOO, curr_fw_version, fw_version);
+        Logger::printfln(firmware);
+        Logger::printfln(DOWNLOADING_FW_COAP, block_size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        m_finished = false;
+        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm, fw_chunk_checksums);
+        Download_Firmware(download_path, fw_size, buffer, block_size);
+
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] buffer;
+        buffer = nullptr;
+        if (previous_receive_size < required_receive_size) {
+            (void)m_client.set_buffer_size(previous_receive_size, previous_send_size);
+        }
+        m_fw_callback = OTA_Update_Callback();
+        return true;
+    }
+
+    /// @brief Requests the chunk the OTA handler requested last as a single block and passes it to the OTA handler, until the handler finished the update.
+    /// Requests that fail even after the retransmissions of the client, or responses that do not contain the expected amount of bytes, are handled like a timed out chunk request
+    /// @param path Path of the firmware resource
+    /// @param fw_size Complete size of the firmware binary
+    /// @param buffer Buffer the received block is copied into, has to be at least as big as the given block size
+    /// @param block_size Size of every block except the last one
+    void Download_Firmware(char const * path, size_t const & fw_size, uint8_t * buffer, uint16_t const & block_size) {
+        while (!m_finished) {
+            // Chunks of cached firmware are read from the cache instead of being downloaded
+            if (m_ota.Serve_Cached_Chunk()) {
+                continue;
+            }
+            size_t const offset = m_requested_chunk * block_size;
+            // The last chunk contains the remaining bytes, which is 0 if the firmware size is a multiple of the block size, in which case there is no block to request
+            size_t const expected_size = (offset + block_size > fw_size) ? fw_size - offset : block_size;
+            if (expected_size == 0U) {
+                m_ota.Process_Firmware_Packet(m_requested_chunk, buffer, 0U);
+                continue;
+            }
+
+            int code = 0;
+            bool const success = m_client.get_block(path, m_requested_chunk, block_size) == 0;
+            if (success) {
+                code = m_client.get_response_code();
+            }
+            if (!success || code != COAP_RESPONSE_CONTENT || m_client.get_response_length() != expected_size) {
+                Logger::printfln(FW_COAP_REQUEST_FAILED, m_requested_chunk, code);
+                m_ota.Handle_Request_Timeout();
+                continue;
+            }
+            memcpy(buffer, m_client.get_response_payload(), expected_size);
+            m_ota.Process_Firmware_Packet(m_requested_chunk, buffer, expected_size);
+        }
+    }
+
+    /// @brief Serializes and sends the given telemetry to the cloud
+    /// @param source JsonDocument containing the key value pairs that should be sent
+    /// @return Whether sending the telemetry was successful or not
+    bool Send_Telemetry(JsonDocument const & source) {
+        size_t const json_size = Helper::Measure_Json(source);
+        char json[json_size] = {};
+        (void)serializeJson(source, json, json_size);
+        char path[Helper::detectSize(COAP_FW_TELEMETRY_PATH, m_token)] = {};
+        (void)snprintf(path, sizeof(path), COAP_FW_TELEMETRY_PATH, m_token);
+
+        int code = 0;
+        bool const success = m_client.request(CoAP_Method::POST, path, reinterpret_cast<uint8_t const *>(json), strlen(json)) == 0;
+        if (success) {
+            code = m_client.get_response_code();
+        }
+        if (!success || (code != COAP_RESPONSE_CREATED && code != COAP_RESPONSE_CHANGED)) {
+            Logger::printfln(FW_COAP_POST_FAILED, code);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Called by the OTA handler once it requests the next chunk, only remembers the requested chunk, because the block is requested by Download_Firmware()
+    /// @param request_id Unused, because the firmware is not requested with a request id over CoAP
+    /// @param request_chunk Index of the chunk that should be requested next
+    /// @return Always true, because no request has to be sent
+    bool Request_Chunk(size_t const & request_id, size_t const & request_chunk) {
+        m_requested_chunk = request_chunk;
+        return true;
+    }
+
+    /// @brief Called by the OTA handler once the update has been completed or failed, stops the download loop
+    /// @return Always true
+    bool Finish_Firmware_Update() {
+        m_finished = true;
+        return true;
+    }
+
+#if !THINGSBOARD_ENABLE_STL
+    static bool staticRequestChunk(size_t const & request_id, size_t const & request_chunk) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Request_Chunk(request_id, request_chunk);
+    }
+
+    static bool staticFirmwareSend(char const * current_fw_state, char const * fw_error = nullptr) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Firmware_Send_State(current_fw_state, fw_error);
+    }
+
+    static bool staticFinish() {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Finish_Firmware_Update();
+    }
+
+    // Used OTA handler cannot call a instanced method, only free-standing function is allowed.
+    // To be able to forward event to an instance, rather than to a function, this pointer exists.
+    static CoAP_OTA_Firmware_Update *m_subscribedInstance;
+#endif // !THINGSBOARD_ENABLE_STL
+
+    ICoAP_Client        &m_client;                 // CoAP client the firmware information is requested and the firmware binary is downloaded with
+    char const          *m_token = {};             // Access token used to authenticate the requests
+    OTA_Update_Callback m_fw_callback = {};        // OTA update response callback, with the chunk size rounded down to a valid block size
+    OTA_Handler<Logger> m_ota;                     // Class instance that handles the flashing and creating a hash from the given received binary firmware data
+    size_t              m_requested_chunk = {};    // Index of the chunk the OTA handler requested last
+    bool                m_finished = {};           // Whether the OTA handler finished the update, either successfully or because it failed
+};
+
+#if !THINGSBOARD_ENABLE_STL
+template <typename Logger>
+CoAP_OTA_Firmware_Update<Logger> *CoAP_OTA_Firmware_Update<Logger>::m_subscribedInstance = nullptr;
+#endif // !THINGSBOARD_ENABLE_STL
+
+#endif // CoAP_OTA_Firmware_Update_h
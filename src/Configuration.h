@@ -114,6 +114,49 @@
 #    endif
 #  endif
 
+// Use the FreeRTOS semaphores internally to guard the state that is shared between the task calling the methods of the ThingsBoard class and the task of the underlying client, as long as the header exists.
+// Required because clients like the Espressif_MQTT_Client call the received data callbacks from their own task, which for example sends the responses to server-side RPC requests,
+// while the user task might send telemetry data or call loop() at the same time. Exists on every ESP32 and on ESP8266 when using the RTOS SDK, without it every method has to be called from the same task.
+#  ifndef THINGSBOARD_USE_FREERTOS
+#    ifdef __has_include
+#      if __has_include(<freertos/FreeRTOS.h>) && __has_include(<freertos/semphr.h>)
+#        define THINGSBOARD_USE_FREERTOS 1
+#      else
+#        define THINGSBOARD_USE_FREERTOS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_FREERTOS 0
+#    endif
+#  endif
+
+// Use BSD sockets internally for sending and receiving CoAP datagrams over UDP, as long as the needed headers exist,
+// to allow users on Linux or on the ESP32 with either Arduino or Espressif IDF, where lwIP implements the same interface, to use the Socket_CoAP_Client.
+#  ifndef THINGSBOARD_USE_BSD_SOCKETS
+#    ifdef __has_include
+#      if __has_include(<sys/socket.h>) && __has_include(<netdb.h>)
+#        define THINGSBOARD_USE_BSD_SOCKETS 1
+#      else
+#        define THINGSBOARD_USE_BSD_SOCKETS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_BSD_SOCKETS 0
+#    endif
+#  endif
+
+// Use the id of the current process internally to name the temporary files of the File_Firmware_Cache, as long as the header exists,
+// which ensures multiple processes that share the same cache directory on Linux never write into the same temporary file.
+#  ifndef THINGSBOARD_USE_PROCESS_ID
+#    ifdef __has_include
+#      if __has_include(<unistd.h>)
+#        define THINGSBOARD_USE_PROCESS_ID 1
+#      else
+#        define THINGSBOARD_USE_PROCESS_ID 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_PROCESS_ID 0
+#    endif
+#  endif
+
 // Enables the ThingsBoard class to be fully dynamic instead of requiring template arguments to statically allocate memory.
 // If enabled the program might be slightly slower and all the memory will be placed onto the heap instead of the stack.
 // See https://arduinojson.org/v6/api/dynamicjsondocument/ for the main difference in the underlying code.
@@ -17,6 +17,24 @@
 #define Default_Request_RPC_Amount 2
 #define Default_Payload_Size 64
 #define Default_Max_Stack_Size 1024
+#define Default_Reconnect_Base_Delay 1000
+#define Default_Reconnect_Max_Delay 60000
+#define Default_Connect_Timeout 10000
+#define Default_Rate_Limit_Windows 3
+#define Default_Rate_Limit_Queue_Size 8
+#define Default_Send_Schedule_Queue_Size 8
+#define Default_Priority_Lane_Queue_Size 8
+#define Default_Priority_Lane_Poll_Interval 10
+#define Default_Normal_Send_Latency 60000
+#define Default_Low_Send_Latency 600000
+#define Default_Stream_Topic_Size 64
+#define Default_Topic_Alias_Amount 2
+#define Default_CoAP_Buffer_Size 512
+#if THINGSBOARD_ENABLE_CXX20
+#define Default_Coroutine_Frame_Size 1024
+#define Default_Coroutine_Frame_Amount 2
+#define Default_Coroutine_Request_Amount 4
+#endif // THINGSBOARD_ENABLE_CXX20
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #define Default_Buffering_Size 64
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
@@ -0,0 +1,356 @@
+#ifndef Coroutine_Driver_h
+#define Coroutine_Driver_h
+
+// Local includes.
+#include "Constants.h"
+#include "DefaultLogger.h"
+
+#if THINGSBOARD_ENABLE_CXX20
+
+// Library includes.
+#include <ArduinoJson.h>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Log messages.
+char constexpr COROUTINE_FRAME_POOL_EXHAUSTED[] = "Coroutine frame (%u) does not fit into the frame pool or all (%u) frames are in use, increase FrameSize or FrameAmount";
+char constexpr COROUTINE_REQUESTS_EXHAUSTED[] = "Too many (%u) pending coroutine requests, increase MaxRequests";
+
+
+/// @brief Result of a request that was awaited in a coroutine
+enum class Coroutine_Result : uint8_t {
+    RECEIVED, ///< Response has been received and is contained in the data of the Coroutine_Response
+    TIMED_OUT, ///< No response has been received in the timeout configured in the passed request callback
+    FAILED ///< Request could not be sent or no request slot of the Coroutine_Driver was free
+};
+
+
+/// @brief Response of a request that was awaited in a coroutine, contains a copy of the received json data,
+/// because the JsonDocument the response was originally deserialized into is only valid while the API implementation calls the request callback
+/// @tparam ResponseSize Capacity of the JsonDocument the response is copied into, has to contain the complete received response including its strings. See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size
+template <size_t ResponseSize>
+struct Coroutine_Response {
+    Coroutine_Result                 result = {}; // Whether the response was received, timed out or the request failed
+    StaticJsonDocument<ResponseSize> data;        // Copy of the received response, empty if the response was not received
+};
+
+
+/// @brief Return type of coroutines that await requests with a Coroutine_Driver. The coroutine is started directly when it is called and runs until its first co_await,
+/// afterwards it is resumed by the loop() method of the Coroutine_Driver once the awaited response has been received or the request timed out, and its frame is released as soon as it returns.
+/// Coroutine frames are never allocated on the heap, instead they are taken from a fixed pool with a slot size and amount per distinct template instantiation,
+/// if the pool is exhausted or the frame is bigger than a slot, the coroutine is not started at all, which can be checked with Started()
+/// @tparam FrameSize Size in bytes of one coroutine frame slot, has to contain all local variables of the coroutine that live across a co_await, including the awaited responses, default = Default_Coroutine_Frame_Size (1024)
+/// @tparam FrameAmount Maximum amount of coroutines of this type that are running at the same time, default = Default_Coroutine_Frame_Amount (2)
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes, default = DefaultLogger
+template <size_t FrameSize = Default_Coroutine_Frame_Size, size_t FrameAmount = Default_Coroutine_Frame_Amount, typename Logger = DefaultLogger>
+class Coroutine_Task {
+  public:
+    /// @brief Promise of the coroutine, allocates the coroutine frame from the fixed pool and starts the coroutine directly without ever awaiting its completion
+    class promise_type {
+      public:
+        /// @brief Takes a free slot from the frame pool, a nullptr causes get_return_object_on_allocation_failure() to be used instead of starting the coroutine
+        /// @param size Size in bytes of the coroutine frame calculated by the compiler
+        /// @return Pointer to the free slot or nullptr if the frame does not fit or every slot is in use
+        static void * operator new(size_t size) noexcept {
+            if (size <= FrameSize) {
+                for (size_t i = 0U; i < FrameAmount; ++i) {
+                    if (!m_used[i]) {
+                        m_used[i] = true;
+                        return m_frames[i];
+                    }
+                }
+            }
+            Logger::printfln(COROUTINE_FRAME_POOL_EXHAUSTED, size, FrameAmount);
+            return nullptr;
+        }
+
+        /// @brief Returns the given slot to the frame pool
+        /// @param frame Slot that was previously returned by operator new
+        static void operator delete(void * frame) noexcept {
+            for (size_t i = 0U; i < FrameAmount; ++i) {
+                if (m_frames[i] == frame) {
+                    m_used[i] = false;
+                    return;
+                }
+            }
+        }
+
+        static Coroutine_Task get_return_object_on_allocation_failure() noexcept {
+            return Coroutine_Task(false);
+        }
+
+        Coroutine_Task get_return_object() noexcept {
+            return Coroutine_Task(true);
+        }
+
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() const noexcept {
+            // Nothing to do
+        }
+
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+
+      private:
+        alignas(alignof(max_align_t)) static inline uint8_t m_frames[FrameAmount][FrameSize] = {}; // Fixed pool the coroutine frames are placed into
+        static inline bool                                  m_used[FrameAmount] = {};              // Whether the frame slot with the same index is in use
+    };
+
+    /// @brief Whether the coroutine was started or not, because no frame could be taken from the fixed pool
+    /// @return Whether the coroutine was started
+    bool Started() const {
+        return m_started;
+    }
+
+  private:
+    /// @brief Constructor
+    /// @param started Whether the coroutine was started or not
+    explicit Coroutine_Task(bool started)
+      : m_started(started)
+    {
+        // Nothing to do
+    }
+
+    bool m_started = {}; // Whether the coroutine was started
+};
+
+
+/// @brief Resumes coroutines that await requests (attribute requests, client-side RPC, provisioning) once their response has been received or they timed out,
+/// which allows to write dependent requests sequentially with co_await instead of chaining callbacks and keeping their state alive manually.
+/// Coroutines are never resumed from inside the request callback itself, because the API implementation is still iterating its internal callbacks at that point,
+/// instead the response is copied into the awaiting coroutine frame and the coroutine is resumed in the next call to loop(), which therefore has to be called regularly after the loop() method of the ThingsBoard client.
+/// Any amount of coroutines can share the same instance, as long as the amount of requests that are awaited at the same time does not exceed MaxRequests.
+/// The instance has to be kept alive for as long as any of the used API implementations, because late responses to requests that already timed out still call into it
+/// @tparam MaxRequests Maximum amount of requests that can be awaited at the same time, default = Default_Coroutine_Request_Amount (4)
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes, default = DefaultLogger
+template <size_t MaxRequests = Default_Coroutine_Request_Amount, typename Logger = DefaultLogger>
+class Coroutine_Driver {
+  private:
+    /// @brief State of a request slot, stored in the lowest byte of the status, with the generation of the slot in the remaining bits,
+    /// which allows to ignore callbacks of requests whose slot has been released and reused already in the same atomic compare and exchange
+    enum class Request_State : uint8_t {
+        FREE, ///< Slot is not used by any request
+        PENDING, ///< Request has been sent and neither a response has been received nor did it time out yet
+        COMPLETING, ///< Response is being copied into the awaiting coroutine frame
+        RECEIVED, ///< Response has been copied and the coroutine can be resumed
+        TIMED_OUT ///< Request timed out and the coroutine can be resumed
+    };
+
+  public:
+    /// @brief Awaitable request, that sends the request with the passed callback once it is awaited and resumes the awaiting coroutine with the copied response
+    /// @tparam ResponseSize Capacity of the JsonDocument the response is copied into
+    /// @tparam RequestCallback Callback wrapper the request is sent with (Attribute_Request_Callback, RPC_Request_Callback, Provision_Callback)
+    /// @tparam RequestFunction Invocable that sends the request with the given callback and returns whether sending was successful
+    template <size_t ResponseSize, typename RequestCallback, typename RequestFunction>
+    class Awaitable {
+      public:
+        /// @brief Constructor
+        /// @param driver Driver that resumes the awaiting coroutine
+        /// @param callback Callback wrapper containing the request configuration, the response and timeout callbacks are overwritten
+        /// @param request Invocable that sends the request with the given callback
+        Awaitable(Coroutine_Driver & driver, RequestCallback const & callback, RequestFunction request)
+          : m_driver(driver)
+          , m_callback(callback)
+          , m_request(request)
+          , m_index(MaxRequests)
+          , m_generation(0U)
+          , m_response()
+        {
+            // Nothing to do
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        /// @brief Sends the request, if sending fails the coroutine is directly resumed with a failed result
+        /// @param handle Handle of the awaiting coroutine
+        /// @return Whether the coroutine was suspended or not
+        bool await_suspend(std::coroutine_handle<> handle) {
+            m_response.result = Coroutine_Result::FAILED;
+            if (!m_driver.Acquire(handle, m_response.data, m_index, m_generation)) {
+                return false;
+            }
+
+            Coroutine_Driver * driver = &m_driver;
+            size_t const index = m_index;
+            uint32_t const generation = m_generation;
+            m_callback.Set_Callback([driver, index, generation](auto const & data) {
+                driver->Complete(index, generation, data);
+            });
+            m_callback.Set_Timeout_Callback([driver, index, generation]() {
+                driver->Time_Out(index, generation);
+            });
+            if (!m_request(m_callback)) {
+                (void)m_driver.Release(m_index);
+                return false;
+            }
+            return true;
+        }
+
+        /// @brief Releases the request slot and returns the copied response
+        /// @return Response containing the result of the request and the copied data
+        Coroutine_Response<ResponseSize> await_resume() {
+            if (m_index < MaxRequests) {
+                Request_State const state = m_driver.Release(m_index);
+                m_response.result = (state == Request_State::RECEIVED) ? Coroutine_Result::RECEIVED : (state == Request_State::TIMED_OUT ? Coroutine_Result::TIMED_OUT : Coroutine_Result::FAILED);
+                m_index = MaxRequests;
+            }
+            return m_response;
+        }
+
+      private:
+        Coroutine_Driver                 &m_driver;         // Driver that resumes the awaiting coroutine
+        RequestCallback                  m_callback = {};   // Copy of the passed callback wrapper, kept in the coroutine frame while the request is pending
+        RequestFunction                  m_request;         // Invocable that sends the request
+        size_t                           m_index = {};      // Index of the acquired request slot, MaxRequests if none was acquired
+        uint32_t                         m_generation = {}; // Generation of the acquired request slot
+        Coroutine_Response<ResponseSize> m_response = {};   // Response the received data is copied into
+    };
+
+    /// @brief Constructor
+    Coroutine_Driver() = default;
+
+    /// @brief Creates an awaitable request, that is sent as soon as it is awaited with co_await.
+    /// The passed callback wrapper only has to contain the request configuration (requested keys, method name and parameters, provisioning credentials and the timeout),
+    /// because its response and timeout callbacks are replaced with ones that resume the awaiting coroutine
+    /// @tparam ResponseSize Capacity of the JsonDocument the response is copied into, has to contain the complete received response including its strings
+    /// @tparam RequestCallback Callback wrapper the request is sent with (Attribute_Request_Callback, RPC_Request_Callback, Provision_Callback)
+    /// @tparam RequestFunction Invocable that sends the request with the given callback and returns whether sending was successful,
+    /// for example a lambda calling Shared_Attributes_Request(), RPC_Request() or Provision_Request() on the used API implementation
+    /// @param callback Callback wrapper containing the request configuration, is copied into the awaiting coroutine frame
+    /// @param request Invocable that sends the request with the given callback
+    /// @return Awaitable that results in the Coroutine_Response once it has been awaited
+    template <size_t ResponseSize, typename RequestCallback, typename RequestFunction>
+    Awaitable<ResponseSize, RequestCallback, RequestFunction> Request(RequestCallback const & callback, RequestFunction request) {
+        return Awaitable<ResponseSize, RequestCallback, RequestFunction>(*this, callback, request);
+    }
+
+    /// @brief Resumes all coroutines whose awaited request received its response or timed out,
+    /// should be called regularly after the loop() method of the ThingsBoard client, because that method receives the responses
+    void loop() {
+        for (size_t i = 0U; i < MaxRequests; ++i) {
+            Request_Slot & slot = m_requests[i];
+            Request_State const state = Get_State(slot.status.load(std::memory_order_acquire));
+            if (state != Request_State::RECEIVED && state != Request_State::TIMED_OUT) {
+                continue;
+            }
+            // Resuming can acquire a new request slot, which is only resumed once its own request has completed, therefore continuing the iteration is safe
+            std::coroutine_handle<> const handle = slot.handle;
+            slot.handle = nullptr;
+            handle.resume();
+        }
+    }
+
+    /// @brief Gets the amount of requests that are currently awaited
+    /// @return Amount of acquired request slots
+    size_t Pending() const {
+        size_t pending = 0U;
+        for (auto const & slot : m_requests) {
+            if (Get_State(slot.status.load(std::memory_order_acquire)) != Request_State::FREE) {
+                ++pending;
+            }
+        }
+        return pending;
+    }
+
+  private:
+    /// @brief Request slot that connects a pending request with the coroutine awaiting it
+    struct Request_Slot {
+        std::coroutine_handle<> handle = {};  // Handle of the awaiting coroutine
+        JsonDocument            *target = {}; // Document in the awaiting coroutine frame, the response is copied into
+        std::atomic<uint32_t>   status = {};  // Generation of the slot and its current state
+    };
+
+    /// @brief Gets the state contained in the given status
+    /// @param status Status of a request slot
+    /// @return State of the request slot
+    static Request_State Get_State(uint32_t const & status) {
+        return static_cast<Request_State>(status & 0xFFU);
+    }
+
+    /// @brief Creates the status of a request slot from the given generation and state
+    /// @param generation Generation of the request slot
+    /// @param state State of the request slot
+    /// @return Combined status
+    static uint32_t Make_Status(uint32_t const & generation, Request_State const & state) {
+        return (generation << 8U) | static_cast<uint8_t>(state);
+    }
+
+    /// @brief Acquires a free request slot for the given coroutine
+    /// @param handle Handle of the awaiting coroutine
+    /// @param target Document the response should be copied into
+    /// @param index Index of the acquired request slot
+    /// @param generation Generation of the acquired request slot
+    /// @return Whether a free request slot was acquired or not
+    bool Acquire(std::coroutine_handle<> const & handle, JsonDocument & target, size_t & index, uint32_t & generation) {
+        for (size_t i = 0U; i < MaxRequests; ++i) {
+            Request_Slot & slot = m_requests[i];
+            uint32_t const status = slot.status.load(std::memory_order_acquire);
+            if (Get_State(status) != Request_State::FREE) {
+                continue;
+            }
+            slot.handle = handle;
+            slot.target = &target;
+            index = i;
+            generation = status >> 8U;
+            slot.status.store(Make_Status(generation, Request_State::PENDING), std::memory_order_release);
+            return true;
+        }
+        Logger::printfln(COROUTINE_REQUESTS_EXHAUSTED, MaxRequests);
+        return false;
+    }
+
+    /// @brief Releases the given request slot and increases its generation, so that late callbacks of the released request are ignored
+    /// @param index Index of the request slot
+    /// @return State the request slot was in before it was released
+    Request_State Release(size_t const & index) {
+        Request_Slot & slot = m_requests[index];
+        uint32_t const status = slot.status.exchange(Make_Status((slot.status.load(std::memory_order_relaxed) >> 8U) + 1U, Request_State::FREE), std::memory_order_acq_rel);
+        slot.handle = nullptr;
+        slot.target = nullptr;
+        return Get_State(status);
+    }
+
+    /// @brief Copies the received response into the awaiting coroutine frame, if the request is still pending
+    /// @tparam TSource Type of the received response (JsonObjectConst, JsonDocument)
+    /// @param index Index of the request slot
+    /// @param generation Generation of the request slot the request was sent with
+    /// @param data Received response
+    template <typename TSource>
+    void Complete(size_t const & index, uint32_t const & generation, TSource const & data) {
+        Request_Slot & slot = m_requests[index];
+        uint32_t expected = Make_Status(generation, Request_State::PENDING);
+        if (!slot.status.compare_exchange_strong(expected, Make_Status(generation, Request_State::COMPLETING), std::memory_order_acq_rel)) {
+            return;
+        }
+        (void)slot.target->set(data);
+        slot.status.store(Make_Status(generation, Request_State::RECEIVED), std::memory_order_release);
+    }
+
+    /// @brief Marks the request as timed out, if it is still pending. Can be called from the timer task when using the ESP Timer
+    /// @param index Index of the request slot
+    /// @param generation Generation of the request slot the request was sent with
+    void Time_Out(size_t const & index, uint32_t const & generation) {
+        uint32_t expected = Make_Status(generation, Request_State::PENDING);
+        (void)m_requests[index].status.compare_exchange_strong(expected, Make_Status(generation, Request_State::TIMED_OUT), std::memory_order_acq_rel);
+    }
+
+    Request_Slot m_requests[MaxRequests] = {}; // Slots of the requests that are currently awaited
+};
+
+#endif // THINGSBOARD_ENABLE_CXX20
+
+#endif // Coroutine_Driver_h
@@ -7,11 +7,16 @@
 #if THINGSBOARD_USE_ESP_MQTT
 
 // Local includes.
+#include "Constants.h"
 #include "IMQTT_Client.h"
 
 // Library includes.
 #include <mqtt_client.h>
 #include <esp_crt_bundle.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <lwip/netdb.h>
+#include <lwip/sockets.h>
+#endif // ESP_IDF_VERSION_MAJOR >= 5
 
 // The error integer -1 means a general failure while handling the mqtt client,
 // where as -2 means that the outbox is filled and the message can therefore not be sent.
@@ -19,6 +24,7 @@
 // to ensure other errors are indentified as well
 constexpr int MQTT_FAILURE_MESSAGE_ID = -1;
 constexpr char MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char MQTT_STREAM_TOPIC_TOO_LONG[] = "Received topic length (%u) is bigger than the maximum streamed topic size (%u), increase Default_Stream_Topic_Size accordingly";
 #if THINGSBOARD_ENABLE_DEBUG
 constexpr char RECEIVED_MQTT_EVENT[] = "Handling received mqtt event: (%s)";
 constexpr char UPDATING_CONFIGURATION[] = "Updated configuration after inital connection with response: (%s)";
@@ -38,8 +44,23 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     Espressif_MQTT_Client()
       : m_received_data_callback()
       , m_connected_callback()
+      , m_stream_filter_callback()
+      , m_stream_callback()
+      , m_stream_topic()
+      , m_stream_active(false)
       , m_connected(false)
+      , m_session_present(false)
       , m_enqueue_messages(false)
+#if ESP_IDF_VERSION_MAJOR >= 5
+      , m_cache_dns_result(false)
+      , m_resolved_domain(nullptr)
+      , m_resolved_address()
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+#if ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+      , m_mqtt_5(false)
+      , m_topic_aliases()
+      , m_topic_alias_amount(0U)
+#endif // ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
       , m_mqtt_configuration()
       , m_mqtt_client(nullptr)
     {
@@ -155,6 +176,20 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return update_configuration();
     }
 
+    /// @brief Wheter to disable or enable the clean session flag when connecting to the server. The default is false meaning the broker discards the session state and all subscriptions once we disconnect.
+    /// Disabling it allows the broker to keep the subscriptions over reconnects, if the broker then reports that the session is still present after reconnecting,
+    /// the ThingsBoard client skips resubscribing all topics, which reduces the load on the broker if a lot of devices reconnect at once, for example after a broker restart
+    /// @param disable_clean_session Whether to connect without the clean session flag set
+    /// @return Whether enabling or disabling the clean session flag was successful or not
+    bool set_disable_clean_session(bool disable_clean_session) {
+#if ESP_IDF_VERSION_MAJOR < 5
+        m_mqtt_configuration.disable_clean_session = disable_clean_session;
+#else
+        m_mqtt_configuration.session.disable_clean_session = disable_clean_session;
+#endif // ESP_IDF_VERSION_MAJOR < 5
+        return update_configuration();
+    }
+
     /// @brief Sets the priority and stack size of the MQTT task running in the background, that is handling the receiving and sending of any outstanding MQTT messages to or from the broker.
     /// The default value for the priority is 5 and can also be changed in the ESP IDF menuconfig, whereas the default value for the stack size is 6144 bytes and can also be changed in the ESP IDF menuconfig
     /// @param priority Task priority with which the MQTT task should run, higher priority means it takes more precedence over other tasks, making it more important
@@ -210,6 +245,39 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_enqueue_messages = enqueue_messages;
     }
 
+#if ESP_IDF_VERSION_MAJOR >= 5
+    /// @brief Sets whether to cache the resolved address of the server domain or not. The default is false meaning the esp-mqtt client resolves the domain with DNS for every connection attempt.
+    /// Caching the result allows to skip the DNS lookup when reconnecting, which reduces the time it takes to reconnect and the load on the DNS server if a lot of devices reconnect at once.
+    /// If TLS / SSL is used the certificate is still verified against the original domain, the cached address is discarded if connecting to it fails
+    /// @param cache_dns_result Whether to cache the resolved address of the server domain or not
+    void set_cache_dns_result(bool cache_dns_result) {
+        m_cache_dns_result = cache_dns_result;
+        m_resolved_domain = nullptr;
+    }
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+
+#if ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+    /// @brief Sets whether to connect with MQTT 5 instead of MQTT 3.1.1, the default is false. Allows to send the topics passed to set_topic_aliases() with a topic alias,
+    /// meaning only the first message over every connection contains the complete topic, which saves the bytes of the topic for every following message.
+    /// Requires MQTT 5 support to be enabled in the esp-mqtt component configuration (CONFIG_MQTT_PROTOCOL_5) and a server that supports MQTT 5 and allows topic aliases.
+    /// Has to be called before initally calling connect() on the client to take effect for the first connection
+    /// @param mqtt_5 Whether to connect with MQTT 5 or not
+    void set_mqtt_5(bool mqtt_5) {
+        m_mqtt_5 = mqtt_5;
+        m_mqtt_configuration.session.protocol_ver = mqtt_5 ? esp_mqtt_protocol_ver_t::MQTT_PROTOCOL_V_5 : esp_mqtt_protocol_ver_t::MQTT_PROTOCOL_V_3_1_1;
+        (void)update_configuration();
+    }
+
+    bool set_topic_aliases(char const * const * topics, size_t const & topic_amount) override {
+        // Additional topics are sent without a topic alias, because the esp-mqtt client only allows as many topic aliases as the server announced
+        m_topic_alias_amount = topic_amount < Default_Topic_Alias_Amount ? topic_amount : Default_Topic_Alias_Amount;
+        for (size_t i = 0U; i < m_topic_alias_amount; ++i) {
+            m_topic_aliases[i] = topics[i];
+        }
+        return true;
+    }
+#endif // ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+
     void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
         m_received_data_callback.Set_Callback(callback);
     }
@@ -232,6 +300,7 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         // If the mqtt client is reinitalized this causes disconnected and reconnects tough and the connection becomes unstable.
         // Therefore this workaround can also not be used. Instead we expect the esp_mqtt_set_config(), to do what the name implies and therefore still call it
         // and created an issue revolving around the aformentioned problem so it might get fixed in future version of the esp_mqtt client.
+        // Increasing the buffer is not required for firmware updates though, because messages that do not fit are streamed, see set_stream_callback()
         // See https://github.com/espressif/esp-mqtt/issues/267 for more information on the issue 
         return update_configuration();
     }
@@ -260,8 +329,10 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         // it is to late as we attempt to establish the connection in the connect() method which is called directly after this one.
         bool const transport_over_sll = m_mqtt_configuration.cert_pem != nullptr || m_mqtt_configuration.crt_bundle_attach != nullptr;
 #else
-        m_mqtt_configuration.broker.address.hostname = domain;
+        m_mqtt_configuration.broker.address.hostname = resolve_domain(domain);
         m_mqtt_configuration.broker.address.port = port;
+        // Ensures the certificate is still verified against the original domain, if we connect to the cached address directly
+        m_mqtt_configuration.broker.verification.common_name = (m_mqtt_configuration.broker.address.hostname != domain ? domain : nullptr);
         // Decide transport depending on if a certificate was passed, because the set_server() method is called in the connect method meaning if the certificate has not been set yet,
         // it is to late as we attempt to establish the connection in the connect() method which is called directly after this one.
         bool const transport_over_sll = m_mqtt_configuration.broker.verification.certificate != nullptr || m_mqtt_configuration.broker.verification.crt_bundle_attach != nullptr;
@@ -320,6 +391,9 @@ class Espressif_MQTT_Client : public IMQTT_Client {
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
         int message_id = MQTT_FAILURE_MESSAGE_ID;
+#if ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+        set_publish_topic_alias(topic);
+#endif // ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
 
         if (m_enqueue_messages) {
             message_id = esp_mqtt_client_enqueue(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, 0U, 0U, true);
@@ -346,6 +420,29 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return message_id > MQTT_FAILURE_MESSAGE_ID;
     }
 
+    bool subscribe(char const * const * topics, size_t const & topic_amount) override {
+        if (!connected()) {
+            return false;
+        }
+#if ESP_IDF_VERSION_MAJOR > 5 || (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 1)
+        // Sending multiple topic filters in one SUBSCRIBE packet is only supported with Espressif IDF v5.1 and newer
+        esp_mqtt_topic_t topic_list[topic_amount] = {};
+        for (size_t i = 0U; i < topic_amount; ++i) {
+            topic_list[i].filter = topics[i];
+            topic_list[i].qos = 0;
+        }
+        int const message_id = esp_mqtt_client_subscribe_multiple(m_mqtt_client, topic_list, topic_amount);
+        return message_id > MQTT_FAILURE_MESSAGE_ID;
+#else
+        for (size_t i = 0U; i < topic_amount; ++i) {
+            if (!subscribe(topics[i])) {
+                return false;
+            }
+        }
+        return true;
+#endif // ESP_IDF_VERSION_MAJOR > 5 || (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 1)
+    }
+
     bool unsubscribe(char const * topic) override {
         // The esp_mqtt_client_unsubscribe method does not return false, if we send a unsubscribe request while not being connected to a broker,
         // so we have to check for that case to ensure the end user is informed that their unsubscribe request could not be sent and has been ignored.
@@ -360,6 +457,32 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return m_connected;
     }
 
+    bool get_session_present() override {
+        return m_session_present;
+    }
+
+    bool set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) override {
+        // The esp-mqtt client already splits messages that do not fit into its receive buffer into multiple data events, which only have to be passed on as slices
+        m_stream_filter_callback.Set_Callback(filter_callback);
+        m_stream_callback.Set_Callback(stream_callback);
+        return true;
+    }
+
+    uint32_t get_next_deadline() override {
+        // Receiving, sending and keeping the connection alive is handled by the task of the esp mqtt client, therefore loop() never has to be called for the client itself
+        return UINT32_MAX;
+    }
+
+    size_t get_outbox_size() override {
+#if ESP_IDF_VERSION_MAJOR >= 5
+        // Messages published with esp_mqtt_client_publish() are sent directly and only enqueued messages wait in the outbox, which is sent in order by the task of the esp mqtt client
+        int const size = esp_mqtt_client_get_outbox_size(m_mqtt_client);
+        return size > 0 ? static_cast<size_t>(size) : 0U;
+#else
+        return 0U;
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+    }
+
 private:
     /// @brief Is internally used to allow changes to the underlying configuration of the esp_mqtt_client_handle_t after it has connected,
     /// to for example increase the buffer size or increase the timeouts or stack size, allows to change the underlying client configuration,
@@ -379,6 +502,61 @@ private:
         return error == ESP_OK;
     }
 
+#if ESP_IDF_VERSION_MAJOR >= 5
+    /// @brief Resolves the given domain to its IPv4 address once and returns the cached address for all further calls with the same domain,
+    /// if caching the DNS result has been enabled with set_cache_dns_result()
+    /// @param domain Server instance name the client should connect too
+    /// @return Cached address of the given domain or the domain itself, if caching is disabled or resolving the domain failed
+    char const * resolve_domain(char const * domain) {
+        if (!m_cache_dns_result || domain == nullptr) {
+            return domain;
+        }
+        else if (m_resolved_domain != nullptr && strcmp(m_resolved_domain, domain) == 0) {
+            return m_resolved_address;
+        }
+
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo * result = nullptr;
+        if (getaddrinfo(domain, nullptr, &hints, &result) != 0 || result == nullptr) {
+            return domain;
+        }
+        sockaddr_in const * address = reinterpret_cast<sockaddr_in const *>(result->ai_addr);
+        char const * const converted = inet_ntoa_r(address->sin_addr, m_resolved_address, sizeof(m_resolved_address));
+        freeaddrinfo(result);
+        if (converted == nullptr) {
+            return domain;
+        }
+        m_resolved_domain = domain;
+        return m_resolved_address;
+    }
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+
+#if ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+    /// @brief Sets the publish properties of the next message to the topic alias of the given topic, or to no topic alias if the topic is not sent with one.
+    /// The esp-mqtt client keeps the topics of all aliases used over the current connection and only sends the complete topic together with the alias the first time,
+    /// the properties have to be set before every message though, because they are kept for all following messages
+    /// @param topic Topic that the next message is sent over
+    void set_publish_topic_alias(char const * topic) {
+        if (!m_mqtt_5) {
+            return;
+        }
+        esp_mqtt5_publish_property_config_t property = {};
+        for (size_t i = 0U; i < m_topic_alias_amount; ++i) {
+            if (strcmp(m_topic_aliases[i], topic) == 0) {
+                property.topic_alias = i + 1U;
+                break;
+            }
+        }
+        // Setting the properties fails if the topic alias is bigger than the topic alias maximum announced by the server, in which case the complete topic is sent instead
+        if (esp_mqtt5_client_set_publish_property(m_mqtt_client, &property) != ESP_OK) {
+            property.topic_alias = 0U;
+            (void)esp_mqtt5_client_set_publish_property(m_mqtt_client, &property);
+        }
+    }
+#endif // ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+
 #if THINGSBOARD_ENABLE_DEBUG
     const char * esp_event_id_to_name(const esp_mqtt_event_id_t& event_id) const {
         switch (event_id) {
@@ -421,16 +599,26 @@ private:
         switch (event_id) {
             case esp_mqtt_event_id_t::MQTT_EVENT_CONNECTED:
                 m_connected = true;
+                m_session_present = event->session_present != 0;
                 m_connected_callback.Call_Callback();
                 break;
             case esp_mqtt_event_id_t::MQTT_EVENT_DISCONNECTED:
                 m_connected = false;
                 break;
+#if ESP_IDF_VERSION_MAJOR >= 5
+            case esp_mqtt_event_id_t::MQTT_EVENT_ERROR:
+                // Discard the cached address if the transport failed, because the address of the server might have changed,
+                // the domain is then resolved again the next time connect is called
+                if (event->error_handle != nullptr && event->error_handle->error_type == esp_mqtt_error_type_t::MQTT_ERROR_TYPE_TCP_TRANSPORT) {
+                    m_resolved_domain = nullptr;
+                }
+                break;
+#endif // ESP_IDF_VERSION_MAJOR >= 5
             case esp_mqtt_event_id_t::MQTT_EVENT_DATA: {
-                // Check wheter the given message has not bee received completly, but instead would be received in multiple chunks,
-                // if it were we discard the message because receiving a message over multiple chunks is currently not supported
+                // Check wheter the given message has not bee received completly, but instead is received in multiple data events, because it did not fit into the receive buffer,
+                // if it is we pass it on as slices if it should be streamed or discard it otherwise
                 if (event->data_len != event->total_data_len) {
-                    Logger::printfln(MQTT_DATA_EXCEEDS_BUFFER, event->total_data_len, get_receive_buffer_size());
+                    handle_fragmented_data(event);
                     break;
                 }
                 // Topic is not null terminated, to fix this issue we copy the topic string.
@@ -446,6 +634,36 @@ private:
         }
     }
 
+    /// @brief Handles a data event that only contains part of the received message, because the esp-mqtt client receives messages that do not fit into the receive buffer in multiple data events.
+    /// The topic is only contained in the first data event of the message, therefore it is copied and reused for all following data events of the same message
+    /// @param event Data event containing the current fragment of the received message
+    void handle_fragmented_data(esp_mqtt_event_handle_t const & event) {
+        size_t const offset = event->current_data_offset;
+        size_t const total_length = event->total_data_len;
+        if (offset == 0U) {
+            m_stream_active = false;
+            if (static_cast<size_t>(event->topic_len) >= sizeof(m_stream_topic)) {
+                Logger::printfln(MQTT_STREAM_TOPIC_TOO_LONG, event->topic_len, sizeof(m_stream_topic));
+                return;
+            }
+            (void)strncpy(m_stream_topic, event->topic, event->topic_len);
+            m_stream_topic[event->topic_len] = '\0';
+            m_stream_active = m_stream_filter_callback.Call_Callback(m_stream_topic);
+            if (!m_stream_active) {
+                Logger::printfln(MQTT_DATA_EXCEEDS_BUFFER, event->total_data_len, get_receive_buffer_size());
+                return;
+            }
+        }
+
+        if (!m_stream_active) {
+            return;
+        }
+        m_stream_callback.Call_Callback(m_stream_topic, reinterpret_cast<uint8_t*>(event->data), event->data_len, offset, total_length);
+        if (offset + event->data_len >= total_length) {
+            m_stream_active = false;
+        }
+    }
+
     static void static_mqtt_event_handler(void * handler_args, esp_event_base_t base, int32_t event_id, void * event_data) {
         if (handler_args == nullptr) {
             return;
@@ -456,8 +674,23 @@ private:
 
     Callback<void, char *, uint8_t *, unsigned int> m_received_data_callback = {}; // Callback that will be called as soon as the mqtt client receives any data
     Callback<void>                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
+    Callback<bool, char const *>                    m_stream_filter_callback = {}; // Callback that decides whether the payload of messages that do not fit into the receive buffer is streamed or discarded
+    Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &> m_stream_callback = {}; // Callback that will be called with every fragment of streamed messages
+    char                                            m_stream_topic[Default_Stream_Topic_Size] = {}; // Topic of the currently streamed message, because only the first data event of a message contains it
+    bool                                            m_stream_active = {};          // Whether the fragments of the currently received message are streamed or discarded
     bool                                            m_connected = {};              // Whether the client has received the connected or disconnected event
+    bool                                            m_session_present = {};        // Whether the broker still held the session state of the previous connection in the last connected event
     bool                                            m_enqueue_messages = {};       // Whether we enqueue messages making nearly all ThingsBoard calls non blocking or wheter we publish instead
+#if ESP_IDF_VERSION_MAJOR >= 5
+    bool                                            m_cache_dns_result = {};       // Whether the resolved address of the server domain is cached or resolved again for every connection attempt
+    char const                                      *m_resolved_domain = {};       // Domain the cached address has been resolved for, nullptr if no address is cached
+    char                                            m_resolved_address[INET_ADDRSTRLEN] = {}; // Cached IPv4 address of the server domain
+#endif // ESP_IDF_VERSION_MAJOR >= 5
+#if ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
+    bool                                            m_mqtt_5 = {};                 // Whether the client connects with MQTT 5 and sends the topics passed to set_topic_aliases() with a topic alias
+    char const                                      *m_topic_aliases[Default_Topic_Alias_Amount] = {}; // Topics sent with a topic alias, the alias of every topic is its index + 1
+    size_t                                          m_topic_alias_amount = {};     // Amount of topics sent with a topic alias
+#endif // ESP_IDF_VERSION_MAJOR >= 5 && CONFIG_MQTT_PROTOCOL_5
     esp_mqtt_client_config_t                        m_mqtt_configuration = {};     // Configuration of the underlying mqtt client, saved as a private variable to allow changes after inital configuration with the same options for all non changed settings
     esp_mqtt_client_handle_t                        m_mqtt_client = {};            // Handle to the underlying mqtt client, used to establish the communication
 };
@@ -11,41 +11,129 @@
 
 // Library include.
 #include <esp_ota_ops.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 constexpr char INVALID_OTA_PARTIION[] = "The running partition and the parition we wanted to boot into were not the same meaning the previous update failed and choose the fallback partition instead";
 constexpr char MISSING_OTA_APP[] = "Missing second ota app or app was invalid";
 constexpr char BEGIN_UPDATE_FAILED[] = "Beginning update failed with error reason (%s)";
+constexpr char PRE_ERASE_FAILED[] = "Erasing the update partition in the background failed with error reason (%s)";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char PRE_ERASE_PROGRESS[] = "Update partition was pre-erased up to (%u) of the required (%u) bytes";
+#endif // THINGSBOARD_ENABLE_DEBUG
+// Size of a single flash sector, which is the smallest region that can be erased, is the same for every flash chip supported by Espressif
+constexpr size_t FLASH_SECTOR_SIZE = 4096U;
+// Stack size and priority of the task erasing the update partition in the background, the priority is just above the idle task, so the erase only uses otherwise unused time
+constexpr uint32_t ERASE_TASK_STACK_SIZE = 2048U;
+constexpr UBaseType_t ERASE_TASK_PRIORITY = tskIDLE_PRIORITY + 1U;
 
 
 /// @brief IUpdater implementation that uses the Over the Air Update API from Espressif (https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/system/ota.html)
-/// under the hood to write the given binary firmware data into flash memory so we can restart with newly received firmware
+/// under the hood to write the given binary firmware data into flash memory so we can restart with newly received firmware.
+/// Per default the complete region the firmware is written into is erased at once when the first firmware packet is received, which blocks for multiple seconds on big partitions
+/// and can cause the connection to the server to time out. Therefore the region can alternatively be erased sector by sector directly before it is written (set_sequential_erase())
+/// or in a low priority background task as soon as the update is started (set_background_erase()), while the first firmware packet is still being requested
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
 template <typename Logger = DefaultLogger>
 class Espressif_Updater : public IUpdater {
   public:
     Espressif_Updater() = default;
 
-    bool begin(size_t const & firmware_size) override {
-        esp_partition_t const * running = esp_ota_get_running_partition();
-        esp_partition_t const * configured = esp_ota_get_boot_partition();
+    /// @brief Destructor, waits until a still running background erase has been stopped, because the task accesses the members of this instance
+    ~Espressif_Updater() {
+        (void)Stop_Background_Erase();
+        if (m_erase_finished != nullptr) {
+            vSemaphoreDelete(m_erase_finished);
+        }
+    }
 
-        if (configured != running) {
-            Logger::printfln(INVALID_OTA_PARTIION);
-            return false;
+    /// @brief Sets whether the region the firmware is written into is erased sector by sector directly before each sector is written, instead of completly when the first firmware packet is received.
+    /// Spreads the time needed to erase the region over all firmware packets, which keeps every single write short enough to not block the connection to the server.
+    /// Requires Espressif IDF v4.3 or newer (OTA_WITH_SEQUENTIAL_WRITES), on older versions the region is still erased completly
+    /// @param sequential_erase Whether the region is erased sequentially or not, default = false
+    void set_sequential_erase(bool sequential_erase) {
+        m_sequential_erase = sequential_erase;
+    }
+
+    /// @brief Sets whether the region the firmware is written into is erased in a low priority background task as soon as the update is started, while the first firmware packet is still being requested.
+    /// If the background erase finished the region before the first firmware packet has been received, begin() does not have to erase anything anymore, otherwise the background erase is stopped
+    /// and the region is erased sequentially instead, even if that was not enabled with set_sequential_erase(). Only on Espressif IDF versions older than v4.3 (without OTA_WITH_SEQUENTIAL_WRITES),
+    /// the remaining part of the region has to be erased at once, which still blocks for multiple seconds if the background erase did not get far, therefore it alone does not prevent that stall there
+    /// @param background_erase Whether the region is erased in the background or not, default = false
+    void set_background_erase(bool background_erase) {
+        m_background_erase = background_erase;
+    }
+
+    void prepare(size_t const & firmware_size) override {
+        if (!m_background_erase || m_erase_task != nullptr) {
+            return;
+        }
+        esp_partition_t const * update_partition = Get_Update_Partition();
+        if (update_partition == nullptr) {
+            return;
+        }
+        if (m_erase_finished == nullptr) {
+            m_erase_finished = xSemaphoreCreateBinary();
+            if (m_erase_finished == nullptr) {
+                return;
+            }
         }
 
-        esp_partition_t const * update_partition = esp_ota_get_next_update_partition(nullptr);
+        m_erase_partition = update_partition;
+        m_erase_size = Get_Erase_Size(update_partition, firmware_size);
+        m_erased_bytes = 0U;
+        m_stop_erase = false;
+        if (xTaskCreate(&Espressif_Updater::Erase_Task, "tb_ota_erase", ERASE_TASK_STACK_SIZE, this, ERASE_TASK_PRIORITY, &m_erase_task) != pdPASS) {
+            m_erase_task = nullptr;
+            m_erase_partition = nullptr;
+        }
+    }
 
+    bool begin(size_t const & firmware_size) override {
+        size_t const erased_bytes = Stop_Background_Erase();
+        esp_partition_t const * update_partition = Get_Update_Partition();
         if (update_partition == nullptr) {
-            Logger::printfln(MISSING_OTA_APP);
             return false;
         }
 
+        // The background erase always starts at the beginning of the partition, any partition other than the one that was erased has not been erased yet
+        size_t const pre_erased_bytes = (update_partition == m_erase_partition) ? erased_bytes : 0U;
+        size_t const erase_size = Get_Erase_Size(update_partition, firmware_size);
+        m_erase_partition = nullptr;
+#if THINGSBOARD_ENABLE_DEBUG
+        if (m_background_erase) {
+            Logger::printfln(PRE_ERASE_PROGRESS, pre_erased_bytes, erase_size);
+        }
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        // esp_ota_begin() always erases the region of the given image size, therefore once the region has been pre-erased, only the size of the first sector is passed,
+        // which erases the already erased first sector again, while every following write goes into the pre-erased region
+        size_t image_size = firmware_size;
+        if (firmware_size != 0U && pre_erased_bytes >= erase_size) {
+            image_size = FLASH_SECTOR_SIZE;
+        }
+#ifdef OTA_WITH_SEQUENTIAL_WRITES
+        // A partially finished background erase continues sequentially as well, because erasing the remaining region at once would block just as long as not pre-erasing at all.
+        // Sectors that were already pre-erased are simply erased again when they are written, which is cheap compared to the stall
+        else if (m_sequential_erase || m_background_erase) {
+            image_size = OTA_WITH_SEQUENTIAL_WRITES;
+        }
+#endif // OTA_WITH_SEQUENTIAL_WRITES
+        else if (firmware_size != 0U && pre_erased_bytes > 0U) {
+            esp_err_t const error = esp_partition_erase_range(update_partition, pre_erased_bytes, erase_size - pre_erased_bytes);
+            if (error != ESP_OK) {
+                Logger::printfln(BEGIN_UPDATE_FAILED, esp_err_to_name(error));
+                return false;
+            }
+            image_size = FLASH_SECTOR_SIZE;
+        }
+
         // Temporary handle is used, because it allows using a void* as the actual ota_handle,
         // allowing us to only include the esp_ota_ops header in the defintion (.cpp) file,
         // instead of also needing to declare it in the declaration (.h) header file
         esp_ota_handle_t ota_handle;
-        esp_err_t const error = esp_ota_begin(update_partition, firmware_size, &ota_handle);
+        esp_err_t const error = esp_ota_begin(update_partition, image_size, &ota_handle);
 
         if (error != ESP_OK) {
             Logger::printfln(BEGIN_UPDATE_FAILED, esp_err_to_name(error));
@@ -64,6 +152,8 @@ class Espressif_Updater : public IUpdater {
     }
 
     void reset() override {
+        (void)Stop_Background_Erase();
+        m_erase_partition = nullptr;
 #if defined(ESP8266) || (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR < 3) || ESP_IDF_VERSION_MAJOR < 4
         (void)end();
 #else
@@ -82,8 +172,75 @@ class Espressif_Updater : public IUpdater {
     }
 
   private:
+    /// @brief Gets the non active OTA partition the firmware is written into, if the currently running partition is the one that was configured to boot into
+    /// @return Partition the firmware is written into or nullptr if the previous update failed or there is no second OTA partition
+    esp_partition_t const * Get_Update_Partition() const {
+        esp_partition_t const * running = esp_ota_get_running_partition();
+        esp_partition_t const * configured = esp_ota_get_boot_partition();
+
+        if (configured != running) {
+            Logger::printfln(INVALID_OTA_PARTIION);
+            return nullptr;
+        }
+
+        esp_partition_t const * update_partition = esp_ota_get_next_update_partition(nullptr);
+
+        if (update_partition == nullptr) {
+            Logger::printfln(MISSING_OTA_APP);
+        }
+        return update_partition;
+    }
+
+    /// @brief Gets the size of the region that has to be erased to write the given amount of bytes, which is rounded up to the next flash sector
+    /// @param partition Partition the firmware is written into, the region is never bigger than the partition itself
+    /// @param firmware_size Total size of the data that will be written, 0 if unknown, in which case the complete partition has to be erased
+    /// @return Size of the region that has to be erased in bytes
+    static size_t Get_Erase_Size(esp_partition_t const * partition, size_t const & firmware_size) {
+        size_t const aligned_size = (firmware_size + FLASH_SECTOR_SIZE - 1U) & ~(FLASH_SECTOR_SIZE - 1U);
+        return (firmware_size == 0U || aligned_size > partition->size) ? partition->size : aligned_size;
+    }
+
+    /// @brief Stops a still running background erase and waits until the task has finished erasing its current sector
+    /// @return Amount of bytes from the start of the partition that have been erased by the background erase, 0 if none was started
+    size_t Stop_Background_Erase() {
+        if (m_erase_task == nullptr) {
+            return 0U;
+        }
+        m_stop_erase = true;
+        (void)xSemaphoreTake(m_erase_finished, portMAX_DELAY);
+        m_erase_task = nullptr;
+        return m_erased_bytes;
+    }
+
+    /// @brief Erases the region of the update partition sector by sector in the background, until either the complete region has been erased or the erase has been stopped.
+    /// Erasing a single sector at a time, ensures the flash cache is only disabled for a short time and stopping the erase in begin() never waits for longer than one sector
+    /// @param parameter Instance of this class that started the task
+    static void Erase_Task(void * parameter) {
+        Espressif_Updater * updater = static_cast<Espressif_Updater *>(parameter);
+        while (!updater->m_stop_erase && updater->m_erased_bytes < updater->m_erase_size) {
+            esp_err_t const error = esp_partition_erase_range(updater->m_erase_partition, updater->m_erased_bytes, FLASH_SECTOR_SIZE);
+            if (error != ESP_OK) {
+                Logger::printfln(PRE_ERASE_FAILED, esp_err_to_name(error));
+                break;
+            }
+            updater->m_erased_bytes = updater->m_erased_bytes + FLASH_SECTOR_SIZE;
+            // Yield to allow the tasks of the same priority, like the idle task, to run between the sectors
+            taskYIELD();
+        }
+        (void)xSemaphoreGive(updater->m_erase_finished);
+        vTaskDelete(nullptr);
+    }
+
     uint32_t               m_ota_handle = {};       // ESP OTA hanle that is used to to access the underlying updater
     esp_partition_t const *m_update_partition = {}; // Non active OTA partition that we write our data into
+    bool                   m_sequential_erase = {}; // Whether the region is erased sector by sector directly before it is written or completly in begin()
+    bool                   m_background_erase = {}; // Whether the region is erased in a background task as soon as the update is started
+    TaskHandle_t           m_erase_task = {};       // Task that erases the region in the background, nullptr if no background erase is running
+    SemaphoreHandle_t      m_erase_finished = {};   // Given by the background erase task once it stopped erasing, allows to wait for it to finish its current sector
+    esp_partition_t const *m_erase_partition = {};  // Partition the background erase was started for, nullptr if none was started since the last update
+    size_t                 m_erase_size = {};       // Size of the region the background erase should erase in bytes
+    size_t volatile        m_erased_bytes = {};     // Amount of bytes from the start of the partition that have already been erased in the background
+    bool volatile          m_stop_erase = {};       // Whether the background erase should stop after the current sector
 };
 
 #endif // THINGSBOARD_USE_ESP_PARTITION
@@ -0,0 +1,182 @@
+#ifndef File_Firmware_Cache_h
+#define File_Firmware_Cache_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IFirmware_Cache.h"
+#include "DefaultLogger.h"
+#include "Helper.h"
+
+// Library includes.
+#include <stdio.h>
+#include <string.h>
+#if THINGSBOARD_USE_PROCESS_ID
+#include <unistd.h>
+#endif // THINGSBOARD_USE_PROCESS_ID
+
+
+// Paths of the committed firmware binaries and the binaries that are currently being stored.
+char constexpr FW_CACHE_FILE_PATH[] = "%s/%s.bin";
+char constexpr FW_CACHE_PART_PATH[] = "%s/%s.%ld.%p.part";
+char constexpr FW_CACHE_HEX_CHARACTERS[] = "0123456789abcdefABCDEF";
+// Maximum size of a stored checksum including the null terminator, big enough for the hex string of a SHA-512 hash.
+size_t constexpr FW_CACHE_MAX_CHECKSUM_SIZE = (64U * 2U) + 1U;
+// Log messages.
+char constexpr FW_CACHE_STORE_FAILED[] = "Failed to open temporary file in directory (%s) to store the downloaded firmware (%s), ensure the directory exists and is writable";
+char constexpr FW_CACHE_COMMIT_FAILED[] = "Failed to move the downloaded firmware (%s) into directory (%s)";
+
+
+/// @brief IFirmware_Cache implementation that uses the c file functions (https://cplusplus.com/reference/cstdio/), under the hood to store every firmware binary as a seperate file in the given directory,
+/// named after the checksum of the binary. Works with any file system that supports fopen(), rename() and remove(), like Linux, SD cards or the virtual file system of ESP-IDF.
+/// Binaries are first written into a temporary file that is unique for every instance of this class in every process, named after the process id and the address of the instance, and only renamed to their final name once they have been verified,
+/// which allows multiple instances, for example one per device behind a gateway, or even multiple processes to share the same directory,
+/// without any of them ever reading an incomplete binary. Every instance can only read and store one binary at once, therefore each update that runs at the same time requires its own instance
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Firmware_Cache : public IFirmware_Cache {
+  public:
+    /// @brief Constructor
+    /// @param directory Path of the directory the firmware binaries are stored in, without a trailing slash, has to exist already and the string is not copied and has to be kept alive for as long as the instance of this class
+    explicit File_Firmware_Cache(char const * directory)
+      : m_directory(directory)
+      , m_read_file(nullptr)
+      , m_read_position(0U)
+      , m_store_file(nullptr)
+      , m_store_checksum()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~File_Firmware_Cache() {
+        close();
+        end_store(false);
+    }
+
+    bool open(char const * checksum, size_t const & size) override {
+        close();
+        if (!Is_Valid_Checksum(checksum)) {
+            return false;
+        }
+        char path[Helper::detectSize(FW_CACHE_FILE_PATH, m_directory, checksum)] = {};
+        (void)snprintf(path, sizeof(path), FW_CACHE_FILE_PATH, m_directory, checksum);
+        m_read_file = fopen(path, "rb");
+        if (m_read_file == nullptr) {
+            return false;
+        }
+        // Entries with a different size can never be verified successfully, therefore they are handled as missing and overwritten by the next download
+        else if (fseek(m_read_file, 0L, SEEK_END) != 0 || static_cast<size_t>(ftell(m_read_file)) != size) {
+            close();
+            return false;
+        }
+        m_read_position = size;
+        return true;
+    }
+
+    size_t read(size_t const & offset, uint8_t * buffer, size_t const & length) override {
+        if (m_read_file == nullptr) {
+            return 0U;
+        }
+        // Chunks are read in order, therefore seeking is only required if a chunk is read again
+        else if (m_read_position != offset && fseek(m_read_file, static_cast<long>(offset), SEEK_SET) != 0) {
+            return 0U;
+        }
+        size_t const read_bytes = fread(buffer, 1U, length, m_read_file);
+        m_read_position = offset + read_bytes;
+        return read_bytes;
+    }
+
+    void close() override {
+        if (m_read_file == nullptr) {
+            return;
+        }
+        (void)fclose(m_read_file);
+        m_read_file = nullptr;
+    }
+
+    bool begin_store(char const * checksum, size_t const & size) override {
+        end_store(false);
+        if (!Is_Valid_Checksum(checksum) || strlen(checksum) >= sizeof(m_store_checksum)) {
+            return false;
+        }
+        (void)strncpy(m_store_checksum, checksum, sizeof(m_store_checksum));
+        long const process_id = Get_Process_Id();
+        char path[Helper::detectSize(FW_CACHE_PART_PATH, m_directory, m_store_checksum, process_id, static_cast<void const *>(this))] = {};
+        (void)snprintf(path, sizeof(path), FW_CACHE_PART_PATH, m_directory, m_store_checksum, process_id, static_cast<void const *>(this));
+        m_store_file = fopen(path, "wb");
+        if (m_store_file == nullptr) {
+            Logger::printfln(FW_CACHE_STORE_FAILED, m_directory, m_store_checksum);
+            return false;
+        }
+        return true;
+    }
+
+    size_t store(uint8_t const * payload, size_t const & length) override {
+        if (m_store_file == nullptr) {
+            return 0U;
+        }
+        return fwrite(payload, 1U, length, m_store_file);
+    }
+
+    void end_store(bool const & verified) override {
+        if (m_store_file == nullptr) {
+            return;
+        }
+        bool const closed = fclose(m_store_file) == 0;
+        m_store_file = nullptr;
+        long const process_id = Get_Process_Id();
+        char part_path[Helper::detectSize(FW_CACHE_PART_PATH, m_directory, m_store_checksum, process_id, static_cast<void const *>(this))] = {};
+        (void)snprintf(part_path, sizeof(part_path), FW_CACHE_PART_PATH, m_directory, m_store_checksum, process_id, static_cast<void const *>(this));
+        if (!verified || !closed) {
+            (void)::remove(part_path);
+            return;
+        }
+        char path[Helper::detectSize(FW_CACHE_FILE_PATH, m_directory, m_store_checksum)] = {};
+        (void)snprintf(path, sizeof(path), FW_CACHE_FILE_PATH, m_directory, m_store_checksum);
+        // Renaming replaces an entry committed by another instance in the meantime, which is identical, because it has the same checksum
+        if (rename(part_path, path) != 0) {
+            Logger::printfln(FW_CACHE_COMMIT_FAILED, m_store_checksum, m_directory);
+            (void)::remove(part_path);
+        }
+    }
+
+    void remove(char const * checksum) override {
+        if (!Is_Valid_Checksum(checksum)) {
+            return;
+        }
+        char path[Helper::detectSize(FW_CACHE_FILE_PATH, m_directory, checksum)] = {};
+        (void)snprintf(path, sizeof(path), FW_CACHE_FILE_PATH, m_directory, checksum);
+        (void)::remove(path);
+    }
+
+  private:
+    /// @brief Gets the id of the current process, which is part of the name of the temporary file, because the address of this instance alone is only unique inside of a single process
+    /// @return Id of the current process or 0 if processes do not exist on this device
+    static long Get_Process_Id() {
+#if THINGSBOARD_USE_PROCESS_ID
+        return static_cast<long>(getpid());
+#else
+        return 0L;
+#endif // THINGSBOARD_USE_PROCESS_ID
+    }
+
+    /// @brief Checks whether the given checksum only contains hex characters, which ensures it can be used as a file name without being able to reference any other directory
+    /// @param checksum Checksum that should be checked
+    /// @return Whether the checksum is a non-empty hex string or not
+    static bool Is_Valid_Checksum(char const * checksum) {
+        if (Helper::stringIsNullorEmpty(checksum)) {
+            return false;
+        }
+        return strspn(checksum, FW_CACHE_HEX_CHARACTERS) == strlen(checksum);
+    }
+
+    char const *m_directory = {};                        // Path of the directory the firmware binaries are stored in
+    FILE       *m_read_file = {};                        // Opened firmware binary that is currently being served, nullptr if none is opened
+    size_t     m_read_position = {};                     // Current position in the opened firmware binary, used to skip seeking while reading in order
+    FILE       *m_store_file = {};                       // Temporary file the firmware binary that is currently being stored is written into, nullptr if none is being stored
+    char       m_store_checksum[FW_CACHE_MAX_CHECKSUM_SIZE] = {}; // Checksum of the firmware binary that is currently being stored, used as the name of the committed file
+};
+
+#endif // File_Firmware_Cache_h
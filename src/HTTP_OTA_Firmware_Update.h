@@ -0,0 +1,454 @@
+#ifndef HTTP_OTA_Firmware_Update_h
+#define HTTP_OTA_Firmware_Update_h
+
+// Local includes.
+#include "OTA_Handler.h"
+#include "IHTTP_Client.h"
+#include "DefaultLogger.h"
+
+
+// HTTP firmware paths.
+char constexpr HTTP_FW_ATTRIBUTES_PATH[] = "/api/v1/%s/attributes?sharedKeys=fw_checksum,fw_checksum_algorithm,fw_size,fw_title,fw_version,fw_chunk_checksums,fw_chunk_checksums_size";
+char constexpr HTTP_FW_DOWNLOAD_PATH[] = "/api/v1/%s/firmware?title=%s&version=%s";
+char constexpr HTTP_FW_TELEMETRY_PATH[] = "/api/v1/%s/telemetry";
+char constexpr HTTP_FW_CONTENT_TYPE[] = "application/json";
+char constexpr HTTP_FW_SHARED_KEY[] = "shared";
+int constexpr HTTP_STATUS_OK = 200;
+int constexpr HTTP_STATUS_PARTIAL_CONTENT = 206;
+// Log messages.
+char constexpr FW_HTTP_REQUEST_FAILED[] = "Requesting firmware starting at byte (%u) failed with HTTP response (%d)";
+char constexpr FW_HTTP_ATTRIBUTES_FAILED[] = "Requesting shared attribute firmware keys failed with HTTP response (%d)";
+char constexpr FW_HTTP_POST_FAILED[] = "Sending firmware information failed with HTTP response (%d)";
+char constexpr FW_HTTP_BUFFER_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the firmware download buffer";
+char constexpr FW_HTTP_BODY_TOO_SHORT[] = "Received firmware binary with size (%u) is shorter than the expected size (%u)";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr DOWNLOADING_FW_HTTP[] = "Attempting to download over HTTP...";
+char constexpr FW_HTTP_STREAMING_UNSUPPORTED[] = "HTTP client does not support range requests, downloading the complete firmware binary into memory instead";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Handles the ThingsBoard over the air firmware update over HTTP(S) instead of MQTT, by downloading the complete firmware binary with a single streamed GET request.
+/// Compared to requesting every single chunk seperately over MQTT, this removes the request and response overhead of every chunk, which makes the download multiple times faster on most connections.
+/// The received firmware binary is processed by the same OTA_Handler as the MQTT update, meaning the firmware checksum, the optional chunk checksums, the IUpdater and the fw_state reporting work exactly the same.
+/// The only difference is that the chunk size configured in the OTA_Update_Callback is only the size of the buffer the streamed binary is read into, instead of the size of seperately requested packets.
+/// If reading a part of the firmware fails, the download is continued with a Range request starting at the first byte that has not been processed yet,
+/// servers that ignore the Range header are handled as well by skipping the already processed bytes of the response body.
+/// HTTP clients that do not support streaming the response body (IHTTP_Client::get_range()) instead receive the complete firmware binary into memory with IHTTP_Client::get_response_body(),
+/// which requires enough free heap memory for the complete binary and is therefore only suitable for small firmware binaries.
+/// Be aware that the update is blocking, meaning Start_Firmware_Update() only returns once the update has been completed or failed.
+/// See https://thingsboard.io/docs/reference/http-api/#firmware-api for more information
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class HTTP_OTA_Firmware_Update {
+  public:
+    /// @brief Constructor
+    /// @param client HTTP client that is already connected to the ThingsBoard server and should be used to download the firmware, has to be kept alive for as long as the instance of this class
+    /// @param access_token Token used to verify the devices identity with the ThingsBoard server, the string is not copied and has to be kept alive for as long as the instance of this class
+    HTTP_OTA_Firmware_Update(IHTTP_Client & client, char const * access_token)
+      : m_client(client)
+      , m_token(access_token)
+      , m_fw_callback()
+#if THINGSBOARD_ENABLE_STL
+      , m_ota(std::bind(&HTTP_OTA_Firmware_Update::Request_Chunk, this, std::placeholders::_1, std::placeholders::_2), std::bind(&HTTP_OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&HTTP_OTA_Firmware_Update::Finish_Firmware_Update, this), false)
+#else
+      , m_ota(HTTP_OTA_Firmware_Update::staticRequestChunk, HTTP_OTA_Firmware_Update::staticFirmwareSend, HTTP_OTA_Firmware_Update::staticFinish, false)
+#endif // THINGSBOARD_ENABLE_STL
+      , m_requested_chunk(0U)
+      , m_stream_offset(0U)
+      , m_stream_open(false)
+      , m_streaming_unsupported(false)
+      , m_finished(false)
+    {
+#if !THINGSBOARD_ENABLE_STL
+        m_subscribedInstance = this;
+#endif // !THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Requests the firmware information assigned to this device and if a firmware that is not already installed is assigned, downloads and flashes it.
+    /// Blocks until the update has been completed or failed, the result is passed to the finished callback of the given OTA_Update_Callback
+    /// @param callback Callback method that contains the configuration information and will be called once the update has finished
+    /// @return Whether an update was started or not, false if no new firmware is assigned or the firmware information could not be requested
+    bool Start_Firmware_Update(OTA_Update_Callback const & callback) {
+        char const * current_fw_title = callback.Get_Firmware_Title();
+        char const * current_fw_version = callback.Get_Firmware_Version();
+        if (Helper::stringIsNullorEmpty(current_fw_title) || Helper::stringIsNullorEmpty(current_fw_version) || m_token == nullptr || callback.Get_Chunk_Size() == 0U) {
+            return false;
+        }
+        (void)Firmware_Send_Info(current_fw_title, current_fw_version);
+        m_fw_callback = callback;
+
+        char attributes_path[Helper::detectSize(HTTP_FW_ATTRIBUTES_PATH, m_token)] = {};
+        (void)snprintf(attributes_path, sizeof(attributes_path), HTTP_FW_ATTRIBUTES_PATH, m_token);
+        int status = 0;
+        bool const success = m_client.get(attributes_path) == 0;
+        if (success) {
+            status = m_client.get_response_status_code();
+        }
+        if (!success || status != HTTP_STATUS_OK) {
+            m_client.stop();
+            Logger::printfln(FW_HTTP_ATTRIBUTES_FAILED, status);
+            return false;
+        }
+#if THINGSBOARD_ENABLE_STL
+        std::string response = m_client.get_response_body();
+#else
+        String response = m_client.get_response_body();
+#endif // THINGSBOARD_ENABLE_STL
+        m_client.stop();
+
+        // Deserializing from a mutable buffer does not copy the strings into the document, they instead point into the response that is kept alive until the update is finished
+        StaticJsonDocument<JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(OTA_ATTRIBUTE_KEYS_AMOUNT)> document;
+        if (response.length() == 0U || deserializeJson(document, &response[0U], response.length()) != DeserializationError::Ok) {
+            Logger::printfln(NO_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, NO_FW);
+            return false;
+        }
+        JsonObjectConst const data = document[HTTP_FW_SHARED_KEY].as<JsonObjectConst>();
+        return Firmware_Shared_Attribute_Received(data);
+    }
+
+    /// @brief Sends the given firmware title and firmware version to the cloud.
+    /// See https://thingsboard.io/docs/user-guide/ota-updates/ for more information
+    /// @param current_fw_title Current device firmware title
+    /// @param current_fw_version Current device firmware version
+    /// @return Whether sending the current device firmware information was successful or not
+    bool Firmware_Send_Info(char const * current_fw_title, char const * current_fw_version) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_info;
+        current_firmware_info[CURR_FW_TITLE_KEY] = current_fw_title;
+        current_firmware_info[CURR_FW_VER_KEY] = current_fw_version;
+        return Send_Telemetry(current_firmware_info);
+    }
+
+    /// @brief Sends the given firmware state to the cloud, closes the firmware download stream if it is still open, because the same client is used to send the state.
+    /// See https://thingsboard.io/docs/user-guide/ota-updates/ for more information
+    /// @param current_fw_state Current firmware download state
+    /// @param fw_error Firmware error message that describes the current firmware state,
+    /// simply do not enter a value and the default value will be used which overwrites the firmware error messages, default = ""
+    /// @return Whether sending the current firmware download state was successful or not
+    bool Firmware_Send_State(char const * current_fw_state, char const * fw_error = "") {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_state;
+        current_firmware_state[FW_ERROR_KEY] = fw_error;
+        current_firmware_state[FW_STATE_KEY] = current_fw_state;
+        return Send_Telemetry(current_firmware_state);
+    }
+
+  private:
+    /// @brief Checks the received firmware information and downloads the firmware if it is meant for this device and not already installed
+    /// @param data Json data containing key-value pairs for the needed firmware information
+    /// @return Whether an update was started or not
+    bool Firmware_Shared_Attribute_Received(JsonObjectConst const & data) {
+        if (!data.containsKey(FW_VER_KEY) || !data.containsKey(FW_TITLE_KEY) || !data.containsKey(FW_CHKS_KEY) || !data.containsKey(FW_CHKS_ALGO_KEY) || !data.containsKey(FW_SIZE_KEY)) {
+            Logger::printfln(NO_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, NO_FW);
+            return false;
+        }
+
+        char const * fw_title = data[FW_TITLE_KEY];
+        char const * fw_version = data[FW_VER_KEY];
+        char const * fw_checksum = data[FW_CHKS_KEY];
+        char const * fw_algorithm = data[FW_CHKS_ALGO_KEY];
+        size_t const fw_size = data[FW_SIZE_KEY];
+        char const * fw_chunk_checksums = data[FW_CHUNK_CHKS_KEY];
+        uint16_t const fw_chunk_checksums_size = data[FW_CHUNK_CHKS_SIZE_KEY];
+
+        char const * curr_fw_title = m_fw_callback.Get_Firmware_Title();
+        char const * curr_fw_version = m_fw_callback.Get_Firmware_Version();
+
+        if (fw_title == nullptr || fw_version == nullptr || fw_algorithm == nullptr || fw_checksum == nullptr) {
+            Logger::printfln(EMPTY_FW);
+            (void)Firmware_Send_State(FW_STATE_FAILED, EMPTY_FW);
+            return false;
+        }
+        // If firmware version and title is the same, we do not initiate an update, because we expect the type of binary to be the same one we are currently using
+        // and therefore updating would be useless as we have already updated previously
+        else if (strncmp(curr_fw_title, fw_title, strlen(curr_fw_title)) == 0 && strncmp(curr_fw_version, fw_version, strlen(curr_fw_version)) == 0) {
+            (void)Firmware_Send_State(FW_STATE_UPDATED);
+            return false;
+        }
+        // If firmware title is not the same, we do not initiate an update, because we expect the binary to be for another type of device
+        // and downloading it on this device could possibly cause hardware issues or even destroy the device
+        else if (strncmp(curr_fw_title, fw_title, strlen(curr_fw_title)) != 0) {
+            char message[strlen(FW_NOT_FOR_US) + strlen(fw_title) + strlen(curr_fw_title) + 3] = {};
+            (void)snprintf(message, sizeof(message), FW_NOT_FOR_US, fw_title, curr_fw_title);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            return false;
+        }
+
+        mbedtls_md_type_t const fw_checksum_algorithm = HashGenerator::string_to_type(fw_algorithm);
+        if (fw_checksum_algorithm == mbedtls_md_type_t::MBEDTLS_MD_NONE) {
+            char message[strlen(FW_CHKS_ALGO_NOT_SUPPORTED) + strlen(fw_algorithm) + 2] = {};
+            (void)snprintf(message, sizeof(message), FW_CHKS_ALGO_NOT_SUPPORTED, fw_algorithm);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            return false;
+        }
+
+        uint16_t const chunk_size = m_fw_callback.Get_Chunk_Size();
+        if (fw_chunk_checksums != nullptr && fw_chunk_checksums_size != chunk_size) {
+            Logger::printfln(FW_CHUNK_CHKS_SIZE_MISMATCH, fw_chunk_checksums_size, chunk_size);
+            fw_chunk_checksums = nullptr;
+        }
+
+        // Buffer the streamed firmware binary is read into, before it is passed to the OTA handler
+        uint8_t * buffer = new uint8_t[chunk_size]();
+        if (buffer == nullptr) {
+            char message[Helper::detectSize(FW_HTTP_BUFFER_ALLOCATION_FAILED, chunk_size)] = {};
+            (void)snprintf(message, sizeof(message), FW_HTTP_BUFFER_ALLOCATION_FAILED, chunk_size);
+            Logger::printfln(message);
+            (void)Firmware_Send_State(FW_STATE_FAILED, message);
+            m_fw_callback.Call_Callback(false);
+            return false;
+        }
+
+        // Title and version are inserted into the query string, where any reserved character like ' ', '&', '#' or '+' would otherwise change or break the request
+        char encoded_title[Helper::urlEncode(fw_title, nullptr, 0U)] = {};
+        (void)Helper::urlEncode(fw_title, encoded_title, sizeof(encoded_title));
+        char encoded_version[Helper::urlEncode(fw_version, nullptr, 0U)] = {};
+        (void)Helper::urlEncode(fw_version, encoded_version, sizeof(encoded_version));
+        char const * const title = encoded_title;
+        char const * const version = encoded_version;
+        char download_path[Helper::detectSize(HTTP_FW_DOWNLOAD_PATH, m_token, title, version)] = {};
+        (void)snprintf(download_path, sizeof(download_path), HTTP_FW_DOWNLOAD_PATH, m_token, title, version);
+
+        m_fw_callback.Call_Update_Starting_Callback();
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(PAGE_BREAK);
+        Logger::printfln(NEW_FW);
+        char firmware[strlen(FROM_TOO) + strlen(curr_fw_version) + strlen(fw_version) + 3] = {};
+        (void)snprintf(firmware, sizeof(firmware), FROM_TOO, curr_fw_version, fw_version);
+        Logger::printfln(firmware);
+        Logger::printfln(DOWNLOADING_FW_HTTP);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+        m_finished = false;
+        m_stream_open = false;
+        m_streaming_unsupported = false;
+        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm, fw_chunk_checksums);
+        Download_Firmware(download_path, fw_size, buffer, chunk_size);
+
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] buffer;
+        buffer = nullptr;
+        m_client.stop();
+        m_fw_callback = OTA_Update_Callback();
+        return true;
+    }
+
+    /// @brief Reads the streamed firmware binary in parts of the given chunk size and passes them to the OTA handler, until the handler finished the update.
+    /// If the handler requests a different chunk than the one the stream is currently positioned at, because a chunk failed verification or the complete update was restarted,
+    /// or if reading the stream failed, the stream is reopened with a Range request starting at the requested chunk
+    /// @param path Path of the firmware download request
+    /// @param fw_size Complete size of the firmware binary
+    /// @param buffer Buffer the firmware binary is read into, has to be at least as big as the given chunk size
+    /// @param chunk_size Amount of bytes that are read and processed at once
+    void Download_Firmware(char const * path, size_t const & fw_size, uint8_t * buffer, uint16_t const & chunk_size) {
+        while (!m_finished) {
+            // Chunks of cached firmware are read from the cache instead of being downloaded
+            if (m_ota.Serve_Cached_Chunk()) {
+                continue;
+            }
+            size_t const offset = m_requested_chunk * chunk_size;
+            // The last chunk contains the remaining bytes, which is 0 if the firmware size is a multiple of the chunk size
+            size_t const expected_size = (offset + chunk_size > fw_size) ? fw_size - offset : chunk_size;
+
+            if (expected_size > 0U && (!m_stream_open || m_stream_offset != offset) && !Open_Stream(path, offset, buffer, chunk_size)) {
+                if (m_streaming_unsupported) {
+                    Download_Complete_Firmware(path, fw_size, buffer, chunk_size);
+                    return;
+                }
+                m_ota.Handle_Request_Timeout();
+                continue;
+            }
+
+            size_t const read_size = (expected_size > 0U) ? m_client.read_response_body(buffer, expected_size) : 0U;
+            if (read_size != expected_size) {
+                Close_Stream();
+                m_ota.Handle_Request_Timeout();
+                continue;
+            }
+            m_stream_offset += read_size;
+            m_ota.Process_Firmware_Packet(m_requested_chunk, buffer, read_size);
+        }
+    }
+
+    /// @brief Receives the complete firmware binary into memory with a single GET request and passes it to the OTA handler in parts of the given chunk size, until the handler finished the update.
+    /// Used for HTTP clients that do not support streaming the response body, if receiving the binary fails or it is shorter than expected, it is requested again once the handler requests the next chunk
+    /// @param path Path of the firmware download request
+    /// @param fw_size Complete size of the firmware binary
+    /// @param buffer Buffer the parts of the firmware binary are copied into, has to be at least as big as the given chunk size
+    /// @param chunk_size Amount of bytes that are processed at once
+    void Download_Complete_Firmware(char const * path, size_t const & fw_size, uint8_t * buffer, uint16_t const & chunk_size) {
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_HTTP_STREAMING_UNSUPPORTED);
+#endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_STL
+        std::string response;
+#else
+        String response;
+#endif // THINGSBOARD_ENABLE_STL
+        bool received = false;
+        while (!m_finished) {
+            size_t const offset = m_requested_chunk * chunk_size;
+            size_t const expected_size = (offset + chunk_size > fw_size) ? fw_size - offset : chunk_size;
+
+            if (expected_size > 0U && !received) {
+                int status = 0;
+                bool const success = m_client.get(path) == 0;
+                if (success) {
+                    status = m_client.get_response_status_code();
+                }
+                if (success && status == HTTP_STATUS_OK) {
+                    response = m_client.get_response_body();
+                    received = true;
+                }
+                m_client.stop();
+                if (!received) {
+                    Logger::printfln(FW_HTTP_REQUEST_FAILED, 0U, status);
+                    m_ota.Handle_Request_Timeout();
+                    continue;
+                }
+                else if (response.length() < fw_size) {
+                    Logger::printfln(FW_HTTP_BODY_TOO_SHORT, response.length(), fw_size);
+                    received = false;
+                    m_ota.Handle_Request_Timeout();
+                    continue;
+                }
+            }
+
+            if (expected_size > 0U) {
+                memcpy(buffer, response.c_str() + offset, expected_size);
+            }
+            m_ota.Process_Firmware_Packet(m_requested_chunk, buffer, expected_size);
+        }
+    }
+
+    /// @brief Sends the firmware download request starting at the given offset and skips the already processed bytes if the server does not support range requests
+    /// @param path Path of the firmware download request
+    /// @param offset Byte offset the download should start at
+    /// @param buffer Buffer used to read and discard already processed bytes if the server responds with the complete firmware binary
+    /// @param buffer_size Size of the given buffer
+    /// @return Whether the stream is positioned at the given offset or not
+    bool Open_Stream(char const * path, size_t const & offset, uint8_t * buffer, uint16_t const & buffer_size) {
+        Close_Stream();
+        int status = 0;
+        int const result = m_client.get_range(path, offset);
+        if (result == HTTP_CLIENT_UNSUPPORTED) {
+            m_streaming_unsupported = true;
+            return false;
+        }
+        bool const success = result == 0;
+        if (success) {
+            status = m_client.get_response_status_code();
+        }
+        if (!success || (status != HTTP_STATUS_OK && status != HTTP_STATUS_PARTIAL_CONTENT) || (offset == 0U && status != HTTP_STATUS_OK)) {
+            Logger::printfln(FW_HTTP_REQUEST_FAILED, offset, status);
+            Close_Stream();
+            return false;
+        }
+
+        m_stream_open = true;
+        m_stream_offset = (status == HTTP_STATUS_PARTIAL_CONTENT) ? offset : 0U;
+        while (m_stream_offset < offset) {
+            size_t const skip_size = (offset - m_stream_offset > buffer_size) ? buffer_size : offset - m_stream_offset;
+            if (m_client.read_response_body(buffer, skip_size) != skip_size) {
+                Close_Stream();
+                return false;
+            }
+            m_stream_offset += skip_size;
+        }
+        return true;
+    }
+
+    /// @brief Closes the firmware download stream, so the client can be used to send other requests
+    void Close_Stream() {
+        m_client.stop();
+        m_stream_open = false;
+    }
+
+    /// @brief Serializes and sends the given telemetry to the cloud
+    /// @param source JsonDocument containing the key value pairs that should be sent
+    /// @return Whether sending the telemetry was successful or not
+    bool Send_Telemetry(JsonDocument const & source) {
+        // The same client is used for the download and sending telemetry, therefore any ongoing download has to be closed first and is reopened once the next chunk is requested
+        Close_Stream();
+        size_t const json_size = Helper::Measure_Json(source);
+        char json[json_size] = {};
+        (void)serializeJson(source, json, json_size);
+        char path[Helper::detectSize(HTTP_FW_TELEMETRY_PATH, m_token)] = {};
+        (void)snprintf(path, sizeof(path), HTTP_FW_TELEMETRY_PATH, m_token);
+
+        int status = 0;
+        bool const success = m_client.post(path, HTTP_FW_CONTENT_TYPE, json) == 0;
+        if (success) {
+            status = m_client.get_response_status_code();
+        }
+        m_client.stop();
+        if (!success || status != HTTP_STATUS_OK) {
+            Logger::printfln(FW_HTTP_POST_FAILED, status);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Called by the OTA handler once it requests the next chunk, only remembers the requested chunk, because the chunk is read from the stream by Download_Firmware()
+    /// @param request_id Unused, because the firmware is not requested with a request id over HTTP
+    /// @param request_chunk Index of the chunk that should be read next
+    /// @return Always true, because no request has to be sent
+    bool Request_Chunk(size_t const & request_id, size_t const & request_chunk) {
+        m_requested_chunk = request_chunk;
+        return true;
+    }
+
+    /// @brief Called by the OTA handler once the update has been completed or failed, stops the download loop
+    /// @return Always true
+    bool Finish_Firmware_Update() {
+        m_finished = true;
+        return true;
+    }
+
+#if !THINGSBOARD_ENABLE_STL
+    static bool staticRequestChunk(size_t const & request_id, size_t const & request_chunk) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Request_Chunk(request_id, request_chunk);
+    }
+
+    static bool staticFirmwareSend(char const * current_fw_state, char const * fw_error = nullptr) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Firmware_Send_State(current_fw_state, fw_error);
+    }
+
+    static bool staticFinish() {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Finish_Firmware_Update();
+    }
+
+    // Used OTA handler cannot call a instanced method, only free-standing function is allowed.
+    // To be able to forward event to an instance, rather than to a function, this pointer exists.
+    static HTTP_OTA_Firmware_Update *m_subscribedInstance;
+#endif // !THINGSBOARD_ENABLE_STL
+
+    IHTTP_Client        &m_client;                 // HTTP client the firmware information is requested and the firmware binary is downloaded with
+    char const          *m_token = {};             // Access token used to authenticate the requests
+    OTA_Update_Callback m_fw_callback = {};        // OTA update response callback
+    OTA_Handler<Logger> m_ota;                     // Class instance that handles the flashing and creating a hash from the given received binary firmware data
+    size_t              m_requested_chunk = {};    // Index of the chunk the OTA handler requested last
+    size_t              m_stream_offset = {};      // Byte offset of the firmware binary the open download stream is currently positioned at
+    bool                m_stream_open = {};        // Whether a download stream is currently open
+    bool                m_streaming_unsupported = {}; // Whether the HTTP client does not support streaming, meaning the complete firmware binary is received into memory instead
+    bool                m_finished = {};           // Whether the OTA handler finished the update, either successfully or because it failed
+};
+
+#if !THINGSBOARD_ENABLE_STL
+template <typename Logger>
+HTTP_OTA_Firmware_Update<Logger> *HTTP_OTA_Firmware_Update<Logger>::m_subscribedInstance = nullptr;
+#endif // !THINGSBOARD_ENABLE_STL
+
+#endif // HTTP_OTA_Firmware_Update_h
@@ -2,16 +2,27 @@
 #include "HashGenerator.h"
 
 // Library include.
-#include <stdio.h>
+#include <string.h>
+
+// Lower case hex characters indexed by their value, used to encode each half of a byte with a single lookup
+char constexpr HEX_CHARACTERS[] = "0123456789abcdef";
 
 HashGenerator::~HashGenerator(void) {
     free();
 }
 
+void HashGenerator::set_backend(IHash_Backend * backend) {
+    m_backend = backend;
+}
+
 bool HashGenerator::start(mbedtls_md_type_t const & type) {
     // Clear the internal structure of any previous attempt, because if we do not the init function will not work correctly
     free();
     m_size = mbedtls_type_to_size(type);
+    m_active_backend = m_backend;
+    if (m_active_backend != nullptr) {
+        return m_active_backend->start(type);
+    }
     // Initialize the context
     mbedtls_md_init(&m_ctx);
     // Choose the hash function
@@ -22,22 +33,90 @@ bool HashGenerator::start(mbedtls_md_type_t const & type) {
 }
 
 bool HashGenerator::update(uint8_t const * data, size_t const & length) {
+    if (m_active_backend != nullptr) {
+        return m_active_backend->update(data, length);
+    }
     return mbedtls_md_update(&m_ctx, data, length) == 0;
 }
 
 bool HashGenerator::finish(char * hash_string) {
-    unsigned char byte_hash[m_size] = {};
-    bool const success = mbedtls_md_finish(&m_ctx, byte_hash) == 0;
+    uint8_t byte_hash[MBEDTLS_MD_MAX_SIZE] = {};
+    bool const success = finish(byte_hash);
     if (!success) {
         return success;
     }
-    for (size_t i = 0; i < m_size; ++i) {
-        sprintf(hash_string + (i * 2), "%02x", byte_hash[i]);
-    }
-    hash_string[m_size * 2] = '\0';
+    encode_hex(byte_hash, m_size, hash_string);
     return success;
 }
 
+bool HashGenerator::finish(uint8_t * hash) {
+    if (m_active_backend != nullptr) {
+        return m_active_backend->finish(hash);
+    }
+    return mbedtls_md_finish(&m_ctx, hash) == 0;
+}
+
+size_t HashGenerator::get_size() const {
+    return m_size;
+}
+
+void HashGenerator::encode_hex(uint8_t const * bytes, size_t const & length, char * hex_string) {
+    for (size_t i = 0; i < length; ++i) {
+        hex_string[i * 2U] = HEX_CHARACTERS[bytes[i] >> 4U];
+        hex_string[(i * 2U) + 1U] = HEX_CHARACTERS[bytes[i] & 0x0FU];
+    }
+    hex_string[length * 2U] = '\0';
+}
+
+size_t HashGenerator::decode_hex(char const * hex_string, uint8_t * bytes, size_t const & max_length) {
+    if (hex_string == nullptr) {
+        return 0U;
+    }
+    size_t length = 0U;
+    for (; hex_string[0U] != '\0'; hex_string += 2U) {
+        int8_t const high = hex_to_value(hex_string[0U]);
+        // Checking the low character also ensures we do not read past the null terminator of a string with an odd length
+        int8_t const low = hex_to_value(hex_string[1U]);
+        if (high < 0 || low < 0 || length >= max_length) {
+            return 0U;
+        }
+        bytes[length++] = static_cast<uint8_t>((high << 4U) | low);
+    }
+    return length;
+}
+
+mbedtls_md_type_t HashGenerator::string_to_type(char const * algorithm) {
+    if (algorithm == nullptr) {
+        return mbedtls_md_type_t::MBEDTLS_MD_NONE;
+    }
+    else if (strncmp(CHECKSUM_AGORITM_MD5, algorithm, strlen(CHECKSUM_AGORITM_MD5)) == 0) {
+        return mbedtls_md_type_t::MBEDTLS_MD_MD5;
+    }
+    else if (strncmp(CHECKSUM_AGORITM_SHA256, algorithm, strlen(CHECKSUM_AGORITM_SHA256)) == 0) {
+        return mbedtls_md_type_t::MBEDTLS_MD_SHA256;
+    }
+    else if (strncmp(CHECKSUM_AGORITM_SHA384, algorithm, strlen(CHECKSUM_AGORITM_SHA384)) == 0) {
+        return mbedtls_md_type_t::MBEDTLS_MD_SHA384;
+    }
+    else if (strncmp(CHECKSUM_AGORITM_SHA512, algorithm, strlen(CHECKSUM_AGORITM_SHA512)) == 0) {
+        return mbedtls_md_type_t::MBEDTLS_MD_SHA512;
+    }
+    return mbedtls_md_type_t::MBEDTLS_MD_NONE;
+}
+
+int8_t HashGenerator::hex_to_value(char const & character) {
+    if (character >= '0' && character <= '9') {
+        return character - '0';
+    }
+    else if (character >= 'a' && character <= 'f') {
+        return character - 'a' + 10;
+    }
+    else if (character >= 'A' && character <= 'F') {
+        return character - 'A' + 10;
+    }
+    return -1;
+}
+
 void HashGenerator::free() {
     // MBEDTLS Version 3 is a major breaking changes were accessing the internal structures requires the MBEDTLS_PRIVATE macro
 #if MBEDTLS_VERSION_MAJOR < 3
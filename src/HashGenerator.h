@@ -3,6 +3,7 @@
 
 // Local includes.
 #include "Configuration.h"
+#include "IHash_Backend.h"
 
 // Library includes.
 #if THINGSBOARD_USE_MBED_TLS
@@ -14,6 +15,13 @@
 #include <stddef.h>
 
 
+// Checksum algorithm names.
+char constexpr CHECKSUM_AGORITM_MD5[] = "MD5";
+char constexpr CHECKSUM_AGORITM_SHA256[] = "SHA256";
+char constexpr CHECKSUM_AGORITM_SHA384[] = "SHA384";
+char constexpr CHECKSUM_AGORITM_SHA512[] = "SHA512";
+
+
 /// @brief Wrapper class which allows generating a hash of the given type from any arbitrary byte payload, which is hashable in chunks.
 /// The class wraps around either the Arduino Seeed mbedtls library from Seed Studio (https://github.com/Seeed-Studio/Seeed_Arduino_mbedtls) or the offical ESP Mbed TLS implementation from Mbed TLS (https://github.com/Mbed-TLS/mbedtls), the latter takes precendence if it exists.
 /// This is done because it removes the need to include another library, because the component already exists on the system and we can therefore simply utilize that one.
@@ -22,6 +30,7 @@
 /// The class instance is meant to be started with start() which will then create the configuration for a hash of the given type
 /// and we then expect the complete binary payload to be called in multiple calls to update() and the final result to be read with get_hash_string()
 /// Documentation about the specific use and caviates of the ESP Mbedt TLS implementation can be found here https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/protocols/mbedtls.html
+/// Alternatively an IHash_Backend implementation can be set with set_backend(), which is then used instead of mbedtls for every following hash calculation
 class HashGenerator {
   public:
     /// @brief Constructor
@@ -30,6 +39,10 @@ class HashGenerator {
     /// @brief Destructor
     ~HashGenerator(void);
 
+    /// @brief Sets the backend used to calculate the hash instead of the default mbedtls implementation, only takes effect the next time start() is called
+    /// @param backend Backend implementation that should be used or nullptr to use the default mbedtls implementation, has to be kept alive for as long as it is used by this class
+    void set_backend(IHash_Backend * backend);
+
     /// @brief Starts the hashing process
     /// @param type Supported type of hash that should be generated from this class
     /// @return Whether initalizing and starting the hash calculation was successful or not
@@ -50,6 +63,34 @@ class HashGenerator {
     /// @return Whether stopping and caculating the final hash for the given bytes was successful or not
     bool finish(char * hash_string);
 
+    /// @brief Calculates the final binary hash and stops the hash calculation no further calls to update() will work,
+    /// instead the same context can be reused to start another hash calculation operation with start()
+    /// @param hash Output buffer that the binary hash will be copied into, needs to be big enough to hold get_size() bytes, recommended size is simply MBEDTLS_MD_MAX_SIZE
+    /// @return Whether stopping and caculating the final hash for the given bytes was successful or not
+    bool finish(uint8_t * hash);
+
+    /// @brief Gets the size of the binary hash of the type the current hash calculation was started with
+    /// @return Amount of bytes of the binary hash, 0 if the type is not supported
+    size_t get_size() const;
+
+    /// @brief Encodes the given bytes into their lower case hex string representation, with a lookup table instead of formatting every single byte with sprintf
+    /// @param bytes Bytes that should be encoded
+    /// @param length Amount of bytes that should be encoded
+    /// @param hex_string Output string the hex string representation will be copied into, needs to be big enough to hold (length * 2) + 1 characters including the null terminator
+    static void encode_hex(uint8_t const * bytes, size_t const & length, char * hex_string);
+
+    /// @brief Decodes the given hex string representation into its bytes, upper and lower case hex characters are both accepted
+    /// @param hex_string Null-terminated hex string representation that should be decoded
+    /// @param bytes Output buffer the decoded bytes will be copied into
+    /// @param max_length Size of the output buffer in bytes
+    /// @return Amount of decoded bytes or 0 if the string contains invalid characters, has an odd length or does not fit into the output buffer
+    static size_t decode_hex(char const * hex_string, uint8_t * bytes, size_t const & max_length);
+
+    /// @brief Converts the given checksum algorithm name, as it is used by ThingsBoard for the fw_checksum_algorithm shared attribute, into the type of hash that should be generated
+    /// @param algorithm Name of the checksum algorithm (MD5, SHA256, SHA384 or SHA512)
+    /// @return Type of hash that should be generated or MBEDTLS_MD_NONE if the given algorithm is not supported
+    static mbedtls_md_type_t string_to_type(char const * algorithm);
+
   private:
     /// @brief Frees all internally allocated memory to ensure no memory leak occurs, additionally check if a hash calculation was ever started,
     /// before freeing, because freeing without having started a hash calculation causes a crash.
@@ -62,8 +103,15 @@ class HashGenerator {
     /// @return Amount of bytes needed to be allocated by the buffer that will hold the final hash that is then transformed into a string
     size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
 
-    size_t               m_size = {}; // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
-    mbedtls_md_context_t m_ctx = {};  // Context used to access the already written bytes and update them latter
+    /// @brief Converts a single hex character into its value
+    /// @param character Hex character that should be converted
+    /// @return Value of the given hex character between 0 and 15 or -1 if it is not a valid hex character
+    static int8_t hex_to_value(char const & character);
+
+    size_t               m_size = {};           // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
+    mbedtls_md_context_t m_ctx = {};            // Context used to access the already written bytes and update them latter
+    IHash_Backend        *m_backend = {};       // Backend set by the user, used instead of mbedtls if it is not nullptr
+    IHash_Backend        *m_active_backend = {}; // Backend the current hash calculation was started with, ensures changing the backend does not affect an already started calculation
 };
 
 #endif // Hash_Generator_h
@@ -30,3 +30,63 @@ size_t Helper::parseRequestId(char const * base_topic, char const * received_top
     // Meaning the index we attempt to parse at, is simply the length of the base topic
     return atoi(received_topic + strlen(base_topic));
 }
+
+uint32_t Helper::calculateKeyHash(char const * key) {
+    // FNV-1a offset basis and prime for 32-bit hashes
+    uint32_t hash = 2166136261U;
+    if (key == nullptr) {
+        return hash;
+    }
+    for (; *key != '\0'; ++key) {
+        hash ^= static_cast<uint8_t>(*key);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/// @brief Returns whether the given character is allowed in an URL without being percent-encoded
+/// @param character Character that should be checked
+/// @return Whether the character is an unreserved character or not
+static bool Is_Unreserved(char const & character) {
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9') || character == '-' || character == '_' || character == '.' || character == '~';
+}
+
+size_t Helper::urlEncode(char const * value, char * buffer, size_t const & buffer_size) {
+    static char constexpr HEX_DIGITS[] = "0123456789ABCDEF";
+    size_t required_size = 1U;
+    for (char const * it = value; it != nullptr && *it != '\0'; ++it) {
+        required_size += Is_Unreserved(*it) ? 1U : 3U;
+    }
+    if (buffer == nullptr || buffer_size < required_size) {
+        return required_size;
+    }
+
+    size_t index = 0U;
+    for (char const * it = value; it != nullptr && *it != '\0'; ++it) {
+        uint8_t const current = static_cast<uint8_t>(*it);
+        if (Is_Unreserved(*it)) {
+            buffer[index++] = *it;
+            continue;
+        }
+        buffer[index++] = '%';
+        buffer[index++] = HEX_DIGITS[current >> 4U];
+        buffer[index++] = HEX_DIGITS[current & 0x0FU];
+    }
+    buffer[index] = '\0';
+    return required_size;
+}
+
+uint32_t Helper::calculateCrc32(uint8_t const * bytes, size_t const & length, uint32_t const & previous) {
+    // Reflected CRC-32 polynomial (0xEDB88320) applied to every possible half byte
+    static uint32_t constexpr CRC32_TABLE[16U] = {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+    };
+    uint32_t crc = ~previous;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= bytes[i];
+        crc = (crc >> 4U) ^ CRC32_TABLE[crc & 0x0FU];
+        crc = (crc >> 4U) ^ CRC32_TABLE[crc & 0x0FU];
+    }
+    return ~crc;
+}
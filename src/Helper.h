@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdint.h>
 
 
 /// @brief Static helper class that includes some uniliterally used functionalities in multiple places, especially the ThingsBoardHttp and ThingsBoard implementations
@@ -54,6 +55,33 @@ class Helper {
     /// @return Converted integral request id if possible or 0 if parsing as an integer failed
     static size_t parseRequestId(char const * base_topic, char const * received_topic);
 
+    /// @brief Calculates the 32-bit FNV-1a hash of the given null-terminated key.
+    /// Is used to build lookup tables for json keys, so that received payloads can be matched against subscribed keys,
+    /// without having to compare every subscribed key string with every received key string.
+    /// Different keys can produce the same hash, therefore a match still has to be confirmed by comparing the actual strings.
+    /// See http://www.isthe.com/chongo/tech/comp/fnv/ for more information on the underlying algorithm
+    /// @param key Null-terminated key we want to calculate the hash for, nullptr results in the hash of an empty string
+    /// @return Calculated hash of the given key
+    static uint32_t calculateKeyHash(char const * key);
+
+    /// @brief Calculates the CRC-32 (IEEE 802.3, the same one as used by zlib) of the given byte payload.
+    /// Is used to verify single firmware chunks as soon as they are received, so that corrupted chunks can be requested again directly.
+    /// Calculated with a 16 entry lookup table, processing half a byte at once, which is a good tradeoff between the speed of the full 256 entry table and its memory usage
+    /// @param bytes Byte payload that we want to calculate the checksum for
+    /// @param length Length of the byte payload
+    /// @param previous Checksum of the bytes preceding the given byte payload, allows to calculate the checksum of a payload that is received in multiple slices, default = 0
+    /// @return Calculated checksum of the given byte payload
+    static uint32_t calculateCrc32(uint8_t const * bytes, size_t const & length, uint32_t const & previous = 0U);
+
+    /// @brief Percent-encodes the given null-terminated string, so that it can be inserted into the query string of an URL.
+    /// Every character except the unreserved characters (letters, digits, '-', '_', '.' and '~') is replaced with '%' followed by its hexadecimal value,
+    /// see https://datatracker.ietf.org/doc/html/rfc3986#section-2.1 for more information
+    /// @param value Null-terminated string that should be encoded, nullptr is handled like an empty string
+    /// @param buffer Buffer the encoded string and its null terminator are written into, nullptr to only calculate the required size
+    /// @param buffer_size Size of the given buffer, the encoded string is only written if it fits completly
+    /// @return Amount of bytes needed for the encoded string including the null terminator
+    static size_t urlEncode(char const * value, char * buffer, size_t const & buffer_size);
+
     /// @brief Calculates the total size of the string the serializeJson method would produce including the null end terminator.
     /// Be aware that null terminator will later not be serialied in the serializeJson() call,
     /// meaning the returned written amount of bytes is the return value of this method - 1.
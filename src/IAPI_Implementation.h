@@ -6,6 +6,7 @@
 #include "Constants.h"
 #include "DefaultLogger.h"
 #include "API_Process_Type.h"
+#include "Topic_Profile.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STL
@@ -25,12 +26,8 @@ char constexpr REQUEST_ID_NULL[] = "Internal request id is NULL";
 // RPC data keys.
 char constexpr RPC_METHOD_KEY[] = "method";
 char constexpr RPC_PARAMS_KEY[] = "params";
-// Shared attribute update API topics.
-char constexpr ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
 // Shared attribute request keys.
 char constexpr SHARED_RESPONSE_KEY[] = "shared";
-// Publish data topics.
-char constexpr TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
 
 
 /// @brief Base functionality required by all API implementation
@@ -55,6 +52,25 @@ class IAPI_Implementation {
     /// @param data Payload sent by the server over our given topic, that contains our key value pairs
     virtual void Process_Json_Response(char const * topic, JsonDocument const & data) = 0;
 
+    /// @brief Process callback that will be called with consecutive slices of a received payload, if the payload did not fit into the receive buffer and the underlying client supports streaming it.
+    /// Only called for API implementations that process their response as API_Process_Type::RAW, therefore the default implementation simply ignores the slices.
+    /// Implementations that process their response as API_Process_Type::RAW, but can only handle complete payloads, should override it to at least report that the payload was discarded
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Slice of the payload that was sent over the cloud and received over the given topic
+    /// @param length Length of the received slice
+    /// @param offset Offset of the received slice from the start of the complete payload
+    /// @param total_length Total length of the complete payload
+    virtual void Process_Response_Slice(char const * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) {
+        // Nothing to do
+    }
+
+    /// @brief Informs the API implementation whether the underlying client supports streaming payloads bigger than the receive buffer with Process_Response_Slice(),
+    /// which allows to receive big raw payloads without having to increase the size of the receive buffer. The default implementation simply ignores the information
+    /// @param supported Whether the underlying client supports streaming received payloads or not
+    virtual void Set_Stream_Supported(bool supported) {
+        // Nothing to do
+    }
+
     /// @brief Compares received response topic and the topic this api implementation handles responses on,
     /// messages from all other topics are ignored and only messages from topics that match are handled.
     /// For the comparsion we either compare the full expected string with the null termination, if the response topic does not include additional parameters.
@@ -73,12 +89,25 @@ class IAPI_Implementation {
     /// @return Whether resubscribing was successfull or not
     virtual bool Resubscribe_Topic() = 0;
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Internal loop method to update inernal timers for API calls that can timeout.
-    /// Only exists on boards that can not use the ESP Timer, because that one uses the FreeRTOS timer in the background instead
-    /// and therefore does not require calling a loop method
+    /// @brief Internal loop method to update inernal timers for API calls that can timeout and to continue work that is split over multiple calls, like serving cached firmware one chunk at a time.
+    /// Boards that use the ESP Timer update the timers with the FreeRTOS timer in the background instead, but still have to call the loop method for the remaining work,
+    /// because it should not block the high priority task of the ESP Timer
     virtual void loop() = 0;
-#endif // !THINGSBOARD_USE_ESP_TIMER
+
+    /// @brief Gets the time until the earliest internal timer of any API call that can timeout expires or the remaining work has to be continued, which is the latest time loop() has to be called again at.
+    /// Allows to sleep or block on the network until then instead of calling loop() continously, the default implementation has no internal timers
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if a timer already expired and UINT32_MAX if no timer is started
+    virtual uint32_t Get_Next_Deadline() const {
+        return UINT32_MAX;
+    }
+
+    /// @brief Sets the topics the API implementation publishes, subscribes and compares received topics with, allows to use the short topic variants for example.
+    /// Directly set by the used ThingsBoard client to its own topic profile, therefore calling it as a user is not recommended, use setTopicProfile() on the ThingsBoard client instead.
+    /// The default implementation simply ignores the profile, for API implementations that do not use any of the device API topics contained in it
+    /// @param profile Topics that should be used, has to be kept alive for as long as the API implementation uses it
+    virtual void Set_Topic_Profile(Topic_Profile const & profile) {
+        // Nothing to do
+    }
 
     /// @brief Method that allows to construct internal objects, after the required callback member methods have been set already.
     /// Required for API Implementations that subscribe further API calls, because immediately calling in the constructor can lead,
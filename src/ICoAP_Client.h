@@ -0,0 +1,106 @@
+#ifndef ICoAP_Client_h
+#define ICoAP_Client_h
+
+// Local includes.
+#include "Callback.h"
+#include "CoAP_Codec.h"
+
+
+/// @brief CoAP Client interface that contains the method that a class that can be used to send and receive data over CoAP (https://datatracker.ietf.org/doc/html/rfc7252) should implement.
+/// Seperates the specific implementation used from the ThingsBoardCoap client, allows to use different clients depending on different needs.
+/// Compared to MQTT and HTTP, CoAP is sent over UDP, meaning there is neither a TCP handshake nor a connection that has to be kept alive,
+/// which makes it far cheaper for sleepy devices that only wake up once in a while to send a few values and then power down the radio again.
+/// Every request is sent as a confirmable message and retransmitted until the response is received, server pushed data is received by observing a resource (https://datatracker.ietf.org/doc/html/rfc7641)
+/// and large resources are downloaded block-wise (https://datatracker.ietf.org/doc/html/rfc7959).
+/// The implementation already contained in the library is the Socket_CoAP_Client, which uses BSD sockets and can therefore be used on Linux and on the ESP32 with both Arduino and Espressif IDF
+class ICoAP_Client {
+  public:
+    /// @brief Sets the callback that is called for every notification of an observed resource, that is received while calling loop()
+    /// @param callback Method that should be called with the path the observation was registered with, the payload of the notification and its length.
+    /// The payload points into the receive buffer of the client and is only valid until the callback returns
+    virtual void set_notification_callback(Callback<void, char const *, uint8_t *, unsigned int>::function callback) = 0;
+
+    /// @brief Changes the size of the buffers sent and received datagrams are stored in, the buffers have to be big enough to hold the CoAP header, the options and the payload.
+    /// Is especially important for block-wise downloads, where a complete block has to fit into the receive buffer
+    /// @param receive_buffer_size Maximum size of a single received datagram
+    /// @param send_buffer_size Maximum size of a single sent datagram
+    /// @return Whether allocating the buffers with the given sizes was successful or not
+    virtual bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) = 0;
+
+    /// @brief Gets the previously set size of the buffer received datagrams are stored in
+    /// @return Maximum size of a single received datagram
+    virtual uint16_t get_receive_buffer_size() = 0;
+
+    /// @brief Gets the previously set size of the buffer sent datagrams are encoded into
+    /// @return Maximum size of a single sent datagram
+    virtual uint16_t get_send_buffer_size() = 0;
+
+    /// @brief Resolves the given server and opens the socket all following requests are sent over, does not send any data itself,
+    /// because UDP does not require establishing a connection first
+    /// @param host Server instance name the client should send requests to
+    /// @param port Port the server listens on, should be DEFAULT_COAP_PORT (5683) for unencrypted CoAP
+    /// @return Whether the socket could be opened successfully with return code 0 or failed with error code otherwise
+    virtual int connect(char const * host, uint16_t port) = 0;
+
+    /// @brief Closes the socket and forgets every observation, which are not deregistered on the server, instead the server stops sending notifications once they are not acknowledged anymore
+    virtual void stop() = 0;
+
+    /// @brief Whether the socket is currently open and requests can be sent
+    /// @return Whether the client is connected
+    virtual bool connected() = 0;
+
+    /// @brief Sends a confirmable request and waits until the response has been received, retransmits the request with an exponential back-off if it is not acknowledged.
+    /// Confirmable notifications received while waiting are not acknowledged, so that the server retransmits them and they can be received once loop() is called.
+    /// Non-confirmable notifications received while waiting are never retransmitted, therefore at least the newest one per observation is queued and passed on once loop() is called
+    /// @param method Method of the request
+    /// @param path Path and query of the requested resource (example: /api/v1/$TOKEN/telemetry)
+    /// @param payload Payload sent with the request, nullptr if no payload should be sent
+    /// @param length Length of the given payload
+    /// @return Whether a response was received, returns 0 if successful or if not the internal error code, the response code still has to be checked with get_response_code()
+    virtual int request(CoAP_Method const & method, char const * path, uint8_t const * payload, size_t const & length) = 0;
+
+    /// @brief Sends a confirmable GET request for a single block of the given resource and waits until the response has been received, see https://datatracker.ietf.org/doc/html/rfc7959#section-2.4 for more information
+    /// @param path Path and query of the requested resource (example: /fw/$TOKEN?title=$TITLE&version=$VERSION)
+    /// @param block_number Index of the requested block
+    /// @param block_size Size of every block, has to be a power of two between COAP_MIN_BLOCK_SIZE (16) and COAP_MAX_BLOCK_SIZE (1024)
+    /// @return Whether a response was received, returns 0 if successful or if not the internal error code, the response code still has to be checked with get_response_code()
+    virtual int get_block(char const * path, size_t const & block_number, uint16_t const & block_size) = 0;
+
+    /// @brief Gets the code of the last received response with the same decimal representation used for HTTP status codes, meaning 2.05 Content becomes 205
+    /// @return Response code of the last request
+    virtual int get_response_code() = 0;
+
+    /// @brief Gets the payload of the last received response, points into the receive buffer of the client
+    /// and is therefore only valid until the next request is sent or loop() is called
+    /// @return Payload of the last received response, nullptr if it did not contain a payload
+    virtual uint8_t * get_response_payload() = 0;
+
+    /// @brief Gets the length of the payload of the last received response
+    /// @return Length of the payload of the last received response
+    virtual size_t get_response_length() = 0;
+
+    /// @brief Registers an observation of the given resource, the following notifications are passed to the callback set with set_notification_callback(), once they are received while calling loop().
+    /// Observing a resource that is already observed does nothing
+    /// @param path Path of the resource that should be observed (example: /api/v1/$TOKEN/rpc), is copied by the client
+    /// @return Whether the server accepted the observation or not
+    virtual bool observe(char const * path) = 0;
+
+    /// @brief Deregisters the observation of the given resource
+    /// @param path Path of the observed resource
+    /// @return Whether the resource was observed or not
+    virtual bool cancel_observe(char const * path) = 0;
+
+    /// @brief Receives every datagram that is currently available without blocking, acknowledges the received notifications and passes them to the notification callback
+    /// @return Whether the client is still connected or not
+    virtual bool loop() = 0;
+
+    /// @brief Gets the handle of the underlying socket, which becomes readable as soon as a notification has been received and loop() should be called.
+    /// Allows sleepy devices to wait with select() on the handle, instead of calling loop() continously.
+    /// Optional, implementations that do not expose a handle do not need to override this method
+    /// @return File descriptor of the underlying socket or -1 if no handle is exposed
+    virtual int get_readiness_handle() {
+        return -1;
+    }
+};
+
+#endif // ICoAP_Client_h
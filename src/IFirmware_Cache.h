@@ -0,0 +1,57 @@
+#ifndef IFirmware_Cache_h
+#define IFirmware_Cache_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Firmware cache interface that contains the methods a class has to implement, to store downloaded firmware binaries and serve them to later updates of the same firmware,
+/// instead of downloading them from the server again. Meant for gateways or edge devices that update a lot of devices or client instances behind one upstream connection with the same firmware,
+/// where every single device would otherwise download identical chunks and multiply the upstream traffic by the amount of devices.
+/// Entries are content-addressed by the checksum of the complete firmware binary received from the server, because identical firmware always has the same checksum independent of its title and version.
+/// Served binaries are verified exactly like downloaded ones, therefore a corrupted entry is detected, removed and downloaded from the server again, instead of being flashed.
+/// Stored binaries are only committed once the complete firmware has been verified, if anything fails before that the partially stored binary has to be discarded
+class IFirmware_Cache {
+  public:
+    /// @brief Opens the cached firmware binary with the given checksum for reading, has to close any previously opened binary
+    /// @param checksum Hex string of the checksum of the complete firmware binary, only contains hex characters
+    /// @param size Size of the complete firmware binary, an entry with a different size has to be handled as missing
+    /// @return Whether a complete firmware binary with the given checksum and size is cached and could be opened or not
+    virtual bool open(char const * checksum, size_t const & size) = 0;
+
+    /// @brief Reads the given amount of bytes of the opened firmware binary, starting at the given offset
+    /// @param offset Offset from the start of the firmware binary in bytes
+    /// @param buffer Buffer the read bytes are copied into
+    /// @param length Amount of bytes that should be read
+    /// @return Amount of bytes that were read, less than the requested length if reading failed
+    virtual size_t read(size_t const & offset, uint8_t * buffer, size_t const & length) = 0;
+
+    /// @brief Closes the opened firmware binary
+    virtual void close() = 0;
+
+    /// @brief Starts storing a new firmware binary with the given checksum, has to discard any binary that is currently being stored but was not committed yet
+    /// @param checksum Hex string of the checksum of the complete firmware binary, only contains hex characters
+    /// @param size Size of the complete firmware binary
+    /// @return Whether storing could be started or not, if it fails the update continues without storing the binary
+    virtual bool begin_store(char const * checksum, size_t const & size) = 0;
+
+    /// @brief Appends the given bytes to the firmware binary that is currently being stored, bytes are always passed in order without gaps
+    /// @param payload Firmware binary data that should be appended
+    /// @param length Amount of bytes that should be appended
+    /// @return Amount of bytes that were appended, less than the given length if storing failed
+    virtual size_t store(uint8_t const * payload, size_t const & length) = 0;
+
+    /// @brief Ends storing the firmware binary, commits it if it was verified and discards it otherwise
+    /// @param verified Whether the complete binary was stored and its checksum verified, meaning it can be served to later updates
+    virtual void end_store(bool const & verified) = 0;
+
+    /// @brief Removes the cached firmware binary with the given checksum, called if the served binary failed verification
+    /// @param checksum Hex string of the checksum of the complete firmware binary that should be removed
+    virtual void remove(char const * checksum) = 0;
+};
+
+#endif // IFirmware_Cache_h
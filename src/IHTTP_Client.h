@@ -12,6 +12,10 @@
 #endif // THINGSBOARD_ENABLE_STL
 
 
+// Returned by the optional methods of the interface that the implementation does not support, chosen outside of the error codes used by the supported HTTP clients.
+int constexpr HTTP_CLIENT_UNSUPPORTED = -100;
+
+
 /// @brief HTTP Client interface that contains the method that a class that can be used to send and receive data over an HTTP conection should implement.
 /// Seperates the specific implementation used from the ThingsBoardHttp client, allows to use different clients depending on different needs.
 /// In this case the main use case of the seperation is to both support Espressif IDF and Arduino with the following libraries as recommendations.
@@ -56,6 +60,28 @@ class IHTTP_Client {
     /// @return Whether the request was successful or not, returns 0 if successful or if not the internal error code
     virtual int get(const char *url_path) = 0;
 
+    /// @brief Connects to the server and sends a GET request, that only requests the response body starting at the given byte offset with the Range header (Range: bytes=range_start-).
+    /// Servers that do not support range requests respond with the complete response body and the status code 200 instead of 206, which has to be handled by the caller.
+    /// Is an optional extension together with read_response_body(), therefore implementations that do not support streaming the response body can simply keep the default implementation,
+    /// which does not send any request and causes the firmware to be downloaded with get() and get_response_body() instead
+    /// @param url_path URL the GET request should be sent too
+    /// @param range_start Byte offset the response body should start at, 0 sends a normal GET request without the Range header
+    /// @return Whether the request was successful or not, returns 0 if successful, HTTP_CLIENT_UNSUPPORTED if the implementation does not support it or if not the internal error code
+    virtual int get_range(char const * url_path, size_t const & range_start) {
+        return HTTP_CLIENT_UNSUPPORTED;
+    }
+
+    /// @brief Reads the given amount of bytes of the response body of a previously sent message directly into the given buffer, without copying the complete response body into a string first.
+    /// Skips any response headers if they have not been read already, should be called after calling get_response_status_code() and ensuring the request was successful.
+    /// Can be called multiple times to stream large response bodies in multiple parts, blocks until the given amount of bytes has been read or the underlying client timed out.
+    /// Is an optional extension, that has to be implemented if get_range() is implemented, the default implementation does not read anything
+    /// @param buffer Buffer the read bytes will be copied into
+    /// @param size Amount of bytes that should be read, buffer needs to be at least as big
+    /// @return Amount of bytes that were actually read, less than the given size if the response body ended or reading timed out and 0 if the implementation does not support it
+    virtual size_t read_response_body(uint8_t * buffer, size_t const & size) {
+        return 0U;
+    }
+
     /// @brief Returns the response body of a previously sent message as a string object,
     /// skips any response headers if they have not been read already,
     /// should be called after calling get_response_status_code() and ensuring the request was successful
@@ -0,0 +1,39 @@
+#ifndef IHash_Backend_h
+#define IHash_Backend_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library includes.
+#if THINGSBOARD_USE_MBED_TLS
+#include <mbedtls/md.h>
+#else
+#include <Seeed_mbedtls.h>
+#endif // THINGSBOARD_USE_MBED_TLS
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Hash backend interface that contains the methods a class has to implement, to be used by the HashGenerator instead of the default mbedtls message digest implementation.
+/// Allows to calculate the firmware hash with a different implementation, for example directly with the SHA hardware accelerator of the ESP32 or a portable implementation on the host,
+/// which can then be benchmarked against the default mbedtls implementation. The algorithm is still identified with the mbedtls_md_type_t, because that is the type the received checksum algorithm is parsed into
+class IHash_Backend {
+  public:
+    /// @brief Starts the hashing process, has to discard any previously started hash calculation
+    /// @param type Type of hash that should be generated
+    /// @return Whether the given type is supported and starting the hash calculation was successful or not
+    virtual bool start(mbedtls_md_type_t const & type) = 0;
+
+    /// @brief Update the current hash value with new data
+    /// @param data Data that should be added to generate the hash
+    /// @param length Length of data entered
+    /// @return Whether updating the hash for the given bytes was successful or not
+    virtual bool update(uint8_t const * data, size_t const & length) = 0;
+
+    /// @brief Calculates the final binary hash and stops the hash calculation
+    /// @param hash Output buffer the binary hash will be copied into, is guaranteed to be big enough to hold the digest of the type passed to start()
+    /// @return Whether calculating the final hash was successful or not
+    virtual bool finish(uint8_t * hash) = 0;
+};
+
+#endif // IHash_Backend_h
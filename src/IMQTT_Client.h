@@ -103,6 +103,24 @@ class IMQTT_Client {
     /// @return Wheter subscribing the given topic was possible or not, should return false and a warning should be printed,
     /// if the connection has been lost or the topic does not exist
     virtual bool subscribe(char const * topic) = 0;
+
+    /// @brief Subscribes to MQTT messages on all the given topics, which will cause an internal callback to be called for each message received on any of those topics from the server,
+    /// it should then, call the previously configured callback with set_data_callback() with the received data.
+    /// Should send all topic filters in one SUBSCRIBE packet if the underlying client supports it, this reduces the load on the broker when a lot of devices reconnect at once,
+    /// because each device only sends one instead of one SUBSCRIBE packet per topic. Is an optional extension, therefore implementations that do not support it can simply keep the default implementation,
+    /// which subscribes the topics one after another
+    /// @param topics Array of topics we want to receive a notification about if messages are sent by the server
+    /// @param topic_amount Amount of topics contained in the given array
+    /// @return Wheter subscribing all the given topics was possible or not, should return false and a warning should be printed,
+    /// if the connection has been lost or any of the topics does not exist
+    virtual bool subscribe(char const * const * topics, size_t const & topic_amount) {
+        for (size_t i = 0U; i < topic_amount; ++i) {
+            if (!subscribe(topics[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
   
     /// @brief Unsubscribes to previously subscribed MQTT message on the given topic
     /// @param topic Topic we want to stop receiving a notification about if messages are sent by the server
@@ -115,6 +133,62 @@ class IMQTT_Client {
     /// @return Whether the client is currently connected or not
     virtual bool connected() = 0;
 
+    /// @brief Returns whether the broker reported in the response to our last connection attempt, that it still holds the session state of a previous connection.
+    /// Can only ever be true if the client connects with the clean session flag set to false, which has to be explicitly enabled in the specific implementation.
+    /// If it is true all previously subscribed topics are still subscribed and do not need to be resubscribed, which is skipped by the ThingsBoard client in that case
+    /// @return Whether the broker still holds the session state of the previous connection or not,
+    /// should return false if the underlying client does not expose that information, which simply causes all topics to be resubscribed.
+    /// Is an optional extension, therefore implementations that do not expose that information can simply keep the default implementation
+    virtual bool get_session_present() {
+        return false;
+    }
+
+    /// @brief Sets the callbacks that allow to receive messages that are bigger than the receive buffer, by passing their payload in consecutive slices directly from the underlying transport,
+    /// instead of discarding them. Allows to receive big raw payloads, like firmware chunks, without having to increase the size of the receive buffer, which might fail on devices with fragmented heap memory.
+    /// Is an optional extension, therefore implementations that do not support it can simply keep the default implementation, which does not stream and causes the receive buffer to be increased instead.
+    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing
+    /// @param filter_callback Method that is called with the topic of a received message that does not fit into the receive buffer, returns whether its payload should be streamed or discarded
+    /// @param stream_callback Method that is called with every slice of the streamed payload, including the topic, the slice and its length, the offset of the slice in the payload and the total length of the payload
+    /// @return Whether the implementation supports streaming received payloads or not
+    virtual bool set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) {
+        return false;
+    }
+
+    /// @brief Gets the time until loop() has to be called again at the latest, to read received packets or keep the connection alive, which allows to integrate the client into an event loop
+    /// that sleeps or blocks on the network instead of calling loop() continously. Is an optional extension, therefore implementations that do not support it can simply keep the default implementation,
+    /// which requires loop() to be called continously like before
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if it has to be called immediately and UINT32_MAX if the client does not require loop() to be called at all
+    virtual uint32_t get_next_deadline() {
+        return 0U;
+    }
+
+    /// @brief Gets the handle of the underlying network connection, which becomes readable as soon as a packet has been received, meaning loop() should be called.
+    /// Allows to wait with select() or poll() on the handle together with any other handles of the application until either the handle is readable or the deadline of get_next_deadline() passed.
+    /// Is an optional extension, therefore implementations that do not expose their connection can simply keep the default implementation, which does not return any handle
+    /// @return File descriptor of the underlying socket or -1 if the implementation does not expose one, in which case only the deadline can be used
+    virtual int get_readiness_handle() {
+        return -1;
+    }
+
+    /// @brief Gets the amount of bytes of published messages that have been accepted by publish(), but are still waiting in the outbox of the implementation to be sent by another task.
+    /// Allows the ThingsBoard client to hold back lower priority messages while the outbox is busy, so higher priority messages like RPC responses are not enqueued behind a long backlog of telemetry.
+    /// Is an optional extension, therefore implementations that send published messages directly can simply keep the default implementation, which reports an empty outbox
+    /// @return Amount of bytes still waiting to be sent, 0 if the outbox is empty or the implementation does not have one
+    virtual size_t get_outbox_size() {
+        return 0U;
+    }
+
+    /// @brief Sets the topics that are published to repeatedly, which allows implementations that connect with MQTT 5 to send them with a topic alias instead of the complete topic.
+    /// The first message on each of the topics still contains the complete topic together with the alias, every following message over the same connection only contains the alias, which saves the bytes of the topic for every message.
+    /// Directly set by the used ThingsBoard client to the telemetry and attribute topics of its topic profile. Is an optional extension, therefore implementations that connect with MQTT 3.1.1
+    /// or that do not support topic aliases can simply keep the default implementation, which always sends the complete topic
+    /// @param topics Array of topics that should be sent with a topic alias, the topics themselves have to be kept alive for as long as they are used, but the array itself can be temporary
+    /// @param topic_amount Amount of topics contained in the given array
+    /// @return Whether the implementation supports topic aliases or not
+    virtual bool set_topic_aliases(char const * const * topics, size_t const & topic_amount) {
+        return false;
+    }
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
     /// @brief Start to publish a message over a given topic, without being restricted to the internal buffer size.
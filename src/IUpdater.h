@@ -13,6 +13,14 @@
 /// @brief Updater interface that contains the method that a class that can be used to flash given binary data onto a device has to implement
 class IUpdater {
   public:
+    /// @brief Prepares the writing of the given data, called as soon as the firmware information has been received and the update is started, before the first firmware packet has been received.
+    /// Allows implementations to start time consuming preparations in the background, like erasing the flash region the firmware will be written into, instead of blocking in begin().
+    /// Is an optional extension, therefore implementations that do not need any preparation can simply keep the default implementation, which does nothing
+    /// @param firmware_size Total size of the data that will be written
+    virtual void prepare(size_t const & firmware_size) {
+        // Nothing to do
+    }
+
     /// @brief Initalizes the writing of the given data
     /// @param firmware_size Total size of the data that should be written, is done in multiple packets
     /// @return Whether initalizing the update was successful or not
@@ -0,0 +1,200 @@
+// Header include.
+#include "Json_Scanner.h"
+
+// Library includes.
+#include <string.h>
+
+// Json null value.
+char constexpr JSON_NULL_VALUE[] = "null";
+
+bool Json_Span::Is_Null() const {
+    return data == nullptr || (length == strlen(JSON_NULL_VALUE) && strncmp(data, JSON_NULL_VALUE, length) == 0);
+}
+
+bool Json_Scanner::Scan_Object(char const * json, size_t const & length, char const * const * keys, Json_Span * values, size_t const & key_amount) {
+    for (size_t i = 0U; i < key_amount; ++i) {
+        values[i] = Json_Span();
+    }
+    if (json == nullptr) {
+        return false;
+    }
+
+    size_t index = Skip_Whitespace(json, length, 0U);
+    if (index >= length || json[index] != '{') {
+        return false;
+    }
+    index = Skip_Whitespace(json, length, index + 1U);
+    if (index < length && json[index] == '}') {
+        return true;
+    }
+
+    while (index < length) {
+        if (json[index] != '"') {
+            return false;
+        }
+        size_t const key_end = Skip_String(json, length, index);
+        if (key_end == 0U) {
+            return false;
+        }
+        char const * key = json + index + 1U;
+        // Excludes both the opening and the closing quote of the key
+        size_t const key_length = key_end - index - 2U;
+
+        index = Skip_Whitespace(json, length, key_end);
+        if (index >= length || json[index] != ':') {
+            return false;
+        }
+        index = Skip_Whitespace(json, length, index + 1U);
+        size_t const value_end = Skip_Value(json, length, index);
+        if (value_end == 0U) {
+            return false;
+        }
+
+        for (size_t i = 0U; i < key_amount; ++i) {
+            // Comparing the character after the received key length ensures the given key is not only prefixed by the received key,
+            // which is only read if all previous characters matched and therefore the given key is atleast as long as the received key
+            if (strncmp(keys[i], key, key_length) != 0 || keys[i][key_length] != '\0') {
+                continue;
+            }
+            // Overwrites the value of a previous occurence of the same key, because ArduinoJson keeps the last value of duplicated keys as well
+            values[i].data = json + index;
+            values[i].length = value_end - index;
+            break;
+        }
+
+        index = Skip_Whitespace(json, length, value_end);
+        if (index >= length) {
+            return false;
+        }
+        else if (json[index] == '}') {
+            return true;
+        }
+        else if (json[index] != ',') {
+            return false;
+        }
+        index = Skip_Whitespace(json, length, index + 1U);
+    }
+    return false;
+}
+
+bool Json_Scanner::Next_Member(char const * json, size_t const & length, size_t & index, Json_Span & key, Json_Span & member) {
+    if (json == nullptr) {
+        index = length;
+        return false;
+    }
+    else if (index == 0U) {
+        index = Skip_Whitespace(json, length, 0U);
+        if (index >= length || json[index] != '{') {
+            index = length;
+            return false;
+        }
+        index = Skip_Whitespace(json, length, index + 1U);
+    }
+    if (index >= length || json[index] == '}') {
+        return false;
+    }
+    else if (json[index] != '"') {
+        index = length;
+        return false;
+    }
+
+    size_t const key_start = index;
+    size_t const key_end = Skip_String(json, length, key_start);
+    if (key_end == 0U) {
+        index = length;
+        return false;
+    }
+    index = Skip_Whitespace(json, length, key_end);
+    if (index >= length || json[index] != ':') {
+        index = length;
+        return false;
+    }
+    index = Skip_Whitespace(json, length, index + 1U);
+    size_t const value_end = Skip_Value(json, length, index);
+    if (value_end == 0U) {
+        index = length;
+        return false;
+    }
+
+    // Validates the seperator after the member already, so that a truncated payload is detected before its last member is returned
+    index = Skip_Whitespace(json, length, value_end);
+    if (index >= length || (json[index] != ',' && json[index] != '}')) {
+        index = length;
+        return false;
+    }
+    else if (json[index] == ',') {
+        index = Skip_Whitespace(json, length, index + 1U);
+    }
+    key.data = json + key_start;
+    key.length = key_end - key_start;
+    member.data = json + key_start;
+    member.length = value_end - key_start;
+    return true;
+}
+
+bool Json_Scanner::Get_String(Json_Span const & value, Json_Span & content) {
+    if (value.data == nullptr || value.length < 2U || value.data[0U] != '"' || value.data[value.length - 1U] != '"') {
+        return false;
+    }
+    content.data = value.data + 1U;
+    content.length = value.length - 2U;
+    return true;
+}
+
+size_t Json_Scanner::Skip_Whitespace(char const * json, size_t const & length, size_t index) {
+    while (index < length && (json[index] == ' ' || json[index] == '\t' || json[index] == '\n' || json[index] == '\r')) {
+        ++index;
+    }
+    return index;
+}
+
+size_t Json_Scanner::Skip_String(char const * json, size_t const & length, size_t index) {
+    for (++index; index < length; ++index) {
+        if (json[index] == '\\') {
+            // Skips the escaped character, so that an escaped quote does not terminate the string
+            ++index;
+        }
+        else if (json[index] == '"') {
+            return index + 1U;
+        }
+    }
+    return 0U;
+}
+
+size_t Json_Scanner::Skip_Value(char const * json, size_t const & length, size_t index) {
+    if (index >= length) {
+        return 0U;
+    }
+    else if (json[index] == '"') {
+        return Skip_String(json, length, index);
+    }
+    else if (json[index] == '{' || json[index] == '[') {
+        size_t depth = 0U;
+        while (index < length) {
+            char const current = json[index];
+            if (current == '"') {
+                // Strings have to be skipped as a whole, because they might contain brackets themselves
+                index = Skip_String(json, length, index);
+                if (index == 0U) {
+                    return 0U;
+                }
+                continue;
+            }
+            else if (current == '{' || current == '[') {
+                ++depth;
+            }
+            else if ((current == '}' || current == ']') && --depth == 0U) {
+                return index + 1U;
+            }
+            ++index;
+        }
+        return 0U;
+    }
+
+    // Numbers, booleans and null, end with the next seperator or whitespace
+    size_t const start = index;
+    while (index < length && json[index] != ',' && json[index] != '}' && json[index] != ']' && json[index] != ' ' && json[index] != '\t' && json[index] != '\n' && json[index] != '\r') {
+        ++index;
+    }
+    return index == start ? 0U : index;
+}
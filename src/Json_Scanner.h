@@ -0,0 +1,110 @@
+#ifndef Json_Scanner_h
+#define Json_Scanner_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Section of a received json payload, pointing directly into the receive buffer instead of copying the contained value.
+/// Contains the serialized json value exactly as it was received, meaning strings still include their surrounding quotes and escape sequences
+struct Json_Span {
+    char const *data = {};   // Start of the serialized json value, nullptr if the value was not contained in the payload
+    size_t     length = {};  // Length of the serialized json value
+
+    /// @brief Whether the value was either not contained in the payload at all or was explicitly set to null
+    /// @return Whether the value is missing or null
+    bool Is_Null() const;
+};
+
+
+/// @brief Static helper class that extracts the values of known keys from a received json object with a single forward scan over the payload,
+/// without deserializing it into a JsonDocument first. Is used for inbound messages with a fixed shape (server-side RPC requests),
+/// where only a few top-level keys are of interest and building the complete Json data structure would be the most expensive part of handling the message.
+/// Values are not validated while they are skipped, only their extent is determined, therefore any value that should be interpreted further still has to be deserialized,
+/// which can be done for only the extracted span instead of the complete payload
+class Json_Scanner {
+  public:
+    /// @brief Extracts the values of the given top-level keys from the given json object.
+    /// The complete object is always scanned, because if a key is contained multiple times its last value is extracted, the same as if the object was deserialized with ArduinoJson.
+    /// Nested objects and arrays are skipped as a whole and keys are compared as they were received, without resolving escape sequences
+    /// @param json Serialized json object, does not need to be null-terminated
+    /// @param length Length of the serialized json object
+    /// @param keys Null-terminated keys whose values should be extracted
+    /// @param values Spans the extracted values are written into, with the same order as the given keys, keys that are not contained in the payload result in an empty span
+    /// @param key_amount Amount of given keys and values
+    /// @return Whether the payload was a json object that could be scanned successfully up until the end of the object
+    static bool Scan_Object(char const * json, size_t const & length, char const * const * keys, Json_Span * values, size_t const & key_amount);
+
+    /// @brief Gets the content of the given json string value, without its surrounding quotes.
+    /// Escape sequences are not resolved, which is not required for the plain identifiers ThingsBoard uses as method names or keys
+    /// @param value Span containing a serialized json string
+    /// @param content Span the content of the string is written into
+    /// @return Whether the given span contained a json string or not
+    static bool Get_String(Json_Span const & value, Json_Span & content);
+
+    /// @brief Gets the next top-level member of the given json object, which allows to iterate over all members of the object without knowing their keys beforehand
+    /// @param json Serialized json object, does not need to be null-terminated
+    /// @param length Length of the serialized json object
+    /// @param index Index the scan continues at, has to be 0 for the first call and is updated to point after the returned member.
+    /// Once the end of the object has been reached it points to its closing bracket, if the payload is not a valid json object it is set to the length of the payload instead
+    /// @param key Span the key of the member is written into, including its surrounding quotes
+    /// @param member Span the complete member is written into, from the opening quote of the key until the last character of the value
+    /// @return Whether another member was found or not
+    static bool Next_Member(char const * json, size_t const & length, size_t & index, Json_Span & key, Json_Span & member);
+
+  private:
+    /// @brief Skips any whitespace permitted between json tokens
+    /// @param json Serialized json payload
+    /// @param length Length of the serialized json payload
+    /// @param index Index the whitespace should be skipped from
+    /// @return Index of the first character that is not whitespace or the length of the payload
+    static size_t Skip_Whitespace(char const * json, size_t const & length, size_t index);
+
+    /// @brief Skips the json string starting at the given index, including any escaped quotes
+    /// @param json Serialized json payload
+    /// @param length Length of the serialized json payload
+    /// @param index Index of the opening quote of the string
+    /// @return Index after the closing quote of the string or 0 if the string is not terminated
+    static size_t Skip_String(char const * json, size_t const & length, size_t index);
+
+    /// @brief Skips the json value starting at the given index, nested objects and arrays are skipped until their matching closing bracket
+    /// @param json Serialized json payload
+    /// @param length Length of the serialized json payload
+    /// @param index Index of the first character of the value
+    /// @return Index after the last character of the value or 0 if the value is not terminated
+    static size_t Skip_Value(char const * json, size_t const & length, size_t index);
+};
+
+
+/// @brief Extracts the values of a fixed set of top-level keys from received json objects of one message kind.
+/// The keys are fixed at compile time, which allows to keep the extracted values in an array on the stack with the same order as the keys
+/// @tparam KeyAmount Amount of keys that are extracted from every scanned json object
+template <size_t KeyAmount>
+class Json_Extractor {
+  public:
+    /// @brief Constructor
+    /// @param keys Null-terminated keys whose values should be extracted, has to stay valid for the lifetime of this instance
+    constexpr explicit Json_Extractor(char const * const (&keys)[KeyAmount])
+      : m_keys(keys)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Extracts the values of the keys this instance was constructed with from the given json object
+    /// @param json Serialized json object, does not need to be null-terminated
+    /// @param length Length of the serialized json object
+    /// @param values Spans the extracted values are written into, with the same order as the keys this instance was constructed with
+    /// @return Whether the payload was a json object that could be scanned successfully
+    bool Extract(char const * json, size_t const & length, Json_Span (&values)[KeyAmount]) const {
+        return Json_Scanner::Scan_Object(json, length, m_keys, values, KeyAmount);
+    }
+
+  private:
+    char const * const *m_keys = {}; // Keys whose values are extracted
+};
+
+#endif // Json_Scanner_h
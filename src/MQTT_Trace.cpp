@@ -0,0 +1,93 @@
+// Header include.
+#include "MQTT_Trace.h"
+
+// Library includes.
+#include <string.h>
+
+
+size_t MQTT_Trace::Encode_Varint(uint8_t * buffer, uint64_t value) {
+    size_t size = 0U;
+    do {
+        uint8_t encoded_byte = value & 0x7FU;
+        value >>= 7U;
+        if (value > 0U) {
+            encoded_byte |= 0x80U;
+        }
+        buffer[size++] = encoded_byte;
+    } while (value > 0U);
+    return size;
+}
+
+bool MQTT_Trace::Decode_Varint(uint8_t const * buffer, size_t const & length, size_t & index, uint64_t & value) {
+    value = 0U;
+    for (size_t shift = 0U, position = index; position < length && shift < 64U; shift += 7U, position++) {
+        uint8_t const encoded_byte = buffer[position];
+        value |= static_cast<uint64_t>(encoded_byte & 0x7FU) << shift;
+        if ((encoded_byte & 0x80U) == 0U) {
+            index = position + 1U;
+            return true;
+        }
+    }
+    return false;
+}
+
+MQTT_Trace_Reader::MQTT_Trace_Reader(uint8_t const * trace, size_t const & length)
+  : m_trace(trace)
+  , m_length(length)
+{
+    Rewind();
+}
+
+bool MQTT_Trace_Reader::Is_Valid() const {
+    return m_trace != nullptr && m_length > sizeof(MQTT_TRACE_MAGIC) && memcmp(m_trace, MQTT_TRACE_MAGIC, sizeof(MQTT_TRACE_MAGIC)) == 0 && m_trace[sizeof(MQTT_TRACE_MAGIC)] == MQTT_TRACE_VERSION;
+}
+
+bool MQTT_Trace_Reader::Next(MQTT_Trace_Record & record) {
+    if (!Is_Valid() || Is_Finished()) {
+        return false;
+    }
+    size_t index = m_index;
+    uint8_t const type = m_trace[index++];
+    if (type >= static_cast<uint8_t>(MQTT_Trace_Record_Type::MAX_VALUE)) {
+        return false;
+    }
+    uint64_t delta = 0U;
+    uint64_t topic_length = 0U;
+    if (!MQTT_Trace::Decode_Varint(m_trace, m_length, index, delta) || !MQTT_Trace::Decode_Varint(m_trace, m_length, index, topic_length) || topic_length > m_length - index) {
+        return false;
+    }
+    char const * topic = reinterpret_cast<char const *>(m_trace + index);
+    index += topic_length;
+    uint64_t payload_length = 0U;
+    if (!MQTT_Trace::Decode_Varint(m_trace, m_length, index, payload_length) || payload_length > m_length - index) {
+        return false;
+    }
+    uint8_t const * payload = m_trace + index;
+    index += payload_length;
+    uint64_t offset = 0U;
+    uint64_t total_length = payload_length;
+    if (type == static_cast<uint8_t>(MQTT_Trace_Record_Type::RECEIVE_SLICE) && (!MQTT_Trace::Decode_Varint(m_trace, m_length, index, offset) || !MQTT_Trace::Decode_Varint(m_trace, m_length, index, total_length))) {
+        return false;
+    }
+
+    m_index = index;
+    m_timestamp += delta;
+    record.type = static_cast<MQTT_Trace_Record_Type>(type);
+    record.timestamp = m_timestamp;
+    record.topic = topic;
+    record.topic_length = topic_length;
+    record.payload = payload;
+    record.payload_length = payload_length;
+    record.offset = offset;
+    record.total_length = total_length;
+    return true;
+}
+
+bool MQTT_Trace_Reader::Is_Finished() const {
+    return m_index >= m_length;
+}
+
+void MQTT_Trace_Reader::Rewind() {
+    m_index = sizeof(MQTT_TRACE_MAGIC) + sizeof(MQTT_TRACE_VERSION);
+    m_timestamp = 0U;
+}
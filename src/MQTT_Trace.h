@@ -0,0 +1,98 @@
+#ifndef MQTT_Trace_h
+#define MQTT_Trace_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Magic bytes at the start of every trace, followed by the version of the record format.
+uint8_t constexpr MQTT_TRACE_MAGIC[] = { 'T', 'B', 'M', 'T' };
+uint8_t constexpr MQTT_TRACE_VERSION = 1U;
+// Maximum size of a variable length encoded integer, a 64-bit value requires at most ten groups of 7 bits.
+size_t constexpr MQTT_TRACE_MAX_VARINT_SIZE = 10U;
+
+
+/// @brief Kind of the recorded event, outbound records are only kept for analysis while replaying only ever delivers the inbound records
+enum class MQTT_Trace_Record_Type : uint8_t {
+    CONNECT, ///< Connection attempt, the topic contains the client id and the payload contains a single byte with the result
+    DISCONNECT, ///< Disconnect requested by the client, without topic and payload
+    PUBLISH, ///< Outbound message, contains the topic and the payload
+    SUBSCRIBE, ///< Subscribed topic, without payload
+    UNSUBSCRIBE, ///< Unsubscribed topic, without payload
+    RECEIVE, ///< Inbound message that was passed to the data callback, contains the topic and the complete payload
+    RECEIVE_SLICE, ///< Slice of an inbound message that was passed to the stream callback, additionally contains the offset of the slice and the total length of the message
+    MAX_VALUE ///< Amount of record types, not a valid type itself
+};
+
+
+/// @brief Single recorded event of a trace, points directly into the trace buffer instead of copying the topic and payload
+struct MQTT_Trace_Record {
+    MQTT_Trace_Record_Type type = {};     // Kind of the recorded event
+    uint64_t               timestamp = {}; // Time the event occured at in microseconds, relative to the first record of the trace
+    char const             *topic = {};    // Topic of the event, not null-terminated
+    size_t                 topic_length = {}; // Length of the topic
+    uint8_t const          *payload = {};  // Payload of the event
+    size_t                 payload_length = {}; // Length of the payload
+    size_t                 offset = {};    // Offset of the slice from the start of the complete payload, only set for RECEIVE_SLICE records
+    size_t                 total_length = {}; // Total length of the complete payload, only set for RECEIVE_SLICE records
+};
+
+
+/// @brief Compact binary format MQTT sessions are recorded into, starting with the magic bytes and the version followed by the records of the session.
+/// Every record starts with its type, followed by the time passed since the previous record in microseconds, the length and content of the topic and the length and content of the payload,
+/// slices additionally end with their offset and the total length of the message. All lengths and times are unsigned variable length encoded integers (LEB128),
+/// which keeps the overhead of small messages at a few bytes, because the topics and payloads make up nearly all of the trace
+class MQTT_Trace {
+  public:
+    /// @brief Encodes the given value as an unsigned variable length integer
+    /// @param buffer Buffer the encoded value is written into, needs to be at least MQTT_TRACE_MAX_VARINT_SIZE bytes big
+    /// @param value Value that should be encoded
+    /// @return Amount of bytes written into the buffer
+    static size_t Encode_Varint(uint8_t * buffer, uint64_t value);
+
+    /// @brief Decodes an unsigned variable length integer from the given buffer
+    /// @param buffer Buffer the value should be decoded from
+    /// @param length Length of the buffer
+    /// @param index Index the value starts at, is advanced past the value if decoding was successful
+    /// @param value Decoded value
+    /// @return Whether the value could be decoded or not, fails if the buffer ended before the value
+    static bool Decode_Varint(uint8_t const * buffer, size_t const & length, size_t & index, uint64_t & value);
+};
+
+
+/// @brief Iterates over the records of a trace kept completely in memory, the returned records point directly into the given buffer
+class MQTT_Trace_Reader {
+  public:
+    /// @brief Constructor
+    /// @param trace Recorded trace, has to stay valid for the lifetime of this instance
+    /// @param length Length of the recorded trace
+    MQTT_Trace_Reader(uint8_t const * trace, size_t const & length);
+
+    /// @brief Whether the trace starts with the expected magic bytes and a supported version
+    /// @return Whether the trace can be read or not
+    bool Is_Valid() const;
+
+    /// @brief Reads the next record of the trace
+    /// @param record Record the next event is read into
+    /// @return Whether a record could be read or not, fails once the end of the trace has been reached or if the trace is truncated
+    bool Next(MQTT_Trace_Record & record);
+
+    /// @brief Whether every record of the trace has been read
+    /// @return Whether the end of the trace has been reached
+    bool Is_Finished() const;
+
+    /// @brief Starts reading from the first record of the trace again
+    void Rewind();
+
+  private:
+    uint8_t const *m_trace = {};     // Recorded trace
+    size_t        m_length = {};     // Length of the recorded trace
+    size_t        m_index = {};      // Index of the next record
+    uint64_t      m_timestamp = {};  // Accumulated time of the previously read record in microseconds
+};
+
+#endif // MQTT_Trace_h
@@ -9,38 +9,12 @@
 
 
 uint8_t constexpr MAX_FW_TOPIC_SIZE = 33U;
-uint8_t constexpr OTA_ATTRIBUTE_KEYS_AMOUNT = 5U;
 char constexpr NO_FW_REQUEST_RESPONSE[] = "Did not receive requested shared attribute firmware keys. Ensure keys exist and device is connected";
-// Firmware topics.
-char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/";
-char constexpr FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/fw/response/+";
-char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/%u/chunk/%u";
-// Firmware data keys.
-char constexpr CURR_FW_TITLE_KEY[] = "current_fw_title";
-char constexpr CURR_FW_VER_KEY[] = "current_fw_version";
-char constexpr FW_ERROR_KEY[] = "fw_error";
-char constexpr FW_STATE_KEY[] = "fw_state";
-char constexpr FW_VER_KEY[] = "fw_version";
-char constexpr FW_TITLE_KEY[] = "fw_title";
-char constexpr FW_CHKS_KEY[] = "fw_checksum";
-char constexpr FW_CHKS_ALGO_KEY[] = "fw_checksum_algorithm";
-char constexpr FW_SIZE_KEY[] = "fw_size";
-char constexpr CHECKSUM_AGORITM_MD5[] = "MD5";
-char constexpr CHECKSUM_AGORITM_SHA256[] = "SHA256";
-char constexpr CHECKSUM_AGORITM_SHA384[] = "SHA384";
-char constexpr CHECKSUM_AGORITM_SHA512[] = "SHA512";
 // Log messages.
 char constexpr NUMBER_PRINTF[] = "%u";
-char constexpr NO_FW[] = "Missing shared attribute firmware keys. Ensure you assigned an OTA update with binary";
-char constexpr EMPTY_FW[] = "Received shared attribute firmware keys were NULL";
-char constexpr FW_NOT_FOR_US[] = "Received firmware title (%s) is different and not meant for this device (%s)";
-char constexpr FW_CHKS_ALGO_NOT_SUPPORTED[] = "Received checksum algorithm (%s) is not supported";
 char constexpr NOT_ENOUGH_RAM[] = "Temporary allocating more internal client buffer failed, decrease OTA chunk size or decrease overall heap usage";
 char constexpr RESETTING_FAILED[] = "Preparing for OTA firmware updates failed, attributes might be NULL";
 #if THINGSBOARD_ENABLE_DEBUG
-char constexpr PAGE_BREAK[] = "=================================";
-char constexpr NEW_FW[] = "A new Firmware is available:";
-char constexpr FROM_TOO[] = "(%s) => (%s)";
 char constexpr DOWNLOADING_FW[] = "Attempting to download over MQTT...";
 #endif // THINGSBOARD_ENABLE_DEBUG
 
@@ -62,9 +36,11 @@ class OTA_Firmware_Update : public IAPI_Implementation {
       , m_get_send_size_callback()
       , m_set_buffer_size_callback()
       , m_get_request_id_callback()
+      , m_topic_profile(&DEFAULT_TOPIC_PROFILE)
       , m_fw_callback()
       , m_previous_buffer_size(0U)
       , m_changed_buffer_size(false)
+      , m_stream_supported(false)
 #if THINGSBOARD_ENABLE_STL
       , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_OTA_Unsubscribe, this))
 #else
@@ -97,7 +73,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         }
 
         // Request the firmware information
-        constexpr char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY};
+        constexpr char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY, FW_CHUNK_CHKS_KEY, FW_CHUNK_CHKS_SIZE_KEY};
 #if THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_STL
         static const Attribute_Request_Callback fw_request_callback(std::bind(&OTA_Firmware_Update::Firmware_Shared_Attribute_Received, this, std::placeholders::_1), callback.Get_Timeout(), std::bind(&OTA_Firmware_Update::Request_Timeout, this), array + 0U, array + OTA_ATTRIBUTE_KEYS_AMOUNT);
@@ -135,7 +111,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         }
 
         // Subscribes to changes of the firmware information
-        char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY};
+        char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY, FW_CHUNK_CHKS_KEY, FW_CHUNK_CHKS_SIZE_KEY};
 #if THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_STL
         const Shared_Attribute_Callback fw_update_callback(std::bind(&OTA_Firmware_Update::Firmware_Shared_Attribute_Received, this, std::placeholders::_1), array + 0U, array + OTA_ATTRIBUTE_KEYS_AMOUNT);
@@ -161,7 +137,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_info;
         current_firmware_info[CURR_FW_TITLE_KEY] = current_fw_title;
         current_firmware_info[CURR_FW_VER_KEY] = current_fw_version;
-        return m_send_json_callback.Call_Callback(TELEMETRY_TOPIC, current_firmware_info, Helper::Measure_Json(current_firmware_info));
+        return m_send_json_callback.Call_Callback(m_topic_profile->telemetry, current_firmware_info, 0U);
     }
 
     /// @brief Sends the given firmware state to the cloud.
@@ -174,7 +150,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_state;
         current_firmware_state[FW_ERROR_KEY] = fw_error;
         current_firmware_state[FW_STATE_KEY] = current_fw_state;
-        return m_send_json_callback.Call_Callback(TELEMETRY_TOPIC, current_firmware_state, Helper::Measure_Json(current_firmware_state));
+        return m_send_json_callback.Call_Callback(m_topic_profile->telemetry, current_firmware_state, 0U);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -189,6 +165,18 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         m_ota.Process_Firmware_Packet(chunk, payload, length);
     }
 
+    void Process_Response_Slice(char const * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) override {
+        size_t const & request_id = m_fw_callback.Get_Request_ID();
+        char response_topic[Helper::detectSize(FIRMWARE_RESPONSE_TOPIC, request_id)] = {};
+        (void)snprintf(response_topic, sizeof(response_topic), FIRMWARE_RESPONSE_TOPIC, request_id);
+        size_t const chunk = Helper::parseRequestId(response_topic, topic);
+        m_ota.Process_Firmware_Packet_Slice(chunk, payload, length, offset, total_length);
+    }
+
+    void Set_Stream_Supported(bool supported) override {
+        m_stream_supported = supported;
+    }
+
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         // Nothing to do
     }
@@ -206,17 +194,23 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         return Firmware_OTA_Subscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         m_ota.update();
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
+
+    uint32_t Get_Next_Deadline() const override {
+        return m_ota.Get_Remaining_Timeout();
+    }
 
     void Initialize() override {
         m_subscribe_api_callback.Call_Callback(m_fw_attribute_update);
         m_subscribe_api_callback.Call_Callback(m_fw_attribute_request);
     }
 
+    void Set_Topic_Profile(Topic_Profile const & profile) override {
+        m_topic_profile = &profile;
+    }
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_subscribe_api_callback.Set_Callback(subscribe_api_callback);
         m_send_json_callback.Set_Callback(send_json_callback);
@@ -316,6 +310,11 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     /// @param data Json data containing key-value pairs for the needed firmware information,
     /// to ensure we have a firmware assigned and can start the update over MQTT
     void Firmware_Shared_Attribute_Received(JsonObjectConst const & data) {
+        // Updates of the optional chunk checksums alone do not contain any firmware information and do not mean the firmware has changed,
+        // they are only used if they are received together with the firmware information, which is always the case when requesting the firmware information
+        if (!data.containsKey(FW_VER_KEY) && !data.containsKey(FW_TITLE_KEY) && (data.containsKey(FW_CHUNK_CHKS_KEY) || data.containsKey(FW_CHUNK_CHKS_SIZE_KEY))) {
+            return;
+        }
         // Check if firmware is available for our device
         if (!data.containsKey(FW_VER_KEY) || !data.containsKey(FW_TITLE_KEY) || !data.containsKey(FW_CHKS_KEY) || !data.containsKey(FW_CHKS_ALGO_KEY) || !data.containsKey(FW_SIZE_KEY)) {
             Logger::printfln(NO_FW);
@@ -353,21 +352,8 @@ class OTA_Firmware_Update : public IAPI_Implementation {
             return;
         }
 
-        mbedtls_md_type_t fw_checksum_algorithm = mbedtls_md_type_t{};
-
-        if (strncmp(CHECKSUM_AGORITM_MD5, fw_algorithm, strlen(CHECKSUM_AGORITM_MD5)) == 0) {
-            fw_checksum_algorithm = mbedtls_md_type_t::MBEDTLS_MD_MD5;
-        }
-        else if (strncmp(CHECKSUM_AGORITM_SHA256, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA256)) == 0) {
-            fw_checksum_algorithm = mbedtls_md_type_t::MBEDTLS_MD_SHA256;
-        }
-        else if (strncmp(CHECKSUM_AGORITM_SHA384, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA384)) == 0) {
-            fw_checksum_algorithm = mbedtls_md_type_t::MBEDTLS_MD_SHA384;
-        }
-        else if (strncmp(CHECKSUM_AGORITM_SHA512, fw_algorithm, strlen(CHECKSUM_AGORITM_SHA512)) == 0) {
-            fw_checksum_algorithm = mbedtls_md_type_t::MBEDTLS_MD_SHA512;
-        }
-        else {
+        mbedtls_md_type_t const fw_checksum_algorithm = HashGenerator::string_to_type(fw_algorithm);
+        if (fw_checksum_algorithm == mbedtls_md_type_t::MBEDTLS_MD_NONE) {
             char message[strlen(FW_CHKS_ALGO_NOT_SUPPORTED) + strlen(fw_algorithm) + 2] = {};
             (void)snprintf(message, sizeof(message), FW_CHKS_ALGO_NOT_SUPPORTED, fw_algorithm);
             Logger::printfln(message);
@@ -397,7 +383,8 @@ class OTA_Firmware_Update : public IAPI_Implementation {
 
         // Get the previous buffer size and cache it so the previous settings can be restored.
         m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
-        m_changed_buffer_size = m_previous_buffer_size < (chunk_size + 50U);
+        // Chunks that do not fit into the receive buffer are streamed in slices directly into the updater if the client supports it, therefore the buffer does not need to be increased
+        m_changed_buffer_size = !m_stream_supported && m_previous_buffer_size < (chunk_size + 50U);
 
         // Increase size of receive buffer
         if (m_changed_buffer_size && !m_set_buffer_size_callback.Call_Callback(chunk_size + 50U, m_get_send_size_callback.Call_Callback())) {
@@ -407,7 +394,15 @@ class OTA_Firmware_Update : public IAPI_Implementation {
             return;
         }
 
-        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm);
+        // Chunk checksums are optional and only usable if they were calculated with the same chunk size the firmware is requested with
+        char const * fw_chunk_checksums = data[FW_CHUNK_CHKS_KEY];
+        uint16_t const fw_chunk_checksums_size = data[FW_CHUNK_CHKS_SIZE_KEY];
+        if (fw_chunk_checksums != nullptr && fw_chunk_checksums_size != chunk_size) {
+            Logger::printfln(FW_CHUNK_CHKS_SIZE_MISMATCH, fw_chunk_checksums_size, chunk_size);
+            fw_chunk_checksums = nullptr;
+        }
+
+        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm, fw_chunk_checksums);
     }
 
 #if !THINGSBOARD_ENABLE_STL
@@ -461,10 +456,12 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     Callback<uint16_t>                                                       m_get_send_size_callback = {};            // Get client send buffer size callback
     Callback<bool, uint16_t, uint16_t>                                       m_set_buffer_size_callback = {};          // Set client buffer size callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};           // Get internal request id callback
+    Topic_Profile const                                                      *m_topic_profile = {};                    // Topics the current firmware information and the firmware state are sent over
 
     OTA_Update_Callback                                                      m_fw_callback = {};                       // OTA update response callback
     uint16_t                                                                 m_previous_buffer_size = {};              // Previous buffer size of the underlying client, used to revert to the previously configured buffer size if it was temporarily increased by the OTA update
     bool                                                                     m_changed_buffer_size = {};               // Whether the buffer size had to be changed, because the previous internal buffer size was to small to hold the firmware chunks
+    bool                                                                     m_stream_supported = {};                  // Whether the underlying client streams chunks that do not fit into the receive buffer, which makes increasing the buffer size unnecessary
     OTA_Handler<Logger>                                                      m_ota = {};                               // Class instance that handles the flashing and creating a hash from the given received binary firmware data
     char                                                                     m_response_topic[MAX_FW_TOPIC_SIZE] = {}; // Firmware response topic that contains the specific request ID of the firmware we actually want to download
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -15,14 +15,31 @@
 #include <string.h>
 
 
+uint8_t constexpr OTA_ATTRIBUTE_KEYS_AMOUNT = 7U;
 // Firmware data keys.
 char constexpr FW_STATE_DOWNLOADING[] = "DOWNLOADING";
 char constexpr FW_STATE_DOWNLOADED[] = "DOWNLOADED";
 char constexpr FW_STATE_UPDATING[] = "UPDATING";
 char constexpr FW_STATE_FAILED[] = "FAILED";
 char constexpr FW_STATE_UPDATED[] = "UPDATED";
+char constexpr CURR_FW_TITLE_KEY[] = "current_fw_title";
+char constexpr CURR_FW_VER_KEY[] = "current_fw_version";
+char constexpr FW_ERROR_KEY[] = "fw_error";
+char constexpr FW_STATE_KEY[] = "fw_state";
+char constexpr FW_VER_KEY[] = "fw_version";
+char constexpr FW_TITLE_KEY[] = "fw_title";
+char constexpr FW_CHKS_KEY[] = "fw_checksum";
+char constexpr FW_CHKS_ALGO_KEY[] = "fw_checksum_algorithm";
+char constexpr FW_SIZE_KEY[] = "fw_size";
+char constexpr FW_CHUNK_CHKS_KEY[] = "fw_chunk_checksums";
+char constexpr FW_CHUNK_CHKS_SIZE_KEY[] = "fw_chunk_checksums_size";
 
 // Log messages.
+char constexpr NO_FW[] = "Missing shared attribute firmware keys. Ensure you assigned an OTA update with binary";
+char constexpr EMPTY_FW[] = "Received shared attribute firmware keys were NULL";
+char constexpr FW_NOT_FOR_US[] = "Received firmware title (%s) is different and not meant for this device (%s)";
+char constexpr FW_CHKS_ALGO_NOT_SUPPORTED[] = "Received checksum algorithm (%s) is not supported";
+char constexpr FW_CHUNK_CHKS_SIZE_MISMATCH[] = "Received chunk checksums were calculated for chunk size (%u) instead of the configured chunk size (%u), only the complete firmware will be verified";
 char constexpr OTA_CB_IS_NULL[] = "OTA update callback is NULL, has it been deleted";
 char constexpr UNABLE_TO_REQUEST_CHUNCKS[] = "Unable to request firmware chunk";
 char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u), not the same as requested chunk (%u)";
@@ -33,11 +50,21 @@ char constexpr ERROR_UPDATE_END[] = "Error during flash updater not all bytes wr
 char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%s), not the same as expected checksum (%s)";
 char constexpr FW_UPDATE_ABORTED[] = "Firmware update aborted";
 char constexpr CHUNK_REQUEST_TIMED_OUT[] = "Failed to receive requested chunk (%u) in (%llu) us. Internet connection might have been lost";
+char constexpr CHUNK_CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%08x) of chunk (%u), not the same as expected checksum (%08x)";
+char constexpr CHUNK_CHECKSUMS_INVALID[] = "Received chunk checksums do not contain one valid CRC-32 for each of the (%u) chunks, only the complete firmware will be verified";
+char constexpr CHUNK_CHECKSUMS_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for chunk checksums, only the complete firmware will be verified";
+char constexpr FW_CACHE_ALLOCATION_FAILED[] = "Failed allocating required size (%u) to read the cached firmware, downloading it from the server instead";
+char constexpr FW_CACHE_READ_FAILED[] = "Reading chunk (%u) of the cached firmware failed";
+char constexpr FW_CACHE_INVALID[] = "Removing cached firmware, because it could not be read or failed verification, downloading it from the server instead";
 #if THINGSBOARD_ENABLE_DEBUG
+char constexpr PAGE_BREAK[] = "=================================";
+char constexpr NEW_FW[] = "A new Firmware is available:";
+char constexpr FROM_TOO[] = "(%s) => (%s)";
 char constexpr FW_CHUNK[] = "Receive chunk (%u), with size (%u) bytes";
 char constexpr HASH_EXPECTED[] = "Expected checksum: (%s)";
 char constexpr CHECKSUM_VERIFICATION_SUCCESS[] = "Checksum is the same as expected";
 char constexpr FW_UPDATE_SUCCESS[] = "Update success";
+char constexpr FW_CACHE_HIT[] = "Serving firmware from the cache";
 #endif // THINGSBOARD_ENABLE_DEBUG
 // Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
 size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
@@ -53,7 +80,9 @@ class OTA_Handler {
     /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
     /// @param send_fw_state_callback Callback that is used to send information about the current state of the over the air update
     /// @param finish_callback Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    OTA_Handler(Callback<bool, size_t const &, size_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback)
+    /// @param detect_request_timeout Whether a timer should be started for every requested chunk, that handles the request as failed if the chunk was not received in the timeout configured in the OTA_Update_Callback.
+    /// Transports that receive the chunks synchronously detect failed requests themselves and should instead call Handle_Request_Timeout() directly, default = true
+    OTA_Handler(Callback<bool, size_t const &, size_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback, bool detect_request_timeout = true)
       : m_fw_callback(nullptr)
       , m_publish_callback(publish_callback)
       , m_send_fw_state_callback(send_fw_state_callback)
@@ -61,31 +90,88 @@ class OTA_Handler {
       , m_fw_size(0U)
       , m_fw_checksum()
       , m_fw_checksum_algorithm()
+      , m_fw_checksum_bytes()
+      , m_fw_checksum_length(0U)
+      , m_chunk_checksums(nullptr)
+      , m_chunk_checksum_amount(0U)
       , m_hash()
       , m_total_chunks(0U)
       , m_requested_chunks(0U)
       , m_retries(0U)
+      , m_detect_request_timeout(detect_request_timeout)
+      , m_slice_chunk_started(false)
+      , m_slice_checksum(0U)
+      , m_fw_cache(nullptr)
+      , m_from_cache(false)
+      , m_cache_buffer(nullptr)
+      , m_storing(false)
+      , m_finished(false)
       , m_watchdog(std::bind(&OTA_Handler::Handle_Request_Timeout, this))
     {
         // Nothing to do
     }
 
+    /// @brief Destructor
+    ~OTA_Handler() {
+        Free_Chunk_Checksums();
+        Free_Cache_Buffer();
+    }
+
     /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
     /// @param fw_callback Callback method that contains configuration information, about the over the air update
     /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
     /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
     /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
-    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, size_t const & fw_size, char const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm) {
+    /// @param fw_chunk_checksums Optional hex string of the big-endian CRC-32 of every single chunk, with the chunk size configured in the given callback.
+    /// If it is valid every chunk is verified as soon as it is received and only a corrupted chunk has to be downloaded again, instead of the complete firmware binary, default = nullptr
+    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, size_t const & fw_size, char const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm, char const * fw_chunk_checksums = nullptr) {
         m_fw_callback = &fw_callback;
         m_fw_size = fw_size;
         m_total_chunks = (m_fw_size / m_fw_callback->Get_Chunk_Size()) + 1U;
         (void)strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum));
+        // Decode the expected checksum once, so that it can be compared with the calculated binary hash directly, without having to encode the calculated hash first.
+        // Invalid checksums are decoded into a length of 0, which never matches the size of the calculated hash and therefore causes the verification to fail
+        m_fw_checksum_length = HashGenerator::decode_hex(m_fw_checksum, m_fw_checksum_bytes, sizeof(m_fw_checksum_bytes));
         m_fw_checksum_algorithm = fw_checksum_algorithm;
+        Decode_Chunk_Checksums(fw_chunk_checksums);
         m_fw_updater = m_fw_callback->Get_Updater();
+        m_fw_cache = m_fw_callback->Get_Firmware_Cache();
+        m_finished = false;
+        m_storing = false;
+        // Invalid checksums can never be verified, therefore firmware with an invalid checksum is neither served from nor stored into the cache
+        m_from_cache = m_fw_cache != nullptr && m_fw_checksum_length > 0U && m_fw_cache->open(m_fw_checksum, m_fw_size) && Allocate_Cache_Buffer();
         Request_First_Firmware_Packet();
+        // Prepared after the updater has been reset for the first packet, so the preparation can run while the first packet is still being requested
+        m_fw_updater->prepare(m_fw_size);
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
     }
 
+    /// @brief Reads the next chunk of the cached firmware and processes it exactly like a received chunk, if the firmware is currently served from the cache.
+    /// Only a single chunk is processed per call, so that flashing cached firmware never blocks for longer than flashing a single received chunk.
+    /// Called from update() for transports that detect request timeouts with the watchdog, even when using the ESP Timer, so that flashing never blocks its high priority task.
+    /// Transports that receive the chunks synchronously have to call it themselves before requesting a chunk.
+    /// If the cached firmware can not be read or fails verification, the entry is removed and the update continues with requesting the chunks from the server
+    /// @return Whether a chunk of the cached firmware was handled, false if the firmware is not or no longer served from the cache and the chunk has to be requested from the server instead
+    bool Serve_Cached_Chunk() {
+        if (!m_from_cache || m_finished) {
+            return false;
+        }
+        uint16_t const chunk_size = m_fw_callback->Get_Chunk_Size();
+        size_t const offset = m_requested_chunks * chunk_size;
+        // The last chunk contains the remaining bytes, which is 0 if the firmware size is a multiple of the chunk size
+        size_t const expected_size = (offset + chunk_size > m_fw_size) ? m_fw_size - offset : chunk_size;
+        if (expected_size > 0U && m_fw_cache->read(offset, m_cache_buffer, expected_size) != expected_size) {
+            char message[Helper::detectSize(FW_CACHE_READ_FAILED, m_requested_chunks)] = {};
+            (void)snprintf(message, sizeof(message), FW_CACHE_READ_FAILED, m_requested_chunks);
+            Logger::printfln(message);
+            (void)Invalidate_Cached_Firmware();
+            Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            return true;
+        }
+        Process_Firmware_Packet(m_requested_chunks, m_cache_buffer, expected_size);
+        return true;
+    }
+
     /// @brief Stops the firmware update completly and informs that user that the update has failed because it has been aborted, ongoing communication is discarded.
     /// Be aware the written partition is not erased so the already written binary firmware data still remains in the flash partition,
     /// shouldn't really matter, because if we start the update process again the partition will be overwritten anyway and a partially written firmware will not be bootable
@@ -118,27 +204,177 @@ class OTA_Handler {
         Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
-        if (current_chunk == 0U) {
-            // Initialize Flash
-            if (!m_fw_updater->begin(m_fw_size)) {
-                Logger::printfln(ERROR_UPDATE_BEGIN);
-                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+        // Verify the chunk before it is written, so that a corrupted chunk can simply be requested again,
+        // instead of only noticing the corruption once the complete firmware has been downloaded and having to restart the complete update
+        if (!Verify_Chunk_Checksum(current_chunk, Helper::calculateCrc32(payload, total_bytes), OTA_Failure_Response::RETRY_CHUNK)) {
+            return;
+        }
+
+        if (current_chunk == 0U && !Begin_Firmware_Update()) {
+            return;
+        }
+
+        if (!Write_Firmware_Data(payload, total_bytes)) {
+            return;
+        }
+        Finish_Firmware_Packet(current_chunk);
+    }
+
+    /// @brief Handles a slice of a firmware packet, that is received in multiple consecutive slices, because it did not fit into the receive buffer of the underlying client.
+    /// Every slice is written and added to the hash directly, which allows to receive chunks without requiring a buffer that can hold the complete chunk.
+    /// Because the slices are written before the complete chunk could be verified, a corrupted chunk requires restarting the complete update, instead of only requesting the chunk again
+    /// @param current_chunk Index of the chunk the slice is part of
+    /// @param payload Firmware binary data of the slice
+    /// @param length Amount of bytes in the slice
+    /// @param offset Offset of the slice from the start of the chunk
+    /// @param total_bytes Total amount of bytes in the chunk
+    void Process_Firmware_Packet_Slice(size_t const & current_chunk, uint8_t * payload, size_t const & length, size_t const & offset, size_t const & total_bytes) {
+        if (offset == 0U) {
+            m_slice_chunk_started = false;
+            if (current_chunk != m_requested_chunks) {
+                Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_requested_chunks);
+                return;
+            }
+            size_t expected_chunk_size = 0U;
+            if (!Received_Valid_Chunk_Size(total_bytes, expected_chunk_size)) {
+                Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, expected_chunk_size, total_bytes);
+                return;
+            }
+    #if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
+    #endif // THINGSBOARD_ENABLE_DEBUG
+            if (current_chunk == 0U && !Begin_Firmware_Update()) {
+                return;
             }
+            m_slice_chunk_started = true;
+            m_slice_checksum = 0U;
+        }
+
+        // Slices of chunks that were not expected or that already failed are ignored, to ensure only complete chunks are written
+        if (!m_slice_chunk_started || current_chunk != m_requested_chunks) {
+            return;
+        }
+        m_slice_checksum = Helper::calculateCrc32(payload, length, m_slice_checksum);
+        if (!Write_Firmware_Data(payload, length)) {
+            m_slice_chunk_started = false;
+            return;
+        }
+        else if (offset + length < total_bytes) {
+            return;
+        }
+
+        // The watchdog is only stopped once the complete chunk has been received, so that an interrupted chunk still times out
+        m_watchdog.detach();
+        m_slice_chunk_started = false;
+        if (!Verify_Chunk_Checksum(current_chunk, m_slice_checksum, OTA_Failure_Response::RETRY_UPDATE)) {
+            return;
+        }
+        Finish_Firmware_Packet(current_chunk);
+    }
+
+    /// @brief Serves the next chunk of cached firmware and when not being able to use the ESP Timer, updates the watchdog timer which uses a simple software time in the background.
+    /// Ensure to call recently often for higher precision. Meaning the timer is actually triggered closer to the specified waiting time
+    void update() {
+        // Cached firmware is served one chunk per call, if the chunks are not served by the transport itself
+        if (m_detect_request_timeout) {
+            (void)Serve_Cached_Chunk();
+        }
+#if !THINGSBOARD_USE_ESP_TIMER
+        m_watchdog.update();
+#endif // !THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Gets the time until the watchdog timer of the currently requested firmware chunk expires, which is the latest time update() has to be called again at
+    /// @return Amount of milliseconds until the timer expires, 0 if it already expired or the next chunk of cached firmware can be served and UINT32_MAX if no firmware chunk is requested.
+    /// When using the ESP Timer only the cached firmware is considered, because the watchdog timer is handled by the FreeRTOS timer in the background
+    uint32_t Get_Remaining_Timeout() const {
+        if (m_detect_request_timeout && m_from_cache && !m_finished) {
+            return 0U;
+        }
+#if THINGSBOARD_USE_ESP_TIMER
+        return UINT32_MAX;
+#else
+        return m_watchdog.Get_Remaining_Time();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time,
+    /// can additionally be called directly by transports that detect a failed request themselves, to request the same chunk again
+    void Handle_Request_Timeout()  {
+        uint64_t const & timeout = m_fw_callback->Get_Timeout();
+        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
+        Logger::printfln(message);
+        // Parts of a chunk that was interrupted while it was streamed have already been written, therefore the complete update has to be restarted
+        OTA_Failure_Response const failure_response = m_slice_chunk_started ? OTA_Failure_Response::RETRY_UPDATE : OTA_Failure_Response::RETRY_CHUNK;
+        m_slice_chunk_started = false;
+        Handle_Failure(failure_response, message);
+    }
+
+  private:
+    /// @brief Verifies the calculated CRC-32 of the given chunk against the received chunk checksums, if they were received
+    /// @param current_chunk Index of the chunk that should be verified
+    /// @param calculated_checksum Calculated CRC-32 of the received chunk
+    /// @param failure_response Way the update should be retried, if the verification failed
+    /// @return Whether the chunk is valid or not, always valid if no chunk checksums were received
+    bool Verify_Chunk_Checksum(size_t const & current_chunk, uint32_t const & calculated_checksum, OTA_Failure_Response const & failure_response) {
+        if (current_chunk >= m_chunk_checksum_amount) {
+            return true;
+        }
+        uint8_t const * expected = m_chunk_checksums + (current_chunk * sizeof(uint32_t));
+        uint32_t const expected_checksum = (static_cast<uint32_t>(expected[0U]) << 24U) | (static_cast<uint32_t>(expected[1U]) << 16U) | (static_cast<uint32_t>(expected[2U]) << 8U) | expected[3U];
+        if (calculated_checksum == expected_checksum) {
+            return true;
         }
+        char message[Helper::detectSize(CHUNK_CHECKSUM_VERIFICATION_FAILED, calculated_checksum, current_chunk, expected_checksum)] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_CHECKSUM_VERIFICATION_FAILED, calculated_checksum, current_chunk, expected_checksum);
+        Logger::printfln(message);
+        // Corrupted chunks of cached firmware would be read again on every retry, therefore the entry is removed and the complete update downloaded from the server instead
+        Handle_Failure(Invalidate_Cached_Firmware() ? OTA_Failure_Response::RETRY_UPDATE : failure_response, message);
+        return false;
+    }
 
+    /// @brief Initializes the flash partition the firmware is written into, has to be called before the first chunk is written
+    /// @return Whether initializing was successful or not
+    bool Begin_Firmware_Update() {
+        if (m_fw_updater->begin(m_fw_size)) {
+            return true;
+        }
+        Logger::printfln(ERROR_UPDATE_BEGIN);
+        Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+        return false;
+    }
+
+    /// @brief Writes the given firmware binary data to the flash partition and adds it to the hash of the complete firmware
+    /// @param payload Firmware binary data that should be written
+    /// @param length Amount of bytes that should be written
+    /// @return Whether writing the data was successful or not
+    bool Write_Firmware_Data(uint8_t * payload, size_t const & length) {
         // Write received binary data to flash partition
-        size_t const written_bytes = m_fw_updater->write(payload, total_bytes);
-        if (written_bytes != total_bytes) {
-            char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, total_bytes)] = {};
-            (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
+        size_t const written_bytes = m_fw_updater->write(payload, length);
+        if (written_bytes != length) {
+            char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, length)] = {};
+            (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, length);
             Logger::printfln(message);
-            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            return false;
         }
 
         // Update value only if writing to flash was a success, result is ignored,
         // because it can only fail if the input parameters are invalid
-        (void)m_hash.update(payload, total_bytes);
+        (void)m_hash.update(payload, length);
+
+        // Failing to store the binary does not affect the update itself, the firmware is simply downloaded from the server again by the next update
+        if (m_storing && m_fw_cache->store(payload, length) != length) {
+            m_fw_cache->end_store(false);
+            m_storing = false;
+        }
+        return true;
+    }
 
+    /// @brief Marks the given chunk as received and requests the next chunk, or finishes the update if it was the last one
+    /// @param current_chunk Index of the chunk that has been received and written completely
+    void Finish_Firmware_Packet(size_t const & current_chunk) {
         m_requested_chunks = current_chunk + 1;
         m_fw_callback->Call_Progress_Callback(m_requested_chunks, m_total_chunks);
 
@@ -154,15 +390,6 @@ class OTA_Handler {
         Request_Next_Firmware_Packet();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Used to update the watchdog timer which uses a simple software time in the background. Ensure to call recently often for higher precision.
-    /// Meaning the timer is actually triggered closer to the specified waiting time
-    void update() {
-        m_watchdog.update();
-    }
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-  private:
     /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
     /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
     /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
@@ -180,14 +407,59 @@ class OTA_Handler {
         return received_chunk_size == m_fw_callback->Get_Chunk_Size();
     }
 
+    /// @brief Decodes the given hex string of chunk checksums into a heap allocated buffer, so that each received chunk can be verified directly.
+    /// If the string does not contain exactly one checksum for every chunk that contains data, the checksums are discarded and only the complete firmware is verified in the end
+    /// @param fw_chunk_checksums Hex string of the big-endian CRC-32 of every single chunk or nullptr if no chunk checksums are available
+    void Decode_Chunk_Checksums(char const * fw_chunk_checksums) {
+        Free_Chunk_Checksums();
+        if (Helper::stringIsNullorEmpty(fw_chunk_checksums)) {
+            return;
+        }
+
+        uint16_t const chunk_size = m_fw_callback->Get_Chunk_Size();
+        // Amount of chunks that actually contain data, which is one less than the total amount of chunks if the firmware size is a multiple of the chunk size
+        size_t const chunk_amount = (m_fw_size + chunk_size - 1U) / chunk_size;
+        size_t const size = chunk_amount * sizeof(uint32_t);
+        if (strlen(fw_chunk_checksums) != size * 2U) {
+            Logger::printfln(CHUNK_CHECKSUMS_INVALID, chunk_amount);
+            return;
+        }
+
+        m_chunk_checksums = new uint8_t[size];
+        if (m_chunk_checksums == nullptr) {
+            Logger::printfln(CHUNK_CHECKSUMS_ALLOCATION_FAILED, size);
+            return;
+        }
+        else if (HashGenerator::decode_hex(fw_chunk_checksums, m_chunk_checksums, size) != size) {
+            Logger::printfln(CHUNK_CHECKSUMS_INVALID, chunk_amount);
+            return Free_Chunk_Checksums();
+        }
+        m_chunk_checksum_amount = chunk_amount;
+    }
+
+    /// @brief Releases the decoded chunk checksums, because they are not required anymore once the update has been finished
+    void Free_Chunk_Checksums() {
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] m_chunk_checksums;
+        m_chunk_checksums = nullptr;
+        m_chunk_checksum_amount = 0U;
+    }
+
     /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunk
     void Request_First_Firmware_Packet()  {
         m_requested_chunks = 0U;
+        m_slice_chunk_started = false;
         m_retries = m_fw_callback->Get_Chunk_Retries();
         // Hash start result is ignored, because it can only fail if the input parameters are invalid
+        m_hash.set_backend(m_fw_callback->Get_Hash_Backend());
         (void)m_hash.start(m_fw_checksum_algorithm);
         m_watchdog.detach();
         m_fw_updater->reset();
+        // Restarting discards the partially stored binary, because the binary is always stored in order starting with the first byte
+        if (m_fw_cache != nullptr && !m_from_cache && m_fw_checksum_length > 0U) {
+            m_storing = m_fw_cache->begin_store(m_fw_checksum, m_fw_size);
+        }
         Request_Next_Firmware_Packet();
     }
 
@@ -199,6 +471,10 @@ class OTA_Handler {
             Finish_Firmware_Update();   
             return;
         }
+        // Chunks of cached firmware are read by Serve_Cached_Chunk() instead of being requested from the server
+        else if (m_from_cache) {
+            return;
+        }
 
         if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_requested_chunks)) {
             Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
@@ -208,7 +484,62 @@ class OTA_Handler {
         // that after the given timeout the callback calls this method again and can then publish the request successfully.
         // This works because the request fails most of the time, because the internet connection might have been temporarily disconnected.
         // Therefore waiting a while and then retrying, means we might be reconnected again
-        m_watchdog.once(m_fw_callback->Get_Timeout());
+        if (m_detect_request_timeout) {
+            m_watchdog.once(m_fw_callback->Get_Timeout());
+        }
+    }
+
+    /// @brief Allocates the buffer the chunks of the cached firmware are read into, which is kept until the firmware is not served from the cache anymore
+    /// @return Whether the buffer could be allocated, if not the cached firmware is closed and the firmware downloaded from the server instead
+    bool Allocate_Cache_Buffer() {
+        Free_Cache_Buffer();
+        uint16_t const chunk_size = m_fw_callback->Get_Chunk_Size();
+        m_cache_buffer = new uint8_t[chunk_size]();
+        if (m_cache_buffer == nullptr) {
+            Logger::printfln(FW_CACHE_ALLOCATION_FAILED, chunk_size);
+            m_fw_cache->close();
+            return false;
+        }
+    #if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(FW_CACHE_HIT);
+    #endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
+
+    /// @brief Frees the buffer the chunks of the cached firmware are read into
+    void Free_Cache_Buffer() {
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] m_cache_buffer;
+        m_cache_buffer = nullptr;
+    }
+
+    /// @brief Removes the cached firmware that is currently being served, because it could not be read or failed verification, so that the next update downloads it from the server again
+    /// @return Whether the firmware was served from the cache and has been removed or not
+    bool Invalidate_Cached_Firmware() {
+        if (!m_from_cache) {
+            return false;
+        }
+        Logger::printfln(FW_CACHE_INVALID);
+        m_fw_cache->close();
+        m_fw_cache->remove(m_fw_checksum);
+        m_from_cache = false;
+        Free_Cache_Buffer();
+        return true;
+    }
+
+    /// @brief Closes the cached firmware that is currently being served and ends storing the downloaded firmware, once the update has been verified or finally failed
+    /// @param verified Whether the complete firmware has been verified, meaning the stored binary can be committed
+    void Close_Firmware_Cache(bool const & verified) {
+        if (m_storing) {
+            m_fw_cache->end_store(verified);
+            m_storing = false;
+        }
+        if (m_from_cache) {
+            m_fw_cache->close();
+            m_from_cache = false;
+            Free_Cache_Buffer();
+        }
     }
 
     /// @brief Completes the firmware update, which consists of checking the complete hash of the firmware binary if the initally received value,
@@ -217,21 +548,27 @@ class OTA_Handler {
     void Finish_Firmware_Update()  {
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADED, "");
 
-        char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
+        uint8_t calculated_checksum_bytes[MBEDTLS_MD_MAX_SIZE] = {};
         // Result of calculating final hash result is ignored,
         // because it can only fail if the input parameters are invalid and we check it afterwards anyway
-        (void)m_hash.finish(calculated_checksum);
+        (void)m_hash.finish(calculated_checksum_bytes);
 
-        if (strncmp(m_fw_checksum, calculated_checksum, strlen(m_fw_checksum)) != 0) {
+        if (m_fw_checksum_length != m_hash.get_size() || memcmp(m_fw_checksum_bytes, calculated_checksum_bytes, m_fw_checksum_length) != 0) {
+            // Only encode the calculated hash if the verification failed, because the string representation is only needed for the error message
+            char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
+            HashGenerator::encode_hex(calculated_checksum_bytes, m_hash.get_size(), calculated_checksum);
             char message[Helper::detectSize(CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum)] = {};
             (void)snprintf(message, sizeof(message), CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum);
             Logger::printfln(message);
+            (void)Invalidate_Cached_Firmware();
             return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
         }
 
     #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(CHECKSUM_VERIFICATION_SUCCESS);
     #endif // THINGSBOARD_ENABLE_DEBUG
+        // The binary is committed as soon as it has been verified, even if flashing it fails afterwards, because the cached binary itself is valid
+        Close_Firmware_Cache(true);
 
         if (!m_fw_updater->end()) {
             Logger::printfln(ERROR_UPDATE_END);
@@ -242,6 +579,8 @@ class OTA_Handler {
         Logger::printfln(FW_UPDATE_SUCCESS);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
+        Free_Chunk_Checksums();
+        m_finished = true;
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_UPDATING, "");
         m_fw_callback->Call_Callback(true);
         (void)m_finish_callback.Call_Callback();
@@ -253,6 +592,9 @@ class OTA_Handler {
     /// @param error_message Error message that should be printed if we abort the update
     void Handle_Failure(OTA_Failure_Response const & failure_response, char const * error_message)  {
         if (m_retries <= 0) {
+            Free_Chunk_Checksums();
+            Close_Firmware_Cache(false);
+            m_finished = true;
             (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
             m_fw_callback->Call_Callback(false);
             (void)m_finish_callback.Call_Callback();
@@ -271,6 +613,9 @@ class OTA_Handler {
                 Request_First_Firmware_Packet();
                 break;
             case OTA_Failure_Response::RETRY_NOTHING:
+                Free_Chunk_Checksums();
+                Close_Firmware_Cache(false);
+                m_finished = true;
                 (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
                 m_fw_callback->Call_Callback(false);
                 (void)m_finish_callback.Call_Callback();
@@ -281,15 +626,6 @@ class OTA_Handler {
         }
     }
 
-    /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time
-    void Handle_Request_Timeout()  {
-        uint64_t const & timeout = m_fw_callback->Get_Timeout();
-        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
-        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
-        Logger::printfln(message);
-        Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
-    }
-
     const OTA_Update_Callback                              *m_fw_callback = {};                    // Callback method that contains configuration information, about the over the air update
     Callback<bool, size_t const &, size_t const &>         m_publish_callback = {};                // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
     Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};          // Callback that is used to send information about the current state of the over the air update
@@ -297,11 +633,23 @@ class OTA_Handler {
     size_t                                                 m_fw_size = {};                         // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
     char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {}; // Checksum of the complete firmware binary, should be the same as the actually written data in the end
     mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};           // Algorithm type used to hash the firmware binary
+    uint8_t                                                m_fw_checksum_bytes[MBEDTLS_MD_MAX_SIZE] = {}; // Binary representation of the checksum of the complete firmware binary, decoded once when the update is started
+    size_t                                                 m_fw_checksum_length = {};              // Amount of bytes the checksum was decoded into, 0 if the received checksum was not a valid hex string
+    uint8_t                                                *m_chunk_checksums = {};                // Heap allocated big-endian CRC-32 of every single chunk, nullptr if the chunks are not verified seperately
+    size_t                                                 m_chunk_checksum_amount = {};           // Amount of chunk checksums, 0 if the chunks are not verified seperately
     IUpdater                                               *m_fw_updater = {};                     // Interface implementation that writes received firmware binary data onto the given device
     HashGenerator                                          m_hash = {};                            // Class instance that allows to generate a hash from received firmware binary data
     size_t                                                 m_total_chunks = {};                    // Total amount of chunks that need to be received to get the complete firmware binary
     size_t                                                 m_requested_chunks = {};                // Amount of successfully requested and received firmware binary chunks
     uint8_t                                                m_retries = {};                         // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
+    bool                                                   m_detect_request_timeout = {};          // Whether the watchdog is started for every requested chunk, disabled for transports that detect failed requests themselves
+    bool                                                   m_slice_chunk_started = {};             // Whether the first slice of the currently requested chunk has been written, while it is received in multiple slices
+    uint32_t                                               m_slice_checksum = {};                  // CRC-32 of the already received slices of the currently requested chunk
+    IFirmware_Cache                                        *m_fw_cache = {};                       // Interface implementation that serves already downloaded firmware binaries and stores newly downloaded ones, nullptr if not used
+    bool                                                   m_from_cache = {};                      // Whether the chunks are currently read from the cache instead of being requested from the server
+    uint8_t                                                *m_cache_buffer = {};                   // Heap allocated buffer a single chunk of the cached firmware is read into, nullptr if the firmware is not served from the cache
+    bool                                                   m_storing = {};                         // Whether the received firmware binary is currently being stored into the cache
+    bool                                                   m_finished = {};                        // Whether the update has been finished, either successfully or because every retry failed
     Callback_Watchdog                                      m_watchdog = {};                        // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
 };
 
@@ -6,6 +6,8 @@ OTA_Update_Callback::OTA_Update_Callback(char const * current_fw_title, char con
   , m_current_fw_title(current_fw_title)
   , m_current_fw_version(current_fw_version)
   , m_updater(updater)
+  , m_hash_backend(nullptr)
+  , m_firmware_cache(nullptr)
   , m_progress_callback(progress_callback)
   , m_update_starting_callback(update_starting_callback)
   , m_chunk_retries(chunk_retries)
@@ -39,6 +41,22 @@ void OTA_Update_Callback::Set_Updater(IUpdater* updater) {
     m_updater = updater;
 }
 
+IHash_Backend * OTA_Update_Callback::Get_Hash_Backend() const {
+    return m_hash_backend;
+}
+
+void OTA_Update_Callback::Set_Hash_Backend(IHash_Backend* hash_backend) {
+    m_hash_backend = hash_backend;
+}
+
+IFirmware_Cache * OTA_Update_Callback::Get_Firmware_Cache() const {
+    return m_firmware_cache;
+}
+
+void OTA_Update_Callback::Set_Firmware_Cache(IFirmware_Cache* firmware_cache) {
+    m_firmware_cache = firmware_cache;
+}
+
 size_t const & OTA_Update_Callback::Get_Request_ID() const {
     return m_request_id;
 }
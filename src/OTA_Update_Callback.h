@@ -6,6 +6,8 @@
 
 // Local includes.
 #include "IUpdater.h"
+#include "IHash_Backend.h"
+#include "IFirmware_Cache.h"
 
 
 // OTA default values.
@@ -77,6 +79,24 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param updater Updater implementation that writes the given firmware data
     void Set_Updater(IUpdater *updater);
 
+    /// @brief Gets the hash backend implementation, used to calculate the hash of the received firmware data instead of the default mbedtls implementation
+    /// @return Hash backend implementation or nullptr if the default mbedtls implementation is used
+    IHash_Backend * Get_Hash_Backend() const;
+
+    /// @brief Sets the hash backend implementation, used to calculate the hash of the received firmware data instead of the default mbedtls implementation.
+    /// Allows to use hardware accelerated hashing or to benchmark a different implementation against mbedtls, is only applied once the update is (re)started
+    /// @param hash_backend Hash backend implementation or nullptr to use the default mbedtls implementation, has to be kept alive until the update has finished
+    void Set_Hash_Backend(IHash_Backend *hash_backend);
+
+    /// @brief Gets the firmware cache implementation, used to serve already downloaded firmware binaries locally and to store newly downloaded ones
+    /// @return Firmware cache implementation or nullptr if every update is downloaded from the server
+    IFirmware_Cache * Get_Firmware_Cache() const;
+
+    /// @brief Sets the firmware cache implementation, used to serve already downloaded firmware binaries locally and to store newly downloaded ones.
+    /// Allows gateways that update a lot of devices with the same firmware to only download it once from the server, is only applied once the update is (re)started
+    /// @param firmware_cache Firmware cache implementation or nullptr to download every update from the server, has to be kept alive until the update has finished
+    void Set_Firmware_Cache(IFirmware_Cache *firmware_cache);
+
     /// @brief Gets the unique request identifier that is connected to the original request,
     /// and will be later used to verifiy which OTA_Update_Callback
     /// is connected to which received OTA firmware chunk update
@@ -147,6 +167,8 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     char const                                     *m_current_fw_title = {};        // Current firmware title of device
     char const                                     *m_current_fw_version = {};      // Current firmware version of device
     IUpdater                                       *m_updater = {};                 // Updater implementation used to write firmware data
+    IHash_Backend                                  *m_hash_backend = {};            // Hash backend implementation used instead of mbedtls, nullptr if mbedtls is used
+    IFirmware_Cache                                *m_firmware_cache = {};          // Firmware cache implementation downloaded binaries are served from and stored into, nullptr if every update is downloaded
     size_t                                         m_request_id = {};               // Id the request was called with
     Callback<void, size_t const &, size_t const &> m_progress_callback = {};        // Callback called when amount of downloaded chunks increased
     Callback<void>                                 m_update_starting_callback = {}; // Callback called when update is about to start (moment before topic subscription)
@@ -0,0 +1,310 @@
+#ifndef Outbound_Priority_Lanes_h
+#define Outbound_Priority_Lanes_h
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "IAPI_Implementation.h"
+
+
+// Log messages.
+char constexpr PRIORITY_LANE_FULL[] = "Outbox is busy and priority lane (%u) is full, dropping message on topic (%s)";
+char constexpr PRIORITY_LANE_ALLOCATION_FAILED[] = "Failed allocating required size (%u) to queue message in priority lane";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr PRIORITY_LANE_QUEUED[] = "Outbox is busy, queued message on topic (%s) in priority lane (%u)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Classes outgoing messages are sorted into, ordered from the highest to the lowest priority
+enum class Traffic_Class : uint8_t {
+    CONTROL, ///< Server-side RPC responses, client-side RPC requests, attribute requests, claiming and provisioning, which a callback on the device or the server is waiting for
+    OTA, ///< Firmware chunk requests, which the ongoing firmware update is waiting for
+    ATTRIBUTES, ///< Messages sent over the attribute topic
+    TELEMETRY, ///< Messages sent over the telemetry topic, which is the bulk of the traffic
+    MAX_VALUE ///< Amount of classes, not a valid class itself
+};
+
+
+/// @brief Order the queued messages of the different priority lanes are drained in
+enum class Lane_Drain_Mode : uint8_t {
+    STRICT_PRIORITY, ///< Always drains the highest priority lane that contains a message first, lower lanes are only drained once all higher lanes are empty
+    WEIGHTED ///< Drains the lanes in rounds, where every lane can send as many messages per round as its weight allows, which ensures lower lanes are never starved completly
+};
+
+
+// Amount of messages every lane can send per round when draining with Lane_Drain_Mode::WEIGHTED, ordered like Traffic_Class.
+uint8_t constexpr DEFAULT_LANE_WEIGHTS[static_cast<size_t>(Traffic_Class::MAX_VALUE)] = { 8U, 4U, 2U, 1U };
+
+
+/// @brief Prioritizes outgoing MQTT messages for clients that do not send published messages directly, but instead enqueue them into an outbox that is sent in order by another task,
+/// like the Espressif_MQTT_Client with set_enqueue_messages() enabled. Without prioritization a server-side RPC response or firmware chunk request is enqueued behind every bulk telemetry message that is already waiting in the outbox,
+/// which delays it for as long as it takes to send the complete backlog. Every Traffic_Class therefore gets its own bounded priority lane and lower priority messages are only passed on to the client as long as its outbox contains less than the configured limit of bytes,
+/// while the remaining messages are held back in their lane and passed on in loop() once the outbox has been drained again, which keeps the outbox short enough that higher priority messages only ever wait for a small amount of data.
+/// Control messages are passed on even if the outbox is busy, because holding them back would only delay them further. If passing a message on fails while connected it is queued in its lane as well and attempted to be passed on again in loop().
+/// As long as no outbox limit is configured or the client does not report the size of its outbox all messages are published directly, without any additional overhead besides checking the topic.
+/// The lanes themselves are not locked, because control messages like server-side RPC responses are published from the task of the client, while loop() is called from the user task,
+/// every call has to be serialized by the owner instead, which ThingsBoardSized does by holding its send mutex for every publish() and for every call to loop() or Get_Next_Deadline()
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Outbound_Priority_Lanes {
+  public:
+    /// @brief Constructor
+    /// @param client MQTT client the messages are published with, has to be kept alive for as long as the instance of this class
+    explicit Outbound_Priority_Lanes(IMQTT_Client & client)
+      : m_client(client)
+      , m_lanes()
+      , m_topic_profile(&DEFAULT_TOPIC_PROFILE)
+      , m_drain_mode(Lane_Drain_Mode::STRICT_PRIORITY)
+      , m_outbox_limit(0U)
+    {
+        for (size_t i = 0U; i < static_cast<size_t>(Traffic_Class::MAX_VALUE); ++i) {
+            m_lanes[i].weight = DEFAULT_LANE_WEIGHTS[i];
+            m_lanes[i].credits = DEFAULT_LANE_WEIGHTS[i];
+        }
+    }
+
+    /// @brief Destructor
+    ~Outbound_Priority_Lanes() {
+        for (auto & lane : m_lanes) {
+            while (lane.count > 0U) {
+                Pop(lane);
+            }
+        }
+    }
+
+    /// @brief Sets the amount of bytes the outbox of the client may contain before lower priority messages are held back in their lane, see IMQTT_Client::get_outbox_size() for more information.
+    /// Should be big enough to keep the client busy while loop() is not called, but as small as possible, because it is the amount of data a control message might have to wait for
+    /// @param limit Amount of bytes, 0 disables holding back messages, in which case already queued messages are published on the next call to loop()
+    void Set_Outbox_Limit(size_t const & limit) {
+        m_outbox_limit = limit;
+    }
+
+    /// @brief Sets the order the queued messages of the different lanes are drained in
+    /// @param mode Mode that should be used to drain the lanes, default = Lane_Drain_Mode::STRICT_PRIORITY
+    void Set_Drain_Mode(Lane_Drain_Mode const & mode) {
+        m_drain_mode = mode;
+    }
+
+    /// @brief Sets the amount of messages the given lane can send per round, only used when draining with Lane_Drain_Mode::WEIGHTED
+    /// @param traffic_class Class of the lane the weight should be configured for
+    /// @param weight Amount of messages per round, default see DEFAULT_LANE_WEIGHTS
+    /// @return Whether the weight could be set or not, fails for an invalid class or a weight of 0, because the lane would never be drained
+    bool Set_Weight(Traffic_Class const & traffic_class, uint8_t const & weight) {
+        if (traffic_class >= Traffic_Class::MAX_VALUE || weight == 0U) {
+            return false;
+        }
+        Lane & lane = m_lanes[static_cast<size_t>(traffic_class)];
+        lane.weight = weight;
+        lane.credits = weight;
+        return true;
+    }
+
+    /// @brief Sets the topics that are used to decide which class a message belongs to
+    /// @param profile Topics that should be used, has to be kept alive for as long as the instance of this class
+    void Set_Topic_Profile(Topic_Profile const & profile) {
+        m_topic_profile = &profile;
+    }
+
+    /// @brief Gets the MQTT client the messages are published with
+    /// @return Underlying MQTT client
+    IMQTT_Client & Get_Client() const {
+        return m_client;
+    }
+
+    /// @brief Returns our current connection status to the cloud, passed through from the underlying MQTT client
+    /// @return Whether the underlying MQTT Client is currently connected or not
+    bool connected() const {
+        return m_client.connected();
+    }
+
+    /// @brief Publishes the given message directly if the outbox of the client allows it or queues it in the lane of its class to be published later on
+    /// @param topic Topic that the message is sent over
+    /// @param json Null-terminated json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @return Whether publishing or queueing the message was successful or not
+    bool publish(char const * topic, char const * json, size_t const & length) {
+        if (m_outbox_limit == 0U && Queued_Amount() == 0U) {
+            return m_client.publish(topic, reinterpret_cast<uint8_t const *>(json), length);
+        }
+
+        Traffic_Class const traffic_class = Get_Class(topic);
+        // Messages are only published directly if no older message of the same or a higher class is still waiting, to ensure they are received in order and do not overtake more important messages
+        bool waiting = false;
+        for (size_t i = 0U; i <= static_cast<size_t>(traffic_class); ++i) {
+            waiting = waiting || m_lanes[i].count > 0U;
+        }
+        if (!waiting && (traffic_class == Traffic_Class::CONTROL || Has_Capacity())) {
+            if (m_client.publish(topic, reinterpret_cast<uint8_t const *>(json), length)) {
+                return true;
+            }
+            else if (!m_client.connected()) {
+                // Messages are not kept while disconnected, because the subscriptions and requests they belong to have to be renewed after reconnecting anyway
+                return false;
+            }
+        }
+        return Enqueue(traffic_class, topic, json, length);
+    }
+
+    /// @brief Publishes as many queued messages as the outbox of the client allows, in the order of the configured Lane_Drain_Mode, should be called regularly from the loop() method of the ThingsBoard client
+    void loop() {
+        if (Queued_Amount() == 0U || !m_client.connected()) {
+            return;
+        }
+        while (true) {
+            size_t index = static_cast<size_t>(Traffic_Class::MAX_VALUE);
+            if (Has_Capacity()) {
+                index = Next_Lane();
+            }
+            else if (m_lanes[static_cast<size_t>(Traffic_Class::CONTROL)].count > 0U) {
+                index = static_cast<size_t>(Traffic_Class::CONTROL);
+            }
+            if (index >= static_cast<size_t>(Traffic_Class::MAX_VALUE)) {
+                break;
+            }
+            Lane & lane = m_lanes[index];
+            Queued_Message const & message = lane.messages[lane.head];
+            if (!m_client.publish(message.data, reinterpret_cast<uint8_t const *>(message.data + message.json_offset), message.json_length)) {
+                // Keep the message and attempt to publish it again the next time
+                break;
+            }
+            if (lane.credits > 0U) {
+                lane.credits--;
+            }
+            Pop(lane);
+        }
+    }
+
+    /// @brief Calculates how long it takes until queued messages might be published, which is the latest time loop() has to be called again at.
+    /// The outbox is drained by the client in the background without signaling it, therefore it is polled with Default_Priority_Lane_Poll_Interval while it is busy
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if a queued message can be published immediately and UINT32_MAX if no message is queued
+    uint32_t Get_Next_Deadline() const {
+        if (Queued_Amount() == 0U || !m_client.connected()) {
+            // Queued messages are only published once connected, which is signaled by the deadline of the client itself instead
+            return UINT32_MAX;
+        }
+        else if (m_lanes[static_cast<size_t>(Traffic_Class::CONTROL)].count > 0U || Has_Capacity()) {
+            return 0U;
+        }
+        return Default_Priority_Lane_Poll_Interval;
+    }
+
+  private:
+    /// @brief Message that has been copied into a lane, the topic and json payload are stored null-terminated after each other in one allocation
+    struct Queued_Message {
+        char   *data;        // Allocation containing the topic followed by the json payload
+        size_t json_offset;  // Offset of the json payload from the start of the allocation
+        size_t json_length;  // Length of the json payload, excluding the null terminator
+    };
+
+    /// @brief Bounded ring buffer of queued messages of one class
+    struct Lane {
+        Queued_Message messages[Default_Priority_Lane_Queue_Size]; // Queued messages
+        size_t         head;                                       // Index of the oldest queued message
+        size_t         count;                                      // Amount of queued messages
+        uint8_t        weight;                                     // Amount of messages the lane can send per round when draining with Lane_Drain_Mode::WEIGHTED
+        uint8_t        credits;                                    // Amount of messages the lane can still send in the current round
+    };
+
+    /// @brief Gets the class the given topic belongs to, any topic that is not used for firmware chunk requests, attributes or telemetry is a request or response a callback is waiting for
+    /// @param topic Topic the message is sent over
+    /// @return Class of the topic
+    Traffic_Class Get_Class(char const * topic) const {
+        if (strcmp(topic, m_topic_profile->telemetry) == 0) {
+            return Traffic_Class::TELEMETRY;
+        }
+        else if (strcmp(topic, m_topic_profile->attribute) == 0) {
+            return Traffic_Class::ATTRIBUTES;
+        }
+        // Firmware chunk requests are compared with the part of the request topic format before the request id and the index of the chunk
+        else if (strncmp(topic, FIRMWARE_REQUEST_TOPIC, strcspn(FIRMWARE_REQUEST_TOPIC, "%")) == 0) {
+            return Traffic_Class::OTA;
+        }
+        return Traffic_Class::CONTROL;
+    }
+
+    /// @brief Gets whether the outbox of the client contains less than the configured limit of bytes, meaning lower priority messages can be passed on to it
+    /// @return Whether the client can accept lower priority messages or not
+    bool Has_Capacity() const {
+        return m_outbox_limit == 0U || m_client.get_outbox_size() < m_outbox_limit;
+    }
+
+    /// @brief Gets the total amount of messages queued in all lanes
+    /// @return Amount of queued messages
+    size_t Queued_Amount() const {
+        size_t amount = 0U;
+        for (auto const & lane : m_lanes) {
+            amount += lane.count;
+        }
+        return amount;
+    }
+
+    /// @brief Gets the lane the next queued message should be published from, depending on the configured Lane_Drain_Mode.
+    /// When draining with Lane_Drain_Mode::WEIGHTED a new round is started by restoring the credits of all lanes, once every lane that still contains messages has used up its credits
+    /// @return Index of the lane or Traffic_Class::MAX_VALUE if no message is queued
+    size_t Next_Lane() {
+        for (uint8_t round = 0U; round < 2U; ++round) {
+            for (size_t i = 0U; i < static_cast<size_t>(Traffic_Class::MAX_VALUE); ++i) {
+                if (m_lanes[i].count > 0U && (m_drain_mode == Lane_Drain_Mode::STRICT_PRIORITY || m_lanes[i].credits > 0U)) {
+                    return i;
+                }
+            }
+            for (auto & lane : m_lanes) {
+                lane.credits = lane.weight;
+            }
+        }
+        return static_cast<size_t>(Traffic_Class::MAX_VALUE);
+    }
+
+    /// @brief Copies the given message into the lane of the given class
+    /// @param traffic_class Class the message belongs to
+    /// @param topic Topic that the message is sent over
+    /// @param json Json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @return Whether the message could be queued or not
+    bool Enqueue(Traffic_Class const & traffic_class, char const * topic, char const * json, size_t const & length) {
+        Lane & lane = m_lanes[static_cast<size_t>(traffic_class)];
+        if (lane.count >= Default_Priority_Lane_Queue_Size) {
+            Logger::printfln(PRIORITY_LANE_FULL, static_cast<uint8_t>(traffic_class), topic);
+            return false;
+        }
+
+        size_t const topic_size = strlen(topic) + 1U;
+        size_t const size = topic_size + length + 1U;
+        char * data = new char[size]();
+        if (data == nullptr) {
+            Logger::printfln(PRIORITY_LANE_ALLOCATION_FAILED, size);
+            return false;
+        }
+        memcpy(data, topic, topic_size);
+        memcpy(data + topic_size, json, length);
+
+        Queued_Message & message = lane.messages[(lane.head + lane.count) % Default_Priority_Lane_Queue_Size];
+        message.data = data;
+        message.json_offset = topic_size;
+        message.json_length = length;
+        lane.count++;
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(PRIORITY_LANE_QUEUED, topic, static_cast<uint8_t>(traffic_class));
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
+
+    /// @brief Removes the oldest message from the given lane and releases its memory
+    /// @param lane Lane the oldest message should be removed from
+    void Pop(Lane & lane) {
+        Queued_Message & message = lane.messages[lane.head];
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] message.data;
+        message.data = nullptr;
+        lane.head = (lane.head + 1U) % Default_Priority_Lane_Queue_Size;
+        lane.count--;
+    }
+
+    IMQTT_Client        &m_client;                                                   // MQTT client instance the messages are published with
+    Lane                m_lanes[static_cast<size_t>(Traffic_Class::MAX_VALUE)] = {}; // Queued messages of every class, ordered from the highest to the lowest priority
+    Topic_Profile const *m_topic_profile = {};                                       // Topics used to decide which class a message belongs to
+    Lane_Drain_Mode     m_drain_mode = {};                                           // Order the queued messages of the different lanes are drained in
+    size_t              m_outbox_limit = {};                                         // Amount of bytes the outbox of the client may contain before lower priority messages are held back, 0 if messages are never held back
+};
+
+#endif // Outbound_Priority_Lanes_h
@@ -0,0 +1,338 @@
+#ifndef Outbound_Rate_Limiter_h
+#define Outbound_Rate_Limiter_h
+
+// Local includes.
+#include "Rate_Limiter.h"
+#include "Outbound_Priority_Lanes.h"
+#include "Json_Scanner.h"
+#include "IAPI_Implementation.h"
+
+// Library includes.
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+// Log messages.
+char constexpr RATE_LIMIT_QUEUE_FULL[] = "Rate limit exceeded and queue is full, dropping message on topic (%s)";
+char constexpr RATE_LIMIT_ALLOCATION_FAILED[] = "Failed allocating required size (%u) to queue rate limited message";
+char constexpr RATE_LIMIT_MESSAGE_TOO_BIG[] = "Queued message with size (%u) does not fit into the send buffer with size (%u) anymore, dropping message on topic (%s)";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr RATE_LIMIT_QUEUED[] = "Rate limit exceeded, queued message on topic (%s)";
+char constexpr RATE_LIMIT_MERGED[] = "Rate limit exceeded, merged message into queued message on topic (%s)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Budgets that outgoing messages are counted against, ThingsBoard configures seperate rate limits for the different message types
+enum class Rate_Limit_Type : uint8_t {
+    TELEMETRY, ///< Messages sent over the telemetry topic
+    ATTRIBUTES, ///< Messages sent over the attribute topic
+    RPC, ///< Server-side RPC responses and client-side RPC requests
+    MAX_VALUE ///< Amount of budgets, not a valid type itself
+};
+
+
+/// @brief Shapes outgoing MQTT messages to comply with the rate limits configured on the ThingsBoard server, because ThingsBoard disconnects devices that exceed them.
+/// Each message type has its own Rate_Limiter budget, messages on topics that do not belong to any budget (claiming, provisioning, firmware chunks) are never limited.
+/// If a message would exceed its budget it is copied into a bounded queue of its type instead and sent once loop() is called and the budget allows it again, queued messages keep their order.
+/// Attribute messages are merged into the last queued attribute message instead of being queued seperately, because only the latest value of an attribute is relevant, which replaces older values of the same attribute,
+/// while telemetry and RPC messages are queued seperately, because every single one of them is relevant. Attribute messages are only merged as long as the merged message still fits into the send buffer of the client,
+/// otherwise they are queued seperately as well. Only if the queue is full the message is dropped.
+/// As long as no limits are configured all messages are published directly, without any additional overhead besides checking the topic.
+/// Not thread-safe, the queues are expected to be accessed by one task at a time, ThingsBoardSized ensures that by locking its send mutex around every call
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Outbound_Rate_Limiter {
+  public:
+    /// @brief Constructor
+    /// @param priority_lanes Priority lanes the messages are passed on to, has to be kept alive for as long as the instance of this class
+    explicit Outbound_Rate_Limiter(Outbound_Priority_Lanes<Logger> & priority_lanes)
+      : m_priority_lanes(priority_lanes)
+      , m_limiters()
+      , m_queues()
+      , m_topic_profile(&DEFAULT_TOPIC_PROFILE)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~Outbound_Rate_Limiter() {
+        for (auto & queue : m_queues) {
+            while (queue.count > 0U) {
+                Pop(queue);
+            }
+        }
+    }
+
+    /// @brief Configures the rate limits of the given budget, with the ThingsBoard rate limit syntax ("N:seconds,N:seconds"), see Rate_Limiter::Set_Limits() for more information
+    /// @param type Budget the limits should be configured for
+    /// @param limits Comma seperated list of windows, nullptr or an empty string disables rate limiting for the given budget
+    /// @return Whether the given limits could be parsed successfully or not
+    bool Set_Limits(Rate_Limit_Type const & type, char const * limits) {
+        if (type >= Rate_Limit_Type::MAX_VALUE) {
+            return false;
+        }
+        return m_limiters[static_cast<size_t>(type)].Set_Limits(limits);
+    }
+
+    /// @brief Sets the topics that are used to decide which budget a message is counted against
+    /// @param profile Topics that should be used, has to be kept alive for as long as the instance of this class
+    void Set_Topic_Profile(Topic_Profile const & profile) {
+        m_topic_profile = &profile;
+    }
+
+    /// @brief Gets the topics that are used to decide which budget a message is counted against
+    /// @return Topics that are currently used
+    Topic_Profile const & Get_Topic_Profile() const {
+        return *m_topic_profile;
+    }
+
+    /// @brief Publishes the given message directly if its budget allows it or queues it to be published later on
+    /// @param topic Topic that the message is sent over
+    /// @param json Null-terminated json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @return Whether publishing or queueing the message was successful or not
+    bool publish(char const * topic, char const * json, size_t const & length) {
+        Rate_Limit_Type const type = Get_Type(topic);
+        if (type == Rate_Limit_Type::MAX_VALUE || !m_limiters[static_cast<size_t>(type)].Is_Enabled()) {
+            return m_priority_lanes.publish(topic, json, length);
+        }
+
+        Rate_Limiter & limiter = m_limiters[static_cast<size_t>(type)];
+        Message_Queue & queue = m_queues[static_cast<size_t>(type)];
+        // Messages are only published directly if no older message of the same type is still waiting, to ensure they are received in order
+        if (queue.count == 0U && limiter.Is_Available(current_time())) {
+            limiter.Consume();
+            return m_priority_lanes.publish(topic, json, length);
+        }
+        return Enqueue(type, topic, json, length);
+    }
+
+    /// @brief Publishes as many queued messages as the budget of their type allows, should be called regularly from the loop() method of the ThingsBoard client
+    void loop() {
+        if (!m_priority_lanes.connected()) {
+            return;
+        }
+        uint32_t const now = current_time();
+        for (size_t i = 0U; i < static_cast<size_t>(Rate_Limit_Type::MAX_VALUE); ++i) {
+            Message_Queue & queue = m_queues[i];
+            while (queue.count > 0U && m_limiters[i].Is_Available(now)) {
+                Queued_Message const & message = queue.messages[queue.head];
+                // Messages that can never be published, because the send buffer was decreased after they were queued, would otherwise block every following message of the same type
+                uint16_t const send_buffer_size = m_priority_lanes.Get_Client().get_send_buffer_size();
+                if (message.json_length > send_buffer_size) {
+                    Logger::printfln(RATE_LIMIT_MESSAGE_TOO_BIG, message.json_length, send_buffer_size, message.data);
+                    Pop(queue);
+                    continue;
+                }
+                if (!m_priority_lanes.publish(message.data, message.data + message.json_offset, message.json_length)) {
+                    // Keep the message and attempt to publish it again the next time, the budget is only consumed by messages that were actually sent
+                    break;
+                }
+                m_limiters[i].Consume();
+                Pop(queue);
+            }
+        }
+    }
+
+    /// @brief Calculates how long it takes until the budget of any queued message allows it to be published, which is the latest time loop() has to be called again at
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if a queued message can be published immediately and UINT32_MAX if no message is queued
+    uint32_t Get_Next_Deadline() const {
+        uint32_t deadline = UINT32_MAX;
+        if (!m_priority_lanes.connected()) {
+            // Queued messages are only published once connected, which is signaled by the deadline of the client itself instead
+            return deadline;
+        }
+        uint32_t const now = current_time();
+        for (size_t i = 0U; i < static_cast<size_t>(Rate_Limit_Type::MAX_VALUE); ++i) {
+            if (m_queues[i].count == 0U) {
+                continue;
+            }
+            uint32_t const wait_time = m_limiters[i].Get_Wait_Time(now);
+            if (wait_time < deadline) {
+                deadline = wait_time;
+            }
+        }
+        return deadline;
+    }
+
+  private:
+    /// @brief Message that has been copied into the queue, the topic and json payload are stored null-terminated after each other in one allocation
+    struct Queued_Message {
+        char   *data;        // Allocation containing the topic followed by the json payload
+        size_t json_offset;  // Offset of the json payload from the start of the allocation
+        size_t json_length;  // Length of the json payload, excluding the null terminator
+    };
+
+    /// @brief Bounded ring buffer of queued messages of one type
+    struct Message_Queue {
+        Queued_Message messages[Default_Rate_Limit_Queue_Size]; // Queued messages
+        size_t         head;                                    // Index of the oldest queued message
+        size_t         count;                                   // Amount of queued messages
+    };
+
+    /// @brief Gets the current monotonic time in milliseconds, overflows after roughly 49 days, which is handled by the Rate_Limiter
+    /// @return Current time in milliseconds since the device started
+    static uint32_t current_time() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return static_cast<uint32_t>(esp_timer_get_time() / 1000U);
+#else
+        return millis();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Gets the budget the given topic is counted against
+    /// @param topic Topic the message is sent over
+    /// @return Budget of the topic or Rate_Limit_Type::MAX_VALUE if it is not limited
+    Rate_Limit_Type Get_Type(char const * topic) const {
+        if (strcmp(topic, m_topic_profile->telemetry) == 0) {
+            return Rate_Limit_Type::TELEMETRY;
+        }
+        else if (strcmp(topic, m_topic_profile->attribute) == 0) {
+            return Rate_Limit_Type::ATTRIBUTES;
+        }
+        else if (strncmp(topic, m_topic_profile->rpc_prefix, strlen(m_topic_profile->rpc_prefix)) == 0) {
+            return Rate_Limit_Type::RPC;
+        }
+        return Rate_Limit_Type::MAX_VALUE;
+    }
+
+    /// @brief Copies the given message into the queue of the given type or merges it into the last queued attribute message
+    /// @param type Budget the message is counted against
+    /// @param topic Topic that the message is sent over
+    /// @param json Json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @return Whether the message could be queued or not
+    bool Enqueue(Rate_Limit_Type const & type, char const * topic, char const * json, size_t const & length) {
+        Message_Queue & queue = m_queues[static_cast<size_t>(type)];
+        if (type == Rate_Limit_Type::ATTRIBUTES && queue.count > 0U && Merge(queue.messages[(queue.head + queue.count - 1U) % Default_Rate_Limit_Queue_Size], json, length)) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RATE_LIMIT_MERGED, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return true;
+        }
+        else if (queue.count >= Default_Rate_Limit_Queue_Size) {
+            Logger::printfln(RATE_LIMIT_QUEUE_FULL, topic);
+            return false;
+        }
+
+        size_t const topic_size = strlen(topic) + 1U;
+        size_t const size = topic_size + length + 1U;
+        char * data = new char[size]();
+        if (data == nullptr) {
+            Logger::printfln(RATE_LIMIT_ALLOCATION_FAILED, size);
+            return false;
+        }
+        memcpy(data, topic, topic_size);
+        memcpy(data + topic_size, json, length);
+
+        Queued_Message & message = queue.messages[(queue.head + queue.count) % Default_Rate_Limit_Queue_Size];
+        message.data = data;
+        message.json_offset = topic_size;
+        message.json_length = length;
+        queue.count++;
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(RATE_LIMIT_QUEUED, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
+
+    /// @brief Merges the given json object into the given queued json object, members of the queued object whose key is contained in the given object are removed,
+    /// because only the latest value of an attribute is relevant, afterwards all members of the given object are appended
+    /// @param message Queued message the given json object should be merged into
+    /// @param json Json object that should be merged
+    /// @param length Length of the json object in bytes, excluding the null terminator
+    /// @return Whether merging was possible or not, fails if either message is not a json object, the merged object would not fit into the send buffer of the client or the allocation failed,
+    /// in which case the given object has to be queued as a seperate message instead
+    bool Merge(Queued_Message & message, char const * json, size_t const & length) {
+        char const * queued_json = message.data + message.json_offset;
+        // Merged object is never bigger than both objects combined, which allows to allocate it before knowing which members are replaced
+        size_t const size = message.json_offset + message.json_length + length + 1U;
+        char * data = new char[size]();
+        if (data == nullptr) {
+            return false;
+        }
+        memcpy(data, message.data, message.json_offset);
+        char * merged_json = data + message.json_offset;
+        size_t merged_length = 0U;
+        merged_json[merged_length++] = '{';
+
+        size_t queued_index = 0U;
+        Json_Span queued_key;
+        Json_Span queued_member;
+        while (Json_Scanner::Next_Member(queued_json, message.json_length, queued_index, queued_key, queued_member)) {
+            if (Contains_Key(json, length, queued_key)) {
+                continue;
+            }
+            Append_Member(merged_json, merged_length, queued_member);
+        }
+
+        size_t index = 0U;
+        Json_Span key;
+        Json_Span member;
+        while (Json_Scanner::Next_Member(json, length, index, key, member)) {
+            Append_Member(merged_json, merged_length, member);
+        }
+        merged_json[merged_length++] = '}';
+
+        // Both objects have to be scanned until their closing bracket, otherwise one of them was not a valid json object and merging would corrupt the queued message
+        if (queued_index >= message.json_length || index >= length || merged_length > m_priority_lanes.Get_Client().get_send_buffer_size()) {
+            delete[] data;
+            return false;
+        }
+        delete[] message.data;
+        message.data = data;
+        message.json_length = merged_length;
+        return true;
+    }
+
+    /// @brief Gets whether the given json object contains a top-level member with the given key, keys are compared as they were serialized, without resolving escape sequences
+    /// @param json Json object that should be searched
+    /// @param length Length of the json object in bytes
+    /// @param key Key that should be searched for, including its surrounding quotes
+    /// @return Whether the key is contained in the json object or not
+    static bool Contains_Key(char const * json, size_t const & length, Json_Span const & key) {
+        size_t index = 0U;
+        Json_Span current_key;
+        Json_Span member;
+        while (Json_Scanner::Next_Member(json, length, index, current_key, member)) {
+            if (current_key.length == key.length && strncmp(current_key.data, key.data, key.length) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Appends the given member to the given json object that is currently being merged, preceded by a seperating comma if it is not the first member
+    /// @param merged_json Json object the member is appended to, has to be big enough to hold the member
+    /// @param merged_length Current length of the json object, is increased by the appended bytes
+    /// @param member Complete member that should be appended, including its key
+    static void Append_Member(char * merged_json, size_t & merged_length, Json_Span const & member) {
+        if (merged_length > 1U) {
+            merged_json[merged_length++] = ',';
+        }
+        memcpy(merged_json + merged_length, member.data, member.length);
+        merged_length += member.length;
+    }
+
+    /// @brief Removes the oldest message from the given queue and releases its memory
+    /// @param queue Queue the oldest message should be removed from
+    void Pop(Message_Queue & queue) {
+        Queued_Message & message = queue.messages[queue.head];
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] message.data;
+        message.data = nullptr;
+        queue.head = (queue.head + 1U) % Default_Rate_Limit_Queue_Size;
+        queue.count--;
+    }
+
+    Outbound_Priority_Lanes<Logger> &m_priority_lanes;                                                // Priority lanes the messages are passed on to, which publish them with the MQTT client
+    Rate_Limiter                    m_limiters[static_cast<size_t>(Rate_Limit_Type::MAX_VALUE)] = {}; // Budget of every message type
+    Message_Queue                   m_queues[static_cast<size_t>(Rate_Limit_Type::MAX_VALUE)] = {};   // Queued messages of every message type
+    Topic_Profile const             *m_topic_profile = {};                                            // Topics used to decide which budget a message is counted against
+};
+
+#endif // Outbound_Rate_Limiter_h
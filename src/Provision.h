@@ -88,7 +88,7 @@ class Provision : public IAPI_Implementation {
         request_buffer[PROV_DEVICE_KEY] = provision_device_key;
         request_buffer[PROV_DEVICE_SECRET_KEY] = provision_device_secret;
         m_provision_callback.Start_Timeout_Timer();
-        return m_send_json_callback.Call_Callback(PROV_REQUEST_TOPIC, request_buffer, Helper::Measure_Json(request_buffer));
+        return m_send_json_callback.Call_Callback(PROV_REQUEST_TOPIC, request_buffer, 0U);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -123,9 +123,15 @@ class Provision : public IAPI_Implementation {
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
+#if !THINGSBOARD_USE_ESP_TIMER
         m_provision_callback.Update_Timeout_Timer();
+#endif // !THINGSBOARD_USE_ESP_TIMER
+    }
+
+#if !THINGSBOARD_USE_ESP_TIMER
+    uint32_t Get_Next_Deadline() const override {
+        return m_provision_callback.Get_Remaining_Timeout();
     }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
@@ -153,6 +153,10 @@ void Provision_Callback::Set_Timeout(uint64_t const & timeout_microseconds) {
 void Provision_Callback::Update_Timeout_Timer() {
     m_timeout_callback.update();
 }
+
+uint32_t Provision_Callback::Get_Remaining_Timeout() const {
+    return m_timeout_callback.Get_Remaining_Time();
+}
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
 void Provision_Callback::Start_Timeout_Timer() {
@@ -4,6 +4,8 @@
 // Local includes.
 #include "Callback.h"
 #include "Constants.h"
+#include "Json_Scanner.h"
+#include "RPC_Response_Writer.h"
 
 
 /// @brief Server-side RPC callback wrapper,
@@ -11,6 +13,11 @@
 /// Documentation about the specific use of Server-side RPC in ThingsBoard can be found here https://thingsboard.io/docs/user-guide/rpc/#server-side-rpc
 class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocument &> {
   public:
+    /// @brief Response writer callback signature, used instead of the JsonDocument callback if the response should be written directly into the outgoing buffer
+    using writer_function = Callback<void, JsonVariantConst const &, RPC_Response_Writer &>::function;
+    /// @brief Raw parameters callback signature, used instead of the JsonDocument callback if the parameters should be passed as they were received, without deserializing them
+    using raw_params_function = Callback<void, Json_Span const &, RPC_Response_Writer &>::function;
+
     /// @brief Constructs empty callback, will result in never being called. Internals are simply default constructed as nullptr
     RPC_Callback() = default;
 
@@ -35,6 +42,71 @@ class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocumen
         // Nothing to do
     }
 
+    /// @brief Constructs callback, will be called upon server-side RPC request arrival with the given method name.
+    /// Instead of filling a JsonDocument the response is written with the passed RPC_Response_Writer directly into a buffer with the size of the send buffer,
+    /// which removes the need to allocate a JsonDocument for every received request and to estimate its size in advance
+    /// @param method_name Name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param callback Callback method that will be called upon data arrival with the given data that was received serialized into a JsonDocument
+    /// and should write the response key-value pairs with the given RPC_Response_Writer, can write nothing if the RPC widget does not expect any response
+    RPC_Callback(char const * method_name, writer_function callback)
+      : Callback()
+      , m_method_name(method_name)
+#if THINGSBOARD_ENABLE_DYNAMIC
+      , m_response_size(0U)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_writer_callback(callback)
+      , m_uses_response_writer(true)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs callback, will be called upon server-side RPC request arrival with the given method name.
+    /// Instead of deserializing the received parameters into a JsonDocument, they are passed as the serialized json value they were received as, pointing directly into the receive buffer.
+    /// Removes the cost of building the Json data structure for every received request completly, which is the most expensive part of handling a server-side RPC request,
+    /// the passed span can be interpreted further with the Json_Scanner or deserialized by the callback itself if required. The response is written with the passed RPC_Response_Writer
+    /// @param method_name Name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param callback Callback method that will be called upon data arrival with the serialized parameters that were received, which result in an empty span if no parameters were received,
+    /// and should write the response key-value pairs with the given RPC_Response_Writer, can write nothing if the RPC widget does not expect any response
+    RPC_Callback(char const * method_name, raw_params_function callback)
+      : Callback()
+      , m_method_name(method_name)
+#if THINGSBOARD_ENABLE_DYNAMIC
+      , m_response_size(0U)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_writer_callback()
+      , m_uses_response_writer(true)
+      , m_raw_params_callback(callback)
+      , m_uses_raw_params(true)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Whether the response should be written with the RPC_Response_Writer instead of into a JsonDocument
+    /// @return Whether the callback was constructed with a response writer or raw parameters callback
+    bool Uses_Response_Writer() const {
+        return m_uses_response_writer;
+    }
+
+    /// @brief Whether the received parameters should be passed as they were received, instead of deserializing them into a JsonDocument first
+    /// @return Whether the callback was constructed with a raw parameters callback
+    bool Uses_Raw_Params() const {
+        return m_uses_raw_params;
+    }
+
+    /// @brief Calls the response writer callback that was subscribed, when this class instance was initally created
+    /// @param param Parameters that were received with the server-side RPC request
+    /// @param writer Writer the response should be written with
+    void Call_Writer_Callback(JsonVariantConst const & param, RPC_Response_Writer & writer) const {
+        m_writer_callback.Call_Callback(param, writer);
+    }
+
+    /// @brief Calls the raw parameters callback that was subscribed, when this class instance was initally created
+    /// @param param Serialized parameters that were received with the server-side RPC request
+    /// @param writer Writer the response should be written with
+    void Call_Writer_Callback(Json_Span const & param, RPC_Response_Writer & writer) const {
+        m_raw_params_callback.Call_Callback(param, writer);
+    }
+
     /// @brief Gets the poiner to the underlying name we expect to be sent via. server-side RPC so that this method callback will be called
     /// @return Pointer to the passed method name
     char const * Get_Name() const {
@@ -63,10 +135,14 @@ class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocumen
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
   private:
-    char const *m_method_name = {};  // Method name
+    char const                                                      *m_method_name = {};         // Method name
 #if THINGSBOARD_ENABLE_DYNAMIC
-    size_t     m_response_size = {}; // Required size to contain the response
+    size_t                                                          m_response_size = {};        // Required size to contain the response
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+    Callback<void, JsonVariantConst const &, RPC_Response_Writer &> m_writer_callback = {};      // Response writer callback, used instead of the JsonDocument callback if set
+    bool                                                            m_uses_response_writer = {}; // Whether the response writer or raw parameters callback was passed in the constructor
+    Callback<void, Json_Span const &, RPC_Response_Writer &>        m_raw_params_callback = {};  // Raw parameters callback, used instead of the JsonDocument callback and without deserializing the parameters if set
+    bool                                                            m_uses_raw_params = {};      // Whether the raw parameters callback was passed in the constructor
 };
 
 #endif // RPC_Callback_h
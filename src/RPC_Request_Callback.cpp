@@ -48,6 +48,10 @@ void RPC_Request_Callback::Set_Timeout(uint64_t const & timeout_microseconds) {
 void RPC_Request_Callback::Update_Timeout_Timer() {
     m_timeout_callback.update();
 }
+
+uint32_t RPC_Request_Callback::Get_Remaining_Timeout() const {
+    return m_timeout_callback.Get_Remaining_Time();
+}
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
 void RPC_Request_Callback::Start_Timeout_Timer() {
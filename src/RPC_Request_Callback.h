@@ -63,6 +63,10 @@ class RPC_Request_Callback : public Callback<void, JsonDocument const &> {
 #if !THINGSBOARD_USE_ESP_TIMER
     /// @brief Updates the internal timeout timer
     void Update_Timeout_Timer();
+
+    /// @brief Gets the time until the internal timeout timer expires, which is the latest time Update_Timeout_Timer() has to be called again at
+    /// @return Amount of milliseconds until the timer expires, 0 if it already expired and UINT32_MAX if the timer is not started
+    uint32_t Get_Remaining_Timeout() const;
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
     /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
@@ -0,0 +1,106 @@
+// Header include.
+#include "RPC_Response_Writer.h"
+
+// Local includes.
+#include "Helper.h"
+
+RPC_Response_Writer::RPC_Response_Writer(char * buffer, size_t const & buffer_size)
+  : m_buffer(buffer)
+  , m_buffer_size(buffer_size)
+  , m_length(0U)
+  , m_content(Content::NONE)
+  , m_overflowed(false)
+{
+    if (m_buffer != nullptr && m_buffer_size > 0U) {
+        m_buffer[0U] = '\0';
+    }
+}
+
+bool RPC_Response_Writer::Add(char const * key, char const * value) {
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> scratch;
+    // Setting a const char pointer does not copy the string into the document, therefore no additional capacity is required
+    (void)scratch.set(value);
+    return Write_Key_Value(key, scratch.as<JsonVariantConst>());
+}
+
+bool RPC_Response_Writer::Add(char const * key, JsonVariantConst const & value) {
+    return Write_Key_Value(key, value);
+}
+
+bool RPC_Response_Writer::Set(char const * value) {
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> scratch;
+    (void)scratch.set(value);
+    return Set(scratch.as<JsonVariantConst>());
+}
+
+bool RPC_Response_Writer::Set(JsonVariantConst const & value) {
+    if (m_overflowed || m_content != Content::NONE) {
+        return false;
+    }
+    else if (!Write_Value(value)) {
+        m_overflowed = true;
+        return false;
+    }
+    m_content = Content::VALUE;
+    return true;
+}
+
+bool RPC_Response_Writer::Is_Empty() const {
+    return m_content == Content::NONE;
+}
+
+bool RPC_Response_Writer::Overflowed() const {
+    return m_overflowed;
+}
+
+char const * RPC_Response_Writer::Finish() {
+    if (m_content == Content::OBJECT) {
+        // Space for the closing bracket and the null terminator is always kept free, therefore this can not fail
+        m_buffer[m_length++] = '}';
+        m_buffer[m_length] = '\0';
+    }
+    m_content = Content::FINISHED;
+    return m_buffer;
+}
+
+bool RPC_Response_Writer::Write_Key_Value(char const * key, JsonVariantConst const & value) {
+    if (m_overflowed || Helper::stringIsNullorEmpty(key) || (m_content != Content::NONE && m_content != Content::OBJECT)) {
+        return false;
+    }
+
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> key_scratch;
+    (void)key_scratch.set(key);
+    size_t const previous_length = m_length;
+
+    if (!Write_Character(m_content == Content::NONE ? '{' : ',') || !Write_Value(key_scratch.as<JsonVariantConst>()) || !Write_Character(':') || !Write_Value(value)) {
+        // Revert the partially written key-value pair, so the already written content stays a valid json object
+        m_length = previous_length;
+        m_buffer[m_length] = '\0';
+        m_overflowed = true;
+        return false;
+    }
+    m_content = Content::OBJECT;
+    return true;
+}
+
+bool RPC_Response_Writer::Write_Value(JsonVariantConst const & value) {
+    size_t const length = measureJson(value);
+    if (!Can_Write(length)) {
+        return false;
+    }
+    m_length += serializeJson(value, m_buffer + m_length, m_buffer_size - m_length);
+    return true;
+}
+
+bool RPC_Response_Writer::Write_Character(char const & character) {
+    if (!Can_Write(1U)) {
+        return false;
+    }
+    m_buffer[m_length++] = character;
+    m_buffer[m_length] = '\0';
+    return true;
+}
+
+bool RPC_Response_Writer::Can_Write(size_t const & length) const {
+    return m_buffer != nullptr && m_length + length + 2U <= m_buffer_size;
+}
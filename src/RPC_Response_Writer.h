@@ -0,0 +1,131 @@
+#ifndef RPC_Response_Writer_h
+#define RPC_Response_Writer_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <ArduinoJson.h>
+#include <stddef.h>
+
+
+/// @brief Writes the response to a server-side RPC call directly as a serialized json string into a bounded buffer, while the subscribed callback produces the key-value pairs.
+/// Allows to respond to server-side RPC calls without creating an intermediate JsonDocument, which would otherwise have to be allocated, filled, measured and then serialized again for every received request.
+/// Removes the need to estimate the response size of the JsonDocument in advance, because the only limit is the size of the buffer passed into the constructor,
+/// which is the send buffer size of the underlying MQTT client when the writer is used by the Server_Side_RPC API implementation.
+/// The response can either be a json object with multiple key-value pairs written by calling Add() multiple times or a single value written by calling Set() once, but not a combination of the two.
+/// If writing any key-value pair fails because the buffer is too small, the writer keeps the previously written content, but marks itself as overflowed and declines any further writes
+class RPC_Response_Writer {
+  public:
+    /// @brief Constructor
+    /// @param buffer Buffer the serialized json response should be written into, has to stay valid for the lifetime of this instance
+    /// @param buffer_size Total size of the given buffer, including the space required for the closing bracket and null terminator
+    RPC_Response_Writer(char * buffer, size_t const & buffer_size);
+
+    /// @brief Appends the given key-value pair to the json object response
+    /// @tparam T Type of the passed value, can be any type that is supported by JsonVariant::set() without requiring a copy (bool, integral and floating point values).
+    /// See https://arduinojson.org/v6/api/jsonvariant/set/ for more information
+    /// @param key Key of the key value pair we want to write, is not copied and has to be non empty
+    /// @param value Value of the key value pair we want to write
+    /// @return Whether writing the key-value pair was successful or not, fails if the buffer is too small or Set() has already been called
+    template <typename T>
+    bool Add(char const * key, T const & value) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> scratch;
+        if (!scratch.set(value)) {
+            m_overflowed = true;
+            return false;
+        }
+        return Write_Key_Value(key, scratch.template as<JsonVariantConst>());
+    }
+
+    /// @brief Appends the given key-value pair with a string value to the json object response
+    /// @param key Key of the key value pair we want to write, is not copied and has to be non empty
+    /// @param value String value of the key value pair we want to write, is escaped if required
+    /// @return Whether writing the key-value pair was successful or not, fails if the buffer is too small or Set() has already been called
+    bool Add(char const * key, char const * value);
+
+    /// @brief Appends the given key-value pair with a json value to the json object response,
+    /// allows to write nested objects or arrays or to return the received parameters unchanged
+    /// @param key Key of the key value pair we want to write, is not copied and has to be non empty
+    /// @param value Json value of the key value pair we want to write, is serialized directly into the buffer
+    /// @return Whether writing the key-value pair was successful or not, fails if the buffer is too small or Set() has already been called
+    bool Add(char const * key, JsonVariantConst const & value);
+
+    /// @brief Writes the given value as the complete response, instead of a json object containing key-value pairs
+    /// @tparam T Type of the passed value, can be any type that is supported by JsonVariant::set() without requiring a copy (bool, integral and floating point values).
+    /// See https://arduinojson.org/v6/api/jsonvariant/set/ for more information
+    /// @param value Value we want to respond with
+    /// @return Whether writing the value was successful or not, fails if the buffer is too small or anything has already been written
+    template <typename T>
+    bool Set(T const & value) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> scratch;
+        if (!scratch.set(value)) {
+            m_overflowed = true;
+            return false;
+        }
+        return Set(scratch.template as<JsonVariantConst>());
+    }
+
+    /// @brief Writes the given string as the complete response, instead of a json object containing key-value pairs
+    /// @param value String value we want to respond with, is escaped if required
+    /// @return Whether writing the value was successful or not, fails if the buffer is too small or anything has already been written
+    bool Set(char const * value);
+
+    /// @brief Writes the given json value as the complete response, instead of a json object containing key-value pairs
+    /// @param value Json value we want to respond with, is serialized directly into the buffer
+    /// @return Whether writing the value was successful or not, fails if the buffer is too small or anything has already been written
+    bool Set(JsonVariantConst const & value);
+
+    /// @brief Whether anything has been written into the response yet
+    /// @return Whether neither Add() nor Set() has been called successfully
+    bool Is_Empty() const;
+
+    /// @brief Whether any write failed because the given buffer was too small to contain the complete response
+    /// @return Whether the response overflowed the given buffer
+    bool Overflowed() const;
+
+    /// @brief Closes the json object if key-value pairs have been written and returns the complete response,
+    /// afterwards no further key-value pairs can be added
+    /// @return Null-terminated serialized json response
+    char const * Finish();
+
+  private:
+    /// @brief Content that has been written into the response buffer so far
+    enum class Content : uint8_t {
+        NONE, ///< Nothing has been written yet
+        OBJECT, ///< At least one key-value pair of a json object has been written
+        VALUE, ///< A single value has been written as the complete response
+        FINISHED ///< Response has been finished and can not be changed anymore
+    };
+
+    /// @brief Writes the given key-value pair into the buffer, including the opening bracket or the seperating comma.
+    /// Reverts the buffer to the previous state if writing any part of the key-value pair fails
+    /// @param key Key of the key value pair we want to write
+    /// @param value Value of the key value pair we want to write
+    /// @return Whether writing the key-value pair was successful or not
+    bool Write_Key_Value(char const * key, JsonVariantConst const & value);
+
+    /// @brief Serializes the given json value directly into the buffer
+    /// @param value Json value we want to serialize
+    /// @return Whether the serialized value fit into the remaining buffer or not
+    bool Write_Value(JsonVariantConst const & value);
+
+    /// @brief Copies the given character into the buffer
+    /// @param character Character we want to write
+    /// @return Whether the character fit into the remaining buffer or not
+    bool Write_Character(char const & character);
+
+    /// @brief Checks whether the given amount of bytes still fit into the buffer,
+    /// always keeps two bytes free for the closing bracket of the json object and the null terminator
+    /// @param length Amount of bytes we want to write
+    /// @return Whether the given amount of bytes can be written or not
+    bool Can_Write(size_t const & length) const;
+
+    char         *m_buffer = {};              // Buffer the response is serialized into
+    size_t       m_buffer_size = {};          // Total size of the buffer
+    size_t       m_length = {};               // Amount of bytes written into the buffer, excluding the null terminator
+    Content      m_content = Content::NONE;   // Content that has been written so far
+    bool         m_overflowed = {};           // Whether any write failed because the buffer was too small
+};
+
+#endif // RPC_Response_Writer_h
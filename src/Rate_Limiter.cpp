@@ -0,0 +1,92 @@
+// Header include.
+#include "Rate_Limiter.h"
+
+// Library includes.
+#include <stdlib.h>
+
+Rate_Limiter::Rate_Limiter()
+  : m_windows()
+  , m_window_amount(0U)
+{
+    // Nothing to do
+}
+
+bool Rate_Limiter::Set_Limits(char const * limits) {
+    m_window_amount = 0U;
+    if (limits == nullptr) {
+        return true;
+    }
+
+    char const * current = limits;
+    while (*current != '\0') {
+        char * end = nullptr;
+        unsigned long const capacity = strtoul(current, &end, 10);
+        if (end == current || *end != ':' || capacity == 0U) {
+            m_window_amount = 0U;
+            return false;
+        }
+        current = end + 1U;
+        unsigned long const period_seconds = strtoul(current, &end, 10);
+        if (end == current || (*end != ',' && *end != '\0') || period_seconds == 0U || m_window_amount >= Default_Rate_Limit_Windows) {
+            m_window_amount = 0U;
+            return false;
+        }
+        current = (*end == ',') ? end + 1U : end;
+
+        Window & window = m_windows[m_window_amount++];
+        window.capacity = capacity;
+        window.period_ms = period_seconds * 1000U;
+        // Windows start completly filled, which allows a burst of messages directly after configuring
+        window.units = static_cast<uint64_t>(window.capacity) * window.period_ms;
+        window.last_update = 0U;
+    }
+    return true;
+}
+
+bool Rate_Limiter::Is_Enabled() const {
+    return m_window_amount > 0U;
+}
+
+bool Rate_Limiter::Is_Available(uint32_t const & now) {
+    bool available = true;
+    for (size_t i = 0U; i < m_window_amount; ++i) {
+        Window & window = m_windows[i];
+        // Unsigned subtraction ensures the elapsed time is still calculated correctly once the current time overflows
+        uint32_t const elapsed = now - window.last_update;
+        window.last_update = now;
+        uint64_t const maximum_units = static_cast<uint64_t>(window.capacity) * window.period_ms;
+        // Every elapsed millisecond refills capacity units, because one token is scaled to period_ms units this refills capacity tokens per period
+        uint64_t const refilled_units = window.units + (static_cast<uint64_t>(elapsed) * window.capacity);
+        window.units = (refilled_units > maximum_units) ? maximum_units : refilled_units;
+        if (window.units < window.period_ms) {
+            available = false;
+        }
+    }
+    return available;
+}
+
+void Rate_Limiter::Consume() {
+    for (size_t i = 0U; i < m_window_amount; ++i) {
+        Window & window = m_windows[i];
+        window.units = (window.units > window.period_ms) ? window.units - window.period_ms : 0U;
+    }
+}
+
+uint32_t Rate_Limiter::Get_Wait_Time(uint32_t const & now) const {
+    uint32_t wait_time = 0U;
+    for (size_t i = 0U; i < m_window_amount; ++i) {
+        Window const & window = m_windows[i];
+        uint32_t const elapsed = now - window.last_update;
+        uint64_t const refilled_units = window.units + (static_cast<uint64_t>(elapsed) * window.capacity);
+        if (refilled_units >= window.period_ms) {
+            continue;
+        }
+        // Rounds up, because waiting one millisecond too short would still leave the window without a complete token
+        uint64_t const missing_units = window.period_ms - refilled_units;
+        uint32_t const window_wait_time = static_cast<uint32_t>((missing_units + window.capacity - 1U) / window.capacity);
+        if (window_wait_time > wait_time) {
+            wait_time = window_wait_time;
+        }
+    }
+    return wait_time;
+}
@@ -0,0 +1,59 @@
+#ifndef Rate_Limiter_h
+#define Rate_Limiter_h
+
+// Local includes.
+#include "Constants.h"
+
+// Library includes.
+#include <stdint.h>
+#include <stddef.h>
+
+
+/// @brief Token bucket rate limiter supporting multiple windows at once, configured with the same syntax as the device rate limits of ThingsBoard ("N:seconds,N:seconds").
+/// For example "10:1,300:60" allows at most 10 messages per second and at most 300 messages per minute. Each window is a seperate token bucket that holds at most N tokens
+/// and is continously refilled with N tokens per the given amount of seconds, a message can only be sent if every window still contains at least one token.
+/// Refilling is calculated with integer arithmetic only, by scaling one token to the period of the window in milliseconds, which ensures no precision is lost for slow refill rates
+class Rate_Limiter {
+  public:
+    /// @brief Constructs a disabled rate limiter, that allows an unlimited amount of messages
+    Rate_Limiter();
+
+    /// @brief Configures the windows of the rate limiter with the ThingsBoard rate limit syntax ("N:seconds,N:seconds"), all windows start completly filled.
+    /// See https://thingsboard.io/docs/user-guide/tenant-profiles/#rate-limits for more information on the syntax
+    /// @param limits Comma seperated list of windows, where each window consists of the maximum amount of messages and the period in seconds seperated by a colon.
+    /// Passing nullptr or an empty string disables the rate limiter, at most Default_Rate_Limit_Windows windows are supported
+    /// @return Whether the given limits could be parsed successfully or not, if they could not the rate limiter is disabled instead
+    bool Set_Limits(char const * limits);
+
+    /// @brief Whether any window has been configured, if not all messages are allowed
+    /// @return Whether the rate limiter is enabled or not
+    bool Is_Enabled() const;
+
+    /// @brief Refills all windows with the tokens accumulated since the last call and checks whether every window still contains at least one token
+    /// @param now Current time in milliseconds
+    /// @return Whether a message could be sent without exceeding any window
+    bool Is_Available(uint32_t const & now);
+
+    /// @brief Consumes one token from every window, should only be called after Is_Available() returned true
+    void Consume();
+
+    /// @brief Calculates how long it takes until every window contains at least one token again, without refilling or consuming any tokens.
+    /// Allows to sleep until a queued message can actually be sent, instead of polling Is_Available() continously
+    /// @param now Current time in milliseconds
+    /// @return Amount of milliseconds until a message could be sent without exceeding any window, 0 if a message can be sent immediately
+    uint32_t Get_Wait_Time(uint32_t const & now) const;
+
+  private:
+    /// @brief Single token bucket window, where one token is represented by period_ms scaled units
+    struct Window {
+        uint32_t capacity;    // Maximum amount of messages in the period
+        uint32_t period_ms;   // Period the maximum amount of messages is allowed in, in milliseconds
+        uint64_t units;       // Currently available tokens multiplied with the period in milliseconds
+        uint32_t last_update; // Time the window was last refilled at in milliseconds
+    };
+
+    Window m_windows[Default_Rate_Limit_Windows] = {}; // Configured windows
+    size_t m_window_amount = {};                      // Amount of configured windows
+};
+
+#endif // Rate_Limiter_h
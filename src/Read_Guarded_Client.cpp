@@ -0,0 +1,74 @@
+// Header include.
+#include "Read_Guarded_Client.h"
+
+#ifdef ARDUINO
+
+void Read_Guarded_Client::set_client(Client & transport_client) {
+    m_transport_client = &transport_client;
+}
+
+void Read_Guarded_Client::set_read_allowed(bool read_allowed) {
+    m_read_allowed = read_allowed;
+}
+
+int Read_Guarded_Client::connect(IPAddress ip, uint16_t port) {
+    return m_transport_client != nullptr ? m_transport_client->connect(ip, port) : 0;
+}
+
+int Read_Guarded_Client::connect(char const * host, uint16_t port) {
+    return m_transport_client != nullptr ? m_transport_client->connect(host, port) : 0;
+}
+
+int Read_Guarded_Client::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+    return connect(ip, port);
+}
+
+int Read_Guarded_Client::connect(char const * host, uint16_t port, int32_t timeout) {
+    return connect(host, port);
+}
+
+size_t Read_Guarded_Client::write(uint8_t payload_byte) {
+    return m_transport_client != nullptr ? m_transport_client->write(payload_byte) : 0U;
+}
+
+size_t Read_Guarded_Client::write(uint8_t const * buffer, size_t size) {
+    return m_transport_client != nullptr ? m_transport_client->write(buffer, size) : 0U;
+}
+
+int Read_Guarded_Client::available() {
+    return (m_read_allowed && m_transport_client != nullptr) ? m_transport_client->available() : 0;
+}
+
+int Read_Guarded_Client::read() {
+    return m_transport_client != nullptr ? m_transport_client->read() : -1;
+}
+
+int Read_Guarded_Client::read(uint8_t * buffer, size_t size) {
+    return m_transport_client != nullptr ? m_transport_client->read(buffer, size) : -1;
+}
+
+int Read_Guarded_Client::peek() {
+    return m_transport_client != nullptr ? m_transport_client->peek() : -1;
+}
+
+void Read_Guarded_Client::flush() {
+    if (m_transport_client != nullptr) {
+        m_transport_client->flush();
+    }
+}
+
+void Read_Guarded_Client::stop() {
+    if (m_transport_client != nullptr) {
+        m_transport_client->stop();
+    }
+}
+
+uint8_t Read_Guarded_Client::connected() {
+    return m_transport_client != nullptr ? m_transport_client->connected() : 0U;
+}
+
+Read_Guarded_Client::operator bool() {
+    return m_transport_client != nullptr && static_cast<bool>(*m_transport_client);
+}
+
+#endif // ARDUINO
@@ -0,0 +1,66 @@
+#ifndef Read_Guarded_Client_h
+#define Read_Guarded_Client_h
+
+#ifdef ARDUINO
+
+// Library include.
+#include <Client.h>
+
+
+/// @brief Client interface implementation that forwards every call to the given transport client, but reports no received bytes as long as reading has not been allowed.
+/// Is passed to the PubSubClient by the Arduino_MQTT_Client instead of the actual transport client, once received PUBLISH packets are read directly from the transport client.
+/// Because the PubSubClient reads any received packet as soon as available() reports received bytes, it would otherwise read a PUBLISH packet that was received in the short time
+/// between the Arduino_MQTT_Client checking for PUBLISH packets and calling the loop of the PubSubClient, into its minimal receive buffer, where the packet would be discarded
+class Read_Guarded_Client : public Client {
+  public:
+    /// @brief Constructs a guarded client without a transport client, meaning it has to be added later with the set_client() method
+    Read_Guarded_Client() = default;
+
+    /// @brief Sets the transport client every call is forwarded to
+    /// @param transport_client Client that is used to send and receive the actual data
+    void set_client(Client & transport_client);
+
+    /// @brief Sets whether available() reports the received bytes of the transport client, or always 0
+    /// @param read_allowed Whether the received bytes may be read by the PubSubClient or not, default = true
+    void set_read_allowed(bool read_allowed);
+
+    int connect(IPAddress ip, uint16_t port) override;
+
+    int connect(char const * host, uint16_t port) override;
+
+    /// @brief Overload required by newer versions of the ESP32 Arduino core, where it is part of the Client interface. Is not marked as override,
+    /// because older versions and other cores do not contain it, in which case it is simply never called. The timeout is ignored and the default of the transport client is used
+    int connect(IPAddress ip, uint16_t port, int32_t timeout);
+
+    /// @brief Overload required by newer versions of the ESP32 Arduino core, where it is part of the Client interface. Is not marked as override,
+    /// because older versions and other cores do not contain it, in which case it is simply never called. The timeout is ignored and the default of the transport client is used
+    int connect(char const * host, uint16_t port, int32_t timeout);
+
+    size_t write(uint8_t payload_byte) override;
+
+    size_t write(uint8_t const * buffer, size_t size) override;
+
+    int available() override;
+
+    int read() override;
+
+    int read(uint8_t * buffer, size_t size) override;
+
+    int peek() override;
+
+    void flush() override;
+
+    void stop() override;
+
+    uint8_t connected() override;
+
+    operator bool() override;
+
+  private:
+    Client *m_transport_client = {}; // Transport client every call is forwarded to
+    bool   m_read_allowed = true;    // Whether available() reports the received bytes of the transport client
+};
+
+#endif // ARDUINO
+
+#endif // Read_Guarded_Client_h
@@ -0,0 +1,264 @@
+#ifndef Reconnect_Manager_h
+#define Reconnect_Manager_h
+
+// Local includes.
+#include "ThingsBoard.h"
+
+// Library includes.
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+// Log messages.
+char constexpr RECONNECT_ATTEMPT_FAILED[] = "Connection attempt (%u) failed, retrying in (%u) ms";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr RECONNECT_ESTABLISHED[] = "Connection established after (%u) attempts in (%u) ms";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Statistics about the connection attempts handled by the Reconnect_Manager, allows to monitor how long establishing a connection takes
+/// and how often it fails, without having to measure it in the user code
+struct Connection_Metrics {
+    uint32_t attempts;              // Total amount of started connection attempts
+    uint32_t failures;              // Total amount of connection attempts that failed or timed out
+    uint32_t connections;           // Total amount of successfully established connections
+    uint32_t last_latency_ms;       // Time it took to establish the last successful connection in milliseconds
+    uint32_t max_latency_ms;        // Longest time it took to establish any successful connection in milliseconds
+    uint64_t total_latency_ms;      // Summed up time of all successful connections in milliseconds, divide by connections to receive the average latency
+};
+
+
+/// @brief Keeps the given ThingsBoard client connected, by reconnecting with exponential backoff and full jitter once the connection has been lost.
+/// Full jitter means the delay before the next attempt is a random value between 0 and the exponentially growing upper bound (base_delay * 2 ^ failed attempts),
+/// which is limited to the given maximum delay. This spreads out the reconnection attempts of a lot of devices that lost their connection at the same time, for example because of a broker restart,
+/// instead of all devices attempting to reconnect at the exact same moment again and again, which would overload the server and its load balancers.
+/// The random values are generated by a xorshift generator seeded with the hash of the client id, which ensures different devices use a different sequence without requiring a hardware random number generator.
+/// When using the Espressif_MQTT_Client the internal auto reconnect mechanism of the esp-mqtt client should be disabled with set_disable_auto_reconnect(), because it would otherwise reconnect with its own fixed delay.
+/// The class instance is meant to be configured once with set_server() and then loop() has to be called regularly, ideally directly before the loop() method of the ThingsBoard client
+/// @tparam ThingsBoard_Client Type of the ThingsBoardSized instance that should be kept connected, is only required to implement the connect() and connected() methods
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename ThingsBoard_Client, typename Logger = DefaultLogger>
+class Reconnect_Manager {
+  public:
+    /// @brief Constructor
+    /// @param client ThingsBoard client instance that should be kept connected, has to be kept alive for as long as the instance of this class
+    /// @param base_delay_milliseconds Upper bound of the delay before the first reconnection attempt, is doubled with each failed attempt, default = Default_Reconnect_Base_Delay (1000)
+    /// @param max_delay_milliseconds Maximum upper bound the delay before any reconnection attempt can grow to, default = Default_Reconnect_Max_Delay (60000)
+    /// @param connect_timeout_milliseconds Maximum time an asynchronous connection attempt is allowed to take, before it is counted as failed, default = Default_Connect_Timeout (10000)
+    explicit Reconnect_Manager(ThingsBoard_Client & client, uint32_t base_delay_milliseconds = Default_Reconnect_Base_Delay, uint32_t max_delay_milliseconds = Default_Reconnect_Max_Delay, uint32_t connect_timeout_milliseconds = Default_Connect_Timeout)
+      : m_client(client)
+      , m_host(nullptr)
+      , m_access_token(nullptr)
+      , m_port(DEFAULT_MQTT_PORT)
+      , m_client_id(nullptr)
+      , m_password(nullptr)
+      , m_base_delay(base_delay_milliseconds)
+      , m_max_delay(max_delay_milliseconds)
+      , m_connect_timeout(connect_timeout_milliseconds)
+      , m_random_state(0U)
+      , m_consecutive_failures(0U)
+      , m_connecting(false)
+      , m_was_connected(false)
+      , m_attempt_start(0U)
+      , m_delay_start(0U)
+      , m_delay(0U)
+      , m_metrics()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Sets the server and credentials that are used for every connection attempt, all strings are not copied and have to be kept alive for as long as the instance of this class.
+    /// Has to be called before loop() is called for the first time. See ThingsBoardSized::connect() for more information on the single arguments
+    /// @param host ThingsBoard server instance we want to connect to
+    /// @param access_token Access token that connects this device with a created device on the ThingsBoard server, default = PROV_ACCESS_TOKEN ("provision")
+    /// @param port Port that will be used to establish a connection and send / receive data from ThingsBoard over, default = DEFAULT_MQTT_PORT (1883)
+    /// @param client_id Client username that can be used to differentiate the user that is connecting the given device to ThingsBoard, default = Value of passed access token
+    /// @param password Client password that can be used to authenticate the user that is connecting the given device to ThingsBoard, default = nullptr
+    void set_server(char const * host, char const * access_token = PROV_ACCESS_TOKEN, uint16_t port = DEFAULT_MQTT_PORT, char const * client_id = nullptr, char const * password = nullptr) {
+        m_host = host;
+        m_access_token = access_token;
+        m_port = port;
+        m_client_id = client_id;
+        m_password = password;
+        // Seed the random generator with a value unique to this device, so that devices do not all reconnect after the same delays.
+        // Xorshift would only ever generate 0 if seeded with 0, therefore that seed is replaced
+        m_random_state = Helper::calculateKeyHash(Helper::stringIsNullorEmpty(client_id) ? access_token : client_id) ^ current_time();
+        if (m_random_state == 0U) {
+            m_random_state = 1U;
+        }
+    }
+
+    /// @brief Checks the connection state of the client and starts a new connection attempt if the connection has been lost and the backoff delay has passed.
+    /// Does not block for longer than the underlying connect() call of the used client, meaning it is not blocking at all when using the Espressif_MQTT_Client
+    /// @return Whether the client is currently connected or not
+    bool loop() {
+        uint32_t const now = current_time();
+
+        if (m_client.connected()) {
+            if (m_connecting) {
+                Connection_Established(now);
+            }
+            m_was_connected = true;
+            return true;
+        }
+        else if (m_was_connected) {
+            // Connection has just been lost, reconnect directly the first time, but with a random delay to not reconnect at the same time as all other devices
+            m_was_connected = false;
+            m_consecutive_failures = 0U;
+            m_delay_start = now;
+            m_delay = Calculate_Delay();
+            return false;
+        }
+
+        if (m_connecting) {
+            // Asynchronous clients only report the established connection later on, therefore we only count the attempt as failed once the timeout has passed
+            if (now - m_attempt_start < m_connect_timeout) {
+                return false;
+            }
+            Connection_Failed(now);
+        }
+
+        // Unsigned subtraction ensures the comparison still works correctly once the current time overflows
+        if (now - m_delay_start < m_delay || m_host == nullptr) {
+            return false;
+        }
+
+        m_connecting = true;
+        m_attempt_start = now;
+        m_metrics.attempts++;
+        if (!m_client.connect(m_host, m_access_token, m_port, m_client_id, m_password)) {
+            Connection_Failed(current_time());
+            return false;
+        }
+        else if (m_client.connected()) {
+            // Synchronous clients are already connected once the connect call returns
+            Connection_Established(current_time());
+            m_was_connected = true;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Calculates how long it takes until loop() has to be called again, to either start the next connection attempt or count the ongoing one as timed out.
+    /// While connected the lost connection is not detected by this instance, but instead by the loop() of the ThingsBoard client, which is called once its readiness handle signals the closed connection
+    /// or its keep alive deadline passed. Disconnected clients do not require loop() to be called anymore, therefore the reconnection is only driven by the deadline of this instance
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if it has to be called immediately and UINT32_MAX if nothing is pending
+    uint32_t get_next_deadline() {
+        uint32_t const now = current_time();
+
+        if (m_client.connected()) {
+            return (m_connecting || !m_was_connected) ? 0U : UINT32_MAX;
+        }
+        else if (m_was_connected) {
+            return 0U;
+        }
+        else if (m_connecting) {
+            uint32_t const elapsed = now - m_attempt_start;
+            return elapsed >= m_connect_timeout ? 0U : m_connect_timeout - elapsed;
+        }
+        else if (m_host == nullptr) {
+            return UINT32_MAX;
+        }
+        uint32_t const elapsed = now - m_delay_start;
+        return elapsed >= m_delay ? 0U : m_delay - elapsed;
+    }
+
+    /// @brief Resets the backoff, so that the next connection attempt is started directly the next time loop() is called
+    void reset_backoff() {
+        m_consecutive_failures = 0U;
+        m_delay = 0U;
+    }
+
+    /// @brief Gets the statistics about all connection attempts handled by this instance
+    /// @return Statistics about all connection attempts
+    Connection_Metrics const & get_metrics() const {
+        return m_metrics;
+    }
+
+  private:
+    /// @brief Gets the current monotonic time in milliseconds, overflows after roughly 49 days, which is handled by only ever comparing the difference between two timestamps
+    /// @return Current time in milliseconds since the device started
+    static uint32_t current_time() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return static_cast<uint32_t>(esp_timer_get_time() / 1000U);
+#else
+        return millis();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Generates the next pseudo random value with the xorshift32 algorithm
+    /// @return Generated pseudo random value
+    uint32_t Next_Random() {
+        m_random_state ^= m_random_state << 13U;
+        m_random_state ^= m_random_state >> 17U;
+        m_random_state ^= m_random_state << 5U;
+        return m_random_state;
+    }
+
+    /// @brief Calculates the delay before the next connection attempt with exponential backoff and full jitter
+    /// @return Random delay in milliseconds between 0 and min(max_delay, base_delay * 2 ^ consecutive failures)
+    uint32_t Calculate_Delay() {
+        uint64_t upper_bound = m_base_delay;
+        // Limit the shift so the exponentially growing upper bound can not overflow, it reaches the maximum delay long before that anyway
+        for (uint8_t i = 0U; i < m_consecutive_failures && upper_bound < m_max_delay; ++i) {
+            upper_bound <<= 1U;
+        }
+        if (upper_bound > m_max_delay) {
+            upper_bound = m_max_delay;
+        }
+        return static_cast<uint32_t>(Next_Random() % (upper_bound + 1U));
+    }
+
+    /// @brief Updates the metrics and resets the backoff once a connection has been established
+    /// @param now Current time in milliseconds
+    void Connection_Established(uint32_t const & now) {
+        uint32_t const latency = now - m_attempt_start;
+        m_connecting = false;
+        m_consecutive_failures = 0U;
+        m_metrics.connections++;
+        m_metrics.last_latency_ms = latency;
+        m_metrics.total_latency_ms += latency;
+        if (latency > m_metrics.max_latency_ms) {
+            m_metrics.max_latency_ms = latency;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(RECONNECT_ESTABLISHED, m_metrics.attempts, latency);
+#endif // THINGSBOARD_ENABLE_DEBUG
+    }
+
+    /// @brief Updates the metrics and schedules the next connection attempt once a connection attempt failed
+    /// @param now Current time in milliseconds
+    void Connection_Failed(uint32_t const & now) {
+        m_connecting = false;
+        m_metrics.failures++;
+        if (m_consecutive_failures < UINT8_MAX) {
+            m_consecutive_failures++;
+        }
+        m_delay_start = now;
+        m_delay = Calculate_Delay();
+        Logger::printfln(RECONNECT_ATTEMPT_FAILED, m_metrics.attempts, m_delay);
+    }
+
+    ThingsBoard_Client &m_client;               // ThingsBoard client instance that is kept connected
+    char const         *m_host = {};            // ThingsBoard server instance we want to connect to
+    char const         *m_access_token = {};    // Access token used to connect
+    uint16_t           m_port = {};             // Port used to connect
+    char const         *m_client_id = {};       // Client id used to connect
+    char const         *m_password = {};        // Password used to connect
+    uint32_t           m_base_delay = {};       // Upper bound of the delay before the first reconnection attempt in milliseconds
+    uint32_t           m_max_delay = {};        // Maximum upper bound of the delay before any reconnection attempt in milliseconds
+    uint32_t           m_connect_timeout = {};  // Maximum time an asynchronous connection attempt is allowed to take in milliseconds
+    uint32_t           m_random_state = {};     // Internal state of the xorshift random generator
+    uint8_t            m_consecutive_failures = {}; // Amount of failed connection attempts since the last established connection
+    bool               m_connecting = {};       // Whether a connection attempt is currently ongoing
+    bool               m_was_connected = {};    // Whether the client was connected the last time loop() was called
+    uint32_t           m_attempt_start = {};    // Time the current connection attempt was started at in milliseconds
+    uint32_t           m_delay_start = {};      // Time the delay before the next connection attempt was started at in milliseconds
+    uint32_t           m_delay = {};            // Delay before the next connection attempt is allowed to be started in milliseconds
+    Connection_Metrics m_metrics = {};          // Statistics about all connection attempts
+};
+
+#endif // Reconnect_Manager_h
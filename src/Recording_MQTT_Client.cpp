@@ -0,0 +1,192 @@
+// Header include.
+#include "Recording_MQTT_Client.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Library includes.
+#include <string.h>
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+Recording_MQTT_Client::Recording_MQTT_Client(IMQTT_Client & client, Callback<bool, uint8_t const *, size_t const &>::function sink)
+  : m_client(client)
+  , m_sink(sink)
+{
+    // Nothing to do
+}
+
+bool Recording_MQTT_Client::Is_Recording_Failed() const {
+    return m_failed;
+}
+
+void Recording_MQTT_Client::set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) {
+    m_data_callback.Set_Callback(callback);
+    m_client.set_data_callback([this](char * topic, uint8_t * payload, unsigned int length) {
+        Record(MQTT_Trace_Record_Type::RECEIVE, topic, payload, length);
+        m_data_callback.Call_Callback(topic, payload, length);
+    });
+}
+
+void Recording_MQTT_Client::set_connect_callback(Callback<void>::function callback) {
+    m_client.set_connect_callback(callback);
+}
+
+bool Recording_MQTT_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    return m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
+}
+
+uint16_t Recording_MQTT_Client::get_receive_buffer_size() {
+    return m_client.get_receive_buffer_size();
+}
+
+uint16_t Recording_MQTT_Client::get_send_buffer_size() {
+    return m_client.get_send_buffer_size();
+}
+
+void Recording_MQTT_Client::set_server(char const * domain, uint16_t port) {
+    m_client.set_server(domain, port);
+}
+
+bool Recording_MQTT_Client::connect(char const * client_id, char const * user_name, char const * password) {
+    uint8_t const result = m_client.connect(client_id, user_name, password);
+    Record(MQTT_Trace_Record_Type::CONNECT, client_id, &result, sizeof(result));
+    return result;
+}
+
+void Recording_MQTT_Client::disconnect() {
+    Record(MQTT_Trace_Record_Type::DISCONNECT, nullptr, nullptr, 0U);
+    m_client.disconnect();
+}
+
+bool Recording_MQTT_Client::loop() {
+    return m_client.loop();
+}
+
+bool Recording_MQTT_Client::publish(char const * topic, uint8_t const * payload, size_t const & length) {
+    Record(MQTT_Trace_Record_Type::PUBLISH, topic, payload, length);
+    return m_client.publish(topic, payload, length);
+}
+
+bool Recording_MQTT_Client::subscribe(char const * topic) {
+    Record(MQTT_Trace_Record_Type::SUBSCRIBE, topic, nullptr, 0U);
+    return m_client.subscribe(topic);
+}
+
+bool Recording_MQTT_Client::subscribe(char const * const * topics, size_t const & topic_amount) {
+    for (size_t i = 0U; i < topic_amount; i++) {
+        Record(MQTT_Trace_Record_Type::SUBSCRIBE, topics[i], nullptr, 0U);
+    }
+    return m_client.subscribe(topics, topic_amount);
+}
+
+bool Recording_MQTT_Client::unsubscribe(char const * topic) {
+    Record(MQTT_Trace_Record_Type::UNSUBSCRIBE, topic, nullptr, 0U);
+    return m_client.unsubscribe(topic);
+}
+
+bool Recording_MQTT_Client::connected() {
+    return m_client.connected();
+}
+
+bool Recording_MQTT_Client::get_session_present() {
+    return m_client.get_session_present();
+}
+
+bool Recording_MQTT_Client::set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) {
+    m_stream_callback.Set_Callback(stream_callback);
+    return m_client.set_stream_callback(filter_callback, [this](char * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) {
+        Begin_Record(MQTT_Trace_Record_Type::RECEIVE_SLICE, topic, length);
+        Write(payload, length);
+        uint8_t trailer[2U * MQTT_TRACE_MAX_VARINT_SIZE] = {};
+        size_t size = MQTT_Trace::Encode_Varint(trailer, offset);
+        size += MQTT_Trace::Encode_Varint(trailer + size, total_length);
+        Write(trailer, size);
+        m_stream_callback.Call_Callback(topic, payload, length, offset, total_length);
+    });
+}
+
+uint32_t Recording_MQTT_Client::get_next_deadline() {
+    return m_client.get_next_deadline();
+}
+
+int Recording_MQTT_Client::get_readiness_handle() {
+    return m_client.get_readiness_handle();
+}
+
+bool Recording_MQTT_Client::set_topic_aliases(char const * const * topics, size_t const & topic_amount) {
+    // Only changes the bytes sent over the connection, the complete topic of every publish is still recorded
+    return m_client.set_topic_aliases(topics, topic_amount);
+}
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+bool Recording_MQTT_Client::begin_publish(char const * topic, size_t const & length) {
+    // The payload is recorded while it is written, because it is never held in memory completely
+    Begin_Record(MQTT_Trace_Record_Type::PUBLISH, topic, length);
+    return m_client.begin_publish(topic, length);
+}
+
+bool Recording_MQTT_Client::end_publish() {
+    return m_client.end_publish();
+}
+
+size_t Recording_MQTT_Client::write(uint8_t payload_byte) {
+    Write(&payload_byte, sizeof(payload_byte));
+    return m_client.write(payload_byte);
+}
+
+size_t Recording_MQTT_Client::write(uint8_t const * buffer, size_t const & size) {
+    Write(buffer, size);
+    return m_client.write(buffer, size);
+}
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+void Recording_MQTT_Client::Begin_Record(MQTT_Trace_Record_Type const & type, char const * topic, size_t const & payload_length) {
+    uint64_t const elapsed = Get_Elapsed_Time();
+    if (!m_started) {
+        uint8_t const header[] = { MQTT_TRACE_MAGIC[0], MQTT_TRACE_MAGIC[1], MQTT_TRACE_MAGIC[2], MQTT_TRACE_MAGIC[3], MQTT_TRACE_VERSION };
+        Write(header, sizeof(header));
+        m_started = true;
+    }
+    size_t const topic_length = topic != nullptr ? strlen(topic) : 0U;
+    uint8_t start[1U + 2U * MQTT_TRACE_MAX_VARINT_SIZE] = { static_cast<uint8_t>(type) };
+    size_t size = 1U;
+    size += MQTT_Trace::Encode_Varint(start + size, elapsed);
+    size += MQTT_Trace::Encode_Varint(start + size, topic_length);
+    Write(start, size);
+    Write(reinterpret_cast<uint8_t const *>(topic), topic_length);
+    size = MQTT_Trace::Encode_Varint(start, payload_length);
+    Write(start, size);
+}
+
+void Recording_MQTT_Client::Record(MQTT_Trace_Record_Type const & type, char const * topic, uint8_t const * payload, size_t const & length) {
+    Begin_Record(type, topic, length);
+    Write(payload, length);
+}
+
+void Recording_MQTT_Client::Write(uint8_t const * data, size_t const & length) {
+    if (m_failed || length == 0U) {
+        return;
+    }
+    m_failed = !m_sink.Call_Callback(data, length);
+}
+
+uint64_t Recording_MQTT_Client::Get_Elapsed_Time() {
+#if THINGSBOARD_USE_ESP_TIMER
+    uint64_t const now = esp_timer_get_time();
+    uint64_t const elapsed = m_started ? now - m_last_time : 0U;
+#else
+    // Calculated with the 32-bit counter of micros(), which ensures the overflow after around 71 minutes is handled correctly, as long as the records are not further apart than that
+    uint32_t const now = micros();
+    uint64_t const elapsed = m_started ? static_cast<uint32_t>(now - static_cast<uint32_t>(m_last_time)) : 0U;
+#endif // THINGSBOARD_USE_ESP_TIMER
+    m_last_time = now;
+    return elapsed;
+}
+
+#endif // THINGSBOARD_ENABLE_STL
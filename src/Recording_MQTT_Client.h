@@ -0,0 +1,121 @@
+#ifndef Recording_MQTT_Client_h
+#define Recording_MQTT_Client_h
+
+// Local includes.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "MQTT_Trace.h"
+
+
+/// @brief MQTT Client interface implementation that decorates any other implementation and records every connection attempt, publish, subscribe, unsubscribe and received message
+/// with the time it occured at into the compact binary format described in MQTT_Trace, while forwarding every call unchanged to the decorated client.
+/// The trace is not held in memory, instead it is passed in small consecutive blocks to the given sink, which can append it to a file, a ring buffer or send it over a serial connection.
+/// Received messages are recorded before they are passed to the ThingsBoard client, because parsing the payload might modify it in place.
+/// The recorded traces can be replayed with the Replay_MQTT_Client, which allows to reproduce the exact sequence of messages a device received in production on a host machine,
+/// for example to benchmark the CPU time and allocations required to handle RPC storms, big attribute updates or complete OTA sessions between different versions of the library.
+/// Requires THINGSBOARD_ENABLE_STL, because the callbacks set by the ThingsBoard client have to be wrapped with lambdas that capture this instance
+class Recording_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructor
+    /// @param client MQTT client that should be decorated, has to be kept alive for as long as the instance of this class
+    /// @param sink Method that is called with each consecutive block of the recorded trace, returns whether the block could be written or not.
+    /// Once writing any block failed recording is stopped, because the remaining trace could not be decoded anymore, see Is_Recording_Failed()
+    Recording_MQTT_Client(IMQTT_Client & client, Callback<bool, uint8_t const *, size_t const &>::function sink);
+
+    /// @brief Whether writing any block of the trace to the sink failed, in which case nothing is recorded anymore
+    /// @return Whether recording has been stopped because of a failed write
+    bool Is_Recording_Failed() const;
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override;
+
+    void set_connect_callback(Callback<void>::function callback) override;
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override;
+
+    uint16_t get_receive_buffer_size() override;
+
+    uint16_t get_send_buffer_size() override;
+
+    void set_server(char const * domain, uint16_t port) override;
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override;
+
+    void disconnect() override;
+
+    bool loop() override;
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
+
+    bool subscribe(char const * topic) override;
+
+    bool subscribe(char const * const * topics, size_t const & topic_amount) override;
+
+    bool unsubscribe(char const * topic) override;
+
+    bool connected() override;
+
+    bool get_session_present() override;
+
+    bool set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) override;
+
+    uint32_t get_next_deadline() override;
+
+    int get_readiness_handle() override;
+
+    bool set_topic_aliases(char const * const * topics, size_t const & topic_amount) override;
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override;
+
+    bool end_publish() override;
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override;
+
+    size_t write(uint8_t const * buffer, size_t const & size) override;
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Writes the start of a record, consisting of the type, the time passed since the previous record, the topic and the length of the payload
+    /// @param type Kind of the recorded event
+    /// @param topic Topic of the recorded event, can be nullptr if the event has no topic
+    /// @param payload_length Length of the payload that has to be written directly afterwards
+    void Begin_Record(MQTT_Trace_Record_Type const & type, char const * topic, size_t const & payload_length);
+
+    /// @brief Writes a complete record, consisting of the start of the record and the payload
+    /// @param type Kind of the recorded event
+    /// @param topic Topic of the recorded event, can be nullptr if the event has no topic
+    /// @param payload Payload of the recorded event, can be nullptr if the event has no payload
+    /// @param length Length of the payload
+    void Record(MQTT_Trace_Record_Type const & type, char const * topic, uint8_t const * payload, size_t const & length);
+
+    /// @brief Writes the given block to the sink, unless a previous write already failed
+    /// @param data Block that should be written
+    /// @param length Length of the block
+    void Write(uint8_t const * data, size_t const & length);
+
+    /// @brief Gets the time passed since the previous record and remembers the current time for the next record, the first record always starts at 0
+    /// @return Passed time in microseconds
+    uint64_t Get_Elapsed_Time();
+
+    IMQTT_Client                                                                    &m_client;              // MQTT client that is decorated
+    Callback<bool, uint8_t const *, size_t const &>                                 m_sink = {};            // Method the recorded trace is written to
+    Callback<void, char *, uint8_t *, unsigned int>                                 m_data_callback = {};   // Callback of the ThingsBoard client received messages are passed to after recording them
+    Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &> m_stream_callback = {}; // Callback of the ThingsBoard client received slices are passed to after recording them
+    uint64_t                                                                        m_last_time = {};       // Time the previous record was written at in microseconds
+    bool                                                                            m_started = {};         // Whether the magic bytes and version of the trace have already been written
+    bool                                                                            m_failed = {};          // Whether writing to the sink failed and recording has been stopped
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Recording_MQTT_Client_h
@@ -0,0 +1,45 @@
+// Header include.
+#include "Recursive_Mutex.h"
+
+Recursive_Mutex::Recursive_Mutex()
+#if THINGSBOARD_USE_FREERTOS
+  : m_mutex(xSemaphoreCreateRecursiveMutex())
+#endif // THINGSBOARD_USE_FREERTOS
+{
+    // Nothing to do
+}
+
+Recursive_Mutex::~Recursive_Mutex() {
+#if THINGSBOARD_USE_FREERTOS
+    if (m_mutex != nullptr) {
+        vSemaphoreDelete(m_mutex);
+        m_mutex = nullptr;
+    }
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+void Recursive_Mutex::lock() {
+#if THINGSBOARD_USE_FREERTOS
+    if (m_mutex != nullptr) {
+        (void)xSemaphoreTakeRecursive(m_mutex, portMAX_DELAY);
+    }
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+void Recursive_Mutex::unlock() {
+#if THINGSBOARD_USE_FREERTOS
+    if (m_mutex != nullptr) {
+        (void)xSemaphoreGiveRecursive(m_mutex);
+    }
+#endif // THINGSBOARD_USE_FREERTOS
+}
+
+Recursive_Mutex_Lock::Recursive_Mutex_Lock(Recursive_Mutex & mutex)
+  : m_mutex(mutex)
+{
+    m_mutex.lock();
+}
+
+Recursive_Mutex_Lock::~Recursive_Mutex_Lock() {
+    m_mutex.unlock();
+}
@@ -0,0 +1,61 @@
+#ifndef Recursive_Mutex_h
+#define Recursive_Mutex_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library includes.
+#if THINGSBOARD_USE_FREERTOS
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif // THINGSBOARD_USE_FREERTOS
+
+
+/// @brief Mutex that can be locked multiple times by the same task, which allows a method that already holds the lock to call other methods that lock it as well.
+/// Wraps around the recursive mutex of FreeRTOS (https://www.freertos.org/RTOS-Recursive-Mutexes.html) if it exists, on every other platform the library is expected to be used from a single task,
+/// therefore locking and unlocking does nothing. If creating the FreeRTOS mutex failed, because there was not enough heap memory left, the mutex does nothing as well
+class Recursive_Mutex {
+  public:
+    /// @brief Constructor
+    Recursive_Mutex();
+
+    /// @brief Destructor
+    ~Recursive_Mutex();
+
+    /// @brief Copying would create a second handle to the same underlying mutex, which would then be deleted twice
+    Recursive_Mutex(Recursive_Mutex const &) = delete;
+
+    /// @brief Copying would create a second handle to the same underlying mutex, which would then be deleted twice
+    Recursive_Mutex & operator=(Recursive_Mutex const &) = delete;
+
+    /// @brief Waits until no other task holds the mutex anymore and then locks it, has to be unlocked as often as it was locked by the same task
+    void lock();
+
+    /// @brief Unlocks the mutex once, only allows other tasks to lock it once every previous lock() call of the same task has been unlocked
+    void unlock();
+
+  private:
+#if THINGSBOARD_USE_FREERTOS
+    SemaphoreHandle_t m_mutex = {}; // Underlying FreeRTOS recursive mutex, nullptr if creating it failed
+#endif // THINGSBOARD_USE_FREERTOS
+};
+
+
+/// @brief Locks the given mutex for as long as the instance is alive, which ensures it is unlocked again on every return path
+class Recursive_Mutex_Lock {
+  public:
+    /// @brief Constructor, locks the given mutex
+    /// @param mutex Mutex that is locked until this instance is destroyed
+    explicit Recursive_Mutex_Lock(Recursive_Mutex & mutex);
+
+    /// @brief Destructor, unlocks the mutex again
+    ~Recursive_Mutex_Lock();
+
+    Recursive_Mutex_Lock(Recursive_Mutex_Lock const &) = delete;
+    Recursive_Mutex_Lock & operator=(Recursive_Mutex_Lock const &) = delete;
+
+  private:
+    Recursive_Mutex & m_mutex; // Mutex that is locked for the lifetime of this instance
+};
+
+#endif // Recursive_Mutex_h
@@ -0,0 +1,275 @@
+// Header include.
+#include "Replay_MQTT_Client.h"
+
+// Library includes.
+#include <string.h>
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+Replay_MQTT_Client::Replay_MQTT_Client(uint8_t const * trace, size_t const & length, bool real_time)
+  : m_reader(trace, length)
+  , m_real_time(real_time)
+{
+    // Nothing to do
+}
+
+Replay_MQTT_Client::~Replay_MQTT_Client() {
+    delete[] m_receive_buffer;
+    delete[] m_topic;
+}
+
+void Replay_MQTT_Client::set_real_time(bool real_time) {
+    m_real_time = real_time;
+}
+
+bool Replay_MQTT_Client::is_valid() const {
+    return m_reader.Is_Valid();
+}
+
+bool Replay_MQTT_Client::is_finished() const {
+    return !m_has_pending && m_end_reached;
+}
+
+void Replay_MQTT_Client::restart() {
+    m_reader.Rewind();
+    m_has_pending = false;
+    m_end_reached = false;
+    m_elapsed = 0U;
+    m_statistics = {};
+}
+
+MQTT_Replay_Statistics const & Replay_MQTT_Client::get_statistics() const {
+    return m_statistics;
+}
+
+void Replay_MQTT_Client::set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) {
+    m_data_callback.Set_Callback(callback);
+}
+
+void Replay_MQTT_Client::set_connect_callback(Callback<void>::function callback) {
+    m_connected_callback.Set_Callback(callback);
+}
+
+bool Replay_MQTT_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    if (receive_buffer_size != m_receive_buffer_size) {
+        uint8_t * receive_buffer = nullptr;
+        if (receive_buffer_size > 0U) {
+            receive_buffer = new uint8_t[receive_buffer_size]();
+            if (receive_buffer == nullptr) {
+                DefaultLogger::printfln(REPLAY_RECEIVE_BUFFER_ALLOCATION_FAILED, receive_buffer_size);
+                return false;
+            }
+        }
+        delete[] m_receive_buffer;
+        m_receive_buffer = receive_buffer;
+        m_receive_buffer_size = receive_buffer_size;
+    }
+    m_send_buffer_size = send_buffer_size;
+    return true;
+}
+
+uint16_t Replay_MQTT_Client::get_receive_buffer_size() {
+    return m_receive_buffer_size;
+}
+
+uint16_t Replay_MQTT_Client::get_send_buffer_size() {
+    return m_send_buffer_size;
+}
+
+void Replay_MQTT_Client::set_server(char const * domain, uint16_t port) {
+    // Nothing to do, the received messages are read from the trace instead
+}
+
+bool Replay_MQTT_Client::connect(char const * client_id, char const * user_name, char const * password) {
+    if (!is_valid()) {
+        return false;
+    }
+    m_connected = true;
+    m_elapsed = 0U;
+#if THINGSBOARD_USE_ESP_TIMER
+    m_last_time = static_cast<uint32_t>(esp_timer_get_time());
+#else
+    m_last_time = micros();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    m_connected_callback.Call_Callback();
+    return true;
+}
+
+void Replay_MQTT_Client::disconnect() {
+    m_connected = false;
+}
+
+bool Replay_MQTT_Client::loop() {
+    if (!m_connected) {
+        return false;
+    }
+    if (!m_real_time) {
+        if (m_has_pending || Read_Next_Received()) {
+            Deliver_Pending();
+        }
+        return true;
+    }
+    Update_Elapsed_Time();
+    while ((m_has_pending || Read_Next_Received()) && m_pending.timestamp <= m_elapsed) {
+        Deliver_Pending();
+    }
+    return true;
+}
+
+bool Replay_MQTT_Client::publish(char const * topic, uint8_t const * payload, size_t const & length) {
+    if (!m_connected || length > m_send_buffer_size) {
+        return false;
+    }
+    m_statistics.published++;
+    m_statistics.published_bytes += length;
+    return true;
+}
+
+bool Replay_MQTT_Client::subscribe(char const * topic) {
+    if (!m_connected) {
+        return false;
+    }
+    m_statistics.subscribed++;
+    return true;
+}
+
+bool Replay_MQTT_Client::subscribe(char const * const * topics, size_t const & topic_amount) {
+    if (!m_connected) {
+        return false;
+    }
+    m_statistics.subscribed += topic_amount;
+    return true;
+}
+
+bool Replay_MQTT_Client::unsubscribe(char const * topic) {
+    return m_connected;
+}
+
+bool Replay_MQTT_Client::connected() {
+    return m_connected;
+}
+
+bool Replay_MQTT_Client::get_session_present() {
+    return false;
+}
+
+bool Replay_MQTT_Client::set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) {
+    m_stream_filter_callback.Set_Callback(filter_callback);
+    m_stream_callback.Set_Callback(stream_callback);
+    return true;
+}
+
+uint32_t Replay_MQTT_Client::get_next_deadline() {
+    if (!m_connected || (!m_has_pending && !Read_Next_Received())) {
+        return UINT32_MAX;
+    }
+    else if (!m_real_time) {
+        return 0U;
+    }
+    Update_Elapsed_Time();
+    if (m_pending.timestamp <= m_elapsed) {
+        return 0U;
+    }
+    uint64_t const remaining = (m_pending.timestamp - m_elapsed + 999U) / 1000U;
+    return remaining < UINT32_MAX ? static_cast<uint32_t>(remaining) : UINT32_MAX - 1U;
+}
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+bool Replay_MQTT_Client::begin_publish(char const * topic, size_t const & length) {
+    if (!m_connected) {
+        return false;
+    }
+    m_statistics.published++;
+    return true;
+}
+
+bool Replay_MQTT_Client::end_publish() {
+    return m_connected;
+}
+
+size_t Replay_MQTT_Client::write(uint8_t payload_byte) {
+    m_statistics.published_bytes++;
+    return 1U;
+}
+
+size_t Replay_MQTT_Client::write(uint8_t const * buffer, size_t const & size) {
+    m_statistics.published_bytes += size;
+    return size;
+}
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+bool Replay_MQTT_Client::Read_Next_Received() {
+    while (m_reader.Next(m_pending)) {
+        if (m_pending.type == MQTT_Trace_Record_Type::RECEIVE || m_pending.type == MQTT_Trace_Record_Type::RECEIVE_SLICE) {
+            m_has_pending = true;
+            return true;
+        }
+    }
+    // Also stops at a truncated record, because the remaining trace can not be decoded anymore
+    m_end_reached = true;
+    return false;
+}
+
+void Replay_MQTT_Client::Deliver_Pending() {
+    m_has_pending = false;
+    if (m_receive_buffer_size == 0U) {
+        m_statistics.discarded++;
+        return;
+    }
+    if (!Copy_Topic()) {
+        m_statistics.discarded++;
+        return;
+    }
+    if (m_pending.type == MQTT_Trace_Record_Type::RECEIVE && m_pending.payload_length <= m_receive_buffer_size) {
+        memcpy(m_receive_buffer, m_pending.payload, m_pending.payload_length);
+        m_statistics.delivered++;
+        m_data_callback.Call_Callback(m_topic, m_receive_buffer, m_pending.payload_length);
+        return;
+    }
+    bool const is_slice = m_pending.type == MQTT_Trace_Record_Type::RECEIVE_SLICE;
+    if (!is_slice && !m_stream_filter_callback.Call_Callback(m_topic)) {
+        m_statistics.discarded++;
+        return;
+    }
+    // Slices are copied in parts that fit into the receive buffer, in case the trace was recorded with a bigger receive buffer
+    m_statistics.streamed++;
+    for (size_t copied = 0U; copied < m_pending.payload_length; copied += m_receive_buffer_size) {
+        size_t const remaining = m_pending.payload_length - copied;
+        size_t const length = remaining < m_receive_buffer_size ? remaining : m_receive_buffer_size;
+        memcpy(m_receive_buffer, m_pending.payload + copied, length);
+        m_stream_callback.Call_Callback(m_topic, m_receive_buffer, length, m_pending.offset + copied, m_pending.total_length);
+    }
+}
+
+bool Replay_MQTT_Client::Copy_Topic() {
+    if (m_pending.topic_length >= m_topic_size) {
+        size_t const topic_size = m_pending.topic_length + 1U;
+        char * topic = new char[topic_size]();
+        if (topic == nullptr) {
+            DefaultLogger::printfln(REPLAY_TOPIC_ALLOCATION_FAILED, topic_size);
+            return false;
+        }
+        delete[] m_topic;
+        m_topic = topic;
+        m_topic_size = topic_size;
+    }
+    memcpy(m_topic, m_pending.topic, m_pending.topic_length);
+    m_topic[m_pending.topic_length] = '\0';
+    return true;
+}
+
+void Replay_MQTT_Client::Update_Elapsed_Time() {
+#if THINGSBOARD_USE_ESP_TIMER
+    uint32_t const now = static_cast<uint32_t>(esp_timer_get_time());
+#else
+    uint32_t const now = micros();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    m_elapsed += static_cast<uint32_t>(now - m_last_time);
+    m_last_time = now;
+}
@@ -0,0 +1,148 @@
+#ifndef Replay_MQTT_Client_h
+#define Replay_MQTT_Client_h
+
+// Local includes.
+#include "DefaultLogger.h"
+#include "IMQTT_Client.h"
+#include "MQTT_Trace.h"
+
+
+// Log messages.
+char constexpr REPLAY_RECEIVE_BUFFER_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the receive buffer of the replayed client";
+char constexpr REPLAY_TOPIC_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the topic of the replayed message, discarding it";
+
+
+/// @brief Statistics about the messages handled by the Replay_MQTT_Client, allows to compare the amount of messages the ThingsBoard client sent in response to a replayed trace between versions
+struct MQTT_Replay_Statistics {
+    uint32_t delivered;             // Total amount of received messages that were passed completely to the data callback
+    uint32_t streamed;              // Total amount of received messages or recorded slices that were passed to the stream callback
+    uint32_t discarded;             // Total amount of received messages that were neither delivered nor streamed, because they did not fit into the receive buffer
+    uint32_t published;             // Total amount of messages the ThingsBoard client attempted to publish
+    uint32_t subscribed;            // Total amount of topics the ThingsBoard client attempted to subscribe
+    uint64_t published_bytes;       // Summed up length of the payloads of all published messages
+};
+
+
+/// @brief MQTT Client interface implementation that does not establish any connection, but instead feeds the received messages of a trace recorded with the Recording_MQTT_Client
+/// back into the data and stream callbacks set by the ThingsBoard client, exactly like a real client would after receiving them from the broker.
+/// Every outbound message and subscription is counted but otherwise discarded, which allows to reproduce the handling of a recorded production session on a host machine
+/// without any network and therefore to measure the CPU time and memory allocations the ThingsBoard client requires for it, see examples/0021-linux_trace_replay_benchmark.
+/// Messages can either be replayed at full speed, where every call to loop() delivers the next received message, or in real time, where loop() delivers every message whose recorded time has passed since connecting.
+/// Received messages are copied into a receive buffer owned by this class before they are delivered, because parsing might modify the payload in place. Messages that do not fit into the receive buffer
+/// are passed in slices to the stream callback if it accepts their topic and discarded otherwise, while recorded slices are always passed to the stream callback directly
+class Replay_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructor
+    /// @param trace Recorded trace that should be replayed, has to be kept alive for as long as the instance of this class
+    /// @param length Length of the recorded trace
+    /// @param real_time Whether the received messages should be delivered at the time they were recorded at or as fast as loop() is called, default = false
+    Replay_MQTT_Client(uint8_t const * trace, size_t const & length, bool real_time = false);
+
+    /// @brief Destructor
+    ~Replay_MQTT_Client();
+
+    /// @brief Sets whether the received messages should be delivered at the time they were recorded at or as fast as loop() is called
+    /// @param real_time Whether the messages should be delivered in real time
+    void set_real_time(bool real_time);
+
+    /// @brief Whether the given trace starts with the expected magic bytes and a supported version
+    /// @return Whether the trace can be replayed or not
+    bool is_valid() const;
+
+    /// @brief Whether every received message of the trace has been delivered
+    /// @return Whether the end of the trace has been reached
+    bool is_finished() const;
+
+    /// @brief Starts replaying from the first record of the trace again and resets the statistics, the connection state and the configured callbacks are kept
+    void restart();
+
+    /// @brief Gets the statistics about the messages handled since the instance was created or restart() was called
+    /// @return Statistics about the handled messages
+    MQTT_Replay_Statistics const & get_statistics() const;
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override;
+
+    void set_connect_callback(Callback<void>::function callback) override;
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override;
+
+    uint16_t get_receive_buffer_size() override;
+
+    uint16_t get_send_buffer_size() override;
+
+    void set_server(char const * domain, uint16_t port) override;
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override;
+
+    void disconnect() override;
+
+    bool loop() override;
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
+
+    bool subscribe(char const * topic) override;
+
+    bool subscribe(char const * const * topics, size_t const & topic_amount) override;
+
+    bool unsubscribe(char const * topic) override;
+
+    bool connected() override;
+
+    bool get_session_present() override;
+
+    bool set_stream_callback(Callback<bool, char const *>::function filter_callback, Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &>::function stream_callback) override;
+
+    uint32_t get_next_deadline() override;
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override;
+
+    bool end_publish() override;
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override;
+
+    size_t write(uint8_t const * buffer, size_t const & size) override;
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Reads the records of the trace until the next received message or slice, skips every outbound record
+    /// @return Whether a received message or slice was found or not, false once the end of the trace has been reached
+    bool Read_Next_Received();
+
+    /// @brief Delivers the previously read received message or slice to the data or stream callback
+    void Deliver_Pending();
+
+    /// @brief Copies the topic of the previously read record into the topic buffer and null-terminates it, grows the buffer if it is too small
+    /// @return Whether the topic was copied or not, false if growing the buffer failed
+    bool Copy_Topic();
+
+    /// @brief Updates the time passed since connecting, handles overflows of the 32-bit counter of micros()
+    void Update_Elapsed_Time();
+
+    MQTT_Trace_Reader                                                               m_reader;                     // Reader of the replayed trace
+    bool                                                                            m_real_time = {};             // Whether messages are delivered at the time they were recorded at
+    Callback<void>                                                                  m_connected_callback = {};    // Callback that will be called as soon as the mqtt client has connected
+    Callback<void, char *, uint8_t *, unsigned int>                                 m_data_callback = {};         // Callback that will be called with received messages that fit into the receive buffer
+    Callback<bool, char const *>                                                    m_stream_filter_callback = {}; // Callback that decides whether messages that do not fit into the receive buffer are streamed
+    Callback<void, char *, uint8_t *, unsigned int, size_t const &, size_t const &> m_stream_callback = {};       // Callback that will be called with the slices of streamed messages
+    bool                                                                            m_connected = {};             // Whether connect() has been called without calling disconnect() since
+    MQTT_Trace_Record                                                               m_pending = {};               // Received message or slice that is delivered next
+    bool                                                                            m_has_pending = {};           // Whether m_pending contains a record that has not been delivered yet
+    bool                                                                            m_end_reached = {};           // Whether every record of the trace has been read or the remaining trace is truncated
+    uint8_t                                                                         *m_receive_buffer = {};       // Buffer received messages are copied into before they are delivered
+    uint16_t                                                                        m_receive_buffer_size = {};   // Size of the receive buffer
+    uint16_t                                                                        m_send_buffer_size = {};      // Maximum size of published messages, bigger messages are rejected like a real client would
+    char                                                                            *m_topic = {};                // Buffer the null-terminated topic of received messages is copied into
+    size_t                                                                          m_topic_size = {};            // Size of the topic buffer
+    uint64_t                                                                        m_elapsed = {};               // Time passed since connecting in microseconds
+    uint32_t                                                                        m_last_time = {};             // Time the elapsed time was updated at in microseconds
+    MQTT_Replay_Statistics                                                          m_statistics = {};            // Statistics about the handled messages
+};
+
+#endif // Replay_MQTT_Client_h
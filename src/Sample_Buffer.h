@@ -0,0 +1,293 @@
+#ifndef Sample_Buffer_h
+#define Sample_Buffer_h
+
+// Local includes.
+#include "Configuration.h"
+
+// Library includes.
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if THINGSBOARD_ENABLE_STL
+#include <atomic>
+#endif // THINGSBOARD_ENABLE_STL
+
+
+// Timestamped telemetry keys.
+char constexpr SAMPLE_TIMESTAMP_KEY[] = "ts";
+char constexpr SAMPLE_VALUES_KEY[] = "values";
+
+
+/// @brief Type of the values stored in a single column of the Sample_Buffer
+enum class Sample_Column_Type : uint8_t {
+    INTEGER, ///< Signed 32-bit integer values, stored as they are
+    REAL, ///< 32-bit floating point values, stored as they are
+    DELTA_INTEGER ///< Signed 32-bit integer values, stored as the zig-zag encoded difference to the previous value of the same column, allows to export slowly changing values compactly with Encode_Column()
+};
+
+
+/// @brief Single value of a sample, the member that has to be set depends on the Sample_Column_Type of the column the value belongs to
+union Sample_Value {
+    int32_t  integer; // Value of INTEGER and DELTA_INTEGER columns
+    float    real;    // Value of REAL columns
+    uint32_t encoded; // Value as it is stored internally, zig-zag encoded difference for DELTA_INTEGER columns
+};
+
+
+/// @brief Columnar buffer for a high amount of samples of a fixed set of keys, captured at a high rate for example from a vibration sensor.
+/// Instead of storing every single value as a seperate Telemetry instance, with its own key pointer and type tag (24 bytes per value),
+/// the values are stored as a struct of arrays, with one 32-bit column per key and a shared timestamp column, which results in 4 bytes per value and 8 bytes per sample for the timestamp.
+/// Appending is lock-free and safe to be called from a single producer (interrupt or sensor task), while a single consumer concurrently serializes and consumes the samples,
+/// the samples are internally stored in a ring buffer, where the producer only ever writes the head and the consumer only ever writes the tail index.
+/// The samples are serialized into the ThingsBoard timestamped telemetry format ([{"ts":1451649600512,"values":{"key":1}}]) in slices that fit into a given buffer,
+/// which allows to send thousands of samples in multiple messages without ever creating the complete json payload at once.
+/// See https://thingsboard.io/docs/reference/mqtt-api/#telemetry-upload-api for more information on the timestamped telemetry format
+/// @tparam KeyAmount Amount of keys every sample contains a value for
+/// @tparam Capacity Maximum amount of samples that can be stored at once, before Append() fails
+template <size_t KeyAmount, size_t Capacity>
+class Sample_Buffer {
+  public:
+    /// @brief Constructor
+    /// @param keys Keys of the single columns, the strings are not copied and have to be kept alive for as long as the instance of this class
+    /// @param types Type of the single columns, has to contain KeyAmount elements just like the keys
+    Sample_Buffer(char const * const * keys, Sample_Column_Type const * types)
+      : m_keys()
+      , m_types()
+      , m_timestamps()
+      , m_columns()
+      , m_last_appended()
+      , m_last_consumed()
+      , m_head(0U)
+      , m_tail(0U)
+    {
+        for (size_t i = 0U; i < KeyAmount; ++i) {
+            m_keys[i] = keys[i];
+            m_types[i] = types[i];
+        }
+    }
+
+    /// @brief Appends a sample, can be called from an interrupt or another task while the samples are serialized, as long as only one producer appends at a time
+    /// @param timestamp Unix timestamp of the sample in milliseconds
+    /// @param values Values of the sample, has to contain KeyAmount elements in the same order as the keys
+    /// @return Whether the sample could be appended or not, fails if the buffer is full
+    bool Append(uint64_t const & timestamp, Sample_Value const * values) {
+        size_t const head = Load(m_head);
+        size_t const next = Next(head);
+        // Full if the next slot is still used by the oldest sample, one slot always stays empty to differentiate a full from an empty buffer
+        if (next == Load(m_tail)) {
+            return false;
+        }
+
+        m_timestamps[head] = timestamp;
+        for (size_t i = 0U; i < KeyAmount; ++i) {
+            if (m_types[i] == Sample_Column_Type::DELTA_INTEGER) {
+                m_columns[i][head] = Encode_Delta(m_last_appended[i], values[i].integer);
+                m_last_appended[i].integer = values[i].integer;
+                continue;
+            }
+            m_columns[i][head].encoded = values[i].encoded;
+        }
+        // Publish the written sample to the consumer only once it has been completely written
+        Store(m_head, next);
+        return true;
+    }
+
+    /// @brief Amount of samples that are currently stored and have not been consumed yet
+    /// @return Amount of stored samples
+    size_t Size() const {
+        size_t const head = Load(m_head);
+        size_t const tail = Load(m_tail);
+        return (head >= tail) ? head - tail : head + BUFFER_SIZE - tail;
+    }
+
+    /// @brief Serializes as many of the oldest samples as fit into the given buffer, as a json array in the ThingsBoard timestamped telemetry format.
+    /// The samples are not removed, to allow sending the serialized payload first and only calling Consume() once sending was successful.
+    /// Each sample is serialized directly into the given buffer once, without measuring it beforehand
+    /// @param json Buffer the json array will be written into, including the null terminator
+    /// @param size Size of the given buffer in bytes
+    /// @param sample_amount Amount of samples that were serialized, has to be passed to Consume() to remove them
+    /// @return Length of the serialized json array excluding the null terminator, 0 if no samples are stored or not even one sample fits into the buffer
+    size_t Serialize(char * json, size_t const & size, size_t & sample_amount) const {
+        sample_amount = 0U;
+        // Opening and closing bracket and null terminator
+        if (size < 3U) {
+            return 0U;
+        }
+
+        size_t const head = Load(m_head);
+        Sample_Value running[KeyAmount] = {};
+        for (size_t i = 0U; i < KeyAmount; ++i) {
+            running[i] = m_last_consumed[i];
+        }
+
+        size_t length = 0U;
+        json[length++] = '[';
+        for (size_t index = Load(m_tail); index != head; index = Next(index)) {
+            StaticJsonDocument<JSON_OBJECT_SIZE(2) + JSON_OBJECT_SIZE(KeyAmount)> document;
+            document[SAMPLE_TIMESTAMP_KEY] = m_timestamps[index];
+            JsonObject values = document.createNestedObject(SAMPLE_VALUES_KEY);
+            for (size_t i = 0U; i < KeyAmount; ++i) {
+                Sample_Value const value = Decode(i, index, running[i]);
+                if (m_types[i] == Sample_Column_Type::REAL) {
+                    values[m_keys[i]] = value.real;
+                    continue;
+                }
+                values[m_keys[i]] = value.integer;
+                running[i] = value;
+            }
+
+            size_t const separator = (sample_amount > 0U) ? 1U : 0U;
+            if (size < length + separator + 3U) {
+                break;
+            }
+            // Space left for the sample and its null terminator, while still keeping space for the closing bracket
+            size_t const remaining = size - length - separator - 1U;
+            size_t const written = serializeJson(document, json + length + separator, remaining);
+            // If the sample filled the complete space it might have been truncated, therefore it is only kept if there is space left
+            if (written == 0U || written >= remaining - 1U) {
+                break;
+            }
+            if (separator > 0U) {
+                json[length] = ',';
+            }
+            length += separator + written;
+            sample_amount++;
+        }
+
+        if (sample_amount == 0U) {
+            json[0U] = '\0';
+            return 0U;
+        }
+        json[length++] = ']';
+        json[length] = '\0';
+        return length;
+    }
+
+    /// @brief Removes the given amount of the oldest samples, should be called with the amount returned by Serialize() once the serialized payload was sent successfully
+    /// @param sample_amount Amount of samples that should be removed, is limited to the amount of stored samples
+    void Consume(size_t sample_amount) {
+        size_t const head = Load(m_head);
+        size_t tail = Load(m_tail);
+        for (; sample_amount > 0U && tail != head; --sample_amount) {
+            for (size_t i = 0U; i < KeyAmount; ++i) {
+                if (m_types[i] == Sample_Column_Type::DELTA_INTEGER) {
+                    m_last_consumed[i] = Decode(i, tail, m_last_consumed[i]);
+                }
+            }
+            tail = Next(tail);
+        }
+        // Release the consumed slots to the producer only once the consumer does not read them anymore
+        Store(m_tail, tail);
+    }
+
+    /// @brief Encodes the stored values of the given DELTA_INTEGER column, starting at the oldest sample, as unsigned LEB128 variable length integers of their zig-zag encoded differences.
+    /// Slowly changing values result in differences close to 0, which are encoded into a single byte instead of 4 bytes, allows to transfer a high amount of samples in a compact binary form
+    /// @param column Index of the column that should be encoded, has to be a DELTA_INTEGER column
+    /// @param buffer Buffer the encoded differences will be written into
+    /// @param size Size of the given buffer in bytes
+    /// @param sample_amount Amount of samples that were encoded, the first encoded difference is relative to the last consumed value of the column, which is 0 if no samples were consumed yet
+    /// @return Amount of bytes written into the buffer
+    size_t Encode_Column(size_t const & column, uint8_t * buffer, size_t const & size, size_t & sample_amount) const {
+        sample_amount = 0U;
+        if (column >= KeyAmount || m_types[column] != Sample_Column_Type::DELTA_INTEGER) {
+            return 0U;
+        }
+
+        size_t length = 0U;
+        size_t const head = Load(m_head);
+        for (size_t index = Load(m_tail); index != head; index = Next(index)) {
+            uint8_t encoded[5U] = {};
+            size_t encoded_length = 0U;
+            uint32_t remaining = m_columns[column][index].encoded;
+            do {
+                uint8_t const byte = remaining & 0x7FU;
+                remaining >>= 7U;
+                encoded[encoded_length++] = (remaining > 0U) ? (byte | 0x80U) : byte;
+            } while (remaining > 0U);
+
+            if (length + encoded_length > size) {
+                break;
+            }
+            memcpy(buffer + length, encoded, encoded_length);
+            length += encoded_length;
+            sample_amount++;
+        }
+        return length;
+    }
+
+  private:
+    // One additional slot, which always stays empty, to be able to differentiate between a full and an empty buffer with only the head and tail index
+    static size_t constexpr BUFFER_SIZE = Capacity + 1U;
+
+#if THINGSBOARD_ENABLE_STL
+    using Index = std::atomic<size_t>;
+
+    static size_t Load(Index const & index) {
+        return index.load(std::memory_order_acquire);
+    }
+
+    static void Store(Index & index, size_t const & value) {
+        index.store(value, std::memory_order_release);
+    }
+#else
+    using Index = size_t volatile;
+
+    static size_t Load(Index const & index) {
+        size_t const value = index;
+        // Full memory barrier, ensures the slots are not read before the index, because the atomic header does not exist without the C++ STL
+        __sync_synchronize();
+        return value;
+    }
+
+    static void Store(Index & index, size_t const & value) {
+        // Full memory barrier, ensures the slots are completely written or read before the index is changed
+        __sync_synchronize();
+        index = value;
+    }
+#endif // THINGSBOARD_ENABLE_STL
+
+    /// @brief Gets the index of the slot following the given slot in the ring buffer
+    /// @param index Index of the current slot
+    /// @return Index of the following slot
+    static size_t Next(size_t const & index) {
+        return (index + 1U) % BUFFER_SIZE;
+    }
+
+    /// @brief Calculates the difference between the given values and zig-zag encodes it, which maps signed differences close to 0 to small unsigned values (0 => 0, -1 => 1, 1 => 2, ...)
+    /// @param previous Previous value of the column
+    /// @param current Current value of the column
+    /// @return Zig-zag encoded difference between both values
+    static Sample_Value Encode_Delta(Sample_Value const & previous, int32_t const & current) {
+        // Unsigned arithmetic ensures the difference wraps around instead of overflowing, which is undefined behaviour for signed integers
+        uint32_t const difference = static_cast<uint32_t>(current) - previous.encoded;
+        Sample_Value value = {};
+        value.encoded = (difference << 1U) ^ (0U - (difference >> 31U));
+        return value;
+    }
+
+    /// @brief Decodes the stored value of the given column and slot
+    /// @param column Index of the column
+    /// @param index Index of the slot
+    /// @param previous Value of the previous sample of the column, only required for DELTA_INTEGER columns
+    /// @return Decoded value
+    Sample_Value Decode(size_t const & column, size_t const & index, Sample_Value const & previous) const {
+        Sample_Value value = m_columns[column][index];
+        if (m_types[column] == Sample_Column_Type::DELTA_INTEGER) {
+            uint32_t const difference = (value.encoded >> 1U) ^ (0U - (value.encoded & 1U));
+            value.encoded = previous.encoded + difference;
+        }
+        return value;
+    }
+
+    char const         *m_keys[KeyAmount] = {};                  // Keys of the single columns
+    Sample_Column_Type m_types[KeyAmount] = {};                  // Types of the single columns
+    uint64_t           m_timestamps[BUFFER_SIZE] = {};           // Shared timestamp column in milliseconds
+    Sample_Value       m_columns[KeyAmount][BUFFER_SIZE] = {};   // Value columns, one for every key
+    Sample_Value       m_last_appended[KeyAmount] = {};          // Last appended value of every column, only written by the producer to encode differences
+    Sample_Value       m_last_consumed[KeyAmount] = {};          // Last consumed value of every column, only written by the consumer to decode differences
+    Index              m_head = {};                              // Index of the slot the next sample is appended into, only written by the producer
+    Index              m_tail = {};                              // Index of the oldest stored sample, only written by the consumer
+};
+
+#endif // Sample_Buffer_h
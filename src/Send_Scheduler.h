@@ -0,0 +1,235 @@
+#ifndef Send_Scheduler_h
+#define Send_Scheduler_h
+
+// Local includes.
+#include "Outbound_Rate_Limiter.h"
+
+
+// Log messages.
+char constexpr SEND_SCHEDULE_ALLOCATION_FAILED[] = "Failed allocating required size (%u) to hold scheduled message, sending it directly instead";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr SEND_SCHEDULE_HELD[] = "Held message on topic (%s) until the next send window";
+char constexpr SEND_SCHEDULE_FLUSHED[] = "Flushed (%u) held messages in one send window";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Urgency of outgoing telemetry and attribute messages, decides how long the message is allowed to be held back at most, before it has to be sent
+enum class Send_Urgency : uint8_t {
+    IMMEDIATE, ///< Message is sent directly and additionally sends all held messages, because the radio has to wake up anyway
+    NORMAL, ///< Message is held until the next send window, but at most for the maximum latency configured for this urgency, default = Default_Normal_Send_Latency (60000)
+    LOW, ///< Message is held until the next send window, but at most for the maximum latency configured for this urgency, default = Default_Low_Send_Latency (600000)
+    MAX_VALUE ///< Amount of urgencies, not a valid urgency itself
+};
+
+
+/// @brief Holds non-urgent outgoing telemetry and attribute messages back and sends all of them together in one send window, because on battery powered cellular devices (LTE-M, NB-IoT),
+/// the amount of times the radio has to wake up decides the battery life much more than the amount of sent bytes.
+/// A send window is opened once the configured period has passed, aligned to the time the period was configured, once the maximum latency of any held message would be exceeded
+/// or as soon as the radio is awake anyway, because an immediate message (RPC response, firmware chunk request, provisioning, claiming, ...) is sent or any message has been received.
+/// Keep alive messages are sent by the underlying MQTT client itself, therefore to combine them with the send window, the period should be set to the keep alive interval of the client.
+/// Messages that are sent in a send window are passed on to the Outbound_Rate_Limiter, meaning the configured rate limits are still adhered to.
+/// As long as no period is configured all messages are passed on directly, without any additional overhead besides checking the urgency.
+/// Held messages are not guarded by a lock of their own, ThingsBoardSized locks its send mutex before calling any method, including Notify_Activity() from the receive callbacks of the client
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class Send_Scheduler {
+  public:
+    /// @brief Constructor
+    /// @param rate_limiter Rate limiter the messages are published with once they are sent, has to be kept alive for as long as the instance of this class
+    explicit Send_Scheduler(Outbound_Rate_Limiter<Logger> & rate_limiter)
+      : m_rate_limiter(rate_limiter)
+      , m_period(0U)
+      , m_next_window(0U)
+      , m_deadline(0U)
+      , m_activity(false)
+      , m_latencies{0U, Default_Normal_Send_Latency, Default_Low_Send_Latency}
+      , m_messages()
+      , m_count(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~Send_Scheduler() {
+        Clear();
+    }
+
+    /// @brief Sets the period send windows are opened with, the first window is opened one period after this method has been called.
+    /// Should be the same as the keep alive interval of the MQTT client, so held messages are sent while the radio is awake anyway
+    /// @param period Period in milliseconds, 0 disables holding messages and sends all held messages on the next call to loop()
+    void Set_Period(uint32_t const & period) {
+        m_period = period;
+        m_next_window = current_time() + period;
+        m_activity = m_activity || period == 0U;
+    }
+
+    /// @brief Sets the maximum amount of time a message with the given urgency is held back before it is sent, even if no send window has been opened yet
+    /// @param urgency Urgency the maximum latency should be configured for, Send_Urgency::IMMEDIATE can not be configured and is always 0
+    /// @param latency Maximum latency in milliseconds
+    /// @return Whether the maximum latency could be set for the given urgency or not
+    bool Set_Maximum_Latency(Send_Urgency const & urgency, uint32_t const & latency) {
+        if (urgency == Send_Urgency::IMMEDIATE || urgency >= Send_Urgency::MAX_VALUE) {
+            return false;
+        }
+        m_latencies[static_cast<size_t>(urgency)] = latency;
+        return true;
+    }
+
+    /// @brief Marks the radio as awake, because a message has been received, which causes all held messages to be sent on the next call to loop()
+    void Notify_Activity() {
+        m_activity = m_count > 0U;
+    }
+
+    /// @brief Holds the given message until the next send window or passes it on directly if it is urgent or does not contain telemetry or attributes
+    /// @param topic Topic that the message is sent over
+    /// @param json Null-terminated json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @param urgency Urgency of the message, only used for telemetry and attribute messages, every other message is always sent immediately
+    /// @return Whether sending or holding the message was successful or not
+    bool publish(char const * topic, char const * json, size_t const & length, Send_Urgency const & urgency) {
+        if (m_period == 0U || urgency == Send_Urgency::IMMEDIATE || urgency >= Send_Urgency::MAX_VALUE || !Is_Schedulable(topic)) {
+            // Held messages are sent first, to ensure messages are received in order and because the radio has to wake up for this message anyway
+            (void)Flush();
+            return m_rate_limiter.publish(topic, json, length);
+        }
+        else if (m_count >= Default_Send_Schedule_Queue_Size && !Flush()) {
+            return m_rate_limiter.publish(topic, json, length);
+        }
+
+        size_t const topic_size = strlen(topic) + 1U;
+        size_t const size = topic_size + length + 1U;
+        char * data = new char[size]();
+        if (data == nullptr) {
+            Logger::printfln(SEND_SCHEDULE_ALLOCATION_FAILED, size);
+            (void)Flush();
+            return m_rate_limiter.publish(topic, json, length);
+        }
+        memcpy(data, topic, topic_size);
+        memcpy(data + topic_size, json, length);
+
+        uint32_t const deadline = current_time() + m_latencies[static_cast<size_t>(urgency)];
+        // The earliest deadline of all held messages decides when they have to be sent at the latest, because all of them are sent together
+        if (m_count == 0U || static_cast<int32_t>(deadline - m_deadline) < 0) {
+            m_deadline = deadline;
+        }
+        Held_Message & message = m_messages[m_count++];
+        message.data = data;
+        message.json_offset = topic_size;
+        message.json_length = length;
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_SCHEDULE_HELD, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return true;
+    }
+
+    /// @brief Opens a send window if the period passed, the maximum latency of any held message would be exceeded or the radio has been marked as awake, should be called regularly from the loop() method of the ThingsBoard client
+    void loop() {
+        uint32_t const now = current_time();
+        bool const window = m_period != 0U && static_cast<int32_t>(now - m_next_window) >= 0;
+        if (window) {
+            // Keep the windows aligned to the period, even if loop() has not been called for multiple periods
+            do {
+                m_next_window += m_period;
+            } while (static_cast<int32_t>(now - m_next_window) >= 0);
+        }
+        if (m_count == 0U) {
+            return;
+        }
+        else if (window || m_activity || static_cast<int32_t>(now - m_deadline) >= 0) {
+            (void)Flush();
+        }
+    }
+
+    /// @brief Calculates how long it takes until the next send window has to be opened for the currently held messages, which is the latest time loop() has to be called again at.
+    /// Send windows without any held messages do not need loop() to be called, because the next window is realigned to the period once it is called again anyway
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if the held messages have to be sent immediately and UINT32_MAX if no message is held
+    uint32_t Get_Next_Deadline() const {
+        if (m_count == 0U) {
+            return UINT32_MAX;
+        }
+        else if (m_activity) {
+            return 0U;
+        }
+        uint32_t const now = current_time();
+        int32_t remaining = static_cast<int32_t>(m_deadline - now);
+        if (m_period != 0U && static_cast<int32_t>(m_next_window - now) < remaining) {
+            remaining = static_cast<int32_t>(m_next_window - now);
+        }
+        return remaining > 0 ? static_cast<uint32_t>(remaining) : 0U;
+    }
+
+    /// @brief Sends all held messages directly, keeps the remaining messages if sending one of them fails, to attempt sending them again in the next send window
+    /// @return Whether all held messages could be sent or not
+    bool Flush() {
+        if (m_count == 0U) {
+            return true;
+        }
+
+        size_t sent = 0U;
+        for (; sent < m_count; ++sent) {
+            Held_Message const & message = m_messages[sent];
+            if (!m_rate_limiter.publish(message.data, message.data + message.json_offset, message.json_length)) {
+                break;
+            }
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_SCHEDULE_FLUSHED, sent);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        for (size_t i = 0U; i < sent; ++i) {
+            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            delete[] m_messages[i].data;
+        }
+        for (size_t i = sent; i < m_count; ++i) {
+            m_messages[i - sent] = m_messages[i];
+        }
+        m_count -= sent;
+        m_activity = false;
+        return m_count == 0U;
+    }
+
+  private:
+    /// @brief Message that has been copied to be sent in the next send window, the topic and json payload are stored null-terminated after each other in one allocation
+    struct Held_Message {
+        char   *data;        // Allocation containing the topic followed by the json payload
+        size_t json_offset;  // Offset of the json payload from the start of the allocation
+        size_t json_length;  // Length of the json payload, excluding the null terminator
+    };
+
+    /// @brief Checks whether the given topic contains telemetry or attributes, because only those messages are held back, every other message is always sent immediately
+    /// @param topic Topic that the message is sent over
+    /// @return Whether the topic is the telemetry or attribute topic of the topic profile used by the rate limiter
+    bool Is_Schedulable(char const * topic) const {
+        Topic_Profile const & profile = m_rate_limiter.Get_Topic_Profile();
+        return strcmp(topic, profile.telemetry) == 0 || strcmp(topic, profile.attribute) == 0;
+    }
+
+    /// @brief Gets the current monotonic time in milliseconds, overflows after roughly 49 days, which is handled by comparing the signed difference
+    /// @return Current time in milliseconds since the device started
+    static uint32_t current_time() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return static_cast<uint32_t>(esp_timer_get_time() / 1000U);
+#else
+        return millis();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Releases the memory of all held messages without sending them
+    void Clear() {
+        for (size_t i = 0U; i < m_count; ++i) {
+            delete[] m_messages[i].data;
+            m_messages[i].data = nullptr;
+        }
+        m_count = 0U;
+    }
+
+    Outbound_Rate_Limiter<Logger> &m_rate_limiter;                                                    // Rate limiter held messages are passed on to once they are sent
+    uint32_t                      m_period = {};                                                      // Period send windows are opened with in milliseconds, 0 if messages are not held
+    uint32_t                      m_next_window = {};                                                 // Time the next send window is opened at in milliseconds
+    uint32_t                      m_deadline = {};                                                    // Earliest time any held message has to be sent at in milliseconds
+    bool                          m_activity = {};                                                    // Whether the radio is awake anyway, because a message has been received
+    uint32_t                      m_latencies[static_cast<size_t>(Send_Urgency::MAX_VALUE)] = {};    // Maximum latency of every urgency in milliseconds
+    Held_Message                  m_messages[Default_Send_Schedule_Queue_Size] = {};                  // Held messages in the order they were published in
+    size_t                        m_count = {};                                                       // Amount of held messages
+};
+
+#endif // Send_Scheduler_h
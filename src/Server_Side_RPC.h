@@ -4,14 +4,21 @@
 // Local includes.
 #include "RPC_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Helper.h"
 
 
-// Server side RPC topics.
-char constexpr RPC_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/request/+";
-char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
-char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
+// Server side RPC request keys, extracted in the same order from every received request.
+char constexpr const * RPC_REQUEST_KEYS[] = {RPC_METHOD_KEY, RPC_PARAMS_KEY};
 // Log messages.
 char constexpr RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
+char constexpr RPC_WRITER_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase send buffer size (%u)";
+char constexpr RPC_REQUEST_SCAN_FAILED[] = "Received server-side RPC request is not a valid json object";
+char constexpr RPC_REQUEST_TOO_BIG[] = "Received server-side RPC request with size (%u) is bigger than the receive buffer, increase accordingly";
+char constexpr RPC_PARAMS_DE_SERIALIZE_FAILED[] = "Unable to de-serialize received server-side RPC parameters with (%s)";
+char constexpr RPC_RESPONSE_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the server-side RPC response";
+#if THINGSBOARD_ENABLE_DYNAMIC
+char constexpr RPC_PARAMS_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for the received server-side RPC parameters";
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 #if !THINGSBOARD_ENABLE_DYNAMIC
 char constexpr SERVER_SIDE_RPC_SUBSCRIPTIONS[] = "server-side RPC";
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
@@ -34,13 +41,23 @@ template <typename Logger = DefaultLogger>
 /// @tparam MaxRPC Maximum amount of key-value pairs that will ever be sent in the subscribed callback method of an RPC_Callback, allows to use a StaticJsonDocument on the stack in the background.
 /// If we simply use .to<JsonVariant>(); on the received document and use .set() to change the internal value then the size requirements are 0.
 /// However if we attempt to send multiple key-value pairs, we have to adjust the size accordingly. See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size and divide the result by 16 to receive the required MaxRPC value, default = Default_RPC_Amount (0)
-template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC = Default_RPC_Amount, typename Logger = DefaultLogger>
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+/// @tparam MaxParams Maximum amount of key-value pairs that will ever be received in the parameters of a server-side RPC request, only required for callbacks that receive the parameters deserialized into a JsonVariantConst,
+/// because callbacks constructed with a raw parameters callback receive them without deserialization, default = Default_Response_Amount (8)
+template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC = Default_RPC_Amount, typename Logger = DefaultLogger, size_t MaxParams = Default_Response_Amount>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 class Server_Side_RPC : public IAPI_Implementation {
   public:
     /// @brief Constructor
     Server_Side_RPC() = default;
 
+    /// @brief Destructor
+    ~Server_Side_RPC() {
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        delete[] m_response_buffer;
+        m_response_buffer = nullptr;
+    }
+
     /// @brief Subscribes multiple server side RPC callbacks,
     /// that will be called if a request from the server for the method with the given name is received.
     /// Can be called even if we are currently not connected to the cloud,
@@ -64,7 +81,7 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        (void)m_subscribe_topic_callback.Call_Callback(m_topic_profile->rpc_subscribe);
         // Push back complete vector into our local m_rpc_callbacks vector.
         m_rpc_callbacks.insert(m_rpc_callbacks.end(), first, last);
         return true;
@@ -87,7 +104,7 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        (void)m_subscribe_topic_callback.Call_Callback(m_topic_profile->rpc_subscribe);
         m_rpc_callbacks.push_back(callback);
         return true;
     }
@@ -98,81 +115,80 @@ class Server_Side_RPC : public IAPI_Implementation {
     /// and from the rpc topic, was successful or not
     bool RPC_Unsubscribe() {
         m_rpc_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        return m_unsubscribe_topic_callback.Call_Callback(m_topic_profile->rpc_subscribe);
     }
 
     API_Process_Type Get_Process_Type() const override {
-        return API_Process_Type::JSON;
+        // Requests are processed from their raw bytes, because only the method name and the parameters have to be extracted,
+        // which is done with a single scan over the payload instead of deserializing the complete request into a JsonDocument first
+        return API_Process_Type::RAW;
     }
 
-    void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
-        // Nothing to do
+    void Process_Response_Slice(char const * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) override {
+        // Requests are only scanned once they were received completly, therefore a request that did not fit into the receive buffer is discarded, but reported once with its first slice
+        if (offset == 0U) {
+            Logger::printfln(RPC_REQUEST_TOO_BIG, total_length);
+        }
     }
 
-    void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        if (!data.containsKey(RPC_METHOD_KEY)) {
+    void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
+        char * json = reinterpret_cast<char *>(payload);
+        Json_Extractor<2U> const extractor(RPC_REQUEST_KEYS);
+        Json_Span values[2U] = {};
+        if (!extractor.Extract(json, length, values)) {
+            Logger::printfln(RPC_REQUEST_SCAN_FAILED);
+            return;
+        }
+        Json_Span const & params = values[1U];
+        Json_Span method_name = {};
+        if (!Json_Scanner::Get_String(values[0U], method_name)) {
 #if THINGSBOARD_ENABLE_DEBUG
             Logger::printfln(SERVER_RPC_METHOD_NULL);
 #endif // THINGSBOARD_ENABLE_DEBUG
             return;
         }
-        char const * method_name = data[RPC_METHOD_KEY];
 
 #if THINGSBOARD_ENABLE_STL
         auto it = std::find_if(m_rpc_callbacks.begin(), m_rpc_callbacks.end(), [&method_name](RPC_Callback const & rpc) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            return (!Helper::stringIsNullorEmpty(subscribedMethodName) && strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) == 0);
+            return Matches_Method_Name(rpc, method_name);
         });
         if (it != m_rpc_callbacks.end()) {
             auto & rpc = *it;
 #else
         for (auto const & rpc : m_rpc_callbacks) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            if (Helper::stringIsNullorEmpty(subscribedMethodName) || strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) != 0) {
+            if (!Matches_Method_Name(rpc, method_name)) {
               continue;
             }
 #endif // THINGSBOARD_ENABLE_STL
 #if THINGSBOARD_ENABLE_DEBUG
-            if (!data.containsKey(RPC_PARAMS_KEY)) {
+            if (params.Is_Null()) {
                 Logger::printfln(NO_RPC_PARAMS_PASSED);
             }
+            Logger::printfln(CALLING_RPC_CB, rpc.Get_Name());
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-#if THINGSBOARD_ENABLE_DEBUG
-            Logger::printfln(CALLING_RPC_CB, method_name);
-#endif // THINGSBOARD_ENABLE_DEBUG
+            size_t const request_id = Helper::parseRequestId(m_topic_profile->rpc_request, topic);
+            char responseTopic[Helper::detectSize(m_topic_profile->rpc_send_response, request_id)] = {};
+            (void)snprintf(responseTopic, sizeof(responseTopic), m_topic_profile->rpc_send_response, request_id);
 
-            JsonVariantConst const param = data[RPC_PARAMS_KEY];
-#if THINGSBOARD_ENABLE_DYNAMIC
-            size_t const & rpc_response_size = rpc.Get_Response_Size();
-            TBJsonDocument json_buffer(rpc_response_size);
-#else
-            size_t constexpr rpc_response_size = MaxRPC;
-            StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-            rpc.Call_Callback(param, json_buffer);
-
-            if (json_buffer.isNull()) {
-#if THINGSBOARD_ENABLE_DEBUG
-                Logger::printfln(RPC_RESPONSE_NULL);
-#endif // THINGSBOARD_ENABLE_DEBUG
-                return;
-            }
-            else if (json_buffer.overflowed()) {
-                Logger::printfln(RPC_RESPONSE_OVERFLOWED, rpc_response_size);
+            if (rpc.Uses_Raw_Params()) {
+                Write_Response(rpc, params, responseTopic);
                 return;
             }
-
-            size_t const request_id = Helper::parseRequestId(RPC_REQUEST_TOPIC, topic);
-            char responseTopic[Helper::detectSize(RPC_SEND_RESPONSE_TOPIC, request_id)] = {};
-            (void)snprintf(responseTopic, sizeof(responseTopic), RPC_SEND_RESPONSE_TOPIC, request_id);
-            (void)m_send_json_callback.Call_Callback(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
+            // Only the parameters are deserialized and only if the subscribed callback expects them as a JsonVariantConst,
+            // the span points into the writeable receive buffer, which allows to deserialize it with the zero copy mode
+            uint8_t * params_payload = params.Is_Null() ? nullptr : payload + (params.data - json);
+            Process_Json_Params(rpc, params_payload, params.length, responseTopic);
             return;
         }
     }
 
+    void Process_Json_Response(char const * topic, JsonDocument const & data) override {
+        // Nothing to do
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(RPC_REQUEST_TOPIC, topic, strlen(RPC_REQUEST_TOPIC)) == 0;
+        return strncmp(m_topic_profile->rpc_request, topic, strlen(m_topic_profile->rpc_request)) == 0;
     }
 
     bool Unsubscribe() override {
@@ -180,33 +196,167 @@ class Server_Side_RPC : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_rpc_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC)) {
-            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_SUBSCRIBE_TOPIC);
+        if (!m_rpc_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(m_topic_profile->rpc_subscribe)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, m_topic_profile->rpc_subscribe);
             return false;
         }
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
+    void Set_Topic_Profile(Topic_Profile const & profile) override {
+        m_topic_profile = &profile;
+    }
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_send_json_callback.Set_Callback(send_json_callback);
+        m_send_json_string_callback.Set_Callback(send_json_string_callback);
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
         m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
+        m_get_send_size_callback.Set_Callback(get_send_size_callback);
     }
 
   private:
+    /// @brief Checks whether the received method name matches the name the given callback was subscribed with,
+    /// the received method name only has to start with the subscribed name, which keeps the previous matching behaviour
+    /// @param rpc Subscribed callback that should be checked
+    /// @param method_name Received method name without its surrounding quotes
+    /// @return Whether the given callback should be called for the received method name
+    static bool Matches_Method_Name(RPC_Callback const & rpc, Json_Span const & method_name) {
+        char const * subscribedMethodName = rpc.Get_Name();
+        if (Helper::stringIsNullorEmpty(subscribedMethodName)) {
+            return false;
+        }
+        size_t const subscribed_length = strlen(subscribedMethodName);
+        return subscribed_length <= method_name.length && strncmp(subscribedMethodName, method_name.data, subscribed_length) == 0;
+    }
+
+    /// @brief Deserializes the received parameters into a JsonDocument and calls the given callback with them, afterwards sends the response it wrote
+    /// @param rpc Subscribed callback that expects the parameters as a JsonVariantConst
+    /// @param params Serialized parameters pointing into the receive buffer, nullptr if no parameters were received
+    /// @param length Length of the serialized parameters
+    /// @param response_topic Topic the response should be sent on
+    void Process_Json_Params(RPC_Callback const & rpc, uint8_t * params, size_t const & length, char const * response_topic) {
+        // Calculate size with the total amount of commas, always denotes the end of a key-value pair besides for the last element in an array or in an object where the comma is not permitted,
+        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well
+        size_t const size = Helper::getOccurences(params, ',', length) + Helper::getOccurences(params, '{', length) + Helper::getOccurences(params, '[', length);
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const document_size = JSON_OBJECT_SIZE(size);
+        TBJsonDocument params_buffer(document_size);
+        if (params_buffer.capacity() != document_size) {
+            Logger::printfln(RPC_PARAMS_ALLOCATION_FAILED, document_size);
+            return;
+        }
+#else
+        if (size > MaxParams) {
+            Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxParams", MaxParams);
+            return;
+        }
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxParams)> params_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        if (params != nullptr) {
+            DeserializationError const error = deserializeJson(params_buffer, params, length);
+            if (error) {
+                Logger::printfln(RPC_PARAMS_DE_SERIALIZE_FAILED, error.c_str());
+                return;
+            }
+        }
+        JsonVariantConst const param = params_buffer.template as<JsonVariantConst>();
+
+        if (rpc.Uses_Response_Writer()) {
+            Write_Response(rpc, param, response_topic);
+            return;
+        }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const & rpc_response_size = rpc.Get_Response_Size();
+        TBJsonDocument json_buffer(rpc_response_size);
+#else
+        size_t constexpr rpc_response_size = MaxRPC;
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        rpc.Call_Callback(param, json_buffer);
+
+        if (json_buffer.isNull()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RPC_RESPONSE_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+        else if (json_buffer.overflowed()) {
+            Logger::printfln(RPC_RESPONSE_OVERFLOWED, rpc_response_size);
+            return;
+        }
+
+        (void)m_send_json_callback.Call_Callback(response_topic, json_buffer, 0U);
+    }
+
+    /// @brief Calls the given response writer callback and sends the written response.
+    /// The response is written into a buffer with the size of the send buffer, because any bigger response could not be sent anyway,
+    /// the buffer is kept for all following requests and only allocated again if the send buffer has been increased in the meantime
+    /// @tparam TParams Type the received parameters are passed to the callback as, either JsonVariantConst or Json_Span
+    /// @param rpc Subscribed callback that should write the response
+    /// @param param Parameters that were received with the server-side RPC request
+    /// @param response_topic Topic the written response should be sent on
+    template <typename TParams>
+    void Write_Response(RPC_Callback const & rpc, TParams const & param, char const * response_topic) {
+        // Additional byte is required for the null terminator, because the send buffer size only limits the payload itself
+        size_t const buffer_size = m_get_send_size_callback.Call_Callback() + 1U;
+        if (m_response_buffer == nullptr || m_response_buffer_size < buffer_size) {
+            char * buffer = new char[buffer_size]();
+            if (buffer == nullptr) {
+                Logger::printfln(RPC_RESPONSE_ALLOCATION_FAILED, buffer_size);
+                return;
+            }
+            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            delete[] m_response_buffer;
+            m_response_buffer = buffer;
+            m_response_buffer_size = buffer_size;
+        }
+        Write_Response(rpc, param, response_topic, m_response_buffer, buffer_size);
+    }
+
+    /// @brief Calls the given response writer callback and sends the response written into the given buffer
+    /// @tparam TParams Type the received parameters are passed to the callback as, either JsonVariantConst or Json_Span
+    /// @param rpc Subscribed callback that should write the response
+    /// @param param Parameters that were received with the server-side RPC request
+    /// @param response_topic Topic the written response should be sent on
+    /// @param buffer Buffer the response should be written into
+    /// @param buffer_size Total size of the given buffer
+    template <typename TParams>
+    void Write_Response(RPC_Callback const & rpc, TParams const & param, char const * response_topic, char * buffer, size_t const & buffer_size) {
+        RPC_Response_Writer writer(buffer, buffer_size);
+        rpc.Call_Writer_Callback(param, writer);
+
+        if (writer.Overflowed()) {
+            Logger::printfln(RPC_WRITER_RESPONSE_OVERFLOWED, buffer_size - 1U);
+            return;
+        }
+        else if (writer.Is_Empty()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RPC_RESPONSE_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+        (void)m_send_json_string_callback.Call_Callback(response_topic, writer.Finish());
+    }
+
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
+    Callback<bool, char const * const, char const * const>                   m_send_json_string_callback = {};  // Send json string callback
+    Callback<uint16_t>                                                       m_get_send_size_callback = {};     // Get client send buffer size callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    Topic_Profile const                                                      *m_topic_profile = &DEFAULT_TOPIC_PROFILE; // Topics the server-side RPC requests are received and answered over
+    char                                                                     *m_response_buffer = {};           // Heap allocated buffer the response writer callbacks write into, kept for all following requests and nullptr until the first response is written
+    size_t                                                                   m_response_buffer_size = {};       // Size of the response buffer, including the null terminator
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -51,9 +51,13 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        (void)m_subscribe_topic_callback.Call_Callback(m_topic_profile->attribute);
+        size_t const previous_size = m_shared_attribute_update_callbacks.size();
         // Push back complete vector into our local m_shared_attribute_update_callbacks vector.
         m_shared_attribute_update_callbacks.insert(m_shared_attribute_update_callbacks.end(), first, last);
+        for (size_t i = previous_size; i < m_shared_attribute_update_callbacks.size(); ++i) {
+            Index_Callback_Keys(i);
+        }
         return true;
     }
 
@@ -78,8 +82,9 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        (void)m_subscribe_topic_callback.Call_Callback(m_topic_profile->attribute);
         m_shared_attribute_update_callbacks.push_back(callback);
+        Index_Callback_Keys(m_shared_attribute_update_callbacks.size() - 1U);
         return true;
     }
 
@@ -89,7 +94,8 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     /// and from the attribute topic, was successful or not
     bool Shared_Attributes_Unsubscribe() {
         m_shared_attribute_update_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        m_key_index.clear();
+        return m_unsubscribe_topic_callback.Call_Callback(m_topic_profile->attribute);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -106,62 +112,39 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             object = object[SHARED_RESPONSE_KEY];
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<Shared_Attribute_Callback> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (shared_attribute.Get_Attributes().empty() || std::find_if(shared_attribute.Get_Attributes().begin(), shared_attribute.Get_Attributes().end(), [&object](const char * att) {
-                return object.containsKey(att);
-            }) != shared_attribute.Get_Attributes().end());
-        });
-
-        for (auto const & shared_attribute : filtered_shared_attribute_update_callbacks) {
-#else
-        for (auto const & shared_attribute : m_shared_attribute_update_callbacks) {
-            if (shared_attribute.Get_Attributes().empty()) {
-                // No specifc keys were subscribed so we call the callback anyway, assumed to be subscribed to any update
-                shared_attribute.Call_Callback(object);
-                continue;
-            }
-
-            char const * requested_att = nullptr;
+        size_t const callback_amount = m_shared_attribute_update_callbacks.size();
+        if (callback_amount == 0U) {
+            return;
+        }
 
-            for (auto const & att : shared_attribute.Get_Attributes()) {
-                if (Helper::stringIsNullorEmpty(att)) {
-                    continue;
-                }
-                // Check if the request contained any of our requested keys and
-                // break early if the key was requested from this callback.
-                if (object.containsKey(att)) {
-                    requested_att = att;
-                    break;
+        // Walk the received payload only once and look up every received key in the index built at subscription time,
+        // instead of checking every subscribed key of every callback with containsKey(), which would scan the whole payload each time.
+        // Results in a cost of O(received keys * log(subscribed keys)) instead of O(callbacks * subscribed keys * received keys)
+        bool matched_callbacks[callback_amount] = {};
+        for (JsonPairConst const pair : object) {
+            char const * received_key = pair.key().c_str();
+            uint32_t const hash = Helper::calculateKeyHash(received_key);
+            for (size_t i = Find_First_Index_Entry(hash); i < m_key_index.size() && m_key_index[i].hash == hash; ++i) {
+                auto const & entry = m_key_index[i];
+                // Hashes of different keys might collide, therefore we still have to confirm the match with the actual string
+                if (strcmp(entry.key, received_key) == 0) {
+                    matched_callbacks[entry.callback_index] = true;
                 }
             }
+        }
 
-            // Check if this callback did not request any keys that were in this response,
-            // if there were not we simply continue with the next subscribed callback.
-            if (requested_att == nullptr) {
+        // Callbacks are still called in the order they were subscribed in, callbacks without any specific keys are assumed to be subscribed to any update
+        for (size_t i = 0U; i < callback_amount; ++i) {
+            auto const & shared_attribute = m_shared_attribute_update_callbacks[i];
+            if (!matched_callbacks[i] && !shared_attribute.Get_Attributes().empty()) {
                 continue;
             }
-#endif // THINGSBOARD_ENABLE_STL
             shared_attribute.Call_Callback(object);
         }
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(ATTRIBUTE_TOPIC, topic, strlen(ATTRIBUTE_TOPIC) + 1) == 0;
+        return strncmp(m_topic_profile->attribute, topic, strlen(m_topic_profile->attribute) + 1) == 0;
     }
 
     bool Unsubscribe() override {
@@ -169,31 +152,77 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_shared_attribute_update_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC)) {
-            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_TOPIC);
+        if (!m_shared_attribute_update_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(m_topic_profile->attribute)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, m_topic_profile->attribute);
             return false;
         }
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
+    void Set_Topic_Profile(Topic_Profile const & profile) override {
+        m_topic_profile = &profile;
+    }
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
         m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
     }
 
   private:
+    /// @brief Entry of the inverted index from subscribed shared attribute key to the callback that subscribed it
+    struct Key_Index_Entry {
+        uint32_t     hash;           // FNV-1a hash of the subscribed key, the index is sorted by this value
+        char const   *key;           // Subscribed key, used to confirm a match if the hashes are the same
+        size_t       callback_index; // Index of the callback in m_shared_attribute_update_callbacks that subscribed the key
+    };
+
+    /// @brief Inserts all keys of the callback at the given index into the sorted key index.
+    /// Keys are inserted at their sorted position so that received keys can be looked up with a binary search
+    /// @param callback_index Index of the callback in m_shared_attribute_update_callbacks whose keys should be indexed
+    void Index_Callback_Keys(size_t const & callback_index) {
+        for (auto const & att : m_shared_attribute_update_callbacks[callback_index].Get_Attributes()) {
+            if (Helper::stringIsNullorEmpty(att)) {
+                continue;
+            }
+            Key_Index_Entry const entry = { Helper::calculateKeyHash(att), att, callback_index };
+            // Both Array and Vector only support appending, therefore we append and move the entry to its sorted position afterwards
+            m_key_index.push_back(entry);
+            for (size_t i = m_key_index.size() - 1U; i > 0U && m_key_index[i - 1U].hash > entry.hash; --i) {
+                m_key_index[i] = m_key_index[i - 1U];
+                m_key_index[i - 1U] = entry;
+            }
+        }
+    }
+
+    /// @brief Searches the sorted key index for the first entry with the given hash
+    /// @param hash Hash of the received key we want to find subscribed entries for
+    /// @return Index of the first entry with a hash bigger or equal to the given hash, or the size of the index if there is no such entry
+    size_t Find_First_Index_Entry(uint32_t const & hash) const {
+        size_t low = 0U;
+        size_t high = m_key_index.size();
+        while (low < high) {
+            size_t const middle = low + ((high - low) / 2U);
+            if (m_key_index[middle].hash < hash) {
+                low = middle + 1U;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};          // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};        // Unubscribe mqtt topic client callback
+    Topic_Profile const                                                      *m_topic_profile = &DEFAULT_TOPIC_PROFILE; // Topics the shared attribute updates are received over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -205,8 +234,10 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
     Vector<Shared_Attribute_Callback>                                        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks vector
+    Vector<Key_Index_Entry>                                                  m_key_index = {};                         // Subscribed keys of all callbacks sorted by their hash
 #else
     Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions>        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks array
+    Array<Key_Index_Entry, MaxSubscriptions * MaxAttributes>                 m_key_index = {};                         // Subscribed keys of all callbacks sorted by their hash
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
@@ -0,0 +1,451 @@
+// Header include.
+#include "Socket_CoAP_Client.h"
+
+#if THINGSBOARD_USE_BSD_SOCKETS
+
+// Library includes.
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// Length of the generated tokens, enough to differentiate every request and observation of a single device.
+uint8_t constexpr COAP_TOKEN_LENGTH = 4U;
+// Class of successful response codes.
+uint8_t constexpr COAP_SUCCESS_CLASS = 2U;
+
+Socket_CoAP_Client::Socket_CoAP_Client() :
+    m_notification_callback(),
+    m_socket(-1),
+    m_receive_buffer(nullptr),
+    m_receive_buffer_size(0U),
+    m_send_buffer(nullptr),
+    m_send_buffer_size(0U),
+    m_ack_timeout(COAP_DEFAULT_ACK_TIMEOUT),
+    m_max_retransmit(COAP_DEFAULT_MAX_RETRANSMIT),
+    m_message_id(0U),
+    m_token(0U),
+    m_response(),
+    m_observations()
+{
+    // Message ids and tokens should not start at the same value after every restart, because the server would otherwise detect the first requests as duplicates of the requests sent before the restart
+    uint64_t const seed = Get_Time() ^ reinterpret_cast<uintptr_t>(this);
+    m_message_id = static_cast<uint16_t>(seed);
+    m_token = static_cast<uint32_t>(seed >> 16U);
+}
+
+Socket_CoAP_Client::~Socket_CoAP_Client() {
+    stop();
+    delete[] m_receive_buffer;
+    m_receive_buffer = nullptr;
+    delete[] m_send_buffer;
+    m_send_buffer = nullptr;
+}
+
+void Socket_CoAP_Client::set_transmission_parameters(uint32_t ack_timeout, uint8_t max_retransmit) {
+    m_ack_timeout = ack_timeout;
+    m_max_retransmit = max_retransmit;
+}
+
+void Socket_CoAP_Client::set_notification_callback(Callback<void, char const *, uint8_t *, unsigned int>::function callback) {
+    m_notification_callback.Set_Callback(callback);
+}
+
+bool Socket_CoAP_Client::set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    if (receive_buffer_size != m_receive_buffer_size) {
+        // Additional byte allows to detect datagrams that are bigger than the configured size, because they fill the complete buffer
+        uint8_t * receive_buffer = new uint8_t[receive_buffer_size + 1U]();
+        if (receive_buffer == nullptr) {
+            return false;
+        }
+        delete[] m_receive_buffer;
+        m_receive_buffer = receive_buffer;
+        m_receive_buffer_size = receive_buffer_size;
+        // Previous response pointed into the deleted buffer
+        m_response = CoAP_Message();
+    }
+    if (send_buffer_size != m_send_buffer_size) {
+        uint8_t * send_buffer = new uint8_t[send_buffer_size]();
+        if (send_buffer == nullptr) {
+            return false;
+        }
+        delete[] m_send_buffer;
+        m_send_buffer = send_buffer;
+        m_send_buffer_size = send_buffer_size;
+    }
+    return true;
+}
+
+uint16_t Socket_CoAP_Client::get_receive_buffer_size() {
+    return m_receive_buffer_size;
+}
+
+uint16_t Socket_CoAP_Client::get_send_buffer_size() {
+    return m_send_buffer_size;
+}
+
+int Socket_CoAP_Client::connect(char const * host, uint16_t port) {
+    stop();
+    if (host == nullptr) {
+        return COAP_ERROR_RESOLVE_FAILED;
+    }
+    char service[6U] = {};
+    (void)snprintf(service, sizeof(service), "%u", port);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo * addresses = nullptr;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0) {
+        return COAP_ERROR_RESOLVE_FAILED;
+    }
+
+    // Connecting an UDP socket does not send anything, it only sets the default destination and discards datagrams received from any other sender
+    for (addrinfo * address = addresses; address != nullptr && m_socket < 0; address = address->ai_next) {
+        m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (m_socket < 0) {
+            continue;
+        }
+        if (::connect(m_socket, address->ai_addr, address->ai_addrlen) < 0) {
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return (m_socket < 0) ? COAP_ERROR_NOT_CONNECTED : 0;
+}
+
+void Socket_CoAP_Client::stop() {
+    if (m_socket >= 0) {
+        (void)close(m_socket);
+        m_socket = -1;
+    }
+    for (auto & observation : m_observations) {
+        Free_Observation(observation);
+    }
+    m_response = CoAP_Message();
+}
+
+bool Socket_CoAP_Client::connected() {
+    return m_socket >= 0;
+}
+
+int Socket_CoAP_Client::request(CoAP_Method const & method, char const * path, uint8_t const * payload, size_t const & length) {
+    CoAP_Message message;
+    message.code = static_cast<uint8_t>(method);
+    message.uri = path;
+    if (payload != nullptr && length > 0U) {
+        message.has_content_format = true;
+        message.content_format = COAP_CONTENT_FORMAT_JSON;
+        // Payload is only read while encoding the message
+        message.payload = const_cast<uint8_t *>(payload);
+        message.payload_length = length;
+    }
+    return Exchange(message);
+}
+
+int Socket_CoAP_Client::get_block(char const * path, size_t const & block_number, uint16_t const & block_size) {
+    CoAP_Message message;
+    message.code = static_cast<uint8_t>(CoAP_Method::GET);
+    message.uri = path;
+    message.has_block2 = true;
+    message.block_number = block_number;
+    message.block_size = block_size;
+    return Exchange(message);
+}
+
+int Socket_CoAP_Client::get_response_code() {
+    return CoAP_Codec::Get_Response_Code(m_response.code);
+}
+
+uint8_t * Socket_CoAP_Client::get_response_payload() {
+    return m_response.payload;
+}
+
+size_t Socket_CoAP_Client::get_response_length() {
+    return m_response.payload_length;
+}
+
+bool Socket_CoAP_Client::observe(char const * path) {
+    if (path == nullptr) {
+        return false;
+    }
+    else if (Find_Observation(path) != nullptr) {
+        return true;
+    }
+    Observation * observation = Find_Observation(nullptr);
+    if (observation == nullptr) {
+        return false;
+    }
+
+    CoAP_Message message;
+    message.code = static_cast<uint8_t>(CoAP_Method::GET);
+    message.uri = path;
+    message.has_observe = true;
+    message.observe = COAP_OBSERVE_REGISTER;
+    // Servers that do not support observing the resource respond without the Observe option, which means no notifications will follow
+    if (Exchange(message) != 0 || (m_response.code >> 5U) != COAP_SUCCESS_CLASS || !m_response.has_observe) {
+        return false;
+    }
+
+    size_t const path_length = strlen(path);
+    observation->path = new char[path_length + 1U]();
+    if (observation->path == nullptr) {
+        return false;
+    }
+    memcpy(observation->path, path, path_length);
+    memcpy(observation->token, message.token, message.token_length);
+    observation->token_length = message.token_length;
+    observation->sequence = m_response.observe;
+    return true;
+}
+
+bool Socket_CoAP_Client::cancel_observe(char const * path) {
+    Observation * observation = Find_Observation(path);
+    if (observation == nullptr) {
+        return false;
+    }
+    // Deregistering has to use the same token as the registration, the result is ignored because the server stops sending notifications anyway, once they are rejected with a reset
+    CoAP_Message message;
+    message.code = static_cast<uint8_t>(CoAP_Method::GET);
+    message.uri = path;
+    message.has_observe = true;
+    message.observe = COAP_OBSERVE_DEREGISTER;
+    memcpy(message.token, observation->token, observation->token_length);
+    message.token_length = observation->token_length;
+    Free_Observation(*observation);
+    (void)Exchange(message);
+    return true;
+}
+
+bool Socket_CoAP_Client::loop() {
+    if (m_socket < 0) {
+        return false;
+    }
+
+    // Notifications queued while waiting for a response are passed on first, because they were received before any datagram that is still waiting in the socket
+    for (auto & observation : m_observations) {
+        if (observation.queued == nullptr) {
+            continue;
+        }
+        // Taken out of the observation before passing it on, because the callback might cancel the observation, which would otherwise free the payload while it is still used
+        uint8_t * queued = observation.queued;
+        size_t const queued_length = observation.queued_length;
+        observation.queued = nullptr;
+        observation.queued_length = 0U;
+        CoAP_Message message;
+        if (CoAP_Codec::Decode(queued, queued_length, message)) {
+            Handle_Notification(observation, message);
+        }
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] queued;
+        queued = nullptr;
+    }
+
+    int length = 0;
+    while ((length = Receive(0U)) >= 0) {
+        CoAP_Message message;
+        if (length == 0 || !CoAP_Codec::Decode(m_receive_buffer, length, message)) {
+            continue;
+        }
+        Observation * observation = Find_Observation(message.token, message.token_length);
+        if (observation == nullptr || message.code == COAP_CODE_EMPTY) {
+            Reject_Unexpected(message, length);
+            continue;
+        }
+        if (message.type == CoAP_Type::CONFIRMABLE) {
+            Send_Empty(CoAP_Type::ACKNOWLEDGEMENT, message.message_id);
+        }
+        Handle_Notification(*observation, message);
+    }
+    return m_socket >= 0;
+}
+
+int Socket_CoAP_Client::get_readiness_handle() {
+    return m_socket;
+}
+
+int Socket_CoAP_Client::Exchange(CoAP_Message & message) {
+    if (m_socket < 0) {
+        return COAP_ERROR_NOT_CONNECTED;
+    }
+    message.type = CoAP_Type::CONFIRMABLE;
+    message.message_id = m_message_id++;
+    if (message.token_length == 0U) {
+        uint32_t const token = m_token++;
+        for (uint8_t i = 0U; i < COAP_TOKEN_LENGTH; ++i) {
+            message.token[i] = static_cast<uint8_t>(token >> ((COAP_TOKEN_LENGTH - 1U - i) * 8U));
+        }
+        message.token_length = COAP_TOKEN_LENGTH;
+    }
+    size_t const length = CoAP_Codec::Encode(message, m_send_buffer, m_send_buffer_size);
+    if (length == 0U) {
+        return COAP_ERROR_ENCODE_FAILED;
+    }
+    m_response = CoAP_Message();
+
+    // Once the request has been acknowledged with an empty acknowledgement, the response follows as a seperate message, therefore retransmitting stops,
+    // but the remaining retransmission timeouts are still waited for the seperate response
+    bool acknowledged = false;
+    uint32_t timeout = m_ack_timeout;
+    for (uint8_t attempt = 0U; attempt <= m_max_retransmit; ++attempt, timeout *= 2U) {
+        if (!acknowledged && send(m_socket, m_send_buffer, length, 0) != static_cast<ssize_t>(length)) {
+            return COAP_ERROR_SEND_FAILED;
+        }
+        uint64_t const deadline = Get_Time() + timeout;
+        for (uint64_t now = Get_Time(); now < deadline; now = Get_Time()) {
+            int const received = Receive(static_cast<uint32_t>(deadline - now));
+            CoAP_Message response;
+            if (received <= 0 || !CoAP_Codec::Decode(m_receive_buffer, received, response)) {
+                continue;
+            }
+            bool const same_id = response.message_id == message.message_id;
+            if (same_id && response.type == CoAP_Type::RESET) {
+                return COAP_ERROR_RESET;
+            }
+            else if (same_id && response.type == CoAP_Type::ACKNOWLEDGEMENT && response.code == COAP_CODE_EMPTY) {
+                acknowledged = true;
+                continue;
+            }
+            // Piggybacked responses have to match both the message id and the token, seperate responses only the token
+            bool const same_token = response.token_length == message.token_length && memcmp(response.token, message.token, message.token_length) == 0;
+            if (!same_token || response.code == COAP_CODE_EMPTY || (response.type == CoAP_Type::ACKNOWLEDGEMENT && !same_id)) {
+                Reject_Unexpected(response, received);
+                continue;
+            }
+            if (response.type == CoAP_Type::CONFIRMABLE) {
+                Send_Empty(CoAP_Type::ACKNOWLEDGEMENT, response.message_id);
+            }
+            m_response = response;
+            return 0;
+        }
+    }
+    return COAP_ERROR_TIMEOUT;
+}
+
+int Socket_CoAP_Client::Receive(uint32_t const & timeout) {
+    if (m_socket < 0 || m_receive_buffer == nullptr) {
+        return -1;
+    }
+    fd_set descriptors;
+    FD_ZERO(&descriptors);
+    FD_SET(m_socket, &descriptors);
+    timeval wait = {};
+    wait.tv_sec = timeout / 1000U;
+    wait.tv_usec = (timeout % 1000U) * 1000U;
+    if (select(m_socket + 1, &descriptors, nullptr, nullptr, &wait) <= 0) {
+        return -1;
+    }
+    ssize_t const received = recv(m_socket, m_receive_buffer, m_receive_buffer_size + 1U, 0);
+    if (received < 0) {
+        return -1;
+    }
+    // Datagrams that filled the additional byte were truncated and can not be decoded correctly
+    return (received > m_receive_buffer_size) ? 0 : static_cast<int>(received);
+}
+
+void Socket_CoAP_Client::Send_Empty(CoAP_Type const & type, uint16_t const & message_id) {
+    CoAP_Message message;
+    message.type = type;
+    message.code = COAP_CODE_EMPTY;
+    message.message_id = message_id;
+    uint8_t buffer[COAP_MAX_TOKEN_LENGTH] = {};
+    size_t const length = CoAP_Codec::Encode(message, buffer, sizeof(buffer));
+    if (length == 0U) {
+        return;
+    }
+    (void)send(m_socket, buffer, length, 0);
+}
+
+void Socket_CoAP_Client::Reject_Unexpected(CoAP_Message const & message, size_t const & length) {
+    // Acknowledgements and resets are never answered, because that could cause an endless exchange of messages
+    if (message.type == CoAP_Type::ACKNOWLEDGEMENT || message.type == CoAP_Type::RESET) {
+        return;
+    }
+    // Notifications of known observations are never reset, because a reset in reply to a notification cancels the observation on the server (RFC 7641 section 3.6).
+    // Confirmable ones are not acknowledged, so they are retransmitted, while non-confirmable ones are not retransmitted and therefore queued until the next call to loop()
+    Observation * observation = Find_Observation(message.token, message.token_length);
+    if (message.code != COAP_CODE_EMPTY && observation != nullptr) {
+        if (message.type == CoAP_Type::NON_CONFIRMABLE) {
+            Queue_Notification(*observation, message, length);
+        }
+        return;
+    }
+    // Rejecting empty confirmable messages answers CoAP pings and rejecting unknown notifications cancels observations the client does not know anymore
+    Send_Empty(CoAP_Type::RESET, message.message_id);
+}
+
+void Socket_CoAP_Client::Queue_Notification(Observation & observation, CoAP_Message const & message, size_t const & length) {
+    // Older notifications than the already queued one are dropped, they would otherwise overwrite the newer state once passed on
+    if (observation.queued != nullptr && message.has_observe && !CoAP_Codec::Is_Newer_Notification(observation.queued_sequence, message.observe)) {
+        return;
+    }
+    uint8_t * queued = new uint8_t[length]();
+    if (queued == nullptr) {
+        return;
+    }
+    memcpy(queued, m_receive_buffer, length);
+    delete[] observation.queued;
+    observation.queued = queued;
+    observation.queued_length = length;
+    observation.queued_sequence = message.observe;
+}
+
+void Socket_CoAP_Client::Handle_Notification(Observation & observation, CoAP_Message const & message) {
+    // Notifications without the Observe option or with an error code are the last notification, because the server removed the observation
+    bool const last_notification = !message.has_observe || (message.code >> 5U) != COAP_SUCCESS_CLASS;
+    if (message.has_observe) {
+        // Retransmitted or reordered notifications are skipped, they would otherwise be passed on twice or overwrite a newer notification
+        if (!CoAP_Codec::Is_Newer_Notification(observation.sequence, message.observe)) {
+            return;
+        }
+        observation.sequence = message.observe;
+    }
+    if ((message.code >> 5U) == COAP_SUCCESS_CLASS && message.payload_length > 0U) {
+        m_notification_callback.Call_Callback(observation.path, message.payload, message.payload_length);
+    }
+    if (last_notification) {
+        // The callback might have changed the observations in the meantime, therefore the entry is searched again
+        Observation * const current = Find_Observation(message.token, message.token_length);
+        if (current != nullptr) {
+            Free_Observation(*current);
+        }
+    }
+}
+
+Socket_CoAP_Client::Observation * Socket_CoAP_Client::Find_Observation(uint8_t const * token, uint8_t const & token_length) {
+    for (auto & observation : m_observations) {
+        if (observation.path != nullptr && observation.token_length == token_length && memcmp(observation.token, token, token_length) == 0) {
+            return &observation;
+        }
+    }
+    return nullptr;
+}
+
+Socket_CoAP_Client::Observation * Socket_CoAP_Client::Find_Observation(char const * path) {
+    for (auto & observation : m_observations) {
+        if ((path == nullptr && observation.path == nullptr) || (path != nullptr && observation.path != nullptr && strcmp(observation.path, path) == 0)) {
+            return &observation;
+        }
+    }
+    return nullptr;
+}
+
+void Socket_CoAP_Client::Free_Observation(Observation & observation) {
+    // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+    // and set the pointer to null so we do not have a dangling reference.
+    delete[] observation.path;
+    delete[] observation.queued;
+    observation = Observation();
+}
+
+uint64_t Socket_CoAP_Client::Get_Time() {
+    timespec now = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000U + static_cast<uint64_t>(now.tv_nsec) / 1000000U;
+}
+
+#endif // THINGSBOARD_USE_BSD_SOCKETS
@@ -0,0 +1,159 @@
+#ifndef Socket_CoAP_Client_h
+#define Socket_CoAP_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_BSD_SOCKETS
+
+// Local include.
+#include "ICoAP_Client.h"
+
+
+// Amount of resources that can be observed at once, the ThingsBoardCoap client observes at most the server-side RPC and the attributes resource.
+size_t constexpr COAP_MAX_OBSERVATIONS = 2U;
+// Default transmission parameters, see https://datatracker.ietf.org/doc/html/rfc7252#section-4.8 for more information.
+uint32_t constexpr COAP_DEFAULT_ACK_TIMEOUT = 2000U;
+uint8_t constexpr COAP_DEFAULT_MAX_RETRANSMIT = 4U;
+// Error codes returned by connect(), request() and get_block().
+int constexpr COAP_ERROR_NOT_CONNECTED = -1;
+int constexpr COAP_ERROR_RESOLVE_FAILED = -2;
+int constexpr COAP_ERROR_ENCODE_FAILED = -3;
+int constexpr COAP_ERROR_SEND_FAILED = -4;
+int constexpr COAP_ERROR_TIMEOUT = -5;
+int constexpr COAP_ERROR_RESET = -6;
+
+
+/// @brief CoAP Client interface implementation that sends and receives datagrams over a BSD UDP socket, which exists on Linux and on the ESP32 with both Arduino and Espressif IDF, because lwIP implements the same interface.
+/// The socket is connected to the server, meaning datagrams from any other sender are already discarded by the network stack. Requests are always sent as confirmable messages with a 4 byte token
+/// and retransmitted with an exponential back-off until they are acknowledged, both piggybacked responses and seperate responses that follow an empty acknowledgement are supported.
+/// Only one request is sent at a time, which is the same restriction the default transmission parameters of CoAP (NSTART = 1) impose anyway
+class Socket_CoAP_Client : public ICoAP_Client {
+  public:
+    /// @brief Constructor
+    Socket_CoAP_Client();
+
+    /// @brief Destructor
+    ~Socket_CoAP_Client();
+
+    /// @brief Sets the parameters requests are retransmitted with, the first retransmission is sent after the given timeout and every following one after double the previous timeout.
+    /// Has to be configured the same as the server for the duplicate detection to work, therefore the default values of CoAP should only be changed if the server has been configured accordingly
+    /// @param ack_timeout Time in milliseconds until the first retransmission, default = COAP_DEFAULT_ACK_TIMEOUT (2000)
+    /// @param max_retransmit Maximum amount of retransmissions until a request fails, default = COAP_DEFAULT_MAX_RETRANSMIT (4)
+    void set_transmission_parameters(uint32_t ack_timeout, uint8_t max_retransmit);
+
+    void set_notification_callback(Callback<void, char const *, uint8_t *, unsigned int>::function callback) override;
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override;
+
+    uint16_t get_receive_buffer_size() override;
+
+    uint16_t get_send_buffer_size() override;
+
+    int connect(char const * host, uint16_t port) override;
+
+    void stop() override;
+
+    bool connected() override;
+
+    int request(CoAP_Method const & method, char const * path, uint8_t const * payload, size_t const & length) override;
+
+    int get_block(char const * path, size_t const & block_number, uint16_t const & block_size) override;
+
+    int get_response_code() override;
+
+    uint8_t * get_response_payload() override;
+
+    size_t get_response_length() override;
+
+    bool observe(char const * path) override;
+
+    bool cancel_observe(char const * path) override;
+
+    bool loop() override;
+
+    int get_readiness_handle() override;
+
+  private:
+    /// @brief Resource that is currently observed
+    struct Observation {
+        char     *path = {};                         // Path the observation was registered with, nullptr if the entry is unused
+        uint8_t  token[COAP_MAX_TOKEN_LENGTH] = {};  // Token the notifications are matched with
+        uint8_t  token_length = {};                  // Amount of used bytes of the token
+        uint32_t sequence = {};                      // Sequence number of the last received notification
+        uint8_t  *queued = {};                       // Copy of the last non-confirmable notification received while waiting for a response, nullptr if none is queued
+        size_t   queued_length = {};                 // Length of the queued notification
+        uint32_t queued_sequence = {};               // Sequence number of the queued notification
+    };
+
+    /// @brief Sends the given request as a confirmable message and waits until the matching response has been received,
+    /// generates a new token if the given message does not contain one already, the received response is kept in m_response
+    /// @param message Request that should be sent, the type, the message id and if required the token are set by this method
+    /// @return 0 if a response was received or the internal error code otherwise
+    int Exchange(CoAP_Message & message);
+
+    /// @brief Waits at most the given time until a datagram has been received and reads it into the receive buffer
+    /// @param timeout Maximum time in milliseconds to wait for, 0 to only read already received datagrams
+    /// @return Length of the received datagram, 0 if a datagram was received but had to be discarded, because it was bigger than the receive buffer, or -1 if no datagram was received
+    int Receive(uint32_t const & timeout);
+
+    /// @brief Sends an empty message to reject or acknowledge a received confirmable message
+    /// @param type Either CoAP_Type::ACKNOWLEDGEMENT or CoAP_Type::RESET
+    /// @param message_id Id of the message that should be acknowledged or rejected
+    void Send_Empty(CoAP_Type const & type, uint16_t const & message_id);
+
+    /// @brief Handles a received message that does not belong to the currently sent request, notifications of an observed resource are never rejected, because that would cancel the observation.
+    /// Confirmable notifications are not acknowledged, so the server retransmits them and they can be passed on in the next call to loop(), non-confirmable notifications are queued instead.
+    /// Every other message, including notifications with an unknown token, is rejected with a reset
+    /// @param message Received message that does not belong to the sent request
+    /// @param length Length of the received datagram the message has been decoded from, which is still contained in the receive buffer
+    void Reject_Unexpected(CoAP_Message const & message, size_t const & length);
+
+    /// @brief Copies the received datagram of a non-confirmable notification, so that it is passed on in the next call to loop(), because the server does not retransmit it.
+    /// Only the newest notification per observation is kept, because every notification contains the complete current state of the resource
+    /// @param observation Observation the notification belongs to
+    /// @param message Received notification
+    /// @param length Length of the received datagram the notification has been decoded from, which is still contained in the receive buffer
+    void Queue_Notification(Observation & observation, CoAP_Message const & message, size_t const & length);
+
+    /// @brief Passes the payload of the given notification to the notification callback, if it is newer than the last one and removes the observation if it was the last notification
+    /// @param observation Observation the notification belongs to
+    /// @param message Received notification
+    void Handle_Notification(Observation & observation, CoAP_Message const & message);
+
+    /// @brief Gets the observation with the given token
+    /// @param token Token of the received notification
+    /// @param token_length Length of the given token
+    /// @return Matching observation or nullptr if the token does not belong to any observation
+    Observation * Find_Observation(uint8_t const * token, uint8_t const & token_length);
+
+    /// @brief Gets the observation registered with the given path
+    /// @param path Path of the resource, nullptr to get an unused entry instead
+    /// @return Matching observation or nullptr if the given resource is not observed
+    Observation * Find_Observation(char const * path);
+
+    /// @brief Frees the copied path and the queued notification of the given observation, which marks the entry as unused
+    /// @param observation Observation that should be freed
+    void Free_Observation(Observation & observation);
+
+    /// @brief Gets the current time of the monotonic clock
+    /// @return Current time in milliseconds
+    static uint64_t Get_Time();
+
+    Callback<void, char const *, uint8_t *, unsigned int> m_notification_callback = {};            // Callback that is called for every received notification
+    int                                                   m_socket = {};                           // Connected UDP socket, -1 if the client is not connected
+    uint8_t                                               *m_receive_buffer = {};                  // Buffer received datagrams are read into, one byte bigger than the configured size to detect truncated datagrams
+    uint16_t                                              m_receive_buffer_size = {};              // Maximum size of a single received datagram
+    uint8_t                                               *m_send_buffer = {};                     // Buffer sent datagrams are encoded into
+    uint16_t                                              m_send_buffer_size = {};                 // Maximum size of a single sent datagram
+    uint32_t                                              m_ack_timeout = {};                      // Time in milliseconds until the first retransmission of a request
+    uint8_t                                               m_max_retransmit = {};                   // Maximum amount of retransmissions of a request
+    uint16_t                                              m_message_id = {};                       // Id of the next sent message
+    uint32_t                                              m_token = {};                            // Value of the next generated token
+    CoAP_Message                                          m_response = {};                         // Last received response, the payload points into the receive buffer
+    Observation                                           m_observations[COAP_MAX_OBSERVATIONS] = {}; // Currently observed resources
+};
+
+#endif // THINGSBOARD_USE_BSD_SOCKETS
+
+#endif // Socket_CoAP_Client_h
@@ -1,30 +1,122 @@
 // Header include.
 #include "Telemetry.h"
 
+// Library includes.
+#include <string.h>
+
 Telemetry::Telemetry()
   : m_type(DataType::TYPE_NONE)
-  , m_key(nullptr)
+  , m_interned(false)
+  , m_key()
   , m_value()
 {
-    // Nothing to do
+    m_key.str = nullptr;
 }
 
 Telemetry::Telemetry(char const * key, bool value)
   : m_type(DataType::TYPE_BOOL)
-  , m_key(key)
+  , m_interned(false)
+  , m_key()
   , m_value()
 {
+    m_key.str = key;
     m_value.boolean = value;
 }
 
 Telemetry::Telemetry(char const * key, char const * value)
   : m_type(DataType::TYPE_STR)
-  , m_key(key)
+  , m_interned(false)
+  , m_key()
   , m_value()
 {
+    m_key.str = key;
     m_value.str = value;
 }
 
 bool Telemetry::IsEmpty() const {
-    return (m_key == nullptr) && m_type == DataType::TYPE_NONE;
+    return (Get_Key() == nullptr) && m_type == DataType::TYPE_NONE;
+}
+
+bool Telemetry::Is_Interned() const {
+    return m_interned;
+}
+
+size_t Telemetry::Serialize_Member(char * buffer, size_t const & buffer_size) const {
+    char const * key = Get_Key();
+    if (key == nullptr || m_type == DataType::TYPE_NONE) {
+        return 0U;
+    }
+
+    size_t length = 0U;
+    if (m_interned) {
+        Telemetry_Key const & interned = *m_key.interned;
+        if (interned.length >= buffer_size) {
+            return 0U;
+        }
+        memcpy(buffer, interned.fragment, interned.length);
+        length = interned.length;
+    }
+    else {
+        // Setting a const char pointer does not copy the string into the document, therefore no additional capacity is required
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> key_scratch;
+        (void)key_scratch.set(key);
+        // Key and the following colon still have to fit, while keeping space for the null terminator
+        if (measureJson(key_scratch) + 1U >= buffer_size) {
+            return 0U;
+        }
+        length = serializeJson(key_scratch, buffer, buffer_size);
+        buffer[length++] = ':';
+    }
+
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> value_scratch;
+    Copy_Value(value_scratch);
+    if (measureJson(value_scratch) >= buffer_size - length) {
+        return 0U;
+    }
+    return length + serializeJson(value_scratch, buffer + length, buffer_size - length);
+}
+
+size_t Telemetry::Measure_Member() const {
+    char const * key = Get_Key();
+    if (key == nullptr || m_type == DataType::TYPE_NONE) {
+        return 0U;
+    }
+
+    // Key and the following colon, interned keys already contain both in their serialized fragment
+    size_t length = 0U;
+    if (m_interned) {
+        length = m_key.interned->length;
+    }
+    else {
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> key_scratch;
+        (void)key_scratch.set(key);
+        length = measureJson(key_scratch) + 1U;
+    }
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> value_scratch;
+    Copy_Value(value_scratch);
+    return length + measureJson(value_scratch);
+}
+
+char const * Telemetry::Get_Key() const {
+    return m_interned ? m_key.interned->key : m_key.str;
+}
+
+void Telemetry::Copy_Value(JsonDocument & document) const {
+    switch (m_type) {
+        case DataType::TYPE_BOOL:
+            (void)document.set(m_value.boolean);
+            break;
+        case DataType::TYPE_INT:
+            (void)document.set(m_value.integer);
+            break;
+        case DataType::TYPE_REAL:
+            (void)document.set(m_value.real);
+            break;
+        case DataType::TYPE_STR:
+            (void)document.set(m_value.str);
+            break;
+        default:
+            // Nothing to do
+            break;
+    }
 }
@@ -11,6 +11,24 @@
 #endif // THINGSBOARD_ENABLE_STL
 
 
+/// @brief Telemetry key that is declared once and then referenced by any amount of telemetry records, instead of passing the key string itself.
+/// Contains the key already serialized as a json object member name, including its quotes and the following colon, which allows to copy it directly into the outgoing message,
+/// instead of escaping the key again everytime a record is serialized. Should be declared with the TELEMETRY_KEY macro as a constexpr table, which ensures the instances live on for as long as they are referenced by any telemetry record.
+/// On targets with a unified address space like the ESP32 the table and both strings are placed into flash, on AVR and ESP8266 they are still copied into RAM, because they are not declared with PROGMEM.
+/// Placing them into PROGMEM would require reading the fragment with memcpy_P and passing the key to ArduinoJson as a __FlashStringHelper, which copies it into the JsonDocument for every mixed message instead of referencing it.
+/// Interning does not change the size of a Telemetry record either, it only removes escaping the key for every serialized record.
+/// Has no default member initializers on purpose, to stay an aggregate that can be initalized as a constant expression in C++11
+struct Telemetry_Key {
+    char const *key;      // Null-terminated key, used if the record is serialized into a JsonDocument instead
+    char const *fragment; // Key serialized as a json object member name ("key":), not null-terminated when copied
+    uint8_t    length;    // Length of the serialized key fragment
+};
+
+/// @brief Declares a Telemetry_Key from the given string literal, the serialized fragment is concatenated at compile time.
+/// The key is not escaped, therefore it must not contain any quotes, backslashes or control characters, which is the case for any usual ThingsBoard key
+#define TELEMETRY_KEY(key) Telemetry_Key{key, "\"" key "\":", sizeof("\"" key "\":") - 1U}
+
+
 /// @brief Telemetry record class, allows to store different data using a common interface,
 /// is used to allow to easily create a key-value pair of multiple different types that can then be deserialized into a json message
 class Telemetry {
@@ -33,9 +51,11 @@ class Telemetry {
 #endif // THINGSBOARD_ENABLE_STL
     Telemetry(char const * key, T const & value)
       : m_type(DataType::TYPE_INT)
-      , m_key(key)
+      , m_interned(false)
+      , m_key()
       , m_value()
     {
+        m_key.str = key;
         m_value.integer = value;
     }
 
@@ -54,9 +74,11 @@ class Telemetry {
 #endif // THINGSBOARD_ENABLE_STL
     Telemetry(char const * key, T const & value)
       : m_type(DataType::TYPE_REAL)
-      , m_key(key)
+      , m_interned(false)
+      , m_key()
       , m_value()
     {
+        m_key.str = key;
         m_value.real = value;
     }
 
@@ -70,39 +92,69 @@ class Telemetry {
     /// @param value Value of the key value pair we want to create
     Telemetry(char const * key, char const * value);
 
+    /// @brief Constructs telemetry record with an interned key, that is copied as its already serialized fragment instead of being escaped again,
+    /// if all records that are sent together use an interned key
+    /// @tparam T Type of the passed value, supports the same types as the constructors with a key string
+    /// @param key Interned key of the key value pair we want to create, is not copied and has to stay valid for as long as this record, see TELEMETRY_KEY
+    /// @param value Value of the key value pair we want to create
+    template <typename T>
+    Telemetry(Telemetry_Key const & key, T const & value)
+      : Telemetry(key.key, value)
+    {
+        m_interned = true;
+        m_key.interned = &key;
+    }
+
     /// @brief Whether this record is empty or not
     /// @return Whether there is any data in this record or not
     bool IsEmpty() const;
 
+    /// @brief Whether this record was constructed with an interned key
+    /// @return Whether the key is a Telemetry_Key or not
+    bool Is_Interned() const;
+
+    /// @brief Writes the key-value pair directly into the given buffer as a serialized json object member ("key":value), without the surrounding brackets.
+    /// The key is copied as its already serialized fragment if it is interned and the value is serialized with ArduinoJson, to keep the same formatting as SerializeKeyValue()
+    /// @param buffer Buffer the serialized key-value pair should be written into, the written content is null-terminated
+    /// @param buffer_size Size of the remaining buffer, has to leave space for the null terminator
+    /// @return Amount of written bytes excluding the null terminator or 0 if the record has no key or the key-value pair did not fit into the given buffer
+    size_t Serialize_Member(char * buffer, size_t const & buffer_size) const;
+
+    /// @brief Calculates the length of the key-value pair serialized as a json object member ("key":value), without the surrounding brackets or seperating commas.
+    /// Allows to partition multiple records into payloads that fit into a given buffer, without having to serialize them first
+    /// @return Amount of bytes the serialized key-value pair requires excluding the null terminator or 0 if the record has no key
+    size_t Measure_Member() const;
+
     /// @brief Serializes a key-value pair or a value, depending on the constructor used
     /// @tparam TSource Source class that the given key value pair or a value, should be copied into
     /// @param source Data source that should contain the key value pair or a value
     /// @return Whether serializing was successful or not
     template <typename TSource>
     bool SerializeKeyValue(TSource & source) const {
+        char const * key = Get_Key();
         switch (m_type) {
             case DataType::TYPE_BOOL:
-                if (m_key) {
-                    source[m_key] = m_value.boolean;
-                    return source.containsKey(m_key);
+                if (key) {
+                    source[key] = m_value.boolean;
+                    return source.containsKey(key);
                 }
                 return source.set(m_value.boolean);
             case DataType::TYPE_INT:
-                if (m_key) {
-                    source[m_key] = m_value.integer;
-                    return source.containsKey(m_key);
+                if (key) {
+                    source[key] = m_value.integer;
+                    return source.containsKey(key);
                 }
                 return source.set(m_value.integer);
             case DataType::TYPE_REAL:
-                if (m_key) {
-                    source[m_key] = m_value.real;
-                    return source.containsKey(m_key);
+                if (key) {
+                    source[key] = m_value.real;
+                    return source.containsKey(key);
                 }
                 return source.set(m_value.real);
             case DataType::TYPE_STR:
-                if (m_key) {
-                    source[m_key] = m_value.str;
-                    return source.containsKey(m_key);
+                if (key) {
+                    source[key] = m_value.str;
+                    return source.containsKey(key);
                 }
                 return source.set(m_value.str);
             default:
@@ -113,6 +165,20 @@ class Telemetry {
     }
 
   private:
+    /// @brief Key container, which contains either the passed key string or the passed interned key
+    union Key {
+        char const          *str;
+        Telemetry_Key const *interned;
+    };
+
+    /// @brief Gets the null-terminated key of this record, regardless of wheter it was passed as an interned key or not
+    /// @return Key of the key-value pair or nullptr if this record only contains a value
+    char const * Get_Key() const;
+
+    /// @brief Copies the value of this record into the given document, strings are only referenced and do therefore not require any additional capacity
+    /// @param document Document the value should be copied into
+    void Copy_Value(JsonDocument & document) const;
+
     /// @brief Data container, which contains one of the possibly passed values
     union Data {
         const char  *str;
@@ -130,11 +196,15 @@ class Telemetry {
         TYPE_STR ///< Telemetry isntance is a key value-pair with a string value
     };
 
-    DataType     m_type = {};  // Data type flag, showing which value is saved in the class instance
-    const char   *m_key = {};  // Data key of the key-value pair
-    Data         m_value = {}; // Data value of the key-value pair
+    DataType     m_type = {};     // Data type flag, showing which value is saved in the class instance
+    bool         m_interned = {}; // Whether the key is an interned key
+    Key          m_key = {};      // Data key of the key-value pair
+    Data         m_value = {};    // Data value of the key-value pair
 };
 
+// Type flag and interned flag share the padding in front of the key pointer, which keeps a record at 16 bytes on 32-bit targets and at 24 bytes on 64-bit hosts.
+static_assert(sizeof(Telemetry) <= ((sizeof(void *) > 4U) ? 24U : 16U), "Telemetry record grew beyond the type flags, the key pointer and the 8 byte value");
+
 /// @brief Telemetry and attributes are only different on the database side (one has a history the other one does not), but both are simply key-value pairs
 using Attribute = Telemetry;
 
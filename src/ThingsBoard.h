@@ -7,6 +7,8 @@
 #include "IMQTT_Client.h"
 #include "DefaultLogger.h"
 #include "Telemetry.h"
+#include "Send_Scheduler.h"
+#include "Recursive_Mutex.h"
 
 // Library includes.
 #if THINGSBOARD_ENABLE_STREAM_UTILS
@@ -15,12 +17,19 @@
 
 
 uint16_t constexpr DEFAULT_MQTT_PORT = 1883U;
+// Amount of topics passed to the client to be sent with a topic alias, the telemetry and the attribute topic.
+size_t constexpr ALIASED_TOPICS_AMOUNT = 2U;
 char constexpr PROV_ACCESS_TOKEN[] = "provision";
 // Log messages.
 char constexpr UNABLE_TO_DE_SERIALIZE_JSON[] = "Unable to de-serialize received json data with error (DeserializationError::%s)";
 char constexpr INVALID_BUFFER_SIZE[] = "Send buffer size (%u) to small for the given payloads size (%u), increase with setBufferSize accordingly or install the StreamUtils library";
 char constexpr UNABLE_TO_ALLOCATE_BUFFER[] = "Allocating memory for the internal MQTT buffer failed";
+char constexpr UNABLE_TO_ALLOCATE_SEND_BUFFER[] = "Failed allocating required size (%u) for the send buffer. Ensure there is enough heap memory left";
 char constexpr MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME[] = "MaxEndpointsAmount";
+char constexpr SUBSCRIBE_TOPICS_FAILED[] = "Failed to subscribe (%u) topics in one batch";
+#if !THINGSBOARD_ENABLE_STREAM_UTILS
+char constexpr INVALID_MEMBER_SIZE[] = "Send buffer size (%u) to small for a single key-value pair of size (%u), skipping it while splitting the payload, increase with setBufferSize accordingly";
+#endif // !THINGSBOARD_ENABLE_STREAM_UTILS
 #if THINGSBOARD_ENABLE_DYNAMIC
 char constexpr MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (%u) for JsonDocument. Discarding message that is bigger than maximum response size (%u)";
 char constexpr HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
@@ -30,12 +39,20 @@ char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over
 char constexpr ALLOCATING_JSON[] = "Allocated internal JsonDocument for MQTT server response with size (%u)";
 char constexpr SEND_MESSAGE[] = "Sending data to server over topic (%s) with data (%s)";
 char constexpr SEND_SERIALIZED[] = "Hidden, because json data is bigger than buffer, therefore showing in console is skipped";
+char constexpr SESSION_PRESENT_SKIPPING_RESUBSCRIBE[] = "Broker still holds the previous session, skipping resubscribing topics";
+#if !THINGSBOARD_ENABLE_STREAM_UTILS
+char constexpr SPLITTING_PAYLOAD[] = "Splitting payload after (%u) key-value pairs, because it is bigger than the send buffer size (%u)";
+#endif // !THINGSBOARD_ENABLE_STREAM_UTILS
 #endif // THINGSBOARD_ENABLE_DEBUG
-// Claim topics.
-char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
 // Claim data keys.
 char constexpr SECRET_KEY[] = "secretKey";
 char constexpr DURATION_KEY[] = "durationMs";
+// Timestamped telemetry keys, the key-value pairs are wrapped into the values of an object that additionally contains the timestamp ({"ts":1451649600512,"values":{"key":1}}).
+char constexpr TELEMETRY_TIMESTAMP_KEY[] = "ts";
+char constexpr TELEMETRY_VALUES_KEY[] = "values";
+char constexpr TIMESTAMPED_TELEMETRY_PREFIX[] = "{\"ts\":%llu,\"values\":";
+// Maximum size of the fixed header (5 bytes) and the length of the topic (2 bytes) of a PUBLISH packet, which have to fit into the send buffer of the client together with the topic and the payload.
+size_t constexpr MQTT_PUBLISH_OVERHEAD = 7U;
 
 
 #if THINGSBOARD_ENABLE_DYNAMIC
@@ -110,7 +127,14 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #endif // THINGSBOARD_ENABLE_DYNAMIC
       : m_client(client)
+      , m_priority_lanes(client)
+      , m_rate_limiter(m_priority_lanes)
+      , m_send_scheduler(m_rate_limiter)
+      , m_send_urgency(Send_Urgency::IMMEDIATE)
+      , m_topic_profile(&DEFAULT_TOPIC_PROFILE)
       , m_max_stack(max_stack_size)
+      , m_send_buffer(nullptr)
+      , m_send_buffer_size(0U)
 #if THINGSBOARD_ENABLE_STREAM_UTILS
       , m_buffering_size(buffering_size)
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
@@ -128,6 +152,7 @@ class ThingsBoardSized {
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+            api->Set_Topic_Profile(*m_topic_profile);
             api->Initialize();
         }
         (void)setBufferSize(receive_buffer_size, send_buffer_size);
@@ -135,11 +160,28 @@ class ThingsBoardSized {
 #if THINGSBOARD_ENABLE_STL
         m_client.set_data_callback(std::bind(&ThingsBoardSized::onMQTTMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         m_client.set_connect_callback(std::bind(&ThingsBoardSized::Resubscribe_Topics, this));
+        m_stream_supported = m_client.set_stream_callback(std::bind(&ThingsBoardSized::onMQTTStreamFilter, this, std::placeholders::_1), std::bind(&ThingsBoardSized::onMQTTStream, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
 #else
         m_client.set_data_callback(ThingsBoardSized::onStaticMQTTMessage);
         m_client.set_connect_callback(ThingsBoardSized::staticMQTTConnect);
+        m_stream_supported = m_client.set_stream_callback(ThingsBoardSized::onStaticMQTTStreamFilter, ThingsBoardSized::onStaticMQTTStream);
         m_subscribedInstance = this;
 #endif // THINGSBOARD_ENABLE_STL
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            api->Set_Stream_Supported(m_stream_supported);
+        }
+        Register_Topic_Aliases();
+    }
+
+    /// @brief Destructor
+    ~ThingsBoardSized() {
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] m_send_buffer;
+        m_send_buffer = nullptr;
     }
 
     /// @brief Gets the currently connected MQTT Client implementation as a reference.
@@ -151,7 +193,100 @@ class ThingsBoardSized {
         return m_client;
     }
 
-    /// @brief Sets the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
+    /// @brief Sets the topics used to communicate with the device API of the server, for all API implementations and the messages sent by the client itself.
+    /// The short topics of SHORT_TOPIC_PROFILE reduce the overhead of every message by a lot, for example the telemetry topic shrinks from 23 to 4 bytes, which for small payloads can halve the amount of sent bytes.
+    /// This matters especially for devices with expensive or slow connections like NB-IoT, where every sent byte costs airtime and battery. Additionally the telemetry and attribute topics are passed to the underlying client,
+    /// which can send them with a topic alias instead, if it is connected with MQTT 5, see IMQTT_Client::set_topic_aliases() for more information.
+    /// Has to be called before connecting or subscribing any API calls, because topics that have already been subscribed with the previous profile are not unsubscribed
+    /// @param profile Topics that should be used, has to be kept alive for as long as the instance of this class, default = DEFAULT_TOPIC_PROFILE
+    void setTopicProfile(Topic_Profile const & profile) {
+        m_topic_profile = &profile;
+        {
+            Recursive_Mutex_Lock lock(m_send_mutex);
+            m_priority_lanes.Set_Topic_Profile(profile);
+            m_rate_limiter.Set_Topic_Profile(profile);
+        }
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            api->Set_Topic_Profile(profile);
+        }
+        Register_Topic_Aliases();
+    }
+
+    /// @brief Sets the rate limits outgoing messages of the given type have to comply with, should be the same as the device rate limits configured in the tenant profile on the ThingsBoard server,
+    /// because ThingsBoard disconnects devices that exceed them. Messages exceeding the limits are queued and sent once loop() is called and the limits allow it again.
+    /// See https://thingsboard.io/docs/user-guide/tenant-profiles/#rate-limits for more information on the syntax and the limits configured on the server
+    /// @param type Type of the messages the rate limits should be applied to
+    /// @param limits Comma seperated list of windows with the ThingsBoard rate limit syntax ("N:seconds,N:seconds"), nullptr or an empty string disables rate limiting for the given type
+    /// @return Whether the given limits could be parsed successfully or not
+    bool setRateLimits(Rate_Limit_Type const & type, char const * limits) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        return m_rate_limiter.Set_Limits(type, limits);
+    }
+
+    /// @brief Sets the amount of bytes the outbox of the underlying MQTT client may contain, before lower priority messages are held back in the priority lane of their Traffic_Class.
+    /// Only has an effect for clients that enqueue published messages into an outbox that is sent in order by another task, like the Espressif_MQTT_Client with set_enqueue_messages() enabled,
+    /// where it ensures RPC responses and firmware chunk requests are not enqueued behind a long backlog of telemetry. Held back messages are passed on once loop() is called and the outbox has been drained again
+    /// @param limit Amount of bytes, should be a few times the size of the biggest message that is sent, 0 disables holding back messages, default = 0
+    void setOutboxLimit(size_t const & limit) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        m_priority_lanes.Set_Outbox_Limit(limit);
+    }
+
+    /// @brief Sets the order the messages held back in the priority lanes are passed on to the underlying MQTT client in, once its outbox has been drained again
+    /// @param mode Mode that should be used, Lane_Drain_Mode::WEIGHTED ensures telemetry is still sent while a firmware update continously requests chunks, default = Lane_Drain_Mode::STRICT_PRIORITY
+    void setLaneDrainMode(Lane_Drain_Mode const & mode) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        m_priority_lanes.Set_Drain_Mode(mode);
+    }
+
+    /// @brief Sets the amount of messages the priority lane of the given Traffic_Class can pass on per round, only used with Lane_Drain_Mode::WEIGHTED
+    /// @param traffic_class Class of the lane the weight should be configured for
+    /// @param weight Amount of messages per round, has to be at least 1, default see DEFAULT_LANE_WEIGHTS
+    /// @return Whether the weight could be set or not
+    bool setLaneWeight(Traffic_Class const & traffic_class, uint8_t const & weight) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        return m_priority_lanes.Set_Weight(traffic_class, weight);
+    }
+
+    /// @brief Sets the period send windows are opened with, telemetry and attributes that are not sent with Send_Urgency::IMMEDIATE are held back and sent together in the next send window,
+    /// which reduces the amount of times the radio of battery powered cellular devices has to wake up. Held messages are additionally sent as soon as any other message is sent or received.
+    /// Should be the same as the keep alive interval of the underlying MQTT client, because the radio has to wake up to send the keep alive message anyway
+    /// @param period Period in milliseconds, 0 disables holding back messages, default = 0
+    void setSendPeriod(uint32_t const & period) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        m_send_scheduler.Set_Period(period);
+    }
+
+    /// @brief Sets the maximum amount of time telemetry and attributes with the given urgency are held back, before they are sent even if no send window has been opened yet
+    /// @param urgency Urgency the maximum latency should be configured for
+    /// @param latency Maximum latency in milliseconds
+    /// @return Whether the maximum latency could be set for the given urgency or not, fails for Send_Urgency::IMMEDIATE
+    bool setMaximumSendLatency(Send_Urgency const & urgency, uint32_t const & latency) {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        return m_send_scheduler.Set_Maximum_Latency(urgency, latency);
+    }
+
+    /// @brief Sets the urgency all following telemetry and attribute messages are sent with, until it is changed again. Only has an effect if a send period has been configured with setSendPeriod()
+    /// @param urgency Urgency the following messages should be sent with, default = Send_Urgency::IMMEDIATE
+    /// @return Urgency the messages were sent with before, allows to restore it after sending a single message with a different urgency
+    Send_Urgency setSendUrgency(Send_Urgency const & urgency) {
+        Send_Urgency const previous = m_send_urgency;
+        m_send_urgency = urgency;
+        return previous;
+    }
+
+    /// @brief Sends all telemetry and attribute messages that are currently held back directly, instead of waiting for the next send window
+    /// @return Whether all held messages could be sent or not
+    bool flushHeldMessages() {
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        return m_send_scheduler.Flush();
+    }
+
+    /// @brief Sets the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead.
+    /// Outgoing messages are serialized into a reusable send buffer instead, that is allocated once and then kept, therefore the value is currently not used by any internal method
     /// @param max_stack_size Maximum amount of bytes we want to allocate on the stack
     void setMaximumStackSize(size_t const & max_stack_size) {
         m_max_stack = max_stack_size;
@@ -247,27 +382,74 @@ class ThingsBoardSized {
         return m_client.connected();
     }
 
-    /// @brief Receives / sends any outstanding messages from and to the MQTT broker.
-    /// Additionally when not being able to use the ESP Timer, it updates the internal timeout timers
+    /// @brief Receives / sends any outstanding messages from and to the MQTT broker, including messages that were queued because they exceeded the configured rate limits or the outbox limit.
+    /// Additionally it continues the work of the API implementations, like serving cached firmware, and when not being able to use the ESP Timer, it updates the internal timeout timers
     /// @return Whether sending or receiving the oustanding the messages was successful or not
     bool loop() {
-#if !THINGSBOARD_USE_ESP_TIMER
+        {
+            // Queued messages are only passed on while holding the send mutex, because the client task might enqueue new messages at the same time
+            Recursive_Mutex_Lock lock(m_send_mutex);
+            m_send_scheduler.loop();
+            m_rate_limiter.loop();
+            m_priority_lanes.loop();
+        }
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
             api->loop();
         }
-#endif // !THINGSBOARD_USE_ESP_TIMER
         return m_client.loop();
     }
 
+    /// @brief Calculates how long it takes until loop() has to be called again at the latest, which allows to integrate the client into an event loop that sleeps or blocks on the network
+    /// instead of calling loop() continously. Includes the deadline of the underlying MQTT client, of any message held back by the send scheduler, queued by the rate limiter or held back in a priority lane
+    /// of the next chunk of cached firmware and if the ESP Timer is not used, of any timeout timer of ongoing requests (attribute requests, client-side RPC, provisioning and firmware chunks).
+    /// Received messages are handled directly by the MQTT client, therefore loop() should additionally be called as soon as the handle returned by getReadinessHandle() becomes readable
+    /// @return Amount of milliseconds until loop() has to be called again, 0 if it has to be called immediately and UINT32_MAX if nothing is pending
+    uint32_t getNextDeadline() {
+        uint32_t deadline = m_client.get_next_deadline();
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        uint32_t const scheduler_deadline = m_send_scheduler.Get_Next_Deadline();
+        if (scheduler_deadline < deadline) {
+            deadline = scheduler_deadline;
+        }
+        uint32_t const rate_limit_deadline = m_rate_limiter.Get_Next_Deadline();
+        if (rate_limit_deadline < deadline) {
+            deadline = rate_limit_deadline;
+        }
+        uint32_t const priority_lane_deadline = m_priority_lanes.Get_Next_Deadline();
+        if (priority_lane_deadline < deadline) {
+            deadline = priority_lane_deadline;
+        }
+        for (auto const & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            uint32_t const api_deadline = api->Get_Next_Deadline();
+            if (api_deadline < deadline) {
+                deadline = api_deadline;
+            }
+        }
+        return deadline;
+    }
+
+    /// @brief Gets the handle of the underlying network connection, which becomes readable as soon as a message has been received and loop() should be called.
+    /// Allows to wait with select() or poll() on the handle together with any other handles of the application, with the result of getNextDeadline() as the timeout
+    /// @return File descriptor of the underlying socket or -1 if the used MQTT client does not expose one, in which case only the deadline can be used
+    int getReadinessHandle() {
+        return m_client.get_readiness_handle();
+    }
+
     /// @brief Attempts to send key value pairs from custom source over the given topic to the server
     /// @param topic Topic we want to send the data over
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
-    /// @param json_size Size of the data inside the source
+    /// @param json_size Size of the data inside the source including the null terminator, only used as the minimum initial size of the reusable send buffer
+    /// and not required to be exact, because the json is serialized only once and the buffer grows if required, 0 if the size is unknown
     /// @return Whether sending the data was successful or not
+    /// @note Thread-safe, the reusable send buffer is locked from serializing the json until it has been published, because for example server-side RPC responses are sent from the task of the Espressif_MQTT_Client,
+    /// while the user task might send telemetry at the same time. Requires FreeRTOS (THINGSBOARD_USE_FREERTOS), on every other platform all messages have to be sent from the same task
     bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
         // Check if allocating needed memory failed when trying to create the JsonDocument,
         // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
@@ -281,44 +463,38 @@ class ThingsBoardSized {
             Logger::printfln(JSON_SIZE_TO_SMALL);
             return false;
         }
-        bool result = false;
 
-#if THINGSBOARD_ENABLE_STREAM_UTILS
-        // Check if the size of the given message would be too big for the actual client,
-        // if it is utilize the serialize json work around, so that the internal client buffer can be circumvented
-        if (m_client.get_buffer_size() < json_size)  {
-#if THINGSBOARD_ENABLE_DEBUG
-            Logger::printfln(SEND_MESSAGE, topic, SEND_SERIALIZED);
-#endif // THINGSBOARD_ENABLE_DEBUG
-            result = Serialize_Json(topic, source, json_size - 1);
-        }
-        // Check if the remaining stack size of the current task would overflow the stack,
-        // if it would allocate the memory on the heap instead to ensure no stack overflow occurs
-        else
-#endif // THINGSBOARD_ENABLE_STREAM_UTILS
-        if (json_size > getMaximumStackSize()) {
-            char* json = new char[json_size]();
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        // Payload that fills the complete client buffer, the null terminator and one additional byte,
+        // because only a serialization that leaves at least one byte of the buffer unused is guaranteed to not have been truncated
+        size_t const maximum_size = m_client.get_send_buffer_size() + 2U;
+        size_t required_size = json_size;
+        while (true) {
+            if (!Reserve_Send_Buffer(required_size, maximum_size)) {
+                return false;
             }
-            else {
-                result = Send_Json_String(topic, json);
+            // Serializes directly into the reusable send buffer once and uses the returned length, instead of measuring the json and calculating the length of the serialized string beforehand
+            size_t const length = serializeJson(source, m_send_buffer, m_send_buffer_size);
+            if (length < m_send_buffer_size - 1U) {
+                return Publish_Json(topic, m_send_buffer, length);
             }
-            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
-            // and set the pointer to null so we do not have a dangling reference.
-            delete[] json;
-            json = nullptr;
-        }
-        else {
-            char json[json_size] = {};
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
-                return result;
+            else if (m_send_buffer_size >= maximum_size) {
+                break;
             }
-            result = Send_Json_String(topic, json);
+            required_size = m_send_buffer_size * 2U;
         }
 
-        return result;
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+        // The json is too big for the internal client buffer, therefore utilize the serialize json work around, so that the internal client buffer can be circumvented.
+        // Only this work around requires measuring the json beforehand, because the length of the MQTT message has to be sent before the payload itself
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_MESSAGE, topic, SEND_SERIALIZED);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return Serialize_Json(topic, source, measureJson(source));
+#else
+        Logger::printfln(INVALID_BUFFER_SIZE, m_client.get_send_buffer_size(), measureJson(source));
+        return false;
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
     }
 
     /// @brief Attempts to send custom json string over the given topic to the server
@@ -329,19 +505,8 @@ class ThingsBoardSized {
         if (json == nullptr) {
             return false;
         }
-
-        uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
-        size_t const json_size = strlen(json);
-
-        if (current_send_buffer_size < json_size) {
-            Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, json_size);
-            return false;
-        }
-
-#if THINGSBOARD_ENABLE_DEBUG
-        Logger::printfln(SEND_MESSAGE, topic, json);
-#endif // THINGSBOARD_ENABLE_DEBUG
-        return m_client.publish(topic, reinterpret_cast<uint8_t const *>(json), json_size);
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        return Publish_Json(topic, json, strlen(json));
     }
 
     /// @brief Copies a non-owning pointer to the given API implementation, into the local data container.
@@ -359,6 +524,8 @@ class ThingsBoardSized {
 #else
         api.Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+        api.Set_Stream_Supported(m_stream_supported);
+        api.Set_Topic_Profile(*m_topic_profile);
         api.Initialize();
         m_api_implementations.push_back(&api);
     }
@@ -390,6 +557,8 @@ class ThingsBoardSized {
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
 #endif // THINGSBOARD_ENABLE_STL
+            api->Set_Stream_Supported(m_stream_supported);
+            api->Set_Topic_Profile(*m_topic_profile);
             api->Initialize();
         }
         m_api_implementations.insert(m_api_implementations.end(), first, last);
@@ -413,7 +582,7 @@ class ThingsBoardSized {
             request_buffer[SECRET_KEY] = secret_key;
         }
         request_buffer[DURATION_KEY] = duration_ms;
-        return Send_Json(CLAIM_TOPIC, request_buffer, Helper::Measure_Json(request_buffer));
+        return Send_Json(m_topic_profile->claim, request_buffer, 0U);
     }
 
     //----------------------------------------------------------------------------
@@ -453,22 +622,48 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
+    /// @brief Attempts to send aggregated telemetry data with the given timestamp, instead of the time the data arrived at the server, expects iterators to a container containing Telemetry class instances.
+    /// If the data has to be split into multiple messages, because it does not fit into the send buffer, every message contains the same timestamp, so that the data is still stored as a single point in time.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param timestamp Unix timestamp of the data in milliseconds, 0 sends the data without a timestamp
+    /// @return Whether sending the aggregated telemetry data was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud.
+    /// Should simply be the biggest distance between first and last iterator this method is ever called with
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool sendTelemetry(InputIterator const & first, InputIterator const & last, uint64_t const & timestamp) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return sendDataArray(first, last, true, timestamp);
+#else
+        return sendDataArray<MaxKeyValuePairAmount>(first, last, true, timestamp);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+
     /// @brief Attempts to send custom json telemetry string.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool sendTelemetryString(char const * json) {
-        return Send_Json_String(TELEMETRY_TOPIC, json);
+        return Send_Json_String(m_topic_profile->telemetry, json);
     }
 
     /// @brief Attempts to send telemetry key value pairs from custom source to the server.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
-    /// @param json_size Size of the data inside the source
+    /// @param json_size Size of the data inside the source including the null terminator, only used as the minimum initial size of the reusable send buffer
+    /// and not required to be exact, because the json is serialized only once and the buffer grows if required, 0 if the size is unknown
     /// @return Whether sending the data was successful or not
     bool sendTelemetryJson(JsonDocument const & source, size_t const & json_size) {
-        return Send_Json(TELEMETRY_TOPIC, source, json_size);
+        return Send_Json(m_topic_profile->telemetry, source, json_size);
     }
 
     //----------------------------------------------------------------------------
@@ -513,17 +708,18 @@ class ThingsBoardSized {
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool sendAttributeString(char const * json) {
-        return Send_Json_String(ATTRIBUTE_TOPIC, json);
+        return Send_Json_String(m_topic_profile->attribute, json);
     }
 
     /// @brief Attempts to send attribute key value pairs from custom source to the server.
     /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
-    /// @param json_size Size of the data inside the source
+    /// @param json_size Size of the data inside the source including the null terminator, only used as the minimum initial size of the reusable send buffer
+    /// and not required to be exact, because the json is serialized only once and the buffer grows if required, 0 if the size is unknown
     /// @return Whether sending the data was successful or not
     bool sendAttributeJson(JsonDocument const & source, size_t const & json_size) {
-        return Send_Json(ATTRIBUTE_TOPIC, source, json_size);
+        return Send_Json(m_topic_profile->attribute, source, json_size);
     }
 
   private:
@@ -533,7 +729,7 @@ class ThingsBoardSized {
     /// @param topic Topic we want to send the data over
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
-    /// @param json_size Size of the data inside the source
+    /// @param json_size Length of the serialized data inside the source, excluding the null terminator
     /// @return Whether sending the data was successful or not
     bool Serialize_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
         if (!m_client.begin_publish(topic, json_size)) {
@@ -551,10 +747,129 @@ class ThingsBoardSized {
     }
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 
-    /// @brief Returns the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
-    /// @return Maximum amount of bytes we want to allocate on the stack
-    size_t const & getMaximumStackSize() const {
-        return m_max_stack;
+    /// @brief Serializes the given records directly into the reusable send buffer, if every one of them uses an interned key,
+    /// which allows to copy the already serialized key fragments instead of building a JsonDocument and escaping every key again
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param topic Topic the data will be sent over, which has to fit into the send buffer of the client together with the payload
+    /// @param timestamp Unix timestamp in milliseconds the records are wrapped with, 0 if they are serialized without a timestamp
+    /// @param length Length of the serialized json object, excluding the null terminator
+    /// @return Whether the records were serialized into the send buffer, fails if any record does not use an interned key
+    /// or the serialized records do not fit into the send buffer, in which case they have to be serialized into a JsonDocument instead
+    template<typename InputIterator>
+    bool Serialize_Interned_Data(InputIterator const & first, InputIterator const & last, char const * topic, uint64_t const & timestamp, size_t & length) {
+        if (first == last) {
+            return false;
+        }
+        for (auto it = first; it != last; ++it) {
+            if (!(*it).Is_Interned()) {
+                return false;
+            }
+        }
+
+        // Payload that fills the complete client buffer next to the topic and the null terminator, bigger messages can not be sent without the StreamUtils work around
+        size_t const maximum_size = Get_Maximum_Payload_Length(topic) + 1U;
+        // Closing bracket of the records and the closing bracket of the object that wraps them with the timestamp
+        size_t const closing_length = (timestamp != 0U) ? 2U : 1U;
+        size_t required_size = 0U;
+        while (Reserve_Send_Buffer(required_size, maximum_size)) {
+            length = 0U;
+            bool fits = true;
+            if (timestamp != 0U) {
+                int const written = snprintf(m_send_buffer, m_send_buffer_size, TIMESTAMPED_TELEMETRY_PREFIX, static_cast<unsigned long long>(timestamp));
+                fits = written > 0 && static_cast<size_t>(written) < m_send_buffer_size;
+                length = fits ? static_cast<size_t>(written) : 0U;
+            }
+            for (auto it = first; it != last && fits; ++it) {
+                // Opening bracket for the first key-value pair and a seperating comma for every following one, always keeps space for the closing brackets and the null terminator
+                if (length + 2U + closing_length > m_send_buffer_size) {
+                    fits = false;
+                    break;
+                }
+                m_send_buffer[length++] = (it == first) ? '{' : ',';
+                size_t const written = (*it).Serialize_Member(m_send_buffer + length, m_send_buffer_size - length - closing_length);
+                fits = written != 0U;
+                length += written;
+            }
+            if (fits) {
+                m_send_buffer[length++] = '}';
+                if (timestamp != 0U) {
+                    m_send_buffer[length++] = '}';
+                }
+                m_send_buffer[length] = '\0';
+                return true;
+            }
+            else if (m_send_buffer_size >= maximum_size) {
+                break;
+            }
+            required_size = m_send_buffer_size * 2U;
+        }
+        return false;
+    }
+
+    /// @brief Gets the maximum length of a payload that can be published over the given topic, because the send buffer of the client has to hold the header of the PUBLISH packet and the topic as well
+    /// @param topic Topic the payload will be sent over
+    /// @return Maximum length of the payload in bytes, 0 if not even the topic fits into the send buffer
+    size_t Get_Maximum_Payload_Length(char const * topic) {
+        size_t const send_buffer_size = m_client.get_send_buffer_size();
+        size_t const overhead = MQTT_PUBLISH_OVERHEAD + strlen(topic);
+        return (send_buffer_size > overhead) ? send_buffer_size - overhead : 0U;
+    }
+
+    /// @brief Ensures the reusable send buffer can hold at least the given amount of bytes, the buffer grows geometrically and is kept between messages,
+    /// so that serializing outgoing messages does not require a heap allocation for every single message.
+    /// Has to be called while holding the send mutex, which has to be kept until the serialized message has been published, because growing the buffer frees the previous one
+    /// @param size Minimum size in bytes the send buffer should have
+    /// @param maximum_size Size in bytes the send buffer is never grown beyond, because bigger messages can not be sent by the underlying client anyway
+    /// @return Whether the send buffer has the required size or not, only fails if the allocation failed
+    bool Reserve_Send_Buffer(size_t size, size_t const & maximum_size) {
+        if (m_send_buffer != nullptr && m_send_buffer_size >= size) {
+            return true;
+        }
+        if (size < Default_Payload_Size) {
+            size = Default_Payload_Size;
+        }
+        if (size < m_send_buffer_size * 2U) {
+            size = m_send_buffer_size * 2U;
+        }
+        if (size > maximum_size) {
+            size = maximum_size;
+        }
+        if (m_send_buffer != nullptr && m_send_buffer_size >= size) {
+            return true;
+        }
+
+        char * buffer = new char[size]();
+        if (buffer == nullptr) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_SEND_BUFFER, size);
+            return false;
+        }
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        delete[] m_send_buffer;
+        m_send_buffer = buffer;
+        m_send_buffer_size = size;
+        return true;
+    }
+
+    /// @brief Publishes the given already serialized json payload over the given topic, if it fits into the internal client buffer
+    /// @param topic Topic we want to send the data over
+    /// @param json Null-terminated json payload that should be sent
+    /// @param length Length of the payload in bytes, excluding the null terminator
+    /// @return Whether sending the data was successful or not
+    bool Publish_Json(char const * topic, char const * json, size_t const & length) {
+        uint16_t const current_send_buffer_size = m_client.get_send_buffer_size();
+        if (current_send_buffer_size < length) {
+            Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, length);
+            return false;
+        }
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_MESSAGE, topic, json);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return m_send_scheduler.publish(topic, json, length, m_send_urgency);
     }
 
     /// @brief Returns the current receive buffer size of the underlying client interface
@@ -573,7 +888,24 @@ class ThingsBoardSized {
     /// @param topic Topic that should be subscribed
     /// @return Whether subscribing was successfull or not
     bool clientSubscribe(char const * topic) {
-        return m_client.subscribe(topic);
+        if (!m_collect_subscriptions) {
+            return m_client.subscribe(topic);
+        }
+        // Topics are only collected while resubscribing after a reconnect, they are all constant strings so keeping the pointer is safe.
+        // Multiple API implementations might subscribe the same topic, which only needs to be sent once
+        for (size_t i = 0U; i < m_pending_subscriptions.size(); ++i) {
+            if (strcmp(m_pending_subscriptions[i], topic) == 0) {
+                return true;
+            }
+        }
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        // Subscribe the topic directly instead if the batch is already full, because that is still better than not subscribing the topic at all
+        if (m_pending_subscriptions.size() + 1 > m_pending_subscriptions.capacity()) {
+            return m_client.subscribe(topic);
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        m_pending_subscriptions.push_back(topic);
+        return true;
     }
 
     /// @brief Unsubscribes the given topic with the underlying client interface
@@ -614,12 +946,29 @@ class ThingsBoardSized {
         return connection_result;
     }
 
+    /// @brief Passes the telemetry and attribute topics of the current topic profile to the underlying client, because they are published to far more often than any other topic,
+    /// which allows the client to send them with a topic alias instead, if it supports it
+    void Register_Topic_Aliases() {
+        char const * const topics[ALIASED_TOPICS_AMOUNT] = { m_topic_profile->telemetry, m_topic_profile->attribute };
+        (void)m_client.set_topic_aliases(topics, ALIASED_TOPICS_AMOUNT);
+    }
+
     /// @brief Resubscribes to topics that establish a permanent connection with MQTT, meaning they may receive more than one event over their lifetime,
     /// whereas other events that are only ever called once and then deleted after they have been handled are not resubscribed.
     /// Only the topics that establish a permanent connection are resubscribed, because all not yet received data is discard on the MQTT broker,
-    // once we establish a connection again. This is the case because we connect with the cleanSession attribute set to true.
+    // once we establish a connection again. This is the case because we connect with the cleanSession attribute set to true by default.
     // Therefore we can also clear the buffer of all non-permanent topics.
+    // The topics of all API implementations are collected and then subscribed in one batch, so that only one SUBSCRIBE packet is sent, if the client supports it.
+    // If the client connected with the cleanSession attribute set to false and the broker still holds the previous session, resubscribing is skipped completely
     void Resubscribe_Topics() {
+        if (m_client.get_session_present()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SESSION_PRESENT_SKIPPING_RESUBSCRIBE);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+
+        m_collect_subscriptions = true;
         // Results are ignored, because the important part of clearing internal data structures always succeeds
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
@@ -627,6 +976,15 @@ class ThingsBoardSized {
             }
             (void)api->Resubscribe_Topic();
         }
+        m_collect_subscriptions = false;
+
+        if (m_pending_subscriptions.empty()) {
+            return;
+        }
+        if (!m_client.subscribe(&m_pending_subscriptions[0], m_pending_subscriptions.size())) {
+            Logger::printfln(SUBSCRIBE_TOPICS_FAILED, m_pending_subscriptions.size());
+        }
+        m_pending_subscriptions.clear();
     }
 
     /// @brief Attempts to send a single key-value pair with the given key and value of the given type
@@ -647,17 +1005,21 @@ class ThingsBoardSized {
             Logger::printfln(UNABLE_TO_SERIALIZE);
             return false;
         }
-        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
+        return telemetry ? sendTelemetryJson(json_buffer, 0U) : sendAttributeJson(json_buffer, 0U);
     }
 
-    /// @brief Attempts to send aggregated attribute or telemetry data
+    /// @brief Attempts to send aggregated attribute or telemetry data, if the serialized data does not fit into the send buffer of the underlying client,
+    /// it is split into multiple messages that each fit into the buffer, instead of being discarded. Only if THINGSBOARD_ENABLE_STREAM_UTILS is set,
+    /// the data is always sent as a single message, because it can then be streamed without having to fit into the send buffer
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
     /// @param first Iterator pointing to the first element in the data container
     /// @param last Iterator pointing to the end of the data container (last element + 1)
     /// @param telemetry Whether the data we want to send should be sent over the attribute or telemtry topic
-    /// @return Whether sending the aggregated data was successful or not
+    /// @param timestamp Unix timestamp in milliseconds every message is wrapped with, only supported for telemetry, 0 sends the data without a timestamp
+    /// @return Whether sending the aggregated data was successful or not, fails if any of the split messages could not be sent
+    /// @note Thread-safe under the same conditions as Send_Json(), the reusable send buffer is locked until every split message has been published
 #if THINGSBOARD_ENABLE_DYNAMIC
     template<typename InputIterator>
 #else
@@ -665,36 +1027,200 @@ class ThingsBoardSized {
     /// Should simply be the biggest distance between first and last iterator this method is ever called with
     template<size_t MaxKeyValuePairAmount, typename InputIterator>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-    bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry) {
+    bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry, uint64_t const & timestamp = 0U) {
+        char const * topic = telemetry ? m_topic_profile->telemetry : m_topic_profile->attribute;
+        Recursive_Mutex_Lock lock(m_send_mutex);
+        size_t length = 0U;
+        if (Serialize_Interned_Data(first, last, topic, timestamp, length)) {
+            return Publish_Json(topic, m_send_buffer, length);
+        }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return Send_Data_Range(first, last, topic, timestamp);
+#else
+        return Send_Data_Range<MaxKeyValuePairAmount>(first, last, topic, timestamp);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#else
+        // Serializing the interned records fails as well if they do not fit into the send buffer, therefore every record is partitioned regardless
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return Send_Partitioned_Data(first, last, topic, timestamp);
+#else
+        return Send_Partitioned_Data<MaxKeyValuePairAmount>(first, last, topic, timestamp);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    }
+
+#if !THINGSBOARD_ENABLE_STREAM_UTILS
+    /// @brief Splits the given records into consecutive partitions, that each fit into the send buffer of the underlying client once serialized and sends every partition as its own message.
+    /// The serialized size of every record is measured only once and the partitions are filled greedily, meaning the records keep their order and most data sets are sent as a single message.
+    /// Every partition leaves space for the header of the PUBLISH packet and the topic, which the client copies into the send buffer as well, and for the timestamp the records are wrapped with if one is given.
+    /// Records that do not even fit into the send buffer on their own are skipped, while the remaining records are still sent
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param topic Topic we want to send the data over
+    /// @param timestamp Unix timestamp in milliseconds every partition is wrapped with, 0 if the partitions are sent without a timestamp
+    /// @return Whether sending all partitions was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool Send_Partitioned_Data(InputIterator const & first, InputIterator const & last, char const * topic, uint64_t const & timestamp) {
+        size_t const maximum_length = Get_Maximum_Payload_Length(topic);
+        bool result = true;
+        InputIterator start = first;
+        // Opening and closing bracket of the json object, as well as the object that wraps it with the timestamp, including its closing bracket
+        size_t const empty_length = 2U + ((timestamp != 0U) ? static_cast<size_t>(Helper::detectSize(TIMESTAMPED_TELEMETRY_PREFIX, static_cast<unsigned long long>(timestamp))) : 0U);
+        size_t length = empty_length;
+        size_t amount = 0U;
+        for (auto it = first; it != last; ++it) {
+            size_t const member_length = (*it).Measure_Member();
+            // Every record except the first one of the partition is preceded by a seperating comma
+            size_t const required_length = length + member_length + (it == start ? 0U : 1U);
+            if (required_length <= maximum_length) {
+                length = required_length;
+                ++amount;
+                continue;
+            }
+
+            if (it != start) {
+#if THINGSBOARD_ENABLE_DEBUG
+                Logger::printfln(SPLITTING_PAYLOAD, amount, maximum_length);
+#endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_DYNAMIC
+                result = Send_Data_Range(start, it, topic, timestamp) && result;
+#else
+                result = Send_Data_Range<MaxKeyValuePairAmount>(start, it, topic, timestamp) && result;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+            }
+            start = it;
+            length = empty_length + member_length;
+            amount = 1U;
+            if (length > maximum_length) {
+                Logger::printfln(INVALID_MEMBER_SIZE, maximum_length, member_length);
+                result = false;
+                ++start;
+                length = empty_length;
+                amount = 0U;
+            }
+        }
+
+        if (start == last) {
+            return result;
+        }
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return Send_Data_Range(start, last, topic, timestamp) && result;
+#else
+        return Send_Data_Range<MaxKeyValuePairAmount>(start, last, topic, timestamp) && result;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+#endif // !THINGSBOARD_ENABLE_STREAM_UTILS
+
+    /// @brief Attempts to send the given records as a single message, directly serialized into the send buffer if all of them use an interned key or otherwise over a JsonDocument
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param topic Topic we want to send the data over
+    /// @param timestamp Unix timestamp in milliseconds the records are wrapped with, 0 if they are sent without a timestamp
+    /// @return Whether sending the data was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool Send_Data_Range(InputIterator const & first, InputIterator const & last, char const * topic, uint64_t const & timestamp) {
+        size_t length = 0U;
+        if (Serialize_Interned_Data(first, last, topic, timestamp, length)) {
+            return Publish_Json(topic, m_send_buffer, length);
+        }
+
         size_t const size = Helper::distance(first, last);
 #if THINGSBOARD_ENABLE_DYNAMIC
         // char const * are stored as only a pointer inside the JsonDocument --> zero copy, meaning the size for the strings is 0 bytes.
-        // Data structure size, therefore only depends on the amount of key value pairs passed.
+        // Data structure size, therefore only depends on the amount of key value pairs passed and the object wrapping them with the timestamp.
         // See https://arduinojson.org/v6/assistant/ for more information on the needed size for the JsonDocument
-        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(size));
+        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(size) + ((timestamp != 0U) ? JSON_OBJECT_SIZE(2U) : 0U));
 #else
         if (size > MaxKeyValuePairAmount) {
             Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxKeyValuePairAmount", MaxKeyValuePairAmount);
             return false;
         }
-        StaticJsonDocument<JSON_OBJECT_SIZE(MaxKeyValuePairAmount)> json_buffer;
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxKeyValuePairAmount) + JSON_OBJECT_SIZE(2U)> json_buffer;
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+        JsonObject root = json_buffer.template to<JsonObject>();
+        if (timestamp != 0U) {
+            root[TELEMETRY_TIMESTAMP_KEY] = timestamp;
+        }
+        JsonObject values = (timestamp != 0U) ? root.createNestedObject(TELEMETRY_VALUES_KEY) : root;
 
 #if THINGSBOARD_ENABLE_STL
-        if (std::any_of(first, last, [&json_buffer](Telemetry const & data) { return !data.SerializeKeyValue(json_buffer); })) {
+        if (std::any_of(first, last, [&values](Telemetry const & data) { return !data.SerializeKeyValue(values); })) {
             Logger::printfln(UNABLE_TO_SERIALIZE);
             return false;
         }
 #else
         for (auto it = first; it != last; ++it) {
             auto const & data = *it;
-            if (!data.SerializeKeyValue(json_buffer)) {
+            if (!data.SerializeKeyValue(values)) {
                 Logger::printfln(UNABLE_TO_SERIALIZE);
                 return false;
             }
         }
 #endif // THINGSBOARD_ENABLE_STL
-        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
+        return Send_Json(topic, json_buffer, 0U);
+    }
+
+    /// @brief MQTT callback that will be called with the topic of a received message, that does not fit into the receive buffer of the underlying client
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @return Whether the payload should be streamed in slices, which is only the case if any API implementation processes responses on the given topic as raw bytes
+    bool onMQTTStreamFilter(char const * topic) {
+#if THINGSBOARD_ENABLE_STL
+        return std::any_of(m_api_implementations.begin(), m_api_implementations.end(), [&topic](IAPI_Implementation const * api) {
+            return (api != nullptr && api->Get_Process_Type() == API_Process_Type::RAW && api->Compare_Response_Topic(topic));
+        });
+#else
+        for (auto const & api : m_api_implementations) {
+            if (api != nullptr && api->Get_Process_Type() == API_Process_Type::RAW && api->Compare_Response_Topic(topic)) {
+                return true;
+            }
+        }
+        return false;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief MQTT callback that will be called with consecutive slices of a received payload, that did not fit into the receive buffer of the underlying client,
+    /// the slices are only passed to API implementations that process responses on the given topic as raw bytes, because json can not be deserialized partially
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Slice of the payload that was sent over the cloud and received over the given topic
+    /// @param length Length of the received slice
+    /// @param offset Offset of the received slice from the start of the complete payload
+    /// @param total_length Total length of the complete payload
+    void onMQTTStream(char * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) {
+#if THINGSBOARD_ENABLE_DEBUG
+        if (offset == 0U) {
+            Logger::printfln(RECEIVE_MESSAGE, total_length, topic);
+        }
+#endif // THINGSBOARD_ENABLE_DEBUG
+        // Radio is awake anyway, therefore held messages can be sent without requiring an additional wake up
+        {
+            Recursive_Mutex_Lock lock(m_send_mutex);
+            m_send_scheduler.Notify_Activity();
+        }
+
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+            api->Process_Response_Slice(topic, payload, length, offset, total_length);
+        }
     }
 
     /// @brief MQTT callback that will be called if a publish message is received from the server
@@ -711,6 +1237,11 @@ class ThingsBoardSized {
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(RECEIVE_MESSAGE, length, topic);
 #endif // THINGSBOARD_ENABLE_DEBUG
+        // Radio is awake anyway, therefore held messages can be sent without requiring an additional wake up
+        {
+            Recursive_Mutex_Lock lock(m_send_mutex);
+            m_send_scheduler.Notify_Activity();
+        }
 
 #if THINGSBOARD_ENABLE_STL
 #if THINGSBOARD_ENABLE_CXX20
@@ -826,6 +1357,20 @@ class ThingsBoardSized {
         m_subscribedInstance->onMQTTMessage(topic, payload, length);
     }
 
+    static bool onStaticMQTTStreamFilter(char const * topic) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->onMQTTStreamFilter(topic);
+    }
+
+    static void onStaticMQTTStream(char * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->onMQTTStream(topic, payload, length, offset, total_length);
+    }
+
     static void staticMQTTConnect() {
         if (m_subscribedInstance == nullptr) {
             return;
@@ -903,16 +1448,28 @@ class ThingsBoardSized {
 #endif // !THINGSBOARD_ENABLE_STL
 
     IMQTT_Client&                                   m_client = {};              // MQTT client instance.
+    Outbound_Priority_Lanes<Logger>                 m_priority_lanes;           // Holds lower priority messages back while the outbox of the MQTT client is busy
+    Outbound_Rate_Limiter<Logger>                   m_rate_limiter;             // Queues or merges outgoing messages that would exceed the configured rate limits
+    Send_Scheduler<Logger>                          m_send_scheduler;           // Holds non-urgent telemetry and attribute messages back to send them together in one send window
+    Send_Urgency                                    m_send_urgency = {};        // Urgency following telemetry and attribute messages are sent with
+    Topic_Profile const                             *m_topic_profile = {};      // Topics used to communicate with the device API of the server
     size_t                                          m_max_stack = {};           // Maximum stack size we allocate at once.
+    char                                            *m_send_buffer = {};        // Reusable buffer outgoing json messages are serialized into, grows geometrically up to the size of the client send buffer
+    size_t                                          m_send_buffer_size = {};    // Current size of the reusable send buffer in bytes
+    Recursive_Mutex                                 m_send_mutex;               // Guards the reusable send buffer and the send scheduler, rate limiter and priority lanes, because messages might be sent from the task of the client and the user task at the same time
     size_t                                          m_request_id = {};          // Internal id used to differentiate which request should receive which response for certain API calls. Can send 4'294'967'296 requests before wrapping back to 0
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     size_t                                          m_buffering_size = {};      // Buffering size used to serialize directly into client.
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    bool                                            m_stream_supported = {};    // Whether the underlying client streams received payloads that do not fit into its receive buffer
+    bool                                            m_collect_subscriptions = {}; // Whether subscribed topics are collected to be subscribed in one batch instead of being subscribed directly
 #if !THINGSBOARD_ENABLE_DYNAMIC
     Array<IAPI_Implementation*, MaxEndpointsAmount> m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Array<char const *, MaxEndpointsAmount>         m_pending_subscriptions = {}; // Topics collected while resubscribing, that will be subscribed in one batch
 #else
     size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
     Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Vector<char const *>                            m_pending_subscriptions = {}; // Topics collected while resubscribing, that will be subscribed in one batch
 #endif // !THINGSBOARD_ENABLE_DYNAMIC                
 };
 
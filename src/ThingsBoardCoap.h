@@ -0,0 +1,950 @@
+#ifndef ThingsBoard_Coap_h
+#define ThingsBoard_Coap_h
+
+// Local includes.
+#include "Constants.h"
+#include "IAPI_Implementation.h"
+#include "ICoAP_Client.h"
+#include "DefaultLogger.h"
+#include "Telemetry.h"
+#include "Helper.h"
+#include "Json_Scanner.h"
+
+
+// CoAP paths, see https://thingsboard.io/docs/reference/coap-api/ for more information.
+char constexpr COAP_API_PATH[] = "/api/v1/%s/%s";
+char constexpr COAP_RPC_RESPONSE_PATH[] = "/api/v1/%s/rpc/%u";
+char constexpr COAP_TELEMETRY_RESOURCE[] = "telemetry";
+char constexpr COAP_ATTRIBUTES_RESOURCE[] = "attributes";
+char constexpr COAP_RPC_RESOURCE[] = "rpc";
+char constexpr COAP_CLAIM_RESOURCE[] = "claim";
+// Response codes with the same decimal representation used for HTTP status codes, every code of the success class 2.xx is accepted.
+int constexpr COAP_RESPONSE_SUCCESS_RANGE_START = 200;
+int constexpr COAP_RESPONSE_SUCCESS_RANGE_END = 299;
+// Suffixes of the observed paths, used to differentiate the received notifications.
+char constexpr COAP_RPC_SUFFIX[] = "/rpc";
+char constexpr COAP_ATTRIBUTES_SUFFIX[] = "/attributes";
+// Format of the internal topics received responses and notifications are passed to the API implementations with.
+char constexpr COAP_RESPONSE_TOPIC[] = "%s%u";
+// Key of the request id contained in server-side RPC notifications.
+char constexpr COAP_RPC_ID_KEY[] = "id";
+char constexpr const * COAP_RPC_NOTIFICATION_KEYS[] = {COAP_RPC_ID_KEY};
+// Log messages.
+char constexpr COAP_POST[] = "POST";
+char constexpr COAP_GET[] = "GET";
+char constexpr COAP_FAILED[] = "(%s) failed CoAP response (%d)";
+char constexpr COAP_REQUEST_FAILED[] = "(%s) CoAP request failed with internal error (%d)";
+char constexpr COAP_TOPIC_NOT_SUPPORTED[] = "Topic (%s) is not supported over CoAP";
+char constexpr COAP_RPC_ID_MISSING[] = "Received server-side RPC notification without request id";
+char constexpr COAP_UNABLE_TO_DE_SERIALIZE_JSON[] = "Unable to de-serialize received json data with error (DeserializationError::%s)";
+char constexpr COAP_UNABLE_TO_ALLOCATE_BUFFER[] = "Allocating memory for the internal CoAP buffer failed";
+char constexpr COAP_UNABLE_TO_COPY_PAYLOAD[] = "Failed allocating required size (%u) for the copy of the received payload. Ensure there is enough heap memory left";
+char constexpr COAP_MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME[] = "MaxEndpointsAmount";
+#if THINGSBOARD_ENABLE_DYNAMIC
+char constexpr COAP_MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (%u) for JsonDocument. Discarding message that is bigger than maximum response size (%u)";
+char constexpr COAP_HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr COAP_RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server for internal topic (%s)";
+char constexpr COAP_SEND_MESSAGE[] = "Sending data to server over path (%s) with data (%s)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+// Claim data keys.
+char constexpr COAP_SECRET_KEY[] = "secretKey";
+char constexpr COAP_DURATION_KEY[] = "durationMs";
+
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+/// @brief Wrapper around any arbitrary CoAP Client implementing the ICoAP_Client interface, to allow sending / retrieving data from ThingsBoard over the CoAP protocol.
+/// The same API implementations used with the MQTT ThingsBoard client (Server_Side_RPC, Client_Side_RPC, Shared_Attribute_Update and Attribute_Request) can be used with this client as well,
+/// because the MQTT topics they publish and subscribe to are translated into the matching requests and observations of the CoAP device API. Server-side RPC and shared attribute updates are received by observing the resource,
+/// while attribute requests and client-side RPC receive their response piggybacked on the acknowledgement of the request itself. Firmware updates are downloaded block-wise with the CoAP_OTA_Firmware_Update class instead,
+/// because the firmware resource of the CoAP API is not structured like the MQTT firmware topics. Compared to MQTT, no connection has to be kept alive, which makes CoAP a lot cheaper for sleepy devices that only wake up once in a while.
+/// The maximum amount of data points that can ever be received are automatically deduced at runtime and the internal vector holding all API implementations dynamically allocate memory on the heap.
+/// If this feature of automatic deduction, is not needed, or not wanted because it allocates memory on the heap, then the values can be set once as template arguements.
+/// Simply set THINGSBOARD_ENABLE_DYNAMIC to 0, before including ThingsBoardCoap.h
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+#else
+/// @brief Wrapper around any arbitrary CoAP Client implementing the ICoAP_Client interface, to allow sending / retrieving data from ThingsBoard over the CoAP protocol.
+/// The same API implementations used with the MQTT ThingsBoard client (Server_Side_RPC, Client_Side_RPC, Shared_Attribute_Update and Attribute_Request) can be used with this client as well,
+/// because the MQTT topics they publish and subscribe to are translated into the matching requests and observations of the CoAP device API. Server-side RPC and shared attribute updates are received by observing the resource,
+/// while attribute requests and client-side RPC receive their response piggybacked on the acknowledgement of the request itself. Firmware updates are downloaded block-wise with the CoAP_OTA_Firmware_Update class instead,
+/// because the firmware resource of the CoAP API is not structured like the MQTT firmware topics. Compared to MQTT, no connection has to be kept alive, which makes CoAP a lot cheaper for sleepy devices that only wake up once in a while.
+/// The maximum amount of data points that can ever be received and the amount of API implementations can be set once as template argument.
+/// Changing is only possible if a new instance of this class is created. If these values should be automatically deduced at runtime instead then, and then dynamically allocated on the heap,
+/// simply set THINGSBOARD_ENABLE_DYNAMIC to 1, before including ThingsBoardCoap.h
+/// @tparam MaxResponse Maximum amount of key value pair that will ever be received by ThingsBoard in one call, default = Default_Response_Amount (8)
+/// @tparam MaxEndpointsAmount Maximum amount of subscribed API endpoints, default = Default_Endpoints_Amount (7)
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template<size_t MaxResponse = Default_Response_Amount, size_t MaxEndpointsAmount = Default_Endpoints_Amount, typename Logger = DefaultLogger>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+class ThingsBoardCoapSized {
+  public:
+    /// @brief Constructs a ThingsBoardCoapSized instance with the given CoAP client that should be used to send requests to ThingsBoard.
+    /// Directly forwards the last given arguments to the overloaded Array or Vector (THINGSBOARD_ENABLE_DYNAMIC) constructor,
+    /// meaning the API implementations can be passed directly or as a range of pointers
+    /// @tparam ...Args Holds the multiple arguments that will simply be forwarded to the Array or Vector (THINGSBOARD_ENABLE_DYNAMIC) constructor
+    /// @param client CoAP Client implementation that should be used to send requests to ThingsBoard
+    /// @param receive_buffer_size Maximum size of a single received datagram, responses and notifications that are bigger are discarded, default = Default_CoAP_Buffer_Size (512)
+    /// @param send_buffer_size Maximum size of a single sent datagram, including the CoAP header and the path options, default = Default_CoAP_Buffer_Size (512)
+    /// @param max_stack_size Maximum amount of bytes we want to allocate on the stack, default = Default_Max_Stack_Size (1024)
+    /// @param ...args Arguments that will be forwarded into the overloaded Array or Vector (THINGSBOARD_ENABLE_DYNAMIC) constructor
+    template<typename... Args>
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @param max_response_size Maximum amount of bytes allocated for the interal JsonDocument structure that holds the received payload, 0 to not check the size, default = Default_Max_Response_Size (0)
+    ThingsBoardCoapSized(ICoAP_Client & client, uint16_t receive_buffer_size = Default_CoAP_Buffer_Size, uint16_t send_buffer_size = Default_CoAP_Buffer_Size, size_t const & max_stack_size = Default_Max_Stack_Size, size_t const & max_response_size = Default_Max_Response_Size, Args const &... args)
+#else
+    ThingsBoardCoapSized(ICoAP_Client & client, uint16_t receive_buffer_size = Default_CoAP_Buffer_Size, uint16_t send_buffer_size = Default_CoAP_Buffer_Size, size_t const & max_stack_size = Default_Max_Stack_Size, Args const &... args)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      : m_client(client)
+      , m_max_stack(max_stack_size)
+      , m_token(nullptr)
+      , m_request_id(0U)
+#if THINGSBOARD_ENABLE_DYNAMIC
+      , m_max_response_size(max_response_size)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_api_implementations(args...)
+    {
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            Initialize_API_Implementation(*api);
+        }
+        (void)setBufferSize(receive_buffer_size, send_buffer_size);
+#if THINGSBOARD_ENABLE_STL
+        m_client.set_notification_callback(std::bind(&ThingsBoardCoapSized::onCoAPNotification, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+#else
+        m_client.set_notification_callback(ThingsBoardCoapSized::onStaticCoAPNotification);
+        m_subscribedInstance = this;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Gets the underlying CoAP Client implementation as a reference, used by the CoAP_OTA_Firmware_Update class to download firmware block-wise
+    /// @return Reference to the underlying CoAP Client implementation
+    ICoAP_Client & getClient() {
+        return m_client;
+    }
+
+    /// @brief Gets the access token the client connected with, which is part of every path of the CoAP device API
+    /// @return Access token passed to connect() or nullptr if the client has not been connected yet
+    char const * getAccessToken() const {
+        return m_token;
+    }
+
+    /// @brief Sets the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
+    /// @param max_stack_size Maximum amount of bytes we want to allocate on the stack
+    void setMaximumStackSize(size_t const & max_stack_size) {
+        m_max_stack = max_stack_size;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Sets the maximum amount of bytes allocated for internal JsonDocument holding received payload from server responses by attribute requests, shared attribute updates, server-side or client-side rpc
+    /// @param max_response_size Maximum amount of bytes allocated for the interal JsonDocument structure that holds the received payload, 0 to not check the size
+    void setMaxResponseSize(size_t const & max_response_size) {
+        m_max_response_size = max_response_size;
+    }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+    /// @brief Sets the size of the buffers of the underlying CoAP client, every request and every response has to fit into a single datagram,
+    /// therefore the buffers have to hold the complete payload together with the CoAP header and the path options, which require about 40 bytes with a 20 character access token
+    /// @param receive_buffer_size Maximum size of a single received datagram
+    /// @param send_buffer_size Maximum size of a single sent datagram
+    /// @return Whether allocating the needed memory for the given buffer sizes was successful or not
+    bool setBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+        bool const result = m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
+        if (!result) {
+            Logger::printfln(COAP_UNABLE_TO_ALLOCATE_BUFFER);
+        }
+        return result;
+    }
+
+    /// @brief Clears all currently subscribed callbacks and cancels all observations, any notification that will still be received is discarded
+    void Cleanup_Subscriptions() {
+        // Results are ignored, because the important part of clearing internal data structures always succeeds
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            (void)api->Unsubscribe();
+        }
+    }
+
+    /// @brief Opens the socket to the given ThingsBoard server and observes the resources of every API implementation that is currently subscribed,
+    /// does not send any data besides the observation requests, because CoAP does not require establishing a connection first
+    /// @param host ThingsBoard server instance we want to send requests to
+    /// @param access_token Access token that connects this device with a created device on the ThingsBoard server, has to be kept alive for as long as the instance of this class
+    /// @param port Port the server listens on for CoAP requests, default = DEFAULT_COAP_PORT (5683)
+    /// @return Whether opening the socket was successful or not
+    bool connect(char const * host, char const * access_token, uint16_t port = DEFAULT_COAP_PORT) {
+        if (host == nullptr || Helper::stringIsNullorEmpty(access_token)) {
+            return false;
+        }
+        m_token = access_token;
+        if (m_client.connect(host, port) != 0) {
+            Logger::printfln(CONNECT_FAILED);
+            return false;
+        }
+        Resubscribe_Topics();
+        return true;
+    }
+
+    /// @brief Closes the socket, observations are not deregistered on the server, it stops sending notifications once they are rejected instead
+    void disconnect() {
+        m_client.stop();
+    }
+
+    /// @brief Whether the socket to the server is currently open
+    /// @return Whether the underlying CoAP Client is currently connected or not
+    bool connected() {
+        return m_client.connected();
+    }
+
+    /// @brief Receives any outstanding notification of the observed resources and passes them to the API implementations.
+    /// Additionally it continues the work of the API implementations and when not being able to use the ESP Timer, it updates the internal timeout timers
+    /// @return Whether the underlying client is still connected or not
+    bool loop() {
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            api->loop();
+        }
+        return m_client.loop();
+    }
+
+    /// @brief Gets the handle of the underlying socket, which becomes readable as soon as a notification has been received and loop() should be called.
+    /// Allows sleepy devices to wait with select() on the handle instead of calling loop() continously
+    /// @return File descriptor of the underlying socket or -1 if the used CoAP client does not expose one
+    int getReadinessHandle() {
+        return m_client.get_readiness_handle();
+    }
+
+    /// @brief Attempts to send key value pairs from custom source over the given internal MQTT topic, which is translated into the matching CoAP request.
+    /// Attribute requests are translated into a GET request with the requested keys as query arguments, everything else is serialized and sent with Send_Json_String()
+    /// @param topic MQTT topic of the device API the data would be sent over
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param json_size Size of the data inside the source, not required to be exact, because the json is measured again before it is serialized
+    /// @return Whether sending the data was successful or not
+    bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
+        // Check if allocating needed memory failed when trying to create the JsonDocument,
+        // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
+        if (source.isNull()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
+            return false;
+        }
+        // Check if inserting any of the internal values failed because the JsonDocument was too small,
+        // if it did the overflowed() method will return true. See https://arduinojson.org/v6/api/jsondocument/overflowed/ for more information
+        if (source.overflowed()) {
+            Logger::printfln(JSON_SIZE_TO_SMALL);
+            return false;
+        }
+        if (Starts_With_Format(topic, DEFAULT_TOPIC_PROFILE.attribute_request)) {
+            return Request_Attributes(topic, source);
+        }
+
+        // API implementations pass 0 if they do not know the size, therefore the json is always measured
+        size_t const size = measureJson(source) + 1U;
+        (void)json_size;
+        bool result = false;
+        if (getMaximumStackSize() < size) {
+            char * json = new char[size]();
+            if (serializeJson(source, json, size) < size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            }
+            else {
+                result = Send_Json_String(topic, json);
+            }
+            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            delete[] json;
+            json = nullptr;
+        }
+        else {
+            char json[size] = {};
+            if (serializeJson(source, json, size) < size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+            result = Send_Json_String(topic, json);
+        }
+        return result;
+    }
+
+    /// @brief Attempts to send custom json string over the given internal MQTT topic, which is translated into the matching CoAP POST request.
+    /// Telemetry, attributes and claiming requests are sent to their resource, responses to server-side RPC requests to the rpc resource with the request id
+    /// and client-side RPC requests to the rpc resource, where the piggybacked response is passed to the Client_Side_RPC implementation
+    /// @param topic MQTT topic of the device API the data would be sent over
+    /// @param json String containing our json key value pairs we want to attempt to send
+    /// @return Whether sending the data was successful or not
+    bool Send_Json_String(char const * topic, char const * json) {
+        if (topic == nullptr || json == nullptr || m_token == nullptr) {
+            return false;
+        }
+        Topic_Profile const & profile = DEFAULT_TOPIC_PROFILE;
+        if (strcmp(topic, profile.telemetry) == 0) {
+            return Post_Resource(COAP_TELEMETRY_RESOURCE, json);
+        }
+        else if (strcmp(topic, profile.attribute) == 0) {
+            return Post_Resource(COAP_ATTRIBUTES_RESOURCE, json);
+        }
+        else if (strcmp(topic, profile.claim) == 0) {
+            return Post_Resource(COAP_CLAIM_RESOURCE, json);
+        }
+        else if (Starts_With_Format(topic, profile.rpc_send_response)) {
+            size_t const request_id = Parse_Request_Id(profile.rpc_send_response, topic);
+            char path[Helper::detectSize(COAP_RPC_RESPONSE_PATH, m_token, request_id)] = {};
+            (void)snprintf(path, sizeof(path), COAP_RPC_RESPONSE_PATH, m_token, request_id);
+            return Send_Request(CoAP_Method::POST, path, json);
+        }
+        else if (Starts_With_Format(topic, profile.rpc_send_request)) {
+            if (!Post_Resource(COAP_RPC_RESOURCE, json)) {
+                return false;
+            }
+            size_t const request_id = Parse_Request_Id(profile.rpc_send_request, topic);
+            Dispatch_Response(profile.rpc_response, request_id, m_client.get_response_payload(), m_client.get_response_length());
+            return true;
+        }
+        Logger::printfln(COAP_TOPIC_NOT_SUPPORTED, topic);
+        return false;
+    }
+
+    /// @brief Copies a non-owning pointer to the given API implementation, into the local data container.
+    /// Ensure the actual variable is kept alive for as long as the instance of this class
+    /// @param api Additional API that we want to be handled
+    void Subscribe_API_Implementation(IAPI_Implementation & api) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_api_implementations.size() + 1 > m_api_implementations.capacity()) {
+            Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, COAP_MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME, MaxEndpointsAmount);
+            return;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        Initialize_API_Implementation(api);
+        m_api_implementations.push_back(&api);
+    }
+
+    /// @brief Copies the non-owning pointers to the given API implementations, into the local data container.
+    /// Ensure the actual memory of the API implementations inside the data container are kept alive for as long as the instance of this class
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    template <typename InputIterator>
+    void Subscribe_API_Implementations(InputIterator const & first, InputIterator const & last) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        size_t const size = Helper::distance(first, last);
+        if (m_api_implementations.size() + size > m_api_implementations.capacity()) {
+            Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, COAP_MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME, MaxEndpointsAmount);
+            return;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        for (auto it = first; it != last; ++it) {
+            auto & api = *it;
+            if (api == nullptr) {
+                continue;
+            }
+            Initialize_API_Implementation(*api);
+        }
+        m_api_implementations.insert(m_api_implementations.end(), first, last);
+    }
+
+    //----------------------------------------------------------------------------
+    // Claiming API
+
+    /// @brief Sends a claiming request for the given device, allowing any given user on the cloud to assign the device as their own (claim),
+    /// as long as they enter the given device name and secret key in the given amount of time.
+    /// See https://thingsboard.io/docs/user-guide/claiming-devices/ for more information
+    /// @param secret_key Password the user additionaly to the device name needs to enter to claim it as their own,
+    /// pass nullptr or an empty string if the user should be able to claim the device without any password
+    /// @param duration_ms Total time in milliseconds the user has to claim their device as their own
+    /// @return Whether sending the claiming request was successful or not
+    bool Claim_Request(char const * secret_key, size_t const & duration_ms) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> request_buffer;
+
+        if (!Helper::stringIsNullorEmpty(secret_key)) {
+            request_buffer[COAP_SECRET_KEY] = secret_key;
+        }
+        request_buffer[COAP_DURATION_KEY] = duration_ms;
+        return Send_Json(DEFAULT_TOPIC_PROFILE.claim, request_buffer, 0U);
+    }
+
+    //----------------------------------------------------------------------------
+    // Telemetry API
+
+    /// @brief Attempts to send telemetry data with the given key and value of the given type.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send
+    /// @param value Value of the key value pair we want to send
+    /// @return Whether sending the data was successful or not
+    template<typename T>
+    bool sendTelemetryData(char const * key, T const & value) {
+        return sendKeyValue(key, value);
+    }
+
+    /// @brief Attempts to send aggregated telemetry data, expects iterators to a container containing Telemetry class instances.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @return Whether sending the aggregated telemetry data was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud.
+    /// Should simply be the biggest distance between first and last iterator this method is ever called with
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool sendTelemetry(InputIterator const & first, InputIterator const & last) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return sendDataArray(first, last, true);
+#else
+        return sendDataArray<MaxKeyValuePairAmount>(first, last, true);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+
+    /// @brief Attempts to send custom json telemetry string.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @param json String containing our json key value pairs we want to attempt to send
+    /// @return Whether sending the data was successful or not
+    bool sendTelemetryString(char const * json) {
+        return Send_Json_String(DEFAULT_TOPIC_PROFILE.telemetry, json);
+    }
+
+    /// @brief Attempts to send telemetry key value pairs from custom source to the server.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param json_size Size of the data inside the source
+    /// @return Whether sending the data was successful or not
+    bool sendTelemetryJson(JsonDocument const & source, size_t const & json_size) {
+        return Send_Json(DEFAULT_TOPIC_PROFILE.telemetry, source, json_size);
+    }
+
+    //----------------------------------------------------------------------------
+    // Attribute API
+
+    /// @brief Attempts to send attribute data with the given key and value of the given type.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send
+    /// @param value Value of the key value pair we want to send
+    /// @return Whether sending the data was successful or not
+    template<typename T>
+    bool sendAttributeData(char const * key, T const & value) {
+        return sendKeyValue(key, value, false);
+    }
+
+    /// @brief Attempts to send aggregated attribute data, expects iterators to a container containing Attribute class instances.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @return Whether sending the aggregated attribute data was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud.
+    /// Should simply be the biggest distance between first and last iterator this method is ever called with
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool sendAttributes(InputIterator const & first, InputIterator const & last) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return sendDataArray(first, last, false);
+#else
+        return sendDataArray<MaxKeyValuePairAmount>(first, last, false);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+
+    /// @brief Attempts to send custom json attribute string.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @param json String containing our json key value pairs we want to attempt to send
+    /// @return Whether sending the data was successful or not
+    bool sendAttributeString(char const * json) {
+        return Send_Json_String(DEFAULT_TOPIC_PROFILE.attribute, json);
+    }
+
+    /// @brief Attempts to send attribute key value pairs from custom source to the server.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param json_size Size of the data inside the source
+    /// @return Whether sending the data was successful or not
+    bool sendAttributeJson(JsonDocument const & source, size_t const & json_size) {
+        return Send_Json(DEFAULT_TOPIC_PROFILE.attribute, source, json_size);
+    }
+
+  private:
+    /// @brief Returns the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
+    /// @return Maximum amount of bytes we want to allocate on the stack
+    size_t const & getMaximumStackSize() const {
+        return m_max_stack;
+    }
+
+    /// @brief Passes the callbacks of this instance to the given API implementation. The API implementations always use the default topics,
+    /// because the topics are only used internally to differentiate the requests and are never sent to the server
+    /// @param api API implementation that should be initialized
+    void Initialize_API_Implementation(IAPI_Implementation & api) {
+#if THINGSBOARD_ENABLE_STL
+        api.Set_Client_Callbacks(std::bind(&ThingsBoardCoapSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardCoapSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardCoapSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardCoapSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardCoapSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardCoapSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardCoapSized::getClientSendBufferSize, this), std::bind(&ThingsBoardCoapSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardCoapSized::getRequestID, this));
+#else
+        api.Set_Client_Callbacks(ThingsBoardCoapSized::staticSubscribeImplementation, ThingsBoardCoapSized::staticSendJson, ThingsBoardCoapSized::staticSendJsonString, ThingsBoardCoapSized::staticClientSubscribe, ThingsBoardCoapSized::staticClientUnsubscribe, ThingsBoardCoapSized::staticGetClientReceiveBufferSize, ThingsBoardCoapSized::staticGetClientSendBufferSize, ThingsBoardCoapSized::staticSetBufferSize, ThingsBoardCoapSized::staticGetRequestID);
+#endif // THINGSBOARD_ENABLE_STL
+        // Received payloads always have to fit into a single datagram, therefore they are never streamed
+        api.Set_Stream_Supported(false);
+        api.Set_Topic_Profile(DEFAULT_TOPIC_PROFILE);
+        api.Initialize();
+    }
+
+    /// @brief Checks whether the given topic was created from the given topic format, by comparing everything before the request id
+    /// @param topic Topic that should be checked
+    /// @param format Topic format containing a single %u for the request id
+    /// @return Whether the topic starts with the part of the format before the request id
+    static bool Starts_With_Format(char const * topic, char const * format) {
+        return strncmp(topic, format, strcspn(format, "%")) == 0;
+    }
+
+    /// @brief Parses the request id out of the given topic, that was created from the given topic format
+    /// @param format Topic format containing a single %u for the request id
+    /// @param topic Topic containing the request id
+    /// @return Parsed request id
+    static size_t Parse_Request_Id(char const * format, char const * topic) {
+        return atoi(topic + strcspn(format, "%"));
+    }
+
+    /// @brief Checks whether the given path ends with the given suffix
+    /// @param path Path that should be checked
+    /// @param suffix Suffix the path should end with
+    /// @return Whether the path ends with the given suffix
+    static bool Ends_With(char const * path, char const * suffix) {
+        size_t const path_length = strlen(path);
+        size_t const suffix_length = strlen(suffix);
+        return path_length >= suffix_length && strcmp(path + path_length - suffix_length, suffix) == 0;
+    }
+
+    /// @brief Translates the given MQTT topic into the path of the CoAP resource that has to be observed instead
+    /// @param topic MQTT topic that would be subscribed
+    /// @return Resource that has to be observed, nullptr if the topic does not require an observation
+    static char const * Get_Observed_Resource(char const * topic) {
+        if (strcmp(topic, DEFAULT_TOPIC_PROFILE.rpc_subscribe) == 0) {
+            return COAP_RPC_RESOURCE;
+        }
+        else if (strcmp(topic, DEFAULT_TOPIC_PROFILE.attribute) == 0) {
+            return COAP_ATTRIBUTES_RESOURCE;
+        }
+        return nullptr;
+    }
+
+    /// @brief Sends a request and checks whether the server responded with a success code
+    /// @param method Method of the request
+    /// @param path Path and query of the requested resource
+    /// @param json Payload that should be sent or nullptr if no payload should be sent
+    /// @return Whether the request was successful or not, the response is kept in the client until the next request
+    bool Send_Request(CoAP_Method const & method, char const * path, char const * json) {
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(COAP_SEND_MESSAGE, path, json != nullptr ? json : "");
+#endif // THINGSBOARD_ENABLE_DEBUG
+        char const * method_name = (method == CoAP_Method::GET) ? COAP_GET : COAP_POST;
+        int const result = m_client.request(method, path, reinterpret_cast<uint8_t const *>(json), json != nullptr ? strlen(json) : 0U);
+        if (result != 0) {
+            Logger::printfln(COAP_REQUEST_FAILED, method_name, result);
+            return false;
+        }
+        int const code = m_client.get_response_code();
+        if (code < COAP_RESPONSE_SUCCESS_RANGE_START || code > COAP_RESPONSE_SUCCESS_RANGE_END) {
+            Logger::printfln(COAP_FAILED, method_name, code);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Sends the given json as a POST request to the given resource of the device API
+    /// @param resource Resource the json should be sent to (example: telemetry)
+    /// @param json String containing our json key value pairs we want to attempt to send
+    /// @return Whether sending the data was successful or not
+    bool Post_Resource(char const * resource, char const * json) {
+        char path[Helper::detectSize(COAP_API_PATH, m_token, resource)] = {};
+        (void)snprintf(path, sizeof(path), COAP_API_PATH, m_token, resource);
+        return Send_Request(CoAP_Method::POST, path, json);
+    }
+
+    /// @brief Translates the attribute request created by the Attribute_Request implementation into a GET request, where every key of the given json becomes a query argument
+    /// (example: {"sharedKeys":"fw_title,fw_version"} becomes /api/v1/$TOKEN/attributes?sharedKeys=fw_title,fw_version). The response is then passed on as if it was received over the attribute response topic
+    /// @param topic MQTT topic the attribute request would be sent over, contains the request id
+    /// @param source JsonDocument containing the requested keys
+    /// @return Whether sending the request was successful or not
+    bool Request_Attributes(char const * topic, JsonDocument const & source) {
+        if (m_token == nullptr) {
+            return false;
+        }
+        JsonObjectConst const arguments = source.as<JsonObjectConst>();
+        size_t size = Helper::detectSize(COAP_API_PATH, m_token, COAP_ATTRIBUTES_RESOURCE);
+        for (JsonPairConst const argument : arguments) {
+            char const * value = argument.value().as<char const *>();
+            // Seperator before the argument and the equal sign between key and value
+            size += strlen(argument.key().c_str()) + (value != nullptr ? strlen(value) : 0U) + 2U;
+        }
+
+        char path[size] = {};
+        int length = snprintf(path, sizeof(path), COAP_API_PATH, m_token, COAP_ATTRIBUTES_RESOURCE);
+        char seperator = '?';
+        for (JsonPairConst const argument : arguments) {
+            char const * value = argument.value().as<char const *>();
+            length += snprintf(path + length, sizeof(path) - length, "%c%s=%s", seperator, argument.key().c_str(), value != nullptr ? value : "");
+            seperator = '&';
+        }
+
+        if (!Send_Request(CoAP_Method::GET, path, nullptr)) {
+            return false;
+        }
+        size_t const request_id = Parse_Request_Id(DEFAULT_TOPIC_PROFILE.attribute_request, topic);
+        Dispatch_Response(DEFAULT_TOPIC_PROFILE.attribute_response, request_id, m_client.get_response_payload(), m_client.get_response_length());
+        return true;
+    }
+
+    /// @brief Passes the given response to the API implementations, as if it was received over the internal topic created from the given prefix and request id
+    /// @param prefix Prefix of the internal response topic
+    /// @param request_id Id of the request the response belongs to
+    /// @param payload Payload of the response
+    /// @param length Length of the payload
+    void Dispatch_Response(char const * prefix, size_t const & request_id, uint8_t const * payload, size_t const & length) {
+        char topic[Helper::detectSize(COAP_RESPONSE_TOPIC, prefix, request_id)] = {};
+        (void)snprintf(topic, sizeof(topic), COAP_RESPONSE_TOPIC, prefix, request_id);
+        Dispatch(topic, payload, length);
+    }
+
+    /// @brief Copies the given payload and passes it to every API implementation that handles the given topic. The payload is copied, because it points into the receive buffer of the client,
+    /// which is overwritten as soon as any of the called callbacks sends another request, whereas the MQTT clients use seperate buffers for sending and receiving
+    /// @param topic Internal MQTT topic the payload would have been received over
+    /// @param payload Payload of the received response or notification
+    /// @param length Length of the payload
+    void Dispatch(char const * topic, uint8_t const * payload, size_t const & length) {
+        if (payload == nullptr || length == 0U) {
+            return;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(COAP_RECEIVE_MESSAGE, length, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        uint8_t * copy = new uint8_t[length + 1U]();
+        if (copy == nullptr) {
+            Logger::printfln(COAP_UNABLE_TO_COPY_PAYLOAD, length);
+            return;
+        }
+        memcpy(copy, payload, length);
+        Process_Message(topic, copy, length);
+        // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        delete[] copy;
+        copy = nullptr;
+    }
+
+    /// @brief Passes the given payload to the API implementations, first to the ones processing it as raw bytes and if there are none, deserialized to the ones processing it as json
+    /// @param topic Internal MQTT topic the payload would have been received over
+    /// @param payload Writeable copy of the received payload
+    /// @param length Length of the payload
+    void Process_Message(char const * topic, uint8_t * payload, size_t const & length) {
+        bool processed_response_as_raw = false;
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+            api->Process_Response(topic, payload, length);
+            processed_response_as_raw = true;
+        }
+
+        // Responses processed as raw bytes are not valid json in every case, therefore deserializing them would fail
+        if (processed_response_as_raw) {
+            return;
+        }
+
+        // Calculate size with the total amount of commas, always denotes the end of a key-value pair besides for the last element in an array or in an object where the comma is not permitted,
+        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well
+        size_t const size = Helper::getOccurences(payload, ',', length) + Helper::getOccurences(payload, '{', length) + Helper::getOccurences(payload, '[', length);
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const document_size = JSON_OBJECT_SIZE(size);
+        if (m_max_response_size != 0U && document_size > m_max_response_size) {
+            Logger::printfln(COAP_MAXIMUM_RESPONSE_EXCEEDED, document_size, m_max_response_size);
+            return;
+        }
+        TBJsonDocument json_buffer(document_size);
+        if (json_buffer.capacity() != document_size) {
+            Logger::printfln(COAP_HEAP_ALLOCATION_FAILED, document_size);
+            return;
+        }
+#else
+        if (size > MaxResponse) {
+            Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxResponse", MaxResponse);
+            return;
+        }
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxResponse)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        // Copy of the payload is writeable, which allows to use the zero copy mode of ArduinoJson
+        DeserializationError const error = deserializeJson(json_buffer, payload, length);
+        if (error) {
+            Logger::printfln(COAP_UNABLE_TO_DE_SERIALIZE_JSON, error.c_str());
+            return;
+        }
+
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::JSON || !api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+            api->Process_Json_Response(topic, json_buffer);
+        }
+    }
+
+    /// @brief CoAP callback that will be called for every received notification of an observed resource.
+    /// Server-side RPC notifications contain the request id in the payload, which is moved into the internal topic instead, because that is where the Server_Side_RPC implementation expects it
+    /// @param path Path the observation was registered with
+    /// @param payload Payload of the notification
+    /// @param length Length of the payload
+    void onCoAPNotification(char const * path, uint8_t * payload, unsigned int length) {
+        if (path == nullptr) {
+            return;
+        }
+        else if (Ends_With(path, COAP_RPC_SUFFIX)) {
+            Json_Extractor<1U> const extractor(COAP_RPC_NOTIFICATION_KEYS);
+            Json_Span values[1U] = {};
+            if (!extractor.Extract(reinterpret_cast<char const *>(payload), length, values) || values[0U].Is_Null()) {
+                Logger::printfln(COAP_RPC_ID_MISSING);
+                return;
+            }
+            size_t const request_id = strtoul(values[0U].data, nullptr, 10);
+            Dispatch_Response(DEFAULT_TOPIC_PROFILE.rpc_request, request_id, payload, length);
+        }
+        else if (Ends_With(path, COAP_ATTRIBUTES_SUFFIX)) {
+            Dispatch(DEFAULT_TOPIC_PROFILE.attribute, payload, length);
+        }
+    }
+
+    /// @brief Returns the current receive buffer size of the underlying client interface
+    /// @return Current internal receive buffer size
+    uint16_t getClientReceiveBufferSize() {
+        return m_client.get_receive_buffer_size();
+    }
+
+    /// @brief Returns the current send buffer size of the underlying client interface
+    /// @return Current internal send buffer size
+    uint16_t getClientSendBufferSize() {
+        return m_client.get_send_buffer_size();
+    }
+
+    /// @brief Translates subscribing the given MQTT topic into observing the matching CoAP resource. The topics the responses of attribute requests and client-side RPC are received over,
+    /// do not have to be subscribed, because the responses are piggybacked on the acknowledgement of the request itself
+    /// @param topic Topic that should be subscribed
+    /// @return Whether subscribing was successfull or not, fails if the client is not connected yet, the topic is resubscribed once it connects
+    bool clientSubscribe(char const * topic) {
+        if (strcmp(topic, DEFAULT_TOPIC_PROFILE.attribute_response_subscribe) == 0 || strcmp(topic, DEFAULT_TOPIC_PROFILE.rpc_response_subscribe) == 0) {
+            return true;
+        }
+        char const * resource = Get_Observed_Resource(topic);
+        if (resource == nullptr) {
+            Logger::printfln(COAP_TOPIC_NOT_SUPPORTED, topic);
+            return false;
+        }
+        else if (m_token == nullptr || !m_client.connected()) {
+            return false;
+        }
+        char path[Helper::detectSize(COAP_API_PATH, m_token, resource)] = {};
+        (void)snprintf(path, sizeof(path), COAP_API_PATH, m_token, resource);
+        return m_client.observe(path);
+    }
+
+    /// @brief Translates unsubscribing the given MQTT topic into cancelling the observation of the matching CoAP resource
+    /// @param topic Topic that should be unsubscribed
+    /// @return Whether unsubscribing was successfull or not
+    bool clientUnsubscribe(char const * topic) {
+        char const * resource = Get_Observed_Resource(topic);
+        if (resource == nullptr || m_token == nullptr) {
+            return true;
+        }
+        char path[Helper::detectSize(COAP_API_PATH, m_token, resource)] = {};
+        (void)snprintf(path, sizeof(path), COAP_API_PATH, m_token, resource);
+        return m_client.cancel_observe(path);
+    }
+
+    /// @brief Gets a mutable pointer to the request id, the current value is the id of the last sent request.
+    /// Is used because each request to the cloud of the same type has to use a different id to differentiate request and response
+    /// @return Mutable reference to the request id
+    size_t * getRequestID() {
+        return &m_request_id;
+    }
+
+    /// @brief Observes the resources of every API implementation that has subscribed callbacks, because the client forgets all observations once it is stopped
+    void Resubscribe_Topics() {
+        // Results are ignored, because the important part of clearing internal data structures always succeeds
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr) {
+                continue;
+            }
+            (void)api->Resubscribe_Topic();
+        }
+    }
+
+    /// @brief Attempts to send a single key-value pair with the given key and value of the given type
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send
+    /// @param value Value of the key value pair we want to send
+    /// @param telemetry Whether the data we want to send should be sent as an attribute or telemetry data value
+    /// @return Whether sending the data was successful or not
+    template<typename T>
+    bool sendKeyValue(char const * key, T const & value, bool telemetry = true) {
+        const Telemetry t(key, value);
+        if (t.IsEmpty()) {
+            return false;
+        }
+
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> json_buffer;
+        if (!t.SerializeKeyValue(json_buffer)) {
+            Logger::printfln(UNABLE_TO_SERIALIZE);
+            return false;
+        }
+        return telemetry ? sendTelemetryJson(json_buffer, 0U) : sendAttributeJson(json_buffer, 0U);
+    }
+
+    /// @brief Attempts to send aggregated attribute or telemetry data
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param telemetry Whether the data we want to send should be sent over the attribute or telemtry resource
+    /// @return Whether sending the aggregated data was successful or not
+#if THINGSBOARD_ENABLE_DYNAMIC
+    template<typename InputIterator>
+#else
+    /// @tparam MaxKeyValuePairAmount Maximum amount of json key value pairs, which will ever be sent with this method to the cloud.
+    /// Should simply be the biggest distance between first and last iterator this method is ever called with
+    template<size_t MaxKeyValuePairAmount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry) {
+        size_t const size = Helper::distance(first, last);
+#if THINGSBOARD_ENABLE_DYNAMIC
+        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(size));
+#else
+        if (size > MaxKeyValuePairAmount) {
+            Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxKeyValuePairAmount", MaxKeyValuePairAmount);
+            return false;
+        }
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxKeyValuePairAmount)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        for (auto it = first; it != last; ++it) {
+            auto const & data = *it;
+            if (!data.SerializeKeyValue(json_buffer)) {
+                Logger::printfln(UNABLE_TO_SERIALIZE);
+                return false;
+            }
+        }
+        return telemetry ? sendTelemetryJson(json_buffer, 0U) : sendAttributeJson(json_buffer, 0U);
+    }
+
+#if !THINGSBOARD_ENABLE_STL
+    static void onStaticCoAPNotification(char const * path, uint8_t * payload, unsigned int length) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->onCoAPNotification(path, payload, length);
+    }
+
+    static void staticSubscribeImplementation(IAPI_Implementation & api) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->Subscribe_API_Implementation(api);
+    }
+
+    static bool staticSendJson(char const * topic, JsonDocument const & source, size_t const & json_size) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Send_Json(topic, source, json_size);
+    }
+
+    static bool staticSendJsonString(char const * topic, char const * json) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Send_Json_String(topic, json);
+    }
+
+    static bool staticClientSubscribe(char const * topic) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->clientSubscribe(topic);
+    }
+
+    static bool staticClientUnsubscribe(char const * topic) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->clientUnsubscribe(topic);
+    }
+
+    static size_t * staticGetRequestID() {
+        if (m_subscribedInstance == nullptr) {
+            return nullptr;
+        }
+        return m_subscribedInstance->getRequestID();
+    }
+
+    static uint16_t staticGetClientReceiveBufferSize() {
+        if (m_subscribedInstance == nullptr) {
+            return 0U;
+        }
+        return m_subscribedInstance->getClientReceiveBufferSize();
+    }
+
+    static uint16_t staticGetClientSendBufferSize() {
+        if (m_subscribedInstance == nullptr) {
+            return 0U;
+        }
+        return m_subscribedInstance->getClientSendBufferSize();
+    }
+
+    static bool staticSetBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->setBufferSize(receive_buffer_size, send_buffer_size);
+    }
+
+    // CoAP client cannot call a instanced method when a notification arrives.
+    // Only free-standing function is allowed.
+    // To be able to forward event to an instance, rather than to a function, this pointer exists.
+    static ThingsBoardCoapSized *m_subscribedInstance;
+#endif // !THINGSBOARD_ENABLE_STL
+
+    ICoAP_Client&                                   m_client = {};              // CoAP client instance.
+    size_t                                          m_max_stack = {};           // Maximum stack size we allocate at once.
+    char const                                      *m_token = {};              // Access token used in every path of the device API
+    size_t                                          m_request_id = {};          // Internal id used to differentiate which request should receive which response for certain API calls
+#if !THINGSBOARD_ENABLE_DYNAMIC
+    Array<IAPI_Implementation*, MaxEndpointsAmount> m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request)
+#else
+    size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
+    Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request)
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#if !THINGSBOARD_ENABLE_STL
+#if !THINGSBOARD_ENABLE_DYNAMIC
+template<size_t MaxResponse, size_t MaxEndpointsAmount, typename Logger>
+ThingsBoardCoapSized<MaxResponse, MaxEndpointsAmount, Logger> *ThingsBoardCoapSized<MaxResponse, MaxEndpointsAmount, Logger>::m_subscribedInstance = nullptr;
+#else
+template<typename Logger>
+ThingsBoardCoapSized<Logger> *ThingsBoardCoapSized<Logger>::m_subscribedInstance = nullptr;
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+#endif // !THINGSBOARD_ENABLE_STL
+
+using ThingsBoardCoap = ThingsBoardCoapSized<>;
+
+#endif // ThingsBoard_Coap_h
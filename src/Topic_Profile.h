@@ -0,0 +1,74 @@
+#ifndef Topic_Profile_h
+#define Topic_Profile_h
+
+// Local include.
+#include "Configuration.h"
+
+
+// Publish data topics.
+char constexpr TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
+// Shared attribute update API topics.
+char constexpr ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+// Attribute request API topics.
+char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/%u";
+char constexpr ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/attributes/response/+";
+char constexpr ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
+// Server side RPC topics.
+char constexpr RPC_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/request/+";
+char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
+char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
+// Client side RPC topics.
+char constexpr RPC_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/response/+";
+char constexpr RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
+char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/%u";
+// RPC topic prefix shared by server-side RPC responses and client-side RPC requests.
+char constexpr RPC_TOPIC_PREFIX[] = "v1/devices/me/rpc/";
+// Claim topics.
+char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
+// Firmware topics, which are the same for every profile.
+char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/";
+char constexpr FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/fw/response/+";
+char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/%u/chunk/%u";
+// Short variants of the topics above, see https://thingsboard.io/docs/reference/mqtt-api/ for more information.
+char constexpr SHORT_TELEMETRY_TOPIC[] = "v2/t";
+char constexpr SHORT_ATTRIBUTE_TOPIC[] = "v2/a";
+char constexpr SHORT_ATTRIBUTE_REQUEST_TOPIC[] = "v2/a/req/%u";
+char constexpr SHORT_ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/a/res/+";
+char constexpr SHORT_ATTRIBUTE_RESPONSE_TOPIC[] = "v2/a/res/";
+char constexpr SHORT_RPC_SUBSCRIBE_TOPIC[] = "v2/r/req/+";
+char constexpr SHORT_RPC_REQUEST_TOPIC[] = "v2/r/req/";
+char constexpr SHORT_RPC_SEND_RESPONSE_TOPIC[] = "v2/r/res/%u";
+char constexpr SHORT_RPC_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/r/res/+";
+char constexpr SHORT_RPC_RESPONSE_TOPIC[] = "v2/r/res/";
+char constexpr SHORT_RPC_SEND_REQUEST_TOPIC[] = "v2/r/req/%u";
+char constexpr SHORT_RPC_TOPIC_PREFIX[] = "v2/r/";
+
+
+/// @brief Topics of the device MQTT API that the ThingsBoard client and the API implementations publish, subscribe and compare received topics with.
+/// Allows to switch every topic at once, for example to the short variants, which reduces the overhead of every single message,
+/// because for small payloads the topic can make up most of the sent bytes. Topics that contain a request id are formats with a single %u,
+/// response topics that are compared with received topics are the prefixes before the request id. Claiming does not have a short variant.
+/// The firmware and provisioning topics are always the same, because the firmware topics are already short and provisioning only happens once
+struct Topic_Profile {
+    char const *telemetry;                     // Topic telemetry is sent over
+    char const *attribute;                     // Topic client-side attributes are sent over and shared attribute updates are received over
+    char const *attribute_request;             // Format of the topic attribute requests are sent over
+    char const *attribute_response_subscribe;  // Topic filter subscribed to receive the responses to attribute requests
+    char const *attribute_response;            // Prefix of the topic the responses to attribute requests are received over
+    char const *rpc_subscribe;                 // Topic filter subscribed to receive server-side RPC requests
+    char const *rpc_request;                   // Prefix of the topic server-side RPC requests are received over
+    char const *rpc_send_response;             // Format of the topic the responses to server-side RPC requests are sent over
+    char const *rpc_response_subscribe;        // Topic filter subscribed to receive the responses to client-side RPC requests
+    char const *rpc_response;                  // Prefix of the topic the responses to client-side RPC requests are received over
+    char const *rpc_send_request;              // Format of the topic client-side RPC requests are sent over
+    char const *rpc_prefix;                    // Prefix shared by server-side RPC responses and client-side RPC requests
+    char const *claim;                         // Topic claiming requests are sent over
+};
+
+
+// Full length topics, supported by every ThingsBoard version.
+Topic_Profile constexpr DEFAULT_TOPIC_PROFILE = { TELEMETRY_TOPIC, ATTRIBUTE_TOPIC, ATTRIBUTE_REQUEST_TOPIC, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC, ATTRIBUTE_RESPONSE_TOPIC, RPC_SUBSCRIBE_TOPIC, RPC_REQUEST_TOPIC, RPC_SEND_RESPONSE_TOPIC, RPC_RESPONSE_SUBSCRIBE_TOPIC, RPC_RESPONSE_TOPIC, RPC_SEND_REQUEST_TOPIC, RPC_TOPIC_PREFIX, CLAIM_TOPIC };
+// Short topics, supported by ThingsBoard 3.5 and newer.
+Topic_Profile constexpr SHORT_TOPIC_PROFILE = { SHORT_TELEMETRY_TOPIC, SHORT_ATTRIBUTE_TOPIC, SHORT_ATTRIBUTE_REQUEST_TOPIC, SHORT_ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC, SHORT_ATTRIBUTE_RESPONSE_TOPIC, SHORT_RPC_SUBSCRIBE_TOPIC, SHORT_RPC_REQUEST_TOPIC, SHORT_RPC_SEND_RESPONSE_TOPIC, SHORT_RPC_RESPONSE_SUBSCRIBE_TOPIC, SHORT_RPC_RESPONSE_TOPIC, SHORT_RPC_SEND_REQUEST_TOPIC, SHORT_RPC_TOPIC_PREFIX, CLAIM_TOPIC };
+
+#endif // Topic_Profile_h
@@ -0,0 +1,203 @@
+// Passes fabricated data events of the esp-mqtt client to the Espressif_MQTT_Client and streams the firmware chunks split into those events into the OTA_Handler,
+// to ensure the updater receives exactly the bytes of the original firmware, even though only the first data event of every message contains its topic.
+#include <Espressif_MQTT_Client.h>
+#include <HashGenerator.h>
+#include <OTA_Handler.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+
+constexpr char FIRMWARE_TITLE[] = "fragment_test";
+constexpr char FIRMWARE_VERSION[] = "0.0.0";
+constexpr char FIRMWARE_CHUNK_TOPIC[] = "v2/fw/response/0/chunk/%u";
+constexpr char FIRMWARE_CHUNK_TOPIC_PREFIX[] = "v2/fw/response/";
+constexpr char RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/1";
+constexpr uint16_t FIRMWARE_CHUNK_SIZE = 1024U;
+constexpr size_t FIRMWARE_SIZE = (2U * FIRMWARE_CHUNK_SIZE) + 552U;
+// Size of the receive buffer of the esp-mqtt client, every message bigger than it is received in multiple data events
+constexpr size_t RECEIVE_BUFFER_SIZE = 200U;
+
+size_t failures = 0U;
+
+/// @brief Prints the given message and counts the failure if the given condition is not fulfilled
+/// @param condition Condition that should be fulfilled
+/// @param message Description of the checked condition
+void Check(bool const & condition, char const * message) {
+    if (!condition) {
+        printf("FAILED: %s\n", message);
+        ++failures;
+    }
+}
+
+
+/// @brief Updater that keeps the written firmware in memory, so that it can be compared to the original firmware in the end
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_written.clear();
+        m_written.reserve(firmware_size);
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_written.insert(m_written.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_written.clear();
+        m_ended = false;
+    }
+
+    bool end() override {
+        m_ended = true;
+        return true;
+    }
+
+    std::vector<uint8_t> const & Get_Written() const {
+        return m_written;
+    }
+
+    bool Get_Ended() const {
+        return m_ended;
+    }
+
+  private:
+    std::vector<uint8_t> m_written = {}; // Firmware written since the update has been started or reset
+    bool                 m_ended = {};   // Whether the update has been ended after the complete firmware was written
+};
+
+
+std::vector<size_t> requested_chunks;
+size_t streamed_fragments = 0U;
+size_t received_messages = 0U;
+bool update_finished = false;
+bool update_successful = false;
+
+Espressif_MQTT_Client<> mqtt_client;
+Memory_Updater updater;
+OTA_Handler<DefaultLogger> ota_handler(
+    [](size_t const & request_id, size_t const & chunk) { requested_chunks.push_back(chunk); return true; },
+    [](char const * const state, char const * const error) { return true; },
+    []() { return true; });
+
+
+/// @brief Streams only the firmware chunks, exactly like the ThingsBoard client which only streams topics of API implementations that process raw bytes
+/// @param topic Topic of the first data event of a message that does not fit into the receive buffer
+/// @return Whether the fragments of the message should be streamed
+bool Stream_Filter(char const * topic) {
+    return strncmp(topic, FIRMWARE_CHUNK_TOPIC_PREFIX, strlen(FIRMWARE_CHUNK_TOPIC_PREFIX)) == 0;
+}
+
+/// @brief Passes the streamed fragments of the firmware chunks to the OTA_Handler
+void Stream_Callback(char * topic, uint8_t * payload, unsigned int length, size_t const & offset, size_t const & total_length) {
+    ++streamed_fragments;
+    unsigned int chunk = 0U;
+    Check(sscanf(topic, FIRMWARE_CHUNK_TOPIC, &chunk) == 1, "Streamed fragment has the topic of the message it is part of");
+    ota_handler.Process_Firmware_Packet_Slice(chunk, payload, length, offset, total_length);
+}
+
+/// @brief Counts the messages that fit into the receive buffer and are therefore received in a single data event
+void Data_Callback(char * topic, uint8_t * payload, unsigned int length) {
+    ++received_messages;
+}
+
+/// @brief Passes the given payload to the event handler of the client, split into data events of the receive buffer size like the esp-mqtt client does.
+/// Only the first data event contains the topic, every following one only the fragment of the payload at its offset
+/// @param topic Topic the message is received over
+/// @param payload Complete payload of the message
+/// @param length Length of the complete payload
+/// @param first_offset Offset of the first data event that is passed, allows to pass the fragments of a message without its first data event
+void Receive_Message(char const * topic, uint8_t const * payload, size_t const & length, size_t const & first_offset = 0U) {
+    std::vector<char> topic_copy(topic, topic + strlen(topic));
+    std::vector<char> payload_copy(payload, payload + length);
+    for (size_t offset = first_offset; offset < length; offset += RECEIVE_BUFFER_SIZE) {
+        esp_mqtt_event_t event = {};
+        event.event_id = esp_mqtt_event_id_t::MQTT_EVENT_DATA;
+        event.data = payload_copy.data() + offset;
+        event.data_len = static_cast<int>((length - offset < RECEIVE_BUFFER_SIZE) ? length - offset : RECEIVE_BUFFER_SIZE);
+        event.total_data_len = static_cast<int>(length);
+        event.current_data_offset = static_cast<int>(offset);
+        event.topic = (offset == 0U) ? topic_copy.data() : nullptr;
+        event.topic_len = (offset == 0U) ? static_cast<int>(topic_copy.size()) : 0;
+        registered_event_handler(registered_handler_args, "MQTT_EVENTS", event.event_id, &event);
+    }
+}
+
+/// @brief Receives the given firmware chunk split into data events
+/// @param firmware Complete firmware binary
+/// @param chunk Index of the chunk that should be received
+void Receive_Chunk(std::vector<uint8_t> const & firmware, size_t const & chunk) {
+    char topic[sizeof(FIRMWARE_CHUNK_TOPIC) + 10U] = {};
+    (void)snprintf(topic, sizeof(topic), FIRMWARE_CHUNK_TOPIC, static_cast<unsigned int>(chunk));
+    size_t const offset = chunk * FIRMWARE_CHUNK_SIZE;
+    size_t const length = (offset + FIRMWARE_CHUNK_SIZE > firmware.size()) ? firmware.size() - offset : FIRMWARE_CHUNK_SIZE;
+    Receive_Message(topic, firmware.data() + offset, length);
+}
+
+int main() {
+    std::vector<uint8_t> firmware(FIRMWARE_SIZE);
+    srand(0U);
+    for (auto & byte : firmware) {
+        byte = static_cast<uint8_t>(rand());
+    }
+    HashGenerator hash;
+    char checksum[FIRMWARE_HASH_SIZE] = {};
+    (void)hash.start(mbedtls_md_type_t::MBEDTLS_MD_SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    (void)hash.finish(checksum);
+
+    (void)mqtt_client.set_buffer_size(RECEIVE_BUFFER_SIZE, RECEIVE_BUFFER_SIZE);
+    mqtt_client.set_data_callback(Data_Callback);
+    (void)mqtt_client.set_stream_callback(Stream_Filter, Stream_Callback);
+    mqtt_client.set_server("localhost", 1883U);
+    Check(mqtt_client.connect("fragment_test", nullptr, nullptr), "Client registers its event handler");
+    Check(registered_event_handler != nullptr, "Event handler has been registered");
+    if (registered_event_handler == nullptr) {
+        return EXIT_FAILURE;
+    }
+
+    OTA_Update_Callback const callback(FIRMWARE_TITLE, FIRMWARE_VERSION, &updater, [](bool const & success) { update_finished = true; update_successful = success; }, nullptr, nullptr, CHUNK_RETRIES, FIRMWARE_CHUNK_SIZE);
+    ota_handler.Start_Firmware_Update(callback, FIRMWARE_SIZE, checksum, mbedtls_md_type_t::MBEDTLS_MD_SHA256);
+
+    // The topic is captured from the first data event and passed with every following fragment of the same message
+    Check(requested_chunks.size() == 1U && requested_chunks.back() == 0U, "First chunk has been requested");
+    Receive_Chunk(firmware, 0U);
+    Check(streamed_fragments == (FIRMWARE_CHUNK_SIZE + RECEIVE_BUFFER_SIZE - 1U) / RECEIVE_BUFFER_SIZE, "Every fragment of the first chunk has been streamed");
+    Check(requested_chunks.size() == 2U && requested_chunks.back() == 1U, "Second chunk has been requested after the first chunk was received completely");
+
+    // Messages whose topic is rejected by the filter are discarded, including all their following fragments
+    size_t const streamed_before_rejected = streamed_fragments;
+    std::vector<uint8_t> const rpc_request(3U * RECEIVE_BUFFER_SIZE, '1');
+    Receive_Message(RPC_REQUEST_TOPIC, rpc_request.data(), rpc_request.size());
+    Check(streamed_fragments == streamed_before_rejected, "Fragments of a rejected message are not streamed");
+    Check(received_messages == 0U, "Fragments of a rejected message are not received as a complete message");
+
+    // Completely received messages end the stream, therefore fragments without a preceding first data event are discarded
+    Receive_Chunk(firmware, 1U);
+    size_t const streamed_before_stray = streamed_fragments;
+    Receive_Message(RPC_REQUEST_TOPIC, rpc_request.data(), rpc_request.size(), RECEIVE_BUFFER_SIZE);
+    Check(streamed_fragments == streamed_before_stray, "Fragments received after the end of the streamed message are not streamed");
+
+    // Messages that fit into the receive buffer are still received in a single data event
+    uint8_t const attribute_response[] = "{\"shared\":{}}";
+    Receive_Message(RPC_REQUEST_TOPIC, attribute_response, sizeof(attribute_response) - 1U);
+    Check(received_messages == 1U, "Message that fits into the receive buffer is received completely");
+
+    Receive_Chunk(firmware, 2U);
+    Check(requested_chunks.size() == 3U, "Every chunk has been requested exactly once");
+    Check(update_finished && update_successful, "Firmware update finished successfully");
+    Check(updater.Get_Ended(), "Updater has been ended");
+    Check(updater.Get_Written() == firmware, "Updater received exactly the bytes of the original firmware");
+
+    if (failures != 0U) {
+        printf("%zu checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+#ifndef mqtt_client_h
+#define mqtt_client_h
+
+// Minimal replacement of the esp-mqtt client for Linux, provides only the types and functions used by the Espressif_MQTT_Client with Espressif IDF v4.X,
+// none of the functions communicate with a broker, instead the event handler registered by the client is kept, so that tests can pass fabricated events to it directly.
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+typedef int esp_err_t;
+esp_err_t constexpr ESP_OK = 0;
+esp_err_t constexpr ESP_FAIL = -1;
+
+typedef char const * esp_event_base_t;
+typedef void (*esp_event_handler_t)(void * handler_args, esp_event_base_t base, int32_t event_id, void * event_data);
+
+enum esp_mqtt_event_id_t : int32_t {
+    MQTT_EVENT_ANY = -1,
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+    MQTT_EVENT_DELETED
+};
+
+enum esp_mqtt_transport_t {
+    MQTT_TRANSPORT_UNKNOWN = 0,
+    MQTT_TRANSPORT_OVER_TCP,
+    MQTT_TRANSPORT_OVER_SSL
+};
+
+enum esp_mqtt_error_type_t {
+    MQTT_ERROR_TYPE_NONE = 0,
+    MQTT_ERROR_TYPE_TCP_TRANSPORT,
+    MQTT_ERROR_TYPE_CONNECTION_REFUSED
+};
+
+struct esp_mqtt_client;
+typedef esp_mqtt_client * esp_mqtt_client_handle_t;
+
+struct esp_mqtt_error_codes_t {
+    esp_mqtt_error_type_t error_type;
+};
+
+/// @brief Data of a single event, messages that do not fit into the receive buffer are split into multiple data events,
+/// where only the first one contains the topic and every following one the next fragment of the payload at the given offset
+struct esp_mqtt_event_t {
+    esp_mqtt_event_id_t    event_id;
+    esp_mqtt_client_handle_t client;
+    char                   *data;
+    int                    data_len;
+    int                    total_data_len;
+    int                    current_data_offset;
+    char                   *topic;
+    int                    topic_len;
+    int                    msg_id;
+    int                    session_present;
+    esp_mqtt_error_codes_t *error_handle;
+};
+typedef esp_mqtt_event_t * esp_mqtt_event_handle_t;
+
+struct esp_mqtt_client_config_t {
+    char const           *host;
+    uint32_t             port;
+    char const           *client_id;
+    char const           *username;
+    char const           *password;
+    int                  keepalive;
+    bool                 disable_keepalive;
+    bool                 disable_auto_reconnect;
+    bool                 disable_clean_session;
+    int                  task_prio;
+    int                  task_stack;
+    int                  buffer_size;
+    int                  out_buffer_size;
+    int                  reconnect_timeout_ms;
+    int                  network_timeout_ms;
+    char const           *cert_pem;
+    esp_err_t            (*crt_bundle_attach)(void * conf);
+    esp_mqtt_transport_t transport;
+};
+
+/// @brief Event handler and its arguments registered by the last call to esp_mqtt_client_register_event()
+inline esp_event_handler_t registered_event_handler = nullptr;
+inline void *registered_handler_args = nullptr;
+
+inline esp_mqtt_client_handle_t esp_mqtt_client_init(esp_mqtt_client_config_t const * config) {
+    static int client = 0;
+    return reinterpret_cast<esp_mqtt_client_handle_t>(&client);
+}
+
+inline esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event, esp_event_handler_t event_handler, void * event_handler_arg) {
+    registered_event_handler = event_handler;
+    registered_handler_args = event_handler_arg;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client) {
+    return client != nullptr ? ESP_OK : ESP_FAIL;
+}
+
+inline esp_err_t esp_mqtt_client_reconnect(esp_mqtt_client_handle_t client) {
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_disconnect(esp_mqtt_client_handle_t client) {
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client) {
+    registered_event_handler = nullptr;
+    registered_handler_args = nullptr;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_set_config(esp_mqtt_client_handle_t client, esp_mqtt_client_config_t const * config) {
+    return ESP_OK;
+}
+
+inline int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, char const * topic, char const * data, int len, int qos, int retain) {
+    return 0;
+}
+
+inline int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, char const * topic, char const * data, int len, int qos, int retain, bool store) {
+    return 0;
+}
+
+inline int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, char const * topic, int qos) {
+    return 0;
+}
+
+inline int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client, char const * topic) {
+    return 0;
+}
+
+inline char const * esp_err_to_name(esp_err_t code) {
+    return code == ESP_OK ? "ESP_OK" : "ESP_FAIL";
+}
+
+#endif // mqtt_client_h